@@ -26,6 +26,7 @@ except NameError:
 OUTPUT_FILE_EXTENSION = 'hpp'
 OUTPUT_FILE_PERMISSIONS = 0o444  # Read only for all
 TEMPLATE_FILENAME = os.path.join(os.path.dirname(__file__), 'data_type_template.tmpl')
+TABLE_TEMPLATE_FILENAME = os.path.join(os.path.dirname(__file__), 'data_type_table_template.tmpl')
 
 __all__ = ['run', 'logger', 'DsdlCompilerException']
 
@@ -34,7 +35,7 @@ class DsdlCompilerException(Exception):
 
 logger = logging.getLogger(__name__)
 
-def run(source_dirs, include_dirs, output_dir):
+def run(source_dirs, include_dirs, output_dir, data_type_table=None):
     '''
     This function takes a list of root namespace directories (containing DSDL definition files to parse), a
     possibly empty list of search directories (containing DSDL definition files that can be referenced from the types
@@ -50,6 +51,9 @@ def run(source_dirs, include_dirs, output_dir):
         include_dirs   List of root namespace directories with referenced types (possibly empty). This list is
                        automaitcally extended with source_dirs.
         output_dir     Output directory path. Will be created if doesn't exist.
+        data_type_table  Optional name of the data type registration table. If set, an additional header file
+                       <output_dir>/<data_type_table>.hpp will be generated, which contains the table of all
+                       data types with default Data Type ID in the namespace of the same name.
     '''
     assert isinstance(source_dirs, list)
     assert isinstance(include_dirs, list)
@@ -62,6 +66,9 @@ def run(source_dirs, include_dirs, output_dir):
     logger.info('%d types total', len(types))
     run_generator(types, output_dir)
 
+    if data_type_table:
+        run_table_generator(types, output_dir, str(data_type_table))
+
 # -----------------
 
 def pretty_filename(filename):
@@ -111,6 +118,45 @@ def run_generator(types, dest_dir):
         logger.info('Generator failure', exc_info=True)
         die(ex)
 
+class DataTypeTable(object):
+    '''
+    Describes the data type registration table; the types are ordered as GlobalDataTypeRegistry::adoptTable()
+    expects, i.e. messages first, then by full name. Python string comparison matches strcmp() for DSDL names.
+    The ID order lists the table indices of each kind by default data type ID, messages first.
+    '''
+    def __init__(self, name, types):
+        if not re.match(r'^[a-zA-Z_][a-zA-Z0-9_]*$', name):
+            die('Invalid data type table name: %s' % name)
+        self.name = name
+        self.include_guard = name.upper() + '_HPP_INCLUDED'
+        self.types = sorted([t for t in types if t.default_dtid is not None],
+                            key=lambda t: (t.kind != t.KIND_MESSAGE, t.full_name))
+        for t in self.types:
+            t.cpp_kind = {
+                t.KIND_MESSAGE: '::uavcan::DataTypeKindMessage',
+                t.KIND_SERVICE: '::uavcan::DataTypeKindService',
+            }[t.kind]
+        ids = set()
+        for t in self.types:
+            if (t.kind, t.default_dtid) in ids:
+                die('Default data type ID collision: %s [%d]' % (t.full_name, t.default_dtid))
+            ids.add((t.kind, t.default_dtid))
+        self.id_order = [i for i, t in sorted(enumerate(self.types),
+                                              key=lambda x: (x[1].kind != x[1].KIND_MESSAGE, x[1].default_dtid))]
+
+def run_table_generator(types, dest_dir, table_name):
+    try:
+        table = DataTypeTable(table_name, types)
+        logger.info('Generating data type table %s with %d types', table.name, len(table.types))
+        template_expander = make_template_expander(TABLE_TEMPLATE_FILENAME)
+        filename = os.path.join(os.path.abspath(dest_dir), table.name + '.' + OUTPUT_FILE_EXTENSION)
+        text = template_expander(table=table)
+        text = '\n'.join(x.rstrip() for x in text.splitlines()) + '\n'
+        write_generated_data(filename, text)
+    except Exception as ex:
+        logger.info('Table generator failure', exc_info=True)
+        die(ex)
+
 def write_generated_data(filename, data):
     dirname = os.path.dirname(filename)
     makedirs(dirname)
@@ -164,6 +210,154 @@ def type_to_cpp_type(t):
     else:
         raise DsdlCompilerException('Unknown type category: %s' % t.category)
 
+class FixedLayoutPrefix(object):
+    '''
+    Describes the leading fields of a data structure whose bit offsets are known at generation time.
+    Such fields are serialized by straight-line code with constant shifts and masks instead of the generic codec.
+    '''
+    MAX_SLOTS = 128     # Upper limit on the number of primitives, in order to keep the generated code compact
+
+    def __init__(self, fields):
+        self.slots = []     # (C++ expression or None for void, primitive type, bit offset)
+        self.num_fields = 0
+        self.bitlen = 0
+        self.view_fields = []   # (field name, primitive type, bit offset) for the primitive non-void fields
+        for f in fields:
+            slots = self._flatten(f.type, None if f.void else 'self.' + f.name, self.MAX_SLOTS - len(self.slots))
+            if slots is None:
+                break
+            if not f.void and f.type.category == f.type.CATEGORY_PRIMITIVE:
+                self.view_fields.append((f.name, f.type, self.bitlen))
+            for expr, typ in slots:
+                self.slots.append((expr, typ, self.bitlen))
+                self.bitlen += typ.bitlen
+            self.num_fields += 1
+        if not self.bitlen:
+            self.num_fields = 0
+            self.view_fields = []
+
+    @staticmethod
+    def _flatten(t, expr, budget):
+        if t.category in (t.CATEGORY_PRIMITIVE, t.CATEGORY_VOID):
+            return [(expr, t)] if budget > 0 else None
+        if t.category == t.CATEGORY_ARRAY:
+            if t.mode != t.MODE_STATIC:
+                return None
+            out = []
+            for i in range(t.max_size):
+                sub = FixedLayoutPrefix._flatten(t.value_type, '%s[%d]' % (expr, i), budget - len(out))
+                if sub is None:
+                    return None
+                out += sub
+            return out
+        if t.category == t.CATEGORY_COMPOUND:
+            if t.kind != t.KIND_MESSAGE or t.union:
+                return None
+            out = []
+            for f in t.fields:
+                is_void = f.type.category == f.type.CATEGORY_VOID
+                sub = FixedLayoutPrefix._flatten(f.type, None if is_void else '%s.%s' % (expr, f.name),
+                                                 budget - len(out))
+                if sub is None:
+                    return None
+                out += sub
+            return out
+        return None
+
+    def decode_step_bitlens(self, fields):
+        # Max bit length of every step of the resumable decoding: the prefix, then the remaining fields one by one
+        return ([self.bitlen] if self else []) + [f.type.get_max_bitlen() for f in fields[self.num_fields:]]
+
+    def __bool__(self):
+        return self.num_fields > 0
+
+    __nonzero__ = __bool__  # Python 2.7 compatibility
+
+    @staticmethod
+    def _chunks(bitlen, offset):
+        # Wire representation: little endian bytes, MSB first; the trailing partial byte holds the least significant
+        # bits of the last byte. Yields (value shift, number of bits, buffer byte index, bit position within byte).
+        for shift in range(0, bitlen, 8):
+            n = min(8, bitlen - shift)
+            yield shift, n, (offset + shift) // 8, (offset + shift) % 8
+
+    def generate_pack(self):
+        lines = []
+        for expr, typ, offset in self.slots:
+            if expr is None:
+                continue            # Void fields are zero, the buffer is zeroed in advance
+            if typ.bitlen == 1:
+                lines.append('if (%s)' % expr)
+                lines.append('{')
+                lines.append('    buf[%d] = ::uavcan::uint8_t(buf[%d] | 0x%02XU);' %
+                             (offset // 8, offset // 8, 0x80 >> (offset % 8)))
+                lines.append('}')
+                continue
+            lines.append('{')
+            lines.append('    typedef %s S;' % type_to_cpp_type(typ))
+            lines.append('    const S::WireType w = S::toWire(%s);' % expr)
+            for shift, n, index, pos in self._chunks(typ.bitlen, offset):
+                chunk = 'w >> %d' % shift if shift else 'w'
+                if n < 8:
+                    chunk = '%s & 0x%02XU' % ('(%s)' % chunk if shift else chunk, (1 << n) - 1)
+                chunk = '::uavcan::uint8_t(%s)' % chunk
+                if pos + n <= 8:
+                    lsh = 8 - pos - n
+                    lines.append('    buf[%d] = ::uavcan::uint8_t(buf[%d] | %s);' %
+                                 (index, index, '(%s << %d)' % (chunk, lsh) if lsh else chunk))
+                else:
+                    lines.append('    buf[%d] = ::uavcan::uint8_t(buf[%d] | (%s >> %d));' %
+                                 (index, index, chunk, pos + n - 8))
+                    lines.append('    buf[%d] = ::uavcan::uint8_t(buf[%d] | (%s << %d));' %
+                                 (index + 1, index + 1, chunk, 16 - pos - n))
+            lines.append('}')
+        return '\n'.join(lines)
+
+    def generate_unpack(self):
+        lines = []
+        for expr, typ, offset in self.slots:
+            if expr is not None:
+                lines += self._generate_unpack_slot(expr, typ, offset)
+        return '\n'.join(lines)
+
+    def generate_view_accessor(self, name, typ, offset):
+        # Reads only the bytes that contain the field, then unpacks it as in the fixed prefix
+        first_byte = offset // 8
+        num_bytes = (offset + typ.bitlen + 7) // 8 - first_byte
+        lines = ['::uavcan::uint8_t buf[%d] = { 0U };' % num_bytes,
+                 '(void)payload_.read(%dU, buf, %dU);' % (first_byte, num_bytes),
+                 'typename ::uavcan::StorageType< typename FieldTypes::%s >::Type value;' % name]
+        lines += self._generate_unpack_slot('value', typ, offset - first_byte * 8)
+        lines.append('return value;')
+        return '\n'.join(lines)
+
+    def _generate_unpack_slot(self, expr, typ, offset):
+        lines = []
+        if typ.bitlen == 1:
+            lines.append('%s = (buf[%d] & 0x%02XU) != 0;' % (expr, offset // 8, 0x80 >> (offset % 8)))
+            return lines
+        lines.append('{')
+        lines.append('    typedef %s S;' % type_to_cpp_type(typ))
+        terms = []
+        for shift, n, index, pos in self._chunks(typ.bitlen, offset):
+            if pos + n <= 8:
+                rsh = 8 - pos - n
+                chunk = 'buf[%d] >> %d' % (index, rsh) if rsh else 'buf[%d]' % index
+            else:
+                chunk = '(buf[%d] << %d) | (buf[%d] >> %d)' % (index, pos + n - 8, index + 1, 16 - pos - n)
+            if n < 8 or pos + n > 8:
+                chunk = '%s & 0x%02XU' % ('(%s)' % chunk if chunk != 'buf[%d]' % index else chunk, (1 << n) - 1)
+            chunk = 'S::WireType(%s)' % chunk
+            terms.append('S::WireType(%s << %d)' % (chunk, shift) if shift else chunk)
+        if len(terms) > 1:
+            prefix = '    const S::WireType w = S::WireType('
+            lines.append(prefix + (' |\n' + ' ' * len(prefix)).join(terms) + ');')
+        else:
+            lines.append('    const S::WireType w = %s;' % terms[0])
+        lines.append('    %s = S::fromWire(w);' % expr)
+        lines.append('}')
+        return lines
+
 def generate_one_type(template_expander, t):
     t.short_name = t.full_name.split('.')[-1]
     t.cpp_type_name = t.short_name + '_'
@@ -197,6 +391,10 @@ def generate_one_type(template_expander, t):
                 assert not a.name
                 a.name = '_void_%d' % void_index
                 void_index += 1
+            # Float fields are compared through a helper that keeps -Wfloat-equal quiet; the result is the same as ==
+            is_float = a.type.category == a.type.CATEGORY_PRIMITIVE and a.type.kind == a.type.KIND_FLOAT
+            a.cpp_equality = ('::uavcan::areFloatsExactlyEqual(%s, rhs.%s)' if is_float else '%s == rhs.%s') % \
+                (a.name, a.name)
 
     if t.kind == t.KIND_MESSAGE:
         inject_cpp_types(t.fields)
@@ -212,6 +410,30 @@ def generate_one_type(template_expander, t):
         t.request_union = t.request_union and len(t.request_fields)
         t.response_union = t.response_union and len(t.response_fields)
 
+    # Fixed layout serializers
+    if t.kind == t.KIND_MESSAGE:
+        t.fixed_prefix = FixedLayoutPrefix([] if t.union else t.fields)
+    else:
+        t.request_fixed_prefix = FixedLayoutPrefix([] if t.request_union else t.request_fields)
+        t.response_fixed_prefix = FixedLayoutPrefix([] if t.response_union else t.response_fields)
+
+    # Field masks for selective decoding: one bit per non-void field, fields beyond 32 are always decoded
+    def inject_field_mask_bits(fields, fixed_prefix):
+        for idx, a in enumerate([x for x in fields if not x.void]):
+            a.mask_bit = idx if idx < 32 else None
+        prefix_fields = [x for x in fields[:fixed_prefix.num_fields] if not x.void]
+        if any(x.mask_bit is None for x in prefix_fields):
+            fixed_prefix.field_mask = 0xFFFFFFFF
+        else:
+            fixed_prefix.field_mask = sum(1 << x.mask_bit for x in prefix_fields)
+        fixed_prefix.all_fields_masked = all(x.mask_bit is not None for x in fields if not x.void)
+
+    if t.kind == t.KIND_MESSAGE:
+        inject_field_mask_bits(t.fields, t.fixed_prefix)
+    else:
+        inject_field_mask_bits(t.request_fields, t.request_fixed_prefix)
+        inject_field_mask_bits(t.response_fields, t.response_fixed_prefix)
+
     # Constant properties
     def inject_constant_info(constants):
         for c in constants:
@@ -16,6 +16,7 @@
  * This definition contains the integer year number after which the standard was named:
  *  - 2003 for C++03
  *  - 2011 for C++11
+ *  - 2014, 2017, 2020 for the newer standards, which the library treats the same way as C++11
  *
  * This config automatically sets according to the actual C++ standard used by the compiler.
  *
@@ -25,12 +26,19 @@
  * standard than used by the compiler, in which case this symbol can be overridden manually via
  * compiler flags.
  */
+#define UAVCAN_CPP20    2020
+#define UAVCAN_CPP17    2017
+#define UAVCAN_CPP14    2014
 #define UAVCAN_CPP11    2011
 #define UAVCAN_CPP03    2003
 
 #ifndef UAVCAN_CPP_VERSION
-# if __cplusplus > 201200
-#  error Unsupported C++ standard. You can explicitly set UAVCAN_CPP_VERSION=UAVCAN_CPP11 to silence this error.
+# if __cplusplus > 201703L
+#  define UAVCAN_CPP_VERSION    UAVCAN_CPP20
+# elif __cplusplus > 201402L
+#  define UAVCAN_CPP_VERSION    UAVCAN_CPP17
+# elif __cplusplus > 201103L
+#  define UAVCAN_CPP_VERSION    UAVCAN_CPP14
 # elif (__cplusplus > 201100) || defined(__GXX_EXPERIMENTAL_CXX0X__)
 #  define UAVCAN_CPP_VERSION    UAVCAN_CPP11
 # else
@@ -50,6 +58,18 @@
 # endif
 #endif
 
+/**
+ * Allows the objects that are constructed from constant expressions, e.g. the data type tables generated by the
+ * DSDL compiler, to be initialized at compile time and placed into ROM, if the C++ standard permits.
+ */
+#ifndef UAVCAN_CONSTEXPR
+# if UAVCAN_CPP_VERSION >= UAVCAN_CPP11
+#  define UAVCAN_CONSTEXPR constexpr
+# else
+#  define UAVCAN_CONSTEXPR
+# endif
+#endif
+
 /**
  * By default, libuavcan enables all features if it detects that it is being built for a general-purpose
  * target like Linux. Value of this macro influences other configuration options located below in this file.
@@ -116,6 +136,42 @@
 # define UAVCAN_TINY 0
 #endif
 
+/**
+ * Selects the implementation of the bit array copy routine that sits in the inner loop of the serialization code.
+ * By default, unaligned bit arrays are copied one machine word at a time, which is several times faster but
+ * costs some extra ROM. Set to zero to use the compact byte-wise implementation instead.
+ */
+#ifndef UAVCAN_WORDWISE_BITARRAY_COPY
+# if UAVCAN_TINY
+#  define UAVCAN_WORDWISE_BITARRAY_COPY 0
+# else
+#  define UAVCAN_WORDWISE_BITARRAY_COPY 1
+# endif
+#endif
+
+/**
+ * Publishers of data types whose maximum serialized size exceeds this many bytes serialize the messages directly
+ * into the outgoing CAN frames, instead of using a stack buffer sized for the largest possible message.
+ * This trades a second serialization pass (the transfer CRC has to be known before the first frame is sent)
+ * for a much smaller stack footprint. Set to a large value to always use the buffered approach.
+ */
+#ifndef UAVCAN_STREAMING_PUBLISHER_THRESHOLD
+# define UAVCAN_STREAMING_PUBLISHER_THRESHOLD 64
+#endif
+
+/**
+ * Enables the coroutine awaitables defined in <uavcan/node/coroutine.hpp>.
+ * By default, they are enabled if the compiler supports C++20 coroutines. Note that the library itself doesn't
+ * need to be rebuilt, since the awaitables are header-only; only the application has to be built as C++20.
+ */
+#ifndef UAVCAN_COROUTINES
+# if defined(__cpp_impl_coroutine)
+#  define UAVCAN_COROUTINES 1
+# else
+#  define UAVCAN_COROUTINES 0
+# endif
+#endif
+
 /**
  * Disable the global data type registry, which can save some space on embedded systems.
  */
@@ -123,6 +179,51 @@
 # define UAVCAN_NO_GLOBAL_DATA_TYPE_REGISTRY 0
 #endif
 
+/**
+ * Set to zero to disable the static registration of the autogenerated data types with their default Data Type ID.
+ * This is useful if the application registers all data types at once using the table generated by the DSDL
+ * compiler, see @ref GlobalDataTypeRegistry::adoptTable().
+ */
+#ifndef UAVCAN_DEFAULT_DATA_TYPE_REGISTRATION
+# define UAVCAN_DEFAULT_DATA_TYPE_REGISTRATION 1
+#endif
+
+/**
+ * Number of buckets in the lookup index that the global data type registry builds once it is frozen; must be a
+ * power of two. Every registered data type is found in constant time on average rather than by a linear search.
+ * Set to zero to disable the index; this saves a few hundred bytes of RAM.
+ */
+#ifndef UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE
+# if UAVCAN_TINY
+#  define UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE 0
+# else
+#  define UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE 64
+# endif
+#endif
+
+/**
+ * Number of buckets the pending calls of every service client are hashed into by (server node ID, transfer ID).
+ * It should not be less than the number of calls a client is expected to keep pending at once; beyond that the
+ * average lookup cost grows as the ratio of pending calls to buckets. Every bucket takes one pointer in every
+ * service client, so nodes that have many service clients with few pending calls may want to reduce it.
+ */
+#ifndef UAVCAN_SERVICE_CLIENT_CALL_BUCKETS
+# if UAVCAN_TINY
+#  define UAVCAN_SERVICE_CLIENT_CALL_BUCKETS 8
+# else
+#  define UAVCAN_SERVICE_CLIENT_CALL_BUCKETS 128
+# endif
+#endif
+
+/**
+ * Number of data types the RX overload protection of the dispatcher keeps separate drop counters for; must be a
+ * power of two. The counters are allocated statically, so that dropping frames never takes memory from the pool.
+ * Drops of the data types that don't fit are accounted in the total counter only.
+ */
+#ifndef UAVCAN_RX_DROP_COUNTER_TABLE_SIZE
+# define UAVCAN_RX_DROP_COUNTER_TABLE_SIZE 8
+#endif
+
 /**
  * toString() methods will be disabled by default, unless the library is built for a general-purpose target like Linux.
  * It is not recommended to enable toString() on embedded targets as code size will explode.
@@ -167,6 +268,38 @@
 # define UAVCAN_USE_EXTERNAL_FLOAT16_CONVERSION 0
 #endif
 
+/**
+ * Number of bytes processed per step by the table-driven transfer CRC implementation: 1, 4 or 8 (slicing-by-N);
+ * other values fail to compile.
+ * Every additional byte of the step costs 512 bytes of ROM for the lookup tables.
+ * Ignored in UAVCAN_TINY mode, where the CRC is computed bit by bit without tables.
+ */
+#ifndef UAVCAN_CRC_SLICING_FACTOR
+# define UAVCAN_CRC_SLICING_FACTOR 4
+#endif
+
+/**
+ * Long buffers will be processed by the transfer CRC using the carry-less multiplication instruction if the target
+ * supports it (x86 with PCLMULQDQ and SSSE3 enabled at compile time, e.g. -mpclmul -mssse3).
+ * Ignored in UAVCAN_TINY mode.
+ */
+#ifndef UAVCAN_CRC_PCLMUL
+# define UAVCAN_CRC_PCLMUL 1
+#endif
+
+/**
+ * Batch float16 conversion (used for float16 arrays) will use SSE2 or AArch64 NEON kernels if the target supports
+ * them. The kernels produce exactly the same results as the scalar conversion. Ignored if the external float16
+ * conversion is used.
+ */
+#ifndef UAVCAN_FLOAT16_SIMD
+# if UAVCAN_TINY
+#  define UAVCAN_FLOAT16_SIMD 0
+# else
+#  define UAVCAN_FLOAT16_SIMD 1
+# endif
+#endif
+
 /**
  * Run time checks.
  * Resolves to the standard assert() by default.
@@ -55,7 +55,7 @@ public:
 
     DataTypeID() : value_(0xFFFFFFFFUL) { }
 
-    DataTypeID(uint16_t id)  // Implicit
+    UAVCAN_CONSTEXPR DataTypeID(uint16_t id)  // Implicit
         : value_(id)
     { }
 
@@ -112,7 +112,7 @@ class UAVCAN_EXPORT DataTypeSignature
 
 public:
     DataTypeSignature() : value_(0) { }
-    explicit DataTypeSignature(uint64_t value) : value_(value) { }
+    UAVCAN_CONSTEXPR explicit DataTypeSignature(uint64_t value) : value_(value) { }
 
     void extend(DataTypeSignature dts);
 
@@ -153,6 +153,17 @@ public:
         UAVCAN_ASSERT(std::strlen(name) <= MaxFullNameLen);
     }
 
+    /**
+     * Constant expression constructor for the data type tables generated by the DSDL compiler.
+     * The arguments are not checked here; the registry validates the table when it adopts it.
+     */
+    UAVCAN_CONSTEXPR DataTypeDescriptor(DataTypeKind kind, uint16_t id, uint64_t signature, const char* name) :
+        signature_(signature),
+        full_name_(name),
+        kind_(kind),
+        id_(id)
+    { }
+
     bool isValid() const;
 
     DataTypeKind getKind() const { return kind_; }
@@ -252,6 +252,15 @@ protected:
         }
     }
 
+    /**
+     * Changes the size without touching the elements; the bulk decoder writes the storage directly.
+     */
+    void resizeUninitialized(SizeType new_size)
+    {
+        UAVCAN_ASSERT(new_size <= MaxSize);
+        size_ = new_size;
+    }
+
 public:
     enum { SizeBitLen = RawEncodedSizeType::BitLen };
 
@@ -403,6 +412,55 @@ public:
      */
     Reference operator[](SizeType pos)  { return at(pos); }
     bool operator[](SizeType pos) const { return at(pos); }
+
+protected:
+    /**
+     * Bits are transferred in chunks rather than one by one.
+     * One byte of BitStream::MaxBitsPerRW is reserved for the bit offset of an unaligned stream.
+     */
+    enum { BitsPerChunk = BitStream::MaxBitsPerRW - 8 };
+
+    int encodeBits(ScalarCodec& codec) const
+    {
+        uint8_t chunk[BitsPerChunk / 8];
+        for (unsigned offset = 0; offset < size(); offset += BitsPerChunk)
+        {
+            const unsigned chunk_bits = min(unsigned(size()) - offset, unsigned(BitsPerChunk));
+            ::uavcan::fill(chunk, chunk + sizeof(chunk), uint8_t(0));
+            for (unsigned i = 0; i < chunk_bits; i++)
+            {
+                if (BitSet<MaxSize>::test(offset + i))
+                {
+                    chunk[i / 8] = uint8_t(chunk[i / 8] | (0x80U >> (i % 8)));
+                }
+            }
+            const int res = codec.encodeBitArray(chunk, chunk_bits);
+            if (res <= 0)
+            {
+                return res;
+            }
+        }
+        return 1;
+    }
+
+    int decodeBits(ScalarCodec& codec)
+    {
+        uint8_t chunk[BitsPerChunk / 8];
+        for (unsigned offset = 0; offset < size(); offset += BitsPerChunk)
+        {
+            const unsigned chunk_bits = min(unsigned(size()) - offset, unsigned(BitsPerChunk));
+            const int res = codec.decodeBitArray(chunk, chunk_bits);
+            if (res <= 0)
+            {
+                return res;
+            }
+            for (unsigned i = 0; i < chunk_bits; i++)
+            {
+                BitSet<MaxSize>::set(offset + i, (chunk[i / 8] & (0x80U >> (i % 8))) != 0);
+            }
+        }
+        return 1;
+    }
 };
 
 /**
@@ -431,9 +489,17 @@ class UAVCAN_EXPORT Array : public ArrayImpl<T, ArrayMode, MaxSize_>
         return (T::MinBitLen >= 8) && (tao_mode == TailArrayOptEnabled);
     }
 
+    typedef IntToType<ArrayCodecSelector<T>::Result> ElementCodec;
+
     int encodeImpl(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode, FalseType) const  /// Static
     {
         UAVCAN_ASSERT(size() > 0);
+        return encodeElements(codec, tao_mode, ElementCodec());
+    }
+
+    int encodeElements(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode,
+                       IntToType<ArrayCodecPerElement>) const
+    {
         for (SizeType i = 0; i < size(); i++)
         {
             const bool last_item = i == (size() - 1);
@@ -446,6 +512,20 @@ class UAVCAN_EXPORT Array : public ArrayImpl<T, ArrayMode, MaxSize_>
         return 1;
     }
 
+    int encodeElements(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode, IntToType<ArrayCodecBytes>) const
+    {
+        if (!codec.isByteAligned())
+        {
+            return encodeElements(codec, tao_mode, IntToType<ArrayCodecPerElement>());
+        }
+        return codec.encodeArray<RawValueType::BitLen, RawValueType>(Base::begin(), size());
+    }
+
+    int encodeElements(ScalarCodec& codec, const TailArrayOptimizationMode, IntToType<ArrayCodecBits>) const
+    {
+        return Base::encodeBits(codec);
+    }
+
     int encodeImpl(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode, TrueType) const   /// Dynamic
     {
         StaticAssert<IsDynamic>::check();
@@ -470,6 +550,11 @@ class UAVCAN_EXPORT Array : public ArrayImpl<T, ArrayMode, MaxSize_>
     int decodeImpl(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode, FalseType)  /// Static
     {
         UAVCAN_ASSERT(size() > 0);
+        return decodeElements(codec, tao_mode, ElementCodec());
+    }
+
+    int decodeElements(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode, IntToType<ArrayCodecPerElement>)
+    {
         for (SizeType i = 0; i < size(); i++)
         {
             const bool last_item = i == (size() - 1);
@@ -484,6 +569,56 @@ class UAVCAN_EXPORT Array : public ArrayImpl<T, ArrayMode, MaxSize_>
         return 1;
     }
 
+    int decodeElements(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode, IntToType<ArrayCodecBytes>)
+    {
+        if (!codec.isByteAligned())
+        {
+            return decodeElements(codec, tao_mode, IntToType<ArrayCodecPerElement>());
+        }
+        return codec.decodeArray<RawValueType::BitLen, RawValueType>(Base::begin(), size());
+    }
+
+    int decodeElements(ScalarCodec& codec, const TailArrayOptimizationMode, IntToType<ArrayCodecBits>)
+    {
+        return Base::decodeBits(codec);
+    }
+
+    template <int Codec>
+    int decodeTail(ScalarCodec& codec, IntToType<Codec>)
+    {
+        while (true)
+        {
+            ValueType value = ValueType();
+            const int res = RawValueType::decode(value, codec, TailArrayOptDisabled);
+            if (res < 0)
+            {
+                return res;
+            }
+            if (res == 0)             // Success: End of stream reached (even if zero items were read)
+            {
+                return 1;
+            }
+            if (size() == MaxSize_)   // Error: Max array length reached, but the end of stream is not
+            {
+                return -ErrInvalidMarshalData;
+            }
+            push_back(value);
+        }
+    }
+
+    int decodeTail(ScalarCodec& codec, IntToType<ArrayCodecBytes>)
+    {
+        if (!codec.isByteAligned())
+        {
+            return decodeTail(codec, IntToType<ArrayCodecPerElement>());
+        }
+        unsigned count = 0;
+        const int res =
+            codec.decodeArrayUntilEnd<RawValueType::BitLen, RawValueType>(Base::begin(), MaxSize_, count);
+        Base::resizeUninitialized(SizeType(count));
+        return res;
+    }
+
 #if __GNUC__
 # pragma GCC diagnostic push
 # pragma GCC diagnostic ignored "-Wtype-limits"
@@ -494,24 +629,7 @@ class UAVCAN_EXPORT Array : public ArrayImpl<T, ArrayMode, MaxSize_>
         Base::clear();
         if (isOptimizedTailArray(tao_mode))
         {
-            while (true)
-            {
-                ValueType value = ValueType();
-                const int res = RawValueType::decode(value, codec, TailArrayOptDisabled);
-                if (res < 0)
-                {
-                    return res;
-                }
-                if (res == 0)             // Success: End of stream reached (even if zero items were read)
-                {
-                    return 1;
-                }
-                if (size() == MaxSize_)   // Error: Max array length reached, but the end of stream is not
-                {
-                    return -ErrInvalidMarshalData;
-                }
-                push_back(value);
-            }
+            return decodeTail(codec, ElementCodec());
         }
         else
         {
@@ -536,6 +654,58 @@ class UAVCAN_EXPORT Array : public ArrayImpl<T, ArrayMode, MaxSize_>
         UAVCAN_ASSERT(0); // Unreachable
         return -ErrLogic;
     }
+
+    /**
+     * Elements of constant length are skipped in one go, others one by one.
+     */
+    typedef BooleanType<(unsigned(T::MinBitLen) == unsigned(T::MaxBitLen))> ElementLengthIsConstant;
+
+    static int skipElements(ScalarCodec& codec, unsigned count, const TailArrayOptimizationMode, TrueType)
+    {
+        return codec.skipBits(count * unsigned(T::MaxBitLen));
+    }
+
+    static int skipElements(ScalarCodec& codec, unsigned count, const TailArrayOptimizationMode tao_mode, FalseType)
+    {
+        for (unsigned i = 0; i < count; i++)
+        {
+            const int res = RawValueType::skip(codec, (i == (count - 1)) ? tao_mode : TailArrayOptDisabled);
+            if (res <= 0)
+            {
+                return res;
+            }
+        }
+        return 1;
+    }
+
+    static int skipImpl(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode, FalseType)  /// Static
+    {
+        return skipElements(codec, MaxSize_, tao_mode, ElementLengthIsConstant());
+    }
+
+    static int skipImpl(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode, TrueType)   /// Dynamic
+    {
+        if (isOptimizedTailArray(tao_mode))
+        {
+            return 1;       // The rest of the stream belongs to this array
+        }
+        typename StorageType<typename Base::RawEncodedSizeType>::Type sz = 0;
+        const int res_sz = Base::RawEncodedSizeType::decode(sz, codec, TailArrayOptDisabled);
+        if (res_sz <= 0)
+        {
+            return res_sz;
+        }
+        // coverity[result_independent_of_operands]
+        if (static_cast<unsigned>(sz) > MaxSize_)   // False 'type-limits' warning occurs here
+        {
+            return -ErrInvalidMarshalData;
+        }
+        if (sz == 0)
+        {
+            return 1;
+        }
+        return skipElements(codec, static_cast<unsigned>(sz), tao_mode, ElementLengthIsConstant());
+    }
 #if __GNUC__
 # pragma GCC diagnostic pop
 #endif
@@ -704,6 +874,15 @@ public:
         return array.decodeImpl(codec, tao_mode, BooleanType<IsDynamic>());
     }
 
+    /**
+     * Advances the codec past an encoded array without decoding the elements.
+     * The length of a dynamic array is validated, the elements are not.
+     */
+    static int skip(ScalarCodec& codec, const TailArrayOptimizationMode tao_mode)
+    {
+        return skipImpl(codec, tao_mode, BooleanType<IsDynamic>());
+    }
+
     static void extendDataTypeSignature(DataTypeSignature& signature)
     {
         RawValueType::extendDataTypeSignature(signature);
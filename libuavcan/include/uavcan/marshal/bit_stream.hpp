@@ -83,6 +83,34 @@ public:
     int write(const uint8_t* bytes, const unsigned bitlen);
     int read(uint8_t* bytes, const unsigned bitlen);
 
+    /**
+     * Whether the current position is at a byte boundary.
+     */
+    bool isByteAligned() const { return (bit_offset_ % 8) == 0; }
+
+    /**
+     * Number of bits read or written so far.
+     */
+    unsigned getBitOffset() const { return bit_offset_; }
+
+    /**
+     * Fast path for byte aligned streams (see @ref isByteAligned()); the data is transferred directly from/to
+     * the underlying buffer, and there is no limit on the length.
+     * writeAlignedBytes() returns the same values as write().
+     * readAlignedBytes() returns the number of bytes actually read, which will be less than requested if the end
+     * of the buffer has been reached; negative values indicate errors. Only whole units of the specified size
+     * are consumed, so that a trailing incomplete element of an array is left in the stream.
+     */
+    int writeAlignedBytes(const uint8_t* bytes, const unsigned bytelen);
+    int readAlignedBytes(uint8_t* bytes, const unsigned bytelen, const unsigned unit = 1);
+
+    /**
+     * Advances the read position by the specified number of bits without reading them.
+     * There is no limit on the length. Return values are the same as for read(); the skipped bits must be present
+     * in the buffer, but only the last of them is actually accessed.
+     */
+    int skip(const unsigned bitlen);
+
 #if UAVCAN_TOSTRING
     std::string toString() const;
 #endif
@@ -56,6 +56,14 @@ class UAVCAN_EXPORT IEEE754Converter
     }
 
 public:
+    /**
+     * Batch conversion between native single precision floats and IEEE754 half precision.
+     * The results are bit-for-bit identical to those of the element-by-element conversion, including rounding,
+     * overflow and NaN handling; SIMD kernels are used where available (see UAVCAN_FLOAT16_SIMD).
+     */
+    static void nativeIeeeToHalfArray(const float* src, uint16_t* dst, unsigned count);
+    static void halfToNativeIeeeArray(const uint16_t* src, float* dst, unsigned count);
+
 #if UAVCAN_CPP_VERSION >= UAVCAN_CPP11
     /// UAVCAN requires rounding to nearest for all float conversions
     static std::float_round_style roundstyle() { return std::round_to_nearest; }
@@ -138,6 +146,7 @@ public:
     enum { IsPrimitive = 1 };
 
     typedef typename NativeFloatSelector<BitLen>::Type StorageType;
+    typedef typename IntegerSpec<BitLen, SignednessUnsigned, CastModeTruncate>::StorageType WireType;
 
 #if UAVCAN_CPP_VERSION < UAVCAN_CPP11
     enum { IsExactRepresentation = (sizeof(StorageType) * 8 == BitLen) };
@@ -153,33 +162,106 @@ public:
 
     static int encode(StorageType value, ScalarCodec& codec, TailArrayOptimizationMode)
     {
-        // cppcheck-suppress duplicateExpression
-        if (CastMode == CastModeSaturate)
-        {
-            saturate(value);
-        }
-        else
-        {
-            truncate(value);
-        }
-        return codec.encode<BitLen>(IEEE754Converter::toIeee<BitLen>(value));
+        return codec.encode<BitLen>(toWire(value));
     }
 
     static int decode(StorageType& out_value, ScalarCodec& codec, TailArrayOptimizationMode)
     {
-        typename IntegerSpec<BitLen, SignednessUnsigned, CastModeTruncate>::StorageType ieee = 0;
+        WireType ieee = 0;
         const int res = codec.decode<BitLen>(ieee);
         if (res <= 0)
         {
             return res;
         }
-        out_value = IEEE754Converter::toNative<BitLen>(ieee);
+        out_value = fromWire(ieee);
         return res;
     }
 
+    static int skip(ScalarCodec& codec, TailArrayOptimizationMode)
+    {
+        return codec.skipBits(BitLen);
+    }
+
+    /**
+     * Conversion to/from the IEEE754 wire representation; used by the bulk array codec.
+     */
+    static WireType toWire(StorageType value)
+    {
+        applyCastMode(value);
+        return IEEE754Converter::toIeee<BitLen>(value);
+    }
+
+    static StorageType fromWire(WireType value) { return IEEE754Converter::toNative<BitLen>(value); }
+
+    static void toWireArray(const StorageType* values, WireType* out, unsigned count)
+    {
+        toWireArrayImpl(values, out, count, IntToType<BitLen>());
+    }
+
+    static void fromWireArray(const WireType* values, StorageType* out, unsigned count)
+    {
+        fromWireArrayImpl(values, out, count, IntToType<BitLen>());
+    }
+
     static void extendDataTypeSignature(DataTypeSignature&) { }
 
 private:
+    template <int N>
+    static void toWireArrayImpl(const StorageType* values, WireType* out, unsigned count, IntToType<N>)
+    {
+        for (unsigned i = 0; i < count; i++)
+        {
+            out[i] = toWire(values[i]);
+        }
+    }
+
+    static void toWireArrayImpl(const StorageType* values, WireType* out, unsigned count, IntToType<16>)
+    {
+        // The cast mode is applied to a small local copy, then the whole block is converted at once
+        enum { BlockSize = 16 };
+        StorageType block[BlockSize];
+        while (count > 0)
+        {
+            const unsigned block_count = min(count, unsigned(BlockSize));
+            for (unsigned i = 0; i < block_count; i++)
+            {
+                block[i] = values[i];
+                applyCastMode(block[i]);
+            }
+            IEEE754Converter::nativeIeeeToHalfArray(block, out, block_count);
+            values += block_count;
+            out += block_count;
+            count -= block_count;
+        }
+    }
+
+    template <int N>
+    static void fromWireArrayImpl(const WireType* values, StorageType* out, unsigned count, IntToType<N>)
+    {
+        for (unsigned i = 0; i < count; i++)
+        {
+            out[i] = fromWire(values[i]);
+        }
+    }
+
+    static void fromWireArrayImpl(const WireType* values, StorageType* out, unsigned count, IntToType<16>)
+    {
+        IEEE754Converter::halfToNativeIeeeArray(values, out, count);
+    }
+
+    static inline void applyCastMode(StorageType& value)
+    {
+        // cppcheck-suppress duplicateExpression
+        if (CastMode == CastModeSaturate)
+        {
+            saturate(value);
+        }
+        else
+        {
+            truncate(value);
+        }
+    }
+
     static inline void saturate(StorageType& value)
     {
         if ((IsExactRepresentation == 0) && isFinite(value))
@@ -220,6 +302,13 @@ private:
 };
 
 
+template <unsigned BitLen, CastMode CastMode>
+struct ArrayCodecSelector<FloatSpec<BitLen, CastMode> >
+{
+    enum { Result = ((BitLen % 8) == 0) ? ArrayCodecBytes : ArrayCodecPerElement };
+};
+
+
 template <unsigned BitLen, CastMode CastMode>
 class UAVCAN_EXPORT YamlStreamer<FloatSpec<BitLen, CastMode> >
 {
@@ -39,6 +39,7 @@ public:
                               ErrorNoSuchInteger>::Result>::Result>::Result>::Result StorageType;
 
     typedef typename IntegerSpec<BitLen, SignednessUnsigned, CastMode>::StorageType UnsignedStorageType;
+    typedef UnsignedStorageType WireType;
 
 private:
     IntegerSpec();
@@ -93,6 +94,19 @@ private:
 
     static void truncate(StorageType& value) { value = value & StorageType(mask()); }
 
+    static void applyCastMode(StorageType& value)
+    {
+        // cppcheck-suppress duplicateExpression
+        if (CastMode == CastModeSaturate)
+        {
+            saturate(value);
+        }
+        else
+        {
+            truncate(value);
+        }
+    }
+
     static void validate()
     {
         StaticAssert<(BitLen <= (sizeof(StorageType) * 8))>::check();
@@ -110,15 +124,7 @@ public:
     static int encode(StorageType value, ScalarCodec& codec, TailArrayOptimizationMode)
     {
         validate();
-        // cppcheck-suppress duplicateExpression
-        if (CastMode == CastModeSaturate)
-        {
-            saturate(value);
-        }
-        else
-        {
-            truncate(value);
-        }
+        applyCastMode(value);
         return codec.encode<BitLen>(value);
     }
 
@@ -128,6 +134,46 @@ public:
         return codec.decode<BitLen>(out_value);
     }
 
+    static int skip(ScalarCodec& codec, TailArrayOptimizationMode)
+    {
+        return codec.skipBits(BitLen);
+    }
+
+    /**
+     * Conversion to/from the unsigned wire representation; used by the bulk array codec.
+     * The bits above BitLen are not defined on encoding and ignored on decoding.
+     */
+    static WireType toWire(StorageType value)
+    {
+        applyCastMode(value);
+        return WireType(value);
+    }
+
+    static StorageType fromWire(WireType value)
+    {
+        if (IsSigned && (value & WireType(WireType(1) << (BitLen - 1U))))  // Sign extension
+        {
+            value = WireType(value | WireType(~mask()));
+        }
+        return StorageType(value);
+    }
+
+    static void toWireArray(const StorageType* values, WireType* out, unsigned count)
+    {
+        for (unsigned i = 0; i < count; i++)
+        {
+            out[i] = toWire(values[i]);
+        }
+    }
+
+    static void fromWireArray(const WireType* values, StorageType* out, unsigned count)
+    {
+        for (unsigned i = 0; i < count; i++)
+        {
+            out[i] = fromWire(values[i]);
+        }
+    }
+
     static void extendDataTypeSignature(DataTypeSignature&) { }
 };
 
@@ -165,6 +211,11 @@ public:
         return codec.decode<BitLen>(out_value);
     }
 
+    static int skip(ScalarCodec& codec, TailArrayOptimizationMode)
+    {
+        return codec.skipBits(BitLen);
+    }
+
     static void extendDataTypeSignature(DataTypeSignature&) { }
 };
 
@@ -188,6 +239,16 @@ struct IsIntegerSpec<IntegerSpec<BitLen, Signedness, CastMode> >
 };
 
 
+template <unsigned BitLen, Signedness Signedness, CastMode CastMode>
+struct ArrayCodecSelector<IntegerSpec<BitLen, Signedness, CastMode> >
+{
+    enum
+    {
+        Result = (BitLen == 1) ? ArrayCodecBits : (((BitLen % 8) == 0) ? ArrayCodecBytes : ArrayCodecPerElement)
+    };
+};
+
+
 template <unsigned BitLen, Signedness Signedness, CastMode CastMode>
 class UAVCAN_EXPORT YamlStreamer<IntegerSpec<BitLen, Signedness, CastMode> >
 {
@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <uavcan/std.hpp>
+#include <uavcan/error.hpp>
 #include <uavcan/build_config.hpp>
 #include <uavcan/util/templates.hpp>
 #include <uavcan/marshal/bit_stream.hpp>
@@ -86,6 +87,30 @@ class UAVCAN_EXPORT ScalarCodec
     int encodeBytesImpl(uint8_t* bytes, unsigned bitlen);
     int decodeBytesImpl(uint8_t* bytes, unsigned bitlen);
 
+    /// Stack buffer used by the bulk array methods
+    static const unsigned ArrayChunkSize = 64;
+
+    template <unsigned NumBytes, typename W>
+    static void packLittleEndian(W value, uint8_t* out)
+    {
+        for (unsigned i = 0; i < NumBytes; i++)
+        {
+            out[i] = uint8_t(value & 0xFFU);
+            value = W(value >> 8);
+        }
+    }
+
+    template <unsigned NumBytes, typename W>
+    static W unpackLittleEndian(const uint8_t* in)
+    {
+        W value = 0;
+        for (unsigned i = NumBytes; i > 0; i--)
+        {
+            value = W(W(value << 8) | in[i - 1]);
+        }
+        return value;
+    }
+
 public:
     explicit ScalarCodec(BitStream& stream)
         : stream_(stream)
@@ -96,6 +121,52 @@ public:
 
     template <unsigned BitLen, typename T>
     int decode(T& value);
+
+    /**
+     * Bulk encoding/decoding of arrays of primitives whose bit length is a multiple of 8.
+     * These methods can only be used if the stream is byte aligned, see @ref isByteAligned().
+     * The values are converted to/from the wire representation by the primitive type Spec, which must provide
+     * the type WireType and the static methods toWireArray() and fromWireArray() (see IntegerSpec<>, FloatSpec<>).
+     * The resulting encoding is identical to that produced by encode()/decode() called once per element.
+     * Return values are the same as for encode()/decode().
+     */
+    template <unsigned BitLen, typename Spec, typename T>
+    int encodeArray(const T* values, unsigned count);
+
+    template <unsigned BitLen, typename Spec, typename T>
+    int decodeArray(T* values, unsigned count);
+
+    /**
+     * Same as decodeArray(), but the number of values is defined by the remaining length of the stream.
+     * This is used for tail array optimization. Returns -ErrInvalidMarshalData if the stream contains more than
+     * max_count values; out_count will contain the number of decoded values in any case.
+     */
+    template <unsigned BitLen, typename Spec, typename T>
+    int decodeArrayUntilEnd(T* values, unsigned max_count, unsigned& out_count);
+
+    /**
+     * Raw bit array access, most significant bits first, up to @ref BitStream::MaxBitsPerRW bits per call.
+     * This is used for bool arrays.
+     */
+    int encodeBitArray(const uint8_t* bytes, unsigned bitlen) { return stream_.write(bytes, bitlen); }
+    int decodeBitArray(uint8_t* bytes, unsigned bitlen) { return stream_.read(bytes, bitlen); }
+
+    bool isByteAligned() const { return stream_.isByteAligned(); }
+
+    /**
+     * Advances the stream past the specified number of bits, see @ref BitStream::skip().
+     * This is used to skip over the fields that the application is not interested in.
+     */
+    int skipBits(unsigned bitlen) { return stream_.skip(bitlen); }
+
+    /**
+     * Transfers a pre-serialized bit string of arbitrary length, most significant bits first.
+     * This is used by the generated code for the fixed layout parts of data structures; bit offsets of every
+     * field are known at compile time there, so the fields are packed into the buffer directly.
+     * Return values are the same as for encode()/decode().
+     */
+    int encodeFixedLayout(const uint8_t* bytes, unsigned bitlen);
+    int decodeFixedLayout(uint8_t* bytes, unsigned bitlen);
 };
 
 // ----------------------------------------------------------------------------
@@ -135,6 +206,106 @@ int ScalarCodec::decode(T& value)
     return read_res;
 }
 
+template <unsigned BitLen, typename Spec, typename T>
+int ScalarCodec::encodeArray(const T* values, unsigned count)
+{
+    StaticAssert<(BitLen % 8) == 0>::check();
+    enum { BytesPerValue = BitLen / 8 };
+    enum { ValuesPerChunk = ArrayChunkSize / BytesPerValue };
+
+    typename Spec::WireType wire[ValuesPerChunk];
+    uint8_t chunk[unsigned(ValuesPerChunk) * unsigned(BytesPerValue)];
+    while (count > 0)
+    {
+        const unsigned chunk_count = min(count, unsigned(ValuesPerChunk));
+        Spec::toWireArray(values, wire, chunk_count);
+        values += chunk_count;
+        for (unsigned i = 0; i < chunk_count; i++)
+        {
+            packLittleEndian<BytesPerValue>(wire[i], chunk + i * BytesPerValue);
+        }
+        const int res = stream_.writeAlignedBytes(chunk, chunk_count * BytesPerValue);
+        if (res <= 0)
+        {
+            return res;
+        }
+        count -= chunk_count;
+    }
+    return BitStream::ResultOk;
+}
+
+template <unsigned BitLen, typename Spec, typename T>
+int ScalarCodec::decodeArray(T* values, unsigned count)
+{
+    StaticAssert<(BitLen % 8) == 0>::check();
+    enum { BytesPerValue = BitLen / 8 };
+    enum { ValuesPerChunk = ArrayChunkSize / BytesPerValue };
+
+    typename Spec::WireType wire[ValuesPerChunk];
+    uint8_t chunk[unsigned(ValuesPerChunk) * unsigned(BytesPerValue)];
+    while (count > 0)
+    {
+        const unsigned chunk_count = min(count, unsigned(ValuesPerChunk));
+        const int res = stream_.readAlignedBytes(chunk, chunk_count * BytesPerValue, BytesPerValue);
+        if (res < 0)
+        {
+            return res;
+        }
+        if (static_cast<unsigned>(res) < chunk_count * BytesPerValue)
+        {
+            return BitStream::ResultOutOfBuffer;
+        }
+        for (unsigned i = 0; i < chunk_count; i++)
+        {
+            wire[i] = unpackLittleEndian<BytesPerValue, typename Spec::WireType>(chunk + i * BytesPerValue);
+        }
+        Spec::fromWireArray(wire, values, chunk_count);
+        values += chunk_count;
+        count -= chunk_count;
+    }
+    return BitStream::ResultOk;
+}
+
+template <unsigned BitLen, typename Spec, typename T>
+int ScalarCodec::decodeArrayUntilEnd(T* values, const unsigned max_count, unsigned& out_count)
+{
+    StaticAssert<(BitLen % 8) == 0>::check();
+    enum { BytesPerValue = BitLen / 8 };
+    enum { ValuesPerChunk = ArrayChunkSize / BytesPerValue };
+
+    typename Spec::WireType wire[ValuesPerChunk];
+    uint8_t chunk[unsigned(ValuesPerChunk) * unsigned(BytesPerValue)];
+    out_count = 0;
+    while (true)
+    {
+        /*
+         * Full chunks are requested regardless of the remaining capacity, so that excess data can be detected.
+         * Incomplete trailing values are ignored and left in the stream, as in the element-by-element decoding.
+         */
+        const int res = stream_.readAlignedBytes(chunk, sizeof(chunk), BytesPerValue);
+        if (res < 0)
+        {
+            return res;
+        }
+        const unsigned chunk_count = static_cast<unsigned>(res) / BytesPerValue;
+        const unsigned accepted_count = min(chunk_count, max_count - out_count);
+        for (unsigned i = 0; i < accepted_count; i++)
+        {
+            wire[i] = unpackLittleEndian<BytesPerValue, typename Spec::WireType>(chunk + i * BytesPerValue);
+        }
+        Spec::fromWireArray(wire, values + out_count, accepted_count);
+        out_count += accepted_count;
+        if (accepted_count < chunk_count)
+        {
+            return -ErrInvalidMarshalData;
+        }
+        if (static_cast<unsigned>(res) < sizeof(chunk))
+        {
+            return BitStream::ResultOk;     // End of stream reached
+        }
+    }
+}
+
 }
 
 #endif // UAVCAN_MARSHAL_SCALAR_CODEC_HPP_INCLUDED
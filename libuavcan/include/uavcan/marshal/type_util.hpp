@@ -77,6 +77,20 @@ public:
     enum { Result = sizeof(test<T>(0)) == sizeof(Yes) };
 };
 
+/**
+ * Compile-time: Defines how arrays of T can be encoded and decoded. Please see the specializations.
+ *  - ArrayCodecPerElement  - element by element; this is the default.
+ *  - ArrayCodecBytes       - T is a primitive of byte-multiple length; the whole array can be transferred at once.
+ *  - ArrayCodecBits        - T is a single bit; the array can be transferred as a bit string.
+ */
+enum ArrayCodecKind { ArrayCodecPerElement, ArrayCodecBytes, ArrayCodecBits };
+
+template <typename T>
+struct ArrayCodecSelector
+{
+    enum { Result = ArrayCodecPerElement };
+};
+
 /**
  * Streams a given value into YAML string. Please see the specializations.
  */
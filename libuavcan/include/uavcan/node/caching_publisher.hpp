@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_NODE_CACHING_PUBLISHER_HPP_INCLUDED
+#define UAVCAN_NODE_CACHING_PUBLISHER_HPP_INCLUDED
+
+#include <uavcan/node/generic_publisher.hpp>
+
+namespace uavcan
+{
+/**
+ * Same as @ref Publisher, but keeps the encoded payload and the transfer CRC of the last published message.
+ * Every message is encoded into a second buffer and compared with the cached payload byte by byte. If they are
+ * equal, the frames are filled directly from the cached payload without computing the transfer CRC again.
+ * Otherwise the buffers are swapped, and the transfer CRC is only computed if the payload doesn't fit one frame.
+ * Comparing the encoded bytes rather than the messages makes sure that every change that is visible on the bus,
+ * such as the sign of a floating point zero, is published.
+ *
+ * This is useful for periodic messages that rarely change. The cost is the memory for two buffers of the maximum
+ * payload length, so this class is not suitable for very large data types.
+ *
+ * @tparam DataType_    Message data type
+ */
+template <typename DataType_>
+class UAVCAN_EXPORT CachingPublisher : protected GenericPublisherBase
+{
+public:
+    typedef DataType_ DataType; ///< Message data type
+
+private:
+    enum { MaxPayloadLen = BitLenToByteLen<DataType::MaxBitLen>::Result };
+
+    typedef StaticTransferBuffer<(MaxPayloadLen > 0) ? uint16_t(MaxPayloadLen) : uint16_t(1)> PayloadBuffer;
+
+    PayloadBuffer payloads_[2];    ///< The cached payload and the scratch buffer the next message is encoded into
+    TransferCRC payload_crc_;
+    uint32_t num_cache_hits_;
+    uint8_t cached_index_;
+    bool cache_valid_;
+
+    int checkInit();
+
+    int updateCache(const DataType& message);
+
+    int publishCached(TransferID* tid);
+
+public:
+    /**
+     * Parameters are the same as for @ref Publisher.
+     */
+    explicit CachingPublisher(INode& node, MonotonicDuration tx_timeout = getDefaultTxTimeout(),
+                              MonotonicDuration max_transfer_interval =
+                                  TransferSender::getDefaultMaxTransferInterval())
+        : GenericPublisherBase(node, tx_timeout, max_transfer_interval)
+        , num_cache_hits_(0)
+        , cached_index_(0)
+        , cache_valid_(false)
+    {
+        StaticAssert<DataTypeKind(DataType::DataTypeKind) == DataTypeKindMessage>::check();
+    }
+
+    /**
+     * Init method can be called prior first publication, but it's not necessary
+     * because the publisher can be automatically initialized ad-hoc.
+     */
+    int init() { return checkInit(); }
+
+    /**
+     * Broadcast the message; see @ref Publisher::broadcast().
+     * Returns negative error code.
+     */
+    int broadcast(const DataType& message)
+    {
+        const int res = updateCache(message);
+        return (res < 0) ? res : publishCached(UAVCAN_NULLPTR);
+    }
+
+    int broadcast(const DataType& message, TransferID tid)
+    {
+        const int res = updateCache(message);
+        return (res < 0) ? res : publishCached(&tid);
+    }
+
+    /**
+     * The next message will be encoded even if it is equal to the cached one.
+     */
+    void invalidateCache() { cache_valid_ = false; }
+
+    /**
+     * Number of messages that were published from the cache, without computing the transfer CRC.
+     */
+    uint32_t getCacheHitCount() const { return num_cache_hits_; }
+
+    static MonotonicDuration getDefaultTxTimeout() { return MonotonicDuration::fromMSec(100); }
+
+    using GenericPublisherBase::allowAnonymousTransfers;
+    using GenericPublisherBase::getTransferSender;
+    using GenericPublisherBase::getMinTxTimeout;
+    using GenericPublisherBase::getMaxTxTimeout;
+    using GenericPublisherBase::getTxTimeout;
+    using GenericPublisherBase::setTxTimeout;
+    using GenericPublisherBase::getPriority;
+    using GenericPublisherBase::setPriority;
+    using GenericPublisherBase::getNode;
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename DataType_>
+int CachingPublisher<DataType_>::checkInit()
+{
+    if (isInited())
+    {
+        return 0;
+    }
+    return doInit(DataTypeKindMessage, DataType::getDataTypeFullName(), CanTxQueue::Volatile);
+}
+
+template <typename DataType_>
+int CachingPublisher<DataType_>::updateCache(const DataType& message)
+{
+    const int init_res = checkInit();
+    if (init_res < 0)
+    {
+        return init_res;
+    }
+
+    PayloadBuffer& scratch = payloads_[cached_index_ ^ 1U];
+    scratch.reset();
+    BitStream bitstream(scratch);
+    ScalarCodec codec(bitstream);
+    const int encode_res = DataType::encode(message, codec);
+    if (encode_res <= 0)
+    {
+        UAVCAN_ASSERT(0);   // Impossible, internal error
+        return -ErrInvalidMarshalData;
+    }
+
+    const PayloadBuffer& cached = payloads_[cached_index_];
+    if (cache_valid_ &&
+        (scratch.getMaxWritePos() == cached.getMaxWritePos()) &&
+        ::uavcan::equal(scratch.getRawPtr(), scratch.getRawPtr() + scratch.getMaxWritePos(), cached.getRawPtr()))
+    {
+        num_cache_hits_++;
+        return 0;
+    }
+
+    cached_index_ = uint8_t(cached_index_ ^ 1U);
+    if (TransferSender::isMultiFrameTransfer(scratch.getMaxWritePos()))
+    {
+        payload_crc_ = getTransferSender().computeTransferCRC(scratch.getRawPtr(), scratch.getMaxWritePos());
+    }
+    cache_valid_ = true;
+    return 0;
+}
+
+template <typename DataType_>
+int CachingPublisher<DataType_>::publishCached(TransferID* tid)
+{
+    UAVCAN_ASSERT(cache_valid_);
+    const PayloadBuffer& payload = payloads_[cached_index_];
+    const TransferSender& sender = getTransferSender();
+    if (tid != UAVCAN_NULLPTR)
+    {
+        return sender.send(payload.getRawPtr(), payload.getMaxWritePos(), payload_crc_, getTxDeadline(),
+                           MonotonicTime(), TransferTypeMessageBroadcast, NodeID::Broadcast, *tid);
+    }
+    return sender.send(payload.getRawPtr(), payload.getMaxWritePos(), payload_crc_, getTxDeadline(),
+                       MonotonicTime(), TransferTypeMessageBroadcast, NodeID::Broadcast);
+}
+
+}
+
+#endif // UAVCAN_NODE_CACHING_PUBLISHER_HPP_INCLUDED
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_NODE_CONFLATING_PUBLISHER_HPP_INCLUDED
+#define UAVCAN_NODE_CONFLATING_PUBLISHER_HPP_INCLUDED
+
+#include <uavcan/node/publisher.hpp>
+#include <uavcan/node/timer.hpp>
+
+namespace uavcan
+{
+/**
+ * Publisher for data where only the latest value matters, e.g. setpoints and sensor readings that the application
+ * produces faster than the bus can carry them.
+ *
+ * Messages are published no more often than once per minimum interval. If the application publishes a message
+ * before the interval has elapsed, the message is held back and published when the interval elapses; if another
+ * message is published in the meantime, it replaces the held back one, which is counted as conflated.
+ *
+ * Additionally, frames of this publisher are enqueued with @ref CanIOFlagReplaceQueued, so if the previous message
+ * is still waiting in the TX queue when the next one is sent, the queued frame is replaced with the new one instead
+ * of delaying it. This only works for messages that fit one CAN frame.
+ *
+ * @tparam DataType_    Message data type
+ */
+template <typename DataType_>
+class UAVCAN_EXPORT ConflatingPublisher : private TimerBase
+{
+public:
+    typedef DataType_ DataType; ///< Message data type
+
+    /**
+     * Worst case length of an extended CAN frame with 8 bytes of payload, including bit stuffing.
+     * Used to convert the bus load share into the minimum interval.
+     */
+    static const unsigned WorstCaseFrameBitLen = 160;
+
+private:
+    enum { MaxPayloadLen = BitLenToByteLen<DataType::MaxBitLen>::Result };
+
+    Publisher<DataType> publisher_;
+    DataType pending_message_;
+    MonotonicDuration min_interval_;
+    MonotonicTime last_publication_ts_;
+    uint32_t num_conflated_samples_;
+    uint32_t num_failures_;
+    bool has_pending_message_;
+
+    int publishNow(const DataType& message)
+    {
+        const MonotonicTime ts = publisher_.getNode().getMonotonicTime();
+        const int res = publisher_.broadcast(message);
+        if (res >= 0)
+        {
+            last_publication_ts_ = ts;      // A failed publication doesn't hold back the next one
+        }
+        return res;
+    }
+
+    virtual void handleTimerEvent(const TimerEvent&);
+
+public:
+    /**
+     * @param node              Node instance this publisher will be registered with.
+     *
+     * @param min_interval      Messages will not be published more often than that. Zero disables the pacing.
+     *
+     * @param tx_timeout        Same as for @ref Publisher.
+     */
+    explicit ConflatingPublisher(INode& node, MonotonicDuration min_interval = MonotonicDuration(),
+                                 MonotonicDuration tx_timeout = Publisher<DataType>::getDefaultTxTimeout())
+        : TimerBase(node)
+        , publisher_(node, tx_timeout)
+        , min_interval_(min_interval)
+        , num_conflated_samples_(0)
+        , num_failures_(0)
+        , has_pending_message_(false)
+    {
+        publisher_.getTransferSender().setCanIOFlags(CanIOFlagReplaceQueued);
+    }
+
+    /**
+     * Init method can be called prior first publication, but it's not necessary
+     * because the publisher can be automatically initialized ad-hoc.
+     */
+    int init() { return publisher_.init(); }
+
+    /**
+     * Broadcast the message now, or when the minimum interval since the last publication elapses.
+     * Returns negative error code. Errors of deferred publications are only counted, see @ref getFailureCount().
+     */
+    int broadcast(const DataType& message);
+
+    /**
+     * Minimum interval between publications. A change applies to the subsequent calls to @ref broadcast();
+     * a message that is already held back is published at the time that was scheduled for it.
+     */
+    MonotonicDuration getMinInterval() const { return min_interval_; }
+    void setMinInterval(MonotonicDuration x) { min_interval_ = x; }
+
+    /**
+     * Sets the minimum interval so that this publisher doesn't take more than the specified share of the bus
+     * bandwidth, assuming the worst case length of the transfer.
+     * @param bitrate       CAN bus bit rate, bits per second.
+     * @param share         Share of the bus bandwidth, in the range (0, 1].
+     * Returns negative error code.
+     */
+    int setMaxBusLoadShare(uint32_t bitrate, float share);
+
+    /**
+     * Whether there is a message that will be published when the minimum interval elapses.
+     */
+    bool hasPendingMessage() const { return has_pending_message_; }
+
+    /**
+     * Number of messages that were replaced with a newer one before they could be published.
+     * Frames replaced in the TX queue are not included; see @ref CanTxQueue::getReplacedFrameCount().
+     */
+    uint32_t getConflatedSampleCount() const { return num_conflated_samples_; }
+
+    /**
+     * Number of deferred publications that have failed.
+     */
+    uint32_t getFailureCount() const { return num_failures_; }
+
+    Publisher<DataType>& getPublisher() { return publisher_; }
+    const Publisher<DataType>& getPublisher() const { return publisher_; }
+
+    INode& getNode() const { return publisher_.getNode(); }
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename DataType_>
+const unsigned ConflatingPublisher<DataType_>::WorstCaseFrameBitLen;
+
+template <typename DataType_>
+void ConflatingPublisher<DataType_>::handleTimerEvent(const TimerEvent&)
+{
+    if (!has_pending_message_)
+    {
+        return;
+    }
+    has_pending_message_ = false;
+    const int res = publishNow(pending_message_);
+    if (res < 0)
+    {
+        UAVCAN_TRACE("ConflatingPublisher", "Deferred publication failed: %i", res);
+        num_failures_++;
+    }
+}
+
+template <typename DataType_>
+int ConflatingPublisher<DataType_>::broadcast(const DataType& message)
+{
+    const int init_res = publisher_.init();
+    if (init_res < 0)
+    {
+        return init_res;
+    }
+
+    const MonotonicTime next_publication_ts = last_publication_ts_ + min_interval_;
+
+    if (!has_pending_message_ &&
+        (last_publication_ts_.isZero() || (publisher_.getNode().getMonotonicTime() >= next_publication_ts)))
+    {
+        return publishNow(message);
+    }
+
+    if (has_pending_message_)
+    {
+        num_conflated_samples_++;
+    }
+    pending_message_ = message;
+    has_pending_message_ = true;
+    if (!isRunning())
+    {
+        startOneShotWithDeadline(next_publication_ts);
+    }
+    return 0;
+}
+
+template <typename DataType_>
+int ConflatingPublisher<DataType_>::setMaxBusLoadShare(uint32_t bitrate, float share)
+{
+    if ((bitrate == 0) || !(share > 0.0F) || (share > 1.0F))
+    {
+        return -ErrInvalidParam;
+    }
+
+    // Multi-frame transfers carry two bytes of the transfer CRC
+    const unsigned payload_len = (unsigned(MaxPayloadLen) > Frame::PayloadCapacity) ?
+                                 (unsigned(MaxPayloadLen) + 2U) : unsigned(MaxPayloadLen);
+    const unsigned num_frames = (payload_len == 0) ? 1U :
+                                ((payload_len + Frame::PayloadCapacity - 1U) / Frame::PayloadCapacity);
+
+    const float interval_usec = (float(num_frames) * float(WorstCaseFrameBitLen) * 1e6F) / (float(bitrate) * share);
+    min_interval_ = MonotonicDuration::fromUSec(int64_t(interval_usec));
+    return 0;
+}
+
+}
+
+#endif // UAVCAN_NODE_CONFLATING_PUBLISHER_HPP_INCLUDED
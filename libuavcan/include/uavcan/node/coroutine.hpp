@@ -0,0 +1,453 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_NODE_COROUTINE_HPP_INCLUDED
+#define UAVCAN_NODE_COROUTINE_HPP_INCLUDED
+
+#include <uavcan/build_config.hpp>
+
+#if UAVCAN_COROUTINES
+
+#include <uavcan/node/service_client.hpp>
+#include <uavcan/node/subscriber.hpp>
+#include <uavcan/util/method_binder.hpp>
+#include <coroutine>
+#include <cstddef>
+#include <type_traits>
+
+namespace uavcan
+{
+/**
+ * Return type of the coroutines that use the awaitables defined in this header:
+ *
+ *  uavcan::CoroutineTask poll(uavcan::IPoolAllocator& frame_allocator,
+ *                             uavcan::CoroutineServiceClient<protocol::GetNodeInfo>& client,
+ *                             uavcan::NodeID server_node_id)
+ *  {
+ *      for (;;)
+ *      {
+ *          auto result = co_await client.call(server_node_id, protocol::GetNodeInfo::Request());
+ *          ...
+ *          co_await uavcan::sleep(client.getNode(), uavcan::MonotonicDuration::fromMSec(1000));
+ *      }
+ *  }
+ *
+ * Coroutines are started immediately, they run until the first suspension, and then they are resumed from the spin
+ * method of the node, so no extra threads are involved. The coroutine frame is destroyed once the coroutine returns.
+ *
+ * The coroutine frame is allocated from the pool allocator that must be passed to the coroutine as an argument,
+ * in any position. The frame, together with the awaitables that are in progress, must fit one block of the pool;
+ * since the blocks of the node's pool are too small for that, a dedicated pool should be used, e.g.:
+ *  uavcan::HeapBasedPoolAllocator<512> frame_allocator(1000);
+ * If the frame could not be allocated, the coroutine doesn't start, and the returned task is invalid.
+ * GCC 12 and older falsely report the deallocation of such frames with -Wmismatched-new-delete.
+ *
+ * The objects that the coroutine is awaiting, e.g. the client or the node, must outlive the coroutine.
+ */
+class UAVCAN_EXPORT CoroutineTask
+{
+    bool valid_;
+
+    explicit CoroutineTask(bool valid) : valid_(valid) { }
+
+    /**
+     * Frames are prepended with a pointer to the allocator, so that they can be released.
+     */
+    enum { HeaderSize = alignof(std::max_align_t) };
+
+    template <typename... Args>
+    struct FrameAllocatorFinder;
+
+public:
+    struct promise_type
+    {
+        template <typename... Args>
+        static void* operator new(std::size_t size, Args&... args) noexcept;
+
+        static void operator delete(void* ptr) noexcept;
+
+        static CoroutineTask get_return_object_on_allocation_failure() noexcept { return CoroutineTask(false); }
+
+        CoroutineTask get_return_object() noexcept { return CoroutineTask(true); }
+
+        std::suspend_never initial_suspend() const noexcept { return std::suspend_never(); }
+        std::suspend_never final_suspend() const noexcept { return std::suspend_never(); }
+
+        void return_void() const noexcept { }
+
+        void unhandled_exception() const { handleFatalError("Coroutine exception"); }
+    };
+
+    /**
+     * False if the coroutine could not be started because the frame could not be allocated.
+     */
+    bool isValid() const { return valid_; }
+};
+
+template <>
+struct CoroutineTask::FrameAllocatorFinder<>
+{
+    static IPoolAllocator* find() { return UAVCAN_NULLPTR; }
+};
+
+template <typename First, typename... Rest>
+struct CoroutineTask::FrameAllocatorFinder<First, Rest...>
+{
+    static IPoolAllocator* find(First& first, Rest&... rest)
+    {
+        if constexpr (std::is_base_of<IPoolAllocator, typename std::remove_cv<First>::type>::value)
+        {
+            return &first;
+        }
+        else
+        {
+            return FrameAllocatorFinder<Rest...>::find(rest...);
+        }
+    }
+};
+
+template <typename... Args>
+void* CoroutineTask::promise_type::operator new(std::size_t size, Args&... args) noexcept
+{
+    static_assert((std::is_base_of<IPoolAllocator, typename std::remove_cv<Args>::type>::value || ...),
+                  "Coroutine must accept a reference to IPoolAllocator; the frame will be allocated from it");
+
+    IPoolAllocator* const allocator = FrameAllocatorFinder<Args...>::find(args...);
+    uint8_t* const block = static_cast<uint8_t*>(allocator->allocate(size + HeaderSize));
+    if (block == UAVCAN_NULLPTR)
+    {
+        UAVCAN_TRACE("CoroutineTask", "Frame of %u bytes could not be allocated", unsigned(size));
+        return UAVCAN_NULLPTR;
+    }
+    *reinterpret_cast<IPoolAllocator**>(block) = allocator;
+    return block + HeaderSize;
+}
+
+inline void CoroutineTask::promise_type::operator delete(void* ptr) noexcept
+{
+    uint8_t* const block = static_cast<uint8_t*>(ptr) - HeaderSize;
+    (*reinterpret_cast<IPoolAllocator**>(block))->deallocate(block);
+}
+
+/**
+ * Suspends the coroutine for the specified amount of time:
+ *  co_await uavcan::sleep(node, uavcan::MonotonicDuration::fromMSec(100));
+ * Non-positive durations don't suspend the coroutine.
+ */
+class UAVCAN_EXPORT SleepAwaiter : private DeadlineHandler
+{
+    const MonotonicDuration duration_;
+    std::coroutine_handle<> handle_;
+
+    virtual void handleDeadline(MonotonicTime)
+    {
+        handle_.resume();       // The awaiter may not exist anymore once the coroutine is resumed
+    }
+
+public:
+    SleepAwaiter(INode& node, MonotonicDuration duration)
+        : DeadlineHandler(node.getScheduler())
+        , duration_(duration)
+    { }
+
+    bool await_ready() const { return !duration_.isPositive(); }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        handle_ = handle;
+        startWithDelay(duration_);
+    }
+
+    void await_resume() const { }
+};
+
+inline SleepAwaiter sleep(INode& node, MonotonicDuration duration)
+{
+    return SleepAwaiter(node, duration);
+}
+
+/**
+ * Result of a service call awaited with @ref CoroutineServiceClient. Unlike @ref ServiceCallResult, it is copyable
+ * and it owns the response.
+ */
+template <typename DataType>
+struct UAVCAN_EXPORT CoroutineCallResult
+{
+    typedef typename ServiceCallResult<DataType>::Status Status;
+
+    int error;                                  ///< Negative error code if the call could not be issued, else zero
+    Status status;                              ///< Meaningless if the call could not be issued
+    ServiceCallID call_id;
+    typename DataType::Response response;       ///< Value undefined unless the call was successful
+
+    CoroutineCallResult()
+        : error(0)
+        , status(ServiceCallResult<DataType>::ErrorTimeout)
+    { }
+
+    bool isSuccessful() const { return (error >= 0) && (status == ServiceCallResult<DataType>::Success); }
+};
+
+/**
+ * Service client whose calls can be awaited:
+ *  auto result = co_await client.call(server_node_id, request);
+ *  if (result.isSuccessful()) { ... }
+ *
+ * Any number of coroutines can await their calls concurrently. The pending awaiters are stored inside the frames
+ * of the awaiting coroutines, so the client doesn't allocate any memory except for the call states of the
+ * underlying @ref ServiceClient; they are hashed by the server node ID to keep the dispatching cheap.
+ *
+ * The awaiting coroutine is resumed from the response callback, so the response is copied directly into the result.
+ */
+template <typename DataType_>
+class UAVCAN_EXPORT CoroutineServiceClient : Noncopyable
+{
+public:
+    typedef DataType_ DataType;
+    typedef typename DataType::Request RequestType;
+    typedef CoroutineCallResult<DataType> ResultType;
+
+    class CallAwaiter;
+
+private:
+    typedef CoroutineServiceClient<DataType> SelfType;
+    typedef ServiceCallResult<DataType> ServiceCallResultType;
+    typedef MethodBinder<SelfType*, void (SelfType::*)(const ServiceCallResultType&)> ClientCallback;
+
+#if UAVCAN_TINY
+    enum { NumBuckets = 1 };
+#else
+    enum { NumBuckets = 16 };
+#endif
+
+    ServiceClient<DataType, ClientCallback> client_;
+    LinkedListRoot<CallAwaiter> buckets_[NumBuckets];
+
+    LinkedListRoot<CallAwaiter>& getBucket(NodeID server_node_id)
+    {
+        return buckets_[unsigned(server_node_id.get()) % unsigned(NumBuckets)];
+    }
+
+    void handleCallResult(const ServiceCallResultType& result);
+
+public:
+    class CallAwaiter : public LinkedListNode<CallAwaiter>
+    {
+        friend class CoroutineServiceClient;
+
+        SelfType& owner_;
+        const RequestType& request_;
+        const ServiceCallResultType* completed_call_;
+        std::coroutine_handle<> handle_;
+        ServiceCallID call_id_;
+        int error_;
+
+    public:
+        CallAwaiter(SelfType& owner, NodeID server_node_id, const RequestType& request)
+            : owner_(owner)
+            , request_(request)
+            , completed_call_(UAVCAN_NULLPTR)
+            , call_id_(server_node_id, TransferID())
+            , error_(0)
+        { }
+
+        bool await_ready() const { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            error_ = owner_.client_.call(call_id_.server_node_id, request_, call_id_);
+            if (error_ < 0)
+            {
+                return false;   // Resuming immediately
+            }
+            handle_ = handle;
+            owner_.getBucket(call_id_.server_node_id).insert(this);
+            return true;
+        }
+
+        ResultType await_resume() const
+        {
+            ResultType result;
+            result.error = (error_ < 0) ? error_ : 0;
+            result.call_id = call_id_;
+            if (completed_call_ != UAVCAN_NULLPTR)
+            {
+                result.status = completed_call_->getStatus();
+                result.response = completed_call_->getResponse();
+            }
+            return result;
+        }
+    };
+
+    explicit CoroutineServiceClient(INode& node)
+        : client_(node, ClientCallback(this, &SelfType::handleCallResult))
+    { }
+
+    /**
+     * The returned object must be awaited immediately.
+     * The result of the awaiting is @ref CoroutineCallResult.
+     */
+    CallAwaiter call(NodeID server_node_id, const RequestType& request)
+    {
+        return CallAwaiter(*this, server_node_id, request);
+    }
+
+    /**
+     * Returns the number of coroutines awaiting their calls.
+     */
+    unsigned getNumPendingCalls() const { return client_.getNumPendingCalls(); }
+
+    /**
+     * See @ref ServiceClient.
+     */
+    MonotonicDuration getRequestTimeout() const { return client_.getRequestTimeout(); }
+    void setRequestTimeout(MonotonicDuration timeout) { client_.setRequestTimeout(timeout); }
+
+    TransferPriority getPriority() const { return client_.getPriority(); }
+    void setPriority(const TransferPriority prio) { client_.setPriority(prio); }
+
+    INode& getNode() const { return client_.getNode(); }
+};
+
+template <typename DataType_>
+void CoroutineServiceClient<DataType_>::handleCallResult(const ServiceCallResultType& result)
+{
+    LinkedListRoot<CallAwaiter>& bucket = getBucket(result.getCallID().server_node_id);
+    for (CallAwaiter* p = bucket.get(); p != UAVCAN_NULLPTR; p = p->getNextListNode())
+    {
+        if (p->call_id_ == result.getCallID())
+        {
+            bucket.remove(p);
+            p->completed_call_ = &result;
+            p->handle_.resume();        // The result is consumed before the coroutine can suspend again
+            return;
+        }
+    }
+    UAVCAN_ASSERT(0);   // Calls of the private client are only made by the awaiters
+}
+
+/**
+ * Subscriber whose messages can be awaited:
+ *  const auto msg = co_await subscriber.next();
+ *
+ * When a message arrives, all coroutines that are awaiting it are resumed, in the order they started awaiting.
+ * Messages that arrive while no coroutine is awaiting are not stored; use @ref QueuedSubscriber if that's needed.
+ *
+ * @tparam DataType_    Message data type.
+ */
+template <typename DataType_>
+class UAVCAN_EXPORT CoroutineSubscriber : Noncopyable
+{
+public:
+    typedef DataType_ DataType;
+
+    class NextMessageAwaiter;
+
+private:
+    typedef CoroutineSubscriber<DataType> SelfType;
+    typedef MethodBinder<SelfType*, void (SelfType::*)(const ReceivedDataStructure<DataType>&)> SubscriberCallback;
+
+    Subscriber<DataType, SubscriberCallback> subscriber_;
+    NextMessageAwaiter* waiting_head_;      ///< Oldest first
+    NextMessageAwaiter* waiting_tail_;
+    uint32_t num_unawaited_messages_;
+
+    void handleMessage(const ReceivedDataStructure<DataType>& msg);
+
+public:
+    class NextMessageAwaiter : public LinkedListNode<NextMessageAwaiter>
+    {
+        friend class CoroutineSubscriber;
+
+        SelfType& owner_;
+        const ReceivedDataStructure<DataType>* message_;
+        std::coroutine_handle<> handle_;
+
+    public:
+        explicit NextMessageAwaiter(SelfType& owner)
+            : owner_(owner)
+            , message_(UAVCAN_NULLPTR)
+        { }
+
+        bool await_ready() const { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            handle_ = handle;
+            if (owner_.waiting_tail_ == UAVCAN_NULLPTR)
+            {
+                owner_.waiting_head_ = this;
+            }
+            else
+            {
+                owner_.waiting_tail_->setNextListNode(this);
+            }
+            owner_.waiting_tail_ = this;
+        }
+
+        DataType await_resume() const
+        {
+            UAVCAN_ASSERT(message_ != UAVCAN_NULLPTR);
+            return *message_;
+        }
+    };
+
+    explicit CoroutineSubscriber(INode& node)
+        : subscriber_(node)
+        , waiting_head_(UAVCAN_NULLPTR)
+        , waiting_tail_(UAVCAN_NULLPTR)
+        , num_unawaited_messages_(0)
+    { }
+
+    /**
+     * Begin receiving messages. Returns negative error code.
+     */
+    int start() { return subscriber_.start(SubscriberCallback(this, &SelfType::handleMessage)); }
+
+    void stop() { subscriber_.stop(); }
+
+    /**
+     * The returned object must be awaited immediately.
+     * The result of the awaiting is a copy of the message.
+     */
+    NextMessageAwaiter next() { return NextMessageAwaiter(*this); }
+
+    /**
+     * Number of messages that were received while no coroutine was awaiting.
+     */
+    uint32_t getNumUnawaitedMessages() const { return num_unawaited_messages_; }
+
+    uint32_t getFailureCount() const { return subscriber_.getFailureCount(); }
+
+    INode& getNode() const { return subscriber_.getNode(); }
+};
+
+template <typename DataType_>
+void CoroutineSubscriber<DataType_>::handleMessage(const ReceivedDataStructure<DataType>& msg)
+{
+    if (waiting_head_ == UAVCAN_NULLPTR)
+    {
+        num_unawaited_messages_++;
+        return;
+    }
+
+    // The coroutines that start awaiting again once resumed will get the next message, not this one
+    NextMessageAwaiter* p = waiting_head_;
+    waiting_head_ = UAVCAN_NULLPTR;
+    waiting_tail_ = UAVCAN_NULLPTR;
+
+    while (p != UAVCAN_NULLPTR)
+    {
+        NextMessageAwaiter* const next = p->getNextListNode();   // The awaiter is gone once resumed
+        p->message_ = &msg;
+        p->handle_.resume();
+        p = next;
+    }
+}
+
+}
+
+#endif // UAVCAN_COROUTINES
+
+#endif // UAVCAN_NODE_COROUTINE_HPP_INCLUDED
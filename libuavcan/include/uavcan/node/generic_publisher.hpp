@@ -43,11 +43,22 @@ protected:
 
     int doInit(DataTypeKind dtkind, const char* dtname, CanTxQueue::Qos qos);
 
+    /**
+     * Initializes the publisher with the data type that does not need to be registered.
+     */
+    int doInit(const DataTypeDescriptor& descr, CanTxQueue::Qos qos);
+
     MonotonicTime getTxDeadline() const;
 
     int genericPublish(const StaticTransferBufferImpl& buffer, TransferType transfer_type,
                        NodeID dst_node_id, TransferID* tid, MonotonicTime blocking_deadline);
 
+    int genericPublish(const uint8_t* payload, unsigned payload_len, TransferType transfer_type,
+                       NodeID dst_node_id, TransferID* tid, MonotonicTime blocking_deadline);
+
+    int genericPublish(const ITransferPayloadSource& payload, TransferType transfer_type,
+                       NodeID dst_node_id, TransferID* tid, MonotonicTime blocking_deadline);
+
     TransferSender& getTransferSender() { return sender_; }
     const TransferSender& getTransferSender() const { return sender_; }
 
@@ -99,9 +110,33 @@ class UAVCAN_EXPORT GenericPublisher : public GenericPublisherBase
               CanTxQueue::Volatile : CanTxQueue::Persistent
     };
 
+    /**
+     * Large messages are serialized directly into the CAN frames; see UAVCAN_STREAMING_PUBLISHER_THRESHOLD.
+     */
+    enum
+    {
+        Streaming = BitLenToByteLen<DataStruct::MaxBitLen>::Result > UAVCAN_STREAMING_PUBLISHER_THRESHOLD
+    };
+
+    class Serializer : public ITransferPayloadSource
+    {
+        const DataStruct& message_;
+
+    public:
+        explicit Serializer(const DataStruct& message) : message_(message) { }
+
+        virtual int writePayload(ITransferBuffer& sink) const { return doEncode(message_, sink); }
+    };
+
     int checkInit();
 
-    int doEncode(const DataStruct& message, ITransferBuffer& buffer) const;
+    static int doEncode(const DataStruct& message, ITransferBuffer& buffer);
+
+    int doPublish(const DataStruct& message, TransferType transfer_type, NodeID dst_node_id,
+                  TransferID* tid, MonotonicTime blocking_deadline, FalseType);
+
+    int doPublish(const DataStruct& message, TransferType transfer_type, NodeID dst_node_id,
+                  TransferID* tid, MonotonicTime blocking_deadline, TrueType);
 
     int genericPublish(const DataStruct& message, TransferType transfer_type, NodeID dst_node_id,
                        TransferID* tid, MonotonicTime blocking_deadline);
@@ -146,6 +181,21 @@ public:
     {
         return genericPublish(message, transfer_type, dst_node_id, &tid, blocking_deadline);
     }
+
+    /**
+     * Publishes a payload that has been serialized beforehand, e.g. to send the same data repeatedly without
+     * serializing it every time. The payload must be a serialized DataStruct; this is not checked.
+     */
+    int publishSerialized(const ITransferPayloadSource& payload, TransferType transfer_type, NodeID dst_node_id,
+                          TransferID tid, MonotonicTime blocking_deadline = MonotonicTime())
+    {
+        const int res = checkInit();
+        if (res < 0)
+        {
+            return res;
+        }
+        return GenericPublisherBase::genericPublish(payload, transfer_type, dst_node_id, &tid, blocking_deadline);
+    }
 };
 
 // ----------------------------------------------------------------------------
@@ -161,7 +211,7 @@ int GenericPublisher<DataSpec, DataStruct>::checkInit()
 }
 
 template <typename DataSpec, typename DataStruct>
-int GenericPublisher<DataSpec, DataStruct>::doEncode(const DataStruct& message, ITransferBuffer& buffer) const
+int GenericPublisher<DataSpec, DataStruct>::doEncode(const DataStruct& message, ITransferBuffer& buffer)
 {
     BitStream bitstream(buffer);
     ScalarCodec codec(bitstream);
@@ -185,6 +235,14 @@ int GenericPublisher<DataSpec, DataStruct>::genericPublish(const DataStruct& mes
         return res;
     }
 
+    return doPublish(message, transfer_type, dst_node_id, tid, blocking_deadline, BooleanType<Streaming>());
+}
+
+template <typename DataSpec, typename DataStruct>
+int GenericPublisher<DataSpec, DataStruct>::doPublish(const DataStruct& message, TransferType transfer_type,
+                                                      NodeID dst_node_id, TransferID* tid,
+                                                      MonotonicTime blocking_deadline, FalseType)
+{
     Buffer buffer;
 
     const int encode_res = doEncode(message, buffer);
@@ -196,6 +254,15 @@ int GenericPublisher<DataSpec, DataStruct>::genericPublish(const DataStruct& mes
     return GenericPublisherBase::genericPublish(buffer, transfer_type, dst_node_id, tid, blocking_deadline);
 }
 
+template <typename DataSpec, typename DataStruct>
+int GenericPublisher<DataSpec, DataStruct>::doPublish(const DataStruct& message, TransferType transfer_type,
+                                                      NodeID dst_node_id, TransferID* tid,
+                                                      MonotonicTime blocking_deadline, TrueType)
+{
+    const Serializer serializer(message);
+    return GenericPublisherBase::genericPublish(serializer, transfer_type, dst_node_id, tid, blocking_deadline);
+}
+
 }
 
 #endif // UAVCAN_NODE_GENERIC_PUBLISHER_HPP_INCLUDED
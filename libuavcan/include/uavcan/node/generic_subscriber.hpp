@@ -38,7 +38,7 @@ namespace uavcan
 template <typename DataType_>
 class UAVCAN_EXPORT ReceivedDataStructure : public DataType_, Noncopyable
 {
-    const IncomingTransfer* const _transfer_;   ///< Such weird name is necessary to avoid clashing with DataType fields
+    const IncomingTransfer* _transfer_;   ///< Such weird name is necessary to avoid clashing with DataType fields
 
     template <typename Ret, Ret(IncomingTransfer::*Fun) () const>
     Ret safeget() const
@@ -61,6 +61,11 @@ protected:
         UAVCAN_ASSERT(arg_transfer != UAVCAN_NULLPTR);
     }
 
+    /**
+     * Used when the data structure is decoded before the transfer is complete, see the streaming decoder.
+     */
+    void setTransfer(const IncomingTransfer* arg_transfer) { _transfer_ = arg_transfer; }
+
 public:
     typedef DataType_ DataType;
 
@@ -139,6 +144,16 @@ class UAVCAN_EXPORT GenericSubscriber : public GenericSubscriberBase
             obj_.handleIncomingTransfer(transfer);
         }
 
+        void handleStreamedTransfer(IncomingTransfer& transfer)
+        {
+            obj_.handleStreamedTransfer(transfer);
+        }
+
+        void handleStreamedTransferFailure()
+        {
+            obj_.handleStreamedTransferFailure();
+        }
+
     public:
         TransferForwarder(SelfType& obj,
                           const DataTypeDescriptor& data_type,
@@ -158,6 +173,10 @@ class UAVCAN_EXPORT GenericSubscriber : public GenericSubscriberBase
 
     void handleIncomingTransfer(IncomingTransfer& transfer);
 
+    void handleStreamedTransfer(IncomingTransfer& transfer);
+
+    void handleStreamedTransferFailure();
+
     int genericStart(bool (Dispatcher::*registration_method)(TransferListener*));
 
 protected:
@@ -168,11 +187,91 @@ protected:
         ReceivedDataStructureSpec(const IncomingTransfer* arg_transfer) :
             ReceivedDataStructure<DataStruct>(arg_transfer)
         { }
+
+        using ReceivedDataStructure<DataStruct>::setTransfer;
     };
 
-    explicit GenericSubscriber(INode& node) : GenericSubscriberBase(node)
+    /**
+     * Decodes multi frame transfers step by step as the frames arrive, so that they don't need to be reassembled.
+     * The decoder keeps only the bytes of the current decoding step (see DataStruct::decodeStep()) plus one frame.
+     * The decoded structure is delivered once the transfer CRC has been verified; otherwise it is discarded.
+     */
+    class StreamDecoder : public StreamingTransferBuffer
+    {
+        /*
+         * A step is performed as soon as its data is complete, so the window never holds more than the incomplete
+         * data of one step, including the partially decoded byte, plus one frame. The last step is deferred until
+         * the end of the transfer, so all of its data must fit. Neither can exceed the whole structure.
+         */
+        enum
+        {
+            StepWindowSize =
+                unsigned(BitLenToByteLen<DataStruct::MaxDecodeStepBitLen>::Result) + unsigned(Frame::PayloadCapacity),
+            LastStepWindowSize = unsigned(BitLenToByteLen<DataStruct::LastDecodeStepBitLen>::Result) + 1U,
+            StepsWindowSize = unsigned(EnumMax<StepWindowSize, LastStepWindowSize>::Result),
+            StructSize = unsigned(BitLenToByteLen<DataStruct::MaxBitLen>::Result),
+            WindowSize = ((StructSize > 0) && (StructSize < StepsWindowSize)) ? StructSize : StepsWindowSize
+        };
+
+        ReceivedDataStructureSpec struct_;
+        uint8_t window_[WindowSize];
+        uint16_t window_len_;
+        uint8_t window_bit_offset_;     ///< Number of bits of the first window byte that have been decoded already
+        uint16_t next_step_;
+
+        virtual void handleStreamStart()
+        {
+            window_len_ = 0;
+            window_bit_offset_ = 0;
+            next_step_ = 0;
+        }
+
+        virtual bool handleStreamData(const uint8_t* data, unsigned len);
+
+        int decodeNextStep();
+
+    public:
+        StreamDecoder()
+            : window_len_(0)
+            , window_bit_offset_(0)
+            , next_step_(0)
+        {
+            StaticAssert<(WindowSize <= 0xFFFFU)>::check();
+        }
+
+        /**
+         * Performs the remaining steps, including the last one which is not performed until the end of the transfer.
+         */
+        bool finish();
+
+        ReceivedDataStructureSpec& getStruct() { return struct_; }
+    };
+
+    explicit GenericSubscriber(INode& node)
+        : GenericSubscriberBase(node)
+        , stream_decoder_(UAVCAN_NULLPTR)
+        , field_mask_(AllFields)
     { }
 
+    /**
+     * Makes the subscription decode multi frame transfers as the frames arrive; see @ref StreamDecoder.
+     * The decoder object must outlive the subscriber. Must be called before the subscription is started.
+     */
+    void setStreamDecoder(StreamDecoder* decoder)
+    {
+        UAVCAN_ASSERT(!forwarder_);
+        stream_decoder_ = decoder;
+    }
+
+    /**
+     * Makes the subscription decode only the selected fields of the received structures, the other fields
+     * are left default-initialized; see DataStruct::decodeSelected() and DataStruct::FieldMask.
+     * This saves CPU time when only a few leading fields of large structures are needed.
+     * The stream decoder (see @ref setStreamDecoder()) always decodes the whole structure.
+     */
+    void setFieldMask(uint32_t field_mask) { field_mask_ = field_mask; }
+    uint32_t getFieldMask() const { return field_mask_; }
+
     virtual ~GenericSubscriber() { stop(); }
 
     virtual void handleReceivedDataStruct(ReceivedDataStructure<DataStruct>&) = 0;
@@ -217,6 +316,12 @@ protected:
     }
 
     TransferListenerType* getTransferListener() { return forwarder_; }
+
+private:
+    static const uint32_t AllFields = 0xFFFFFFFFU;
+
+    StreamDecoder* stream_decoder_;
+    uint32_t field_mask_;
 };
 
 // ----------------------------------------------------------------------------
@@ -246,6 +351,11 @@ int GenericSubscriber<DataSpec, DataStruct, TransferListenerType>::checkInit()
     forwarder_.template construct<SelfType&, const DataTypeDescriptor&, uint16_t, IPoolAllocator&>
         (*this, *descr, MaxBufferSize, node_.getAllocator());
 
+    if (stream_decoder_ != UAVCAN_NULLPTR)
+    {
+        forwarder_->installStreamingBuffer(stream_decoder_);
+    }
+
     return 0;
 }
 
@@ -260,7 +370,8 @@ void GenericSubscriber<DataSpec, DataStruct, TransferListenerType>::handleIncomi
     BitStream bitstream(transfer);
     ScalarCodec codec(bitstream);
 
-    const int decode_res = DataStruct::decode(rx_struct, codec);
+    const int decode_res = (field_mask_ == AllFields) ? DataStruct::decode(rx_struct, codec) :
+                           DataStruct::decodeSelected(rx_struct, codec, field_mask_);
 
     // We don't need the data anymore, the memory can be reused from the callback:
     transfer.release();
@@ -280,6 +391,105 @@ void GenericSubscriber<DataSpec, DataStruct, TransferListenerType>::handleIncomi
     handleReceivedDataStruct(rx_struct);
 }
 
+template <typename DataSpec, typename DataStruct, typename TransferListenerType>
+void GenericSubscriber<DataSpec, DataStruct, TransferListenerType>::handleStreamedTransfer(IncomingTransfer& transfer)
+{
+    UAVCAN_ASSERT(stream_decoder_ != UAVCAN_NULLPTR);
+    if ((stream_decoder_ == UAVCAN_NULLPTR) || !stream_decoder_->finish())
+    {
+        UAVCAN_TRACE("GenericSubscriber", "Unable to decode the streamed message [%s]",
+                     DataSpec::getDataTypeFullName());
+        failure_count_++;
+        node_.getDispatcher().getTransferPerfCounter().addError();
+        return;
+    }
+
+    ReceivedDataStructureSpec& rx_struct = stream_decoder_->getStruct();
+    rx_struct.setTransfer(&transfer);
+    handleReceivedDataStruct(rx_struct);
+    rx_struct.setTransfer(UAVCAN_NULLPTR);
+}
+
+template <typename DataSpec, typename DataStruct, typename TransferListenerType>
+void GenericSubscriber<DataSpec, DataStruct, TransferListenerType>::handleStreamedTransferFailure()
+{
+    UAVCAN_TRACE("GenericSubscriber", "Streamed message discarded [%s]", DataSpec::getDataTypeFullName());
+    failure_count_++;   // The transfer error has been accounted by the transfer listener
+}
+
+/*
+ * GenericSubscriber::StreamDecoder
+ */
+template <typename DataSpec, typename DataStruct, typename TransferListenerType>
+int GenericSubscriber<DataSpec, DataStruct, TransferListenerType>::StreamDecoder::decodeNextStep()
+{
+    StaticTransferBufferImpl window(window_, WindowSize);
+    window.setMaxWritePos(window_len_);
+    BitStream bitstream(window);
+    ScalarCodec codec(bitstream);
+
+    if (window_bit_offset_ > 0)
+    {
+        uint8_t decoded_bits = 0;
+        const int skip_res = bitstream.read(&decoded_bits, window_bit_offset_);
+        if (skip_res <= 0)
+        {
+            return skip_res;
+        }
+    }
+
+    const int res = DataStruct::decodeStep(struct_, next_step_, codec);
+    if (res > 0)
+    {
+        const unsigned decoded_bytes = bitstream.getBitOffset() / 8U;
+        (void)copy(window_ + decoded_bytes, window_ + window_len_, window_);
+        window_len_ = uint16_t(window_len_ - decoded_bytes);
+        window_bit_offset_ = uint8_t(bitstream.getBitOffset() % 8U);
+        next_step_++;
+    }
+    return res;
+}
+
+template <typename DataSpec, typename DataStruct, typename TransferListenerType>
+bool GenericSubscriber<DataSpec, DataStruct, TransferListenerType>::StreamDecoder::
+handleStreamData(const uint8_t* data, unsigned len)
+{
+    if ((window_len_ + len) > WindowSize)
+    {
+        return false;       // Malformed data, the current step should have been completed by now
+    }
+    (void)copy(data, data + len, window_ + window_len_);
+    window_len_ = uint16_t(window_len_ + len);
+
+    // The last step is deferred until the end of the transfer, because it may depend on where the data ends
+    while ((next_step_ + 1U) < unsigned(DataStruct::NumDecodeSteps))
+    {
+        const int res = decodeNextStep();
+        if (res < 0)
+        {
+            return false;
+        }
+        if (res == 0)
+        {
+            break;          // Not enough data yet
+        }
+    }
+    return true;
+}
+
+template <typename DataSpec, typename DataStruct, typename TransferListenerType>
+bool GenericSubscriber<DataSpec, DataStruct, TransferListenerType>::StreamDecoder::finish()
+{
+    while (next_step_ < unsigned(DataStruct::NumDecodeSteps))
+    {
+        if (decodeNextStep() <= 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 template <typename DataSpec, typename DataStruct, typename TransferListenerType>
 int GenericSubscriber<DataSpec, DataStruct, TransferListenerType>::
 genericStart(bool (Dispatcher::*registration_method)(TransferListener*))
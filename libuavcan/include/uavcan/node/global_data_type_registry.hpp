@@ -37,12 +37,28 @@ class UAVCAN_EXPORT GlobalDataTypeRegistry : Noncopyable
     struct Entry : public LinkedListNode<Entry>
     {
         DataTypeDescriptor descriptor;
+#if UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE > 0
+        Entry* next_by_name;            ///< Index chains, valid only while the registry is frozen
+        Entry* next_by_id;
+        uint32_t name_hash;
+#endif
 
-        Entry() { }
+        Entry() { resetIndex(); }
 
         Entry(DataTypeKind kind, DataTypeID id, const DataTypeSignature& signature, const char* name)
             : descriptor(kind, id, signature, name)
-        { }
+        {
+            resetIndex();
+        }
+
+        void resetIndex()
+        {
+#if UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE > 0
+            next_by_name = UAVCAN_NULLPTR;
+            next_by_id = UAVCAN_NULLPTR;
+            name_hash = 0;
+#endif
+        }
     };
 
     struct EntryInsertionComparator
@@ -76,12 +92,47 @@ private:
     typedef LinkedListRoot<Entry> List;
     mutable List msgs_;
     mutable List srvs_;
+    const DataTypeDescriptor* table_;
+    const uint16_t* table_id_order_;
+    uint16_t table_size_;
+    uint16_t table_num_msgs_;
     bool frozen_;
 
-    GlobalDataTypeRegistry() : frozen_(false) { }
+#if UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE > 0
+    enum { IndexSize = UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE };
+
+    /*
+     * Hash tables with intrusive chains, shared by both kinds; built once by freeze().
+     */
+    Entry* name_index_[IndexSize];
+    Entry* id_index_[IndexSize];
+
+    static uint32_t computeNameHash(const char* name);
+    static unsigned getNameBucket(DataTypeKind kind, uint32_t name_hash);
+    static unsigned getIDBucket(DataTypeKind kind, DataTypeID dtid);
+
+    void buildIndex();
+    void clearIndex();
+#else
+    void buildIndex() { }
+    void clearIndex() { }
+#endif
+
+    GlobalDataTypeRegistry()
+        : table_(UAVCAN_NULLPTR)
+        , table_id_order_(UAVCAN_NULLPTR)
+        , table_size_(0)
+        , table_num_msgs_(0)
+        , frozen_(false)
+    {
+        clearIndex();
+    }
 
     List* selectList(DataTypeKind kind) const;
 
+    const DataTypeDescriptor* findInTable(DataTypeKind kind, const char* name) const;
+    const DataTypeDescriptor* findInTable(DataTypeKind kind, DataTypeID dtid) const;
+
     RegistrationResult remove(Entry* dtd);
     RegistrationResult registImpl(Entry* dtd);
 
@@ -104,6 +155,26 @@ public:
     template <typename Type>
     RegistrationResult registerDataType(DataTypeID id);
 
+    /**
+     * Registers all data types from a constant table at once, replacing the previously adopted table, if any.
+     * The table is normally generated by the DSDL compiler (option --data-type-table), so that its entries are
+     * initialized at compile time and can live in ROM. This method will fail if the data type registry is frozen.
+     *
+     * The table must be ordered by data type kind (messages first), then by full name (as per strcmp()); this is
+     * what allows the lookups by name to use binary search. The lookups by ID use binary search over the ID order
+     * array, which lists the table indices of each kind in ascending order of data type ID, messages first.
+     * Neither array is copied, so both must outlive the registry. Data types that are registered individually
+     * must not collide with the table.
+     *
+     * In order to avoid collisions with the default registrations of the same data types, build the application
+     * with UAVCAN_DEFAULT_DATA_TYPE_REGISTRATION set to zero.
+     *
+     * @param table     Pointer to the first element of the table.
+     * @param id_order  Table indices ordered by kind, then by data type ID; same number of elements as the table.
+     * @param size      Number of elements in the table.
+     */
+    RegistrationResult adoptTable(const DataTypeDescriptor* table, const uint16_t* id_order, uint16_t size);
+
     /**
      * Data Type registry needs to be frozen before a node instance can use it in
      * order to prevent accidental change in data type configuration on a running
@@ -114,6 +185,9 @@ public:
      * calls will not have any effect.
      *
      * Once frozen, data type registry can't be unfrozen.
+     *
+     * Freezing also builds the lookup index, so that the find() methods don't have to iterate over all registered
+     * data types; see @ref UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE.
      */
     void freeze();
     bool isFrozen() const { return frozen_; }
@@ -148,12 +222,12 @@ public:
     /**
      * Returns the number of registered message types.
      */
-    unsigned getNumMessageTypes() const { return msgs_.getLength(); }
+    unsigned getNumMessageTypes() const { return msgs_.getLength() + table_num_msgs_; }
 
     /**
      * Returns the number of registered service types.
      */
-    unsigned getNumServiceTypes() const { return srvs_.getLength(); }
+    unsigned getNumServiceTypes() const { return srvs_.getLength() + (table_size_ - table_num_msgs_); }
 
 #if UAVCAN_DEBUG
     /// Required for unit testing
@@ -162,6 +236,11 @@ public:
         UAVCAN_TRACE("GlobalDataTypeRegistry", "Reset; was frozen: %i, num msgs: %u, num srvs: %u",
                      int(frozen_), getNumMessageTypes(), getNumServiceTypes());
         frozen_ = false;
+        clearIndex();
+        table_ = UAVCAN_NULLPTR;
+        table_id_order_ = UAVCAN_NULLPTR;
+        table_size_ = 0;
+        table_num_msgs_ = 0;
         while (msgs_.get())
         {
             msgs_.remove(msgs_.get());
@@ -187,7 +266,7 @@ struct UAVCAN_EXPORT DefaultDataTypeRegistrator
 {
     DefaultDataTypeRegistrator()
     {
-#if !UAVCAN_NO_GLOBAL_DATA_TYPE_REGISTRY
+#if !UAVCAN_NO_GLOBAL_DATA_TYPE_REGISTRY && UAVCAN_DEFAULT_DATA_TYPE_REGISTRATION
         const GlobalDataTypeRegistry::RegistrationResult res =
             GlobalDataTypeRegistry::instance().registerDataType<Type>(Type::DefaultDataTypeID);
 
@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_NODE_MULTI_NODE_HOST_HPP_INCLUDED
+#define UAVCAN_NODE_MULTI_NODE_HOST_HPP_INCLUDED
+
+#include <uavcan/build_config.hpp>
+#include <uavcan/node/abstract_node.hpp>
+#include <uavcan/transport/can_io.hpp>
+#include <uavcan/transport/frame.hpp>
+#include <uavcan/util/linked_list.hpp>
+
+#if UAVCAN_TINY
+# error "This functionality is not available in tiny mode"
+#endif
+
+namespace uavcan
+{
+
+class UAVCAN_EXPORT MultiNodeHost;
+
+/**
+ * Virtual CAN driver that connects one logical node to a @ref MultiNodeHost.
+ *
+ * The port is passed to the node constructor in place of the real driver, then bound to the node:
+ *
+ *      MultiNodeHostPort port(host);
+ *      SubNode<> node(port, clock, allocator);
+ *      port.setNode(node);
+ *
+ * The port never blocks; it only exposes the frames the host has routed to it, and it accepts a limited number
+ * of TX frames per host spin round so that no single node can monopolize the shared bus.
+ * The node must be spun exclusively via the host.
+ */
+class UAVCAN_EXPORT MultiNodeHostPort : public ICanDriver
+                                      , public LinkedListNode<MultiNodeHostPort>
+{
+    friend class MultiNodeHost;
+
+    class Iface : public ICanIface
+    {
+        MultiNodeHostPort* port_;
+        uint8_t index_;
+
+    public:
+        Iface()
+            : port_(UAVCAN_NULLPTR)
+            , index_(0)
+        { }
+
+        void init(MultiNodeHostPort* port, uint8_t index)
+        {
+            port_ = port;
+            index_ = index;
+        }
+
+        virtual int16_t send(const CanFrame& frame, MonotonicTime tx_deadline, CanIOFlags flags);
+
+        virtual int16_t receive(CanFrame& out_frame, MonotonicTime& out_ts_monotonic, UtcTime& out_ts_utc,
+                                CanIOFlags& out_flags);
+
+        /// Filtering is performed by the host, so the node-side filter configuration is ignored
+        virtual int16_t configureFilters(const CanFilterConfig*, uint16_t) { return 0; }
+        virtual uint16_t getNumFilters() const { return 0; }
+        virtual uint64_t getErrorCount() const { return 0; }
+    };
+
+    struct RxQueueEntry
+    {
+        RxQueueEntry* next;
+        CanRxFrame frame;
+        CanIOFlags flags;
+
+        RxQueueEntry(const CanRxFrame& arg_frame, CanIOFlags arg_flags)
+            : next(UAVCAN_NULLPTR)
+            , frame(arg_frame)
+            , flags(arg_flags)
+        {
+            IsDynamicallyAllocatable<RxQueueEntry>::check();
+        }
+    };
+
+    MultiNodeHost& host_;
+    INode* node_;
+    Iface ifaces_[MaxCanIfaces];
+    RxQueueEntry* rx_head_[MaxCanIfaces];
+    RxQueueEntry* rx_tail_[MaxCanIfaces];
+    uint16_t rx_queue_len_;
+    uint16_t tx_credits_[MaxCanIfaces];
+    uint32_t listener_revision_;
+    NodeID node_id_;
+    bool receives_all_;
+    bool index_valid_;
+    uint64_t rx_frames_dropped_;
+
+    bool pushRx(const CanRxFrame& frame, CanIOFlags flags);
+    int16_t popRx(uint8_t iface_index, CanFrame& out_frame, MonotonicTime& out_ts_monotonic, UtcTime& out_ts_utc,
+                  CanIOFlags& out_flags);
+    void clearRx();
+
+    bool hasPendingRx() const;
+    bool needsSpin(MonotonicTime ts) const;
+
+public:
+    explicit MultiNodeHostPort(MultiNodeHost& host);
+    virtual ~MultiNodeHostPort();
+
+    /**
+     * Binds the node that uses this port as its CAN driver.
+     * Until the node is bound, the port receives all traffic and the host does not spin it.
+     */
+    void setNode(INode& node);
+    INode* getNode() const { return node_; }
+
+    /**
+     * Number of frames pending in the RX queue of this port, all interfaces combined.
+     */
+    unsigned getRxQueueLength() const { return rx_queue_len_; }
+
+    /**
+     * Number of frames that were not delivered to this port because its RX queue was full
+     * or the host ran out of memory.
+     */
+    uint64_t getRxFramesDropped() const { return rx_frames_dropped_; }
+
+    /**
+     * Whether this port has to receive every frame regardless of its destination and data type.
+     * This is the case for unbound ports, and for nodes with an RX frame listener or a wildcard transfer listener.
+     */
+    bool receivesAllFrames() const { return receives_all_; }
+
+    virtual ICanIface* getIface(uint8_t iface_index);
+    virtual const ICanIface* getIface(uint8_t iface_index) const;
+    virtual uint8_t getNumIfaces() const;
+    virtual int16_t select(CanSelectMasks& inout_masks, const CanFrame* (& pending_tx)[MaxCanIfaces],
+                           MonotonicTime blocking_deadline);
+};
+
+/**
+ * Hosts many logical nodes on one physical CAN bus.
+ *
+ * Without the host, every node owns a driver instance that receives and filters all bus traffic, so the
+ * CPU time grows as (bus load * number of nodes). The host instead receives and parses each frame once,
+ * and delivers it only to the nodes that can accept it:
+ *  - unicast frames go to the node with the matching node ID;
+ *  - broadcast messages go to the nodes that subscribe to the data type, via a subscription index;
+ *  - loopback frames go back to the node that sent them;
+ *  - nodes that receive all frames (see @ref MultiNodeHostPort::receivesAllFrames()) get everything.
+ *
+ * All nodes transmit through one shared TX queue, which is ordered by CAN priority like the bus itself.
+ * To keep one chatty node from starving the others, every port can transmit at most a fixed number of frames
+ * per interface per spin round; the excess stays in the node's own TX queue until the next round.
+ * Frames transmitted by one hosted node are also delivered to the other hosted nodes as if they were received
+ * from the bus, because the real driver does not echo them back.
+ *
+ * The subscription index and the node ID table are refreshed once per spin round from the dispatcher's
+ * listener revision counters; the per-round bookkeeping is O(number of nodes), the per-frame cost is
+ * O(number of recipients).
+ */
+class UAVCAN_EXPORT MultiNodeHost : Noncopyable
+{
+    friend class MultiNodeHostPort;
+
+    enum { SubscriptionIndexSize = 32 };
+
+    struct Subscription
+    {
+        Subscription* next;
+        MultiNodeHostPort* port;
+        uint16_t data_type_id;
+
+        Subscription(MultiNodeHostPort* arg_port, uint16_t arg_data_type_id)
+            : next(UAVCAN_NULLPTR)
+            , port(arg_port)
+            , data_type_id(arg_data_type_id)
+        {
+            IsDynamicallyAllocatable<Subscription>::check();
+        }
+    };
+
+    CanIOManager canio_;
+    ISystemClock& sysclock_;
+    IPoolAllocator& allocator_;
+    LinkedListRoot<MultiNodeHostPort> ports_;
+    MultiNodeHostPort* ports_by_node_id_[NodeID::Max + 1];
+    Subscription* subscriptions_[SubscriptionIndexSize];
+    unsigned num_promiscuous_ports_;
+    uint16_t tx_frames_per_round_;
+    uint16_t rx_queue_capacity_;
+    uint64_t frames_routed_;
+    uint64_t frames_delivered_;
+
+    static unsigned computeSubscriptionBucket(uint16_t data_type_id)
+    {
+        return data_type_id & (SubscriptionIndexSize - 1U);
+    }
+
+    void addPort(MultiNodeHostPort* port);
+    void removePort(MultiNodeHostPort* port);
+
+    void removeSubscriptions(MultiNodeHostPort* port);
+    bool addSubscriptions(MultiNodeHostPort* port);
+    void setPortReceivesAll(MultiNodeHostPort* port, bool receives_all);
+    void refreshPort(MultiNodeHostPort* port);
+    void refreshPorts();
+
+    void deliver(MultiNodeHostPort* port, const CanRxFrame& frame, CanIOFlags flags);
+    void route(const CanRxFrame& frame, CanIOFlags flags, const MultiNodeHostPort* origin);
+
+    int16_t sendFromPort(MultiNodeHostPort* port, uint8_t iface_index, const CanFrame& frame,
+                         MonotonicTime tx_deadline, CanIOFlags flags);
+
+    int receiveAndRoute(MonotonicTime blocking_deadline);
+    int spinPorts();
+    MonotonicTime computeNextDeadline(MonotonicTime spin_deadline) const;
+
+public:
+    enum { DefaultTxFramesPerRound = 4 };
+    enum { DefaultRxQueueCapacity = 32 };
+
+    /**
+     * @param can_driver    The real CAN driver. It must not be used by anything else.
+     * @param system_clock  The system clock; it is shared with the hosted nodes.
+     * @param allocator     Allocator for the shared TX queue, the per-port RX queues and the subscription index.
+     */
+    MultiNodeHost(ICanDriver& can_driver, ISystemClock& system_clock, IPoolAllocator& allocator);
+    ~MultiNodeHost();
+
+    /**
+     * Receives and routes all pending frames, then spins every hosted node that has something to do:
+     * pending RX frames, pending TX frames, or an expired deadline.
+     * Returns the number of frames received from the bus, or a negative error code.
+     */
+    int spinOnce();
+
+    /**
+     * Same as @ref spinOnce(), but blocks on the real driver until the deadline is reached.
+     * The blocking is interrupted as soon as any hosted node has a deadline to serve.
+     * Returns negative error code.
+     */
+    int spin(MonotonicTime deadline);
+    int spin(MonotonicDuration duration) { return spin(sysclock_.getMonotonic() + duration); }
+
+    /**
+     * Maximum number of frames a port can transmit per interface per spin round.
+     * Lower values make the arbitration between hosted nodes more fair, at the cost of throughput of each node.
+     */
+    uint16_t getTxFramesPerRound() const { return tx_frames_per_round_; }
+    void setTxFramesPerRound(uint16_t num_frames) { tx_frames_per_round_ = max<uint16_t>(num_frames, 1U); }
+
+    /**
+     * Maximum number of frames pending in the RX queue of each port, all interfaces combined.
+     * Frames that don't fit are dropped and accounted in @ref MultiNodeHostPort::getRxFramesDropped().
+     */
+    uint16_t getRxQueueCapacity() const { return rx_queue_capacity_; }
+    void setRxQueueCapacity(uint16_t capacity) { rx_queue_capacity_ = max<uint16_t>(capacity, 1U); }
+
+    unsigned getNumPorts() const { return ports_.getLength(); }
+
+    /**
+     * Number of frames that went through the router: received from the bus or transmitted by a hosted node.
+     */
+    uint64_t getNumFramesRouted() const { return frames_routed_; }
+
+    /**
+     * Number of frames that were put into the RX queues of the hosted nodes.
+     * Without the host, this number would be (frames routed * number of nodes).
+     */
+    uint64_t getNumFramesDelivered() const { return frames_delivered_; }
+
+    const CanIOManager& getCanIOManager() const { return canio_; }
+    CanIOManager& getCanIOManager() { return canio_; }
+
+    ISystemClock& getSystemClock() { return sysclock_; }
+};
+
+}
+
+#endif // UAVCAN_NODE_MULTI_NODE_HOST_HPP_INCLUDED
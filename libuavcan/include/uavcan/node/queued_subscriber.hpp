@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_NODE_QUEUED_SUBSCRIBER_HPP_INCLUDED
+#define UAVCAN_NODE_QUEUED_SUBSCRIBER_HPP_INCLUDED
+
+#include <uavcan/build_config.hpp>
+#include <uavcan/node/generic_subscriber.hpp>
+#include <uavcan/util/linked_list.hpp>
+
+namespace uavcan
+{
+/**
+ * Non-generic part of @ref QueuedSubscriber; see it for details.
+ */
+class UAVCAN_EXPORT QueuedSubscriberBase : public GenericSubscriberBase
+{
+public:
+    /**
+     * Defines what happens to the received messages that have not been drained yet.
+     */
+    enum Policy
+    {
+        PolicyKeepAll,                  ///< New messages are dropped when the capacity is reached
+        PolicyKeepLatestPerSource,      ///< A new message replaces the queued one from the same source node
+        PolicyKeepLatest                ///< A new message replaces the queued one
+    };
+
+    static const uint16_t DefaultCapacity = 16;
+
+protected:
+    struct Entry : public LinkedListNode<Entry>
+    {
+        MonotonicTime ts_mono;
+        UtcTime ts_utc;
+        TransferBufferManagerEntry* payload;
+        uint8_t priority;
+        uint8_t transfer_id;
+        uint8_t src_node_id;
+        uint8_t iface_index;
+        bool anonymous;
+
+        Entry()
+            : payload(UAVCAN_NULLPTR)
+            , priority(0)
+            , transfer_id(0)
+            , src_node_id(0)
+            , iface_index(0)
+            , anonymous(false)
+        {
+            IsDynamicallyAllocatable<Entry>::check();
+        }
+
+        static void destroy(Entry*& obj, IPoolAllocator& allocator);
+    };
+
+    /**
+     * Presents a queued entry as a received transfer, so that it can be decoded as usual.
+     * The metadata is copied, so it remains accessible after the entry is destroyed; the payload does not.
+     */
+    class QueuedIncomingTransfer : public IncomingTransfer
+    {
+        const TransferBufferManagerEntry* const payload_;
+        const bool anonymous_;
+
+    public:
+        explicit QueuedIncomingTransfer(const Entry& entry)
+            : IncomingTransfer(entry.ts_mono, entry.ts_utc, TransferPriority(entry.priority),
+                               TransferTypeMessageBroadcast, TransferID(entry.transfer_id),
+                               NodeID(entry.src_node_id), entry.iface_index)
+            , payload_(entry.payload)
+            , anonymous_(entry.anonymous)
+        { }
+
+        virtual int read(unsigned offset, uint8_t* data, unsigned len) const;
+        virtual int peek(unsigned offset, const uint8_t*& out_data) const;
+        virtual bool isAnonymousTransfer() const { return anonymous_; }
+    };
+
+private:
+    LimitedPoolAllocator allocator_;
+    LinkedListRoot<Entry> queue_;
+    const Policy policy_;
+    const uint16_t capacity_;
+    uint16_t queue_len_;
+    uint32_t dropped_count_;
+    uint32_t conflated_count_;
+
+    Entry* findReplaceableEntry(NodeID src_node_id) const;
+    Entry* makeEntry(IncomingTransfer& transfer, uint16_t max_payload_len);
+
+protected:
+    QueuedSubscriberBase(INode& node, Policy policy, uint16_t capacity, std::size_t max_pool_blocks)
+        : GenericSubscriberBase(node)
+        , allocator_(node.getAllocator(), (max_pool_blocks > 0) ? max_pool_blocks :
+                                                                  node.getAllocator().getBlockCapacity())
+        , policy_(policy)
+        , capacity_((capacity > 0) ? capacity : uint16_t(1))
+        , queue_len_(0)
+        , dropped_count_(0)
+        , conflated_count_(0)
+    { }
+
+    ~QueuedSubscriberBase() { clear(); }
+
+    /**
+     * Copies the payload of the transfer into the queue according to the policy.
+     */
+    void enqueue(IncomingTransfer& transfer, uint16_t max_payload_len);
+
+    /**
+     * Removes the oldest entry from the queue; the caller must destroy it with @ref destroyEntry().
+     */
+    Entry* popFront();
+
+    void destroyEntry(Entry*& entry) { Entry::destroy(entry, allocator_); }
+
+public:
+    /**
+     * Discards all queued messages.
+     */
+    void clear();
+
+    Policy getPolicy() const { return policy_; }
+
+    /**
+     * Maximum number of queued messages; it doesn't apply to @ref PolicyKeepLatest.
+     */
+    uint16_t getCapacity() const { return capacity_; }
+
+    unsigned getQueueLength() const { return queue_len_; }
+    bool isQueueEmpty() const { return queue_.isEmpty(); }
+
+    /**
+     * Number of messages that were lost because the queue was full or the pool quota was exhausted.
+     */
+    uint32_t getDroppedCount() const { return dropped_count_; }
+
+    /**
+     * Number of queued messages that were replaced by newer ones according to the policy.
+     */
+    uint32_t getConflatedCount() const { return conflated_count_; }
+};
+
+/**
+ * Subscriber that doesn't invoke the application from the spin method. Instead, the received messages are stored
+ * in a bounded queue, and the application drains the queue in batches at its own pace:
+ *  subscriber.drain(callback, 10);     // Delivers up to 10 oldest messages
+ * This way, a slow message handler can't delay the processing of the other incoming transfers, and the behavior
+ * under overload is defined by the queue policy rather than by how fast the callbacks are.
+ *
+ * The queued messages are stored in the serialized form in the memory pool, and they are decoded when drained.
+ * The pool usage is limited by the specified number of blocks; note that every queued message takes at least
+ * three blocks. Messages that don't fit the queue are counted, see @ref getDroppedCount().
+ *
+ * This class is not thread safe. If the queue is drained from another thread, the application must make sure
+ * that drain() is never executed concurrently with the node's spin method, and that the pool allocator is
+ * thread safe.
+ *
+ * @tparam DataType_    Message data type.
+ */
+template <typename DataType_>
+class UAVCAN_EXPORT QueuedSubscriber : public QueuedSubscriberBase
+{
+public:
+    typedef DataType_ DataType;
+
+private:
+    typedef QueuedSubscriber<DataType_> SelfType;
+
+    enum { MaxPayloadLen = BitLenToByteLen<DataType::MaxBitLen>::Result };
+
+    class TransferForwarder : public TransferListener
+    {
+        SelfType& obj_;
+
+        void handleIncomingTransfer(IncomingTransfer& transfer)
+        {
+            obj_.enqueue(transfer, uint16_t(MaxPayloadLen));
+        }
+
+    public:
+        TransferForwarder(SelfType& obj, const DataTypeDescriptor& data_type, IPoolAllocator& allocator)
+            : TransferListener(obj.node_.getDispatcher().getTransferPerfCounter(), data_type,
+                               uint16_t(MaxPayloadLen), allocator)
+            , obj_(obj)
+        { }
+    };
+
+    struct ReceivedDataStructureSpec : public ReceivedDataStructure<DataType>
+    {
+        ReceivedDataStructureSpec(const IncomingTransfer* arg_transfer)
+            : ReceivedDataStructure<DataType>(arg_transfer)
+        { }
+    };
+
+    LazyConstructor<TransferForwarder> forwarder_;
+
+public:
+    /**
+     * @param node              Node instance this subscriber will be registered with.
+     *
+     * @param policy            See @ref Policy.
+     *
+     * @param capacity          Maximum number of queued messages.
+     *
+     * @param max_pool_blocks   Maximum number of pool blocks used by the queue; zero means no limit.
+     */
+    explicit QueuedSubscriber(INode& node, Policy policy = PolicyKeepAll, uint16_t capacity = DefaultCapacity,
+                              std::size_t max_pool_blocks = 0)
+        : QueuedSubscriberBase(node, policy, capacity, max_pool_blocks)
+    {
+        StaticAssert<DataTypeKind(DataType::DataTypeKind) == DataTypeKindMessage>::check();
+        StaticAssert<(unsigned(MaxPayloadLen) <= 0xFFFFU)>::check();
+    }
+
+    virtual ~QueuedSubscriber() { stop(); }
+
+    /**
+     * Begin receiving messages; a running subscription is restarted.
+     * Returns negative error code.
+     */
+    int start();
+
+    /**
+     * By default, anonymous transfers will be ignored.
+     * This option allows to enable reception of anonymous transfers; it must be set after every start().
+     */
+    void allowAnonymousTransfers()
+    {
+        forwarder_->allowAnonymousTransfers();
+    }
+
+    /**
+     * Terminate the subscription. The messages that are already queued are kept until drained or cleared.
+     */
+    void stop()
+    {
+        UAVCAN_TRACE("QueuedSubscriber", "Stop; dtname=%s", DataType::getDataTypeFullName());
+        GenericSubscriberBase::stop(forwarder_);
+        forwarder_.destroy();
+    }
+
+    /**
+     * Decodes the oldest queued messages and passes them to the callback, one by one.
+     * The callback accepts const ReceivedDataStructure<DataType>&; the reference is valid until it returns.
+     * Messages that could not be decoded are discarded and counted, see @ref getFailureCount().
+     * Returns the number of messages that were passed to the callback.
+     */
+    template <typename Callback>
+    unsigned drain(Callback callback, unsigned max_messages = 0xFFFFU);
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename DataType_>
+int QueuedSubscriber<DataType_>::start()
+{
+    stop();
+
+    GlobalDataTypeRegistry::instance().freeze();
+    const DataTypeDescriptor* const descr =
+        GlobalDataTypeRegistry::instance().find(DataTypeKindMessage, DataType::getDataTypeFullName());
+    if (descr == UAVCAN_NULLPTR)
+    {
+        UAVCAN_TRACE("QueuedSubscriber", "Type [%s] is not registered", DataType::getDataTypeFullName());
+        return -ErrUnknownDataType;
+    }
+
+    forwarder_.template construct<SelfType&, const DataTypeDescriptor&, IPoolAllocator&>
+        (*this, *descr, node_.getAllocator());
+
+    UAVCAN_TRACE("QueuedSubscriber", "Start; dtname=%s", DataType::getDataTypeFullName());
+    return GenericSubscriberBase::genericStart(forwarder_, &Dispatcher::registerMessageListener);
+}
+
+template <typename DataType_>
+template <typename Callback>
+unsigned QueuedSubscriber<DataType_>::drain(Callback callback, unsigned max_messages)
+{
+    unsigned num_delivered = 0;
+    while (num_delivered < max_messages)
+    {
+        Entry* entry = popFront();
+        if (entry == UAVCAN_NULLPTR)
+        {
+            break;
+        }
+
+        // The transfer keeps a copy of the metadata, so the entry can be destroyed before the callback is invoked
+        QueuedIncomingTransfer transfer(*entry);
+        ReceivedDataStructureSpec rx_struct(&transfer);
+        {
+            BitStream bitstream(transfer);
+            ScalarCodec codec(bitstream);
+            const int decode_res = DataType::decode(rx_struct, codec);
+            destroyEntry(entry);
+            if (decode_res <= 0)
+            {
+                UAVCAN_TRACE("QueuedSubscriber", "Unable to decode the message [%i] [%s]",
+                             decode_res, DataType::getDataTypeFullName());
+                failure_count_++;
+                continue;
+            }
+        }
+
+        callback(static_cast<const ReceivedDataStructure<DataType>&>(rx_struct));
+        num_delivered++;
+    }
+    return num_delivered;
+}
+
+}
+
+#endif // UAVCAN_NODE_QUEUED_SUBSCRIBER_HPP_INCLUDED
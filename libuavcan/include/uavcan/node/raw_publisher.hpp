@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_NODE_RAW_PUBLISHER_HPP_INCLUDED
+#define UAVCAN_NODE_RAW_PUBLISHER_HPP_INCLUDED
+
+#include <uavcan/node/generic_publisher.hpp>
+
+namespace uavcan
+{
+/**
+ * Publishes pre-serialized messages of any data type, e.g. for bridges and log players that forward
+ * the payloads without decoding them. The data type is defined by its ID and signature, so it doesn't
+ * need to be known at compile time nor registered in the global data type registry.
+ * The payload is fed into the CAN frames directly from the application buffer.
+ */
+class UAVCAN_EXPORT RawPublisher : protected GenericPublisherBase
+{
+public:
+    /**
+     * @param node          Node instance this publisher will be registered with.
+     *
+     * @param tx_timeout    Same as for @ref Publisher.
+     *
+     * @param max_transfer_interval     Same as for @ref Publisher.
+     */
+    explicit RawPublisher(INode& node, MonotonicDuration tx_timeout = getDefaultTxTimeout(),
+                          MonotonicDuration max_transfer_interval = TransferSender::getDefaultMaxTransferInterval())
+        : GenericPublisherBase(node, tx_timeout, max_transfer_interval)
+    { }
+
+    /**
+     * Must be called once before publishing. The signature is needed to compute the CRC of multi frame transfers.
+     * Returns negative error code.
+     */
+    int init(DataTypeID data_type_id, DataTypeSignature signature)
+    {
+        if (!data_type_id.isValidForDataTypeKind(DataTypeKindMessage))
+        {
+            return -ErrInvalidParam;
+        }
+        return doInit(DataTypeDescriptor(DataTypeKindMessage, data_type_id, signature, ""), CanTxQueue::Volatile);
+    }
+
+    /**
+     * Broadcast the serialized message.
+     * Returns negative error code.
+     */
+    int broadcast(const uint8_t* payload, unsigned payload_len)
+    {
+        if (!isInited())
+        {
+            return -ErrNotInited;
+        }
+        return genericPublish(payload, payload_len, TransferTypeMessageBroadcast, NodeID::Broadcast, UAVCAN_NULLPTR,
+                              MonotonicTime());
+    }
+
+    /**
+     * Same as above, with explicitly specified Transfer ID; see @ref Publisher::broadcast().
+     */
+    int broadcast(const uint8_t* payload, unsigned payload_len, TransferID tid)
+    {
+        if (!isInited())
+        {
+            return -ErrNotInited;
+        }
+        return genericPublish(payload, payload_len, TransferTypeMessageBroadcast, NodeID::Broadcast, &tid,
+                              MonotonicTime());
+    }
+
+    static MonotonicDuration getDefaultTxTimeout() { return MonotonicDuration::fromMSec(100); }
+
+    using GenericPublisherBase::allowAnonymousTransfers;
+    using GenericPublisherBase::getTransferSender;
+    using GenericPublisherBase::getMinTxTimeout;
+    using GenericPublisherBase::getMaxTxTimeout;
+    using GenericPublisherBase::getTxTimeout;
+    using GenericPublisherBase::setTxTimeout;
+    using GenericPublisherBase::getPriority;
+    using GenericPublisherBase::setPriority;
+    using GenericPublisherBase::getNode;
+};
+
+}
+
+#endif // UAVCAN_NODE_RAW_PUBLISHER_HPP_INCLUDED
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_NODE_RAW_SUBSCRIBER_HPP_INCLUDED
+#define UAVCAN_NODE_RAW_SUBSCRIBER_HPP_INCLUDED
+
+#include <uavcan/build_config.hpp>
+#include <uavcan/node/generic_subscriber.hpp>
+
+#if !defined(UAVCAN_CPP_VERSION) || !defined(UAVCAN_CPP11)
+# error UAVCAN_CPP_VERSION
+#endif
+
+#if UAVCAN_CPP_VERSION >= UAVCAN_CPP11
+# include <functional>
+#endif
+
+namespace uavcan
+{
+/**
+ * Receives messages of any data type without decoding them, e.g. for bridges and recorders.
+ * The data type is defined by its ID and signature, so it doesn't need to be known at compile time nor registered
+ * in the global data type registry.
+ *
+ * The received transfers are passed to the application as is; the payload can be read with
+ * IncomingTransfer::read(), or accessed in place with IncomingTransfer::peek(), which points directly into the
+ * received frame or into the reassembly buffer:
+ *  void callback(const IncomingTransfer& transfer)
+ *  {
+ *      const uint8_t* data = UAVCAN_NULLPTR;
+ *      unsigned offset = 0;
+ *      int len = 0;
+ *      while ((len = transfer.peek(offset, data)) > 0)
+ *      {
+ *          forward(data, len);
+ *          offset += len;
+ *      }
+ *  }
+ * The payload is only valid until the callback returns.
+ *
+ * @tparam Callback_        Type of the callback that will be used to deliver received transfers
+ *                          into the application. The argument is const IncomingTransfer&.
+ *                          In C++11 mode this type defaults to std::function<>.
+ *                          In C++03 mode this type defaults to a plain function pointer; use binder to
+ *                          call member functions as callbacks.
+ */
+template <
+#if UAVCAN_CPP_VERSION >= UAVCAN_CPP11
+          typename Callback_ = std::function<void (const IncomingTransfer&)>
+#else
+          typename Callback_ = void (*)(const IncomingTransfer&)
+#endif
+          >
+class UAVCAN_EXPORT RawSubscriber : public GenericSubscriberBase
+{
+public:
+    typedef Callback_ Callback;
+
+    /**
+     * Longer transfers are discarded, unless a different limit is passed to start().
+     */
+    static const uint16_t DefaultMaxPayloadLen = 1024;
+
+private:
+    typedef RawSubscriber<Callback_> SelfType;
+
+    class TransferForwarder : public TransferListener
+    {
+        SelfType& obj_;
+
+        void handleIncomingTransfer(IncomingTransfer& transfer)
+        {
+            obj_.handleIncomingTransfer(transfer);
+        }
+
+    public:
+        TransferForwarder(SelfType& obj, const DataTypeDescriptor& data_type, uint16_t max_buffer_size,
+                          IPoolAllocator& allocator)
+            : TransferListener(obj.node_.getDispatcher().getTransferPerfCounter(), data_type, max_buffer_size,
+                               allocator)
+            , obj_(obj)
+        { }
+    };
+
+    DataTypeDescriptor data_type_;      ///< The listener refers to this object
+    LazyConstructor<TransferForwarder> forwarder_;
+    Callback callback_;
+
+    void handleIncomingTransfer(IncomingTransfer& transfer)
+    {
+        if (coerceOrFallback<bool>(callback_, true))
+        {
+            callback_(static_cast<const IncomingTransfer&>(transfer));
+        }
+        else
+        {
+            handleFatalError("Sub clbk");
+        }
+    }
+
+public:
+    explicit RawSubscriber(INode& node)
+        : GenericSubscriberBase(node)
+        , callback_()
+    { }
+
+    virtual ~RawSubscriber() { stop(); }
+
+    /**
+     * Begin receiving messages of the specified data type; a running subscription is restarted.
+     * The signature is needed to check the CRC of multi frame transfers.
+     * Each message will be passed to the application via the callback.
+     * Returns negative error code.
+     */
+    int start(DataTypeID data_type_id, DataTypeSignature signature, const Callback& callback,
+              uint16_t max_payload_len = DefaultMaxPayloadLen);
+
+    /**
+     * By default, anonymous transfers will be ignored.
+     * This option allows to enable reception of anonymous transfers; it must be set after every start().
+     */
+    void allowAnonymousTransfers()
+    {
+        forwarder_->allowAnonymousTransfers();
+    }
+
+    /**
+     * Terminate the subscription.
+     * Dispatcher core will remove this instance from the subscribers list.
+     */
+    void stop()
+    {
+        UAVCAN_TRACE("RawSubscriber", "Stop; dtid=%u", unsigned(data_type_.getID().get()));
+        GenericSubscriberBase::stop(forwarder_);
+        forwarder_.destroy();
+    }
+
+    /**
+     * Data type of the current subscription.
+     */
+    const DataTypeDescriptor& getDataTypeDescriptor() const { return data_type_; }
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename Callback_>
+const uint16_t RawSubscriber<Callback_>::DefaultMaxPayloadLen;
+
+template <typename Callback_>
+int RawSubscriber<Callback_>::start(DataTypeID data_type_id, DataTypeSignature signature, const Callback& callback,
+                                    uint16_t max_payload_len)
+{
+    stop();
+
+    if (!coerceOrFallback<bool>(callback, true) || !data_type_id.isValidForDataTypeKind(DataTypeKindMessage))
+    {
+        UAVCAN_TRACE("RawSubscriber", "Invalid params");
+        return -ErrInvalidParam;
+    }
+    callback_ = callback;
+
+    data_type_ = DataTypeDescriptor(DataTypeKindMessage, data_type_id, signature, "");
+    forwarder_.template construct<SelfType&, const DataTypeDescriptor&, uint16_t, IPoolAllocator&>
+        (*this, data_type_, max_payload_len, node_.getAllocator());
+
+    UAVCAN_TRACE("RawSubscriber", "Start; dtid=%u", unsigned(data_type_id.get()));
+    return GenericSubscriberBase::genericStart(forwarder_, &Dispatcher::registerMessageListener);
+}
+
+}
+
+#endif // UAVCAN_NODE_RAW_SUBSCRIBER_HPP_INCLUDED
@@ -17,6 +17,7 @@ class UAVCAN_EXPORT Scheduler;
 class UAVCAN_EXPORT DeadlineHandler : public LinkedListNode<DeadlineHandler>
 {
     MonotonicTime deadline_;
+    MonotonicDuration slack_;
 
 protected:
     Scheduler& scheduler_;
@@ -38,6 +39,14 @@ public:
 
     bool isRunning() const;
 
+    /**
+     * Slack is how late the handler is allowed to be invoked past its deadline.
+     * The scheduler uses it to serve the deadlines that fall within each other's slack in one wakeup;
+     * the handler is never invoked before its deadline. Default is zero (no coalescing).
+     */
+    MonotonicDuration getSlack() const { return slack_; }
+    void setSlack(MonotonicDuration slack) { slack_ = max(slack, MonotonicDuration()); }
+
     MonotonicTime getDeadline() const { return deadline_; }
     Scheduler& getScheduler() const { return scheduler_; }
 };
@@ -46,8 +55,13 @@ public:
 class UAVCAN_EXPORT DeadlineScheduler : Noncopyable
 {
     LinkedListRoot<DeadlineHandler> handlers_;  // Ordered by deadline, lowest first
+    uint64_t num_coalesced_deadlines_;
 
 public:
+    DeadlineScheduler()
+        : num_coalesced_deadlines_(0)
+    { }
+
     void add(DeadlineHandler* mdh);
     void remove(DeadlineHandler* mdh);
     bool doesExist(const DeadlineHandler* mdh) const;
@@ -55,6 +69,19 @@ public:
 
     MonotonicTime pollAndGetMonotonicTime(ISystemClock& sysclock);
     MonotonicTime getEarliestDeadline() const;
+
+    /**
+     * The latest time the scheduler can wake up at without exceeding the slack of any handler.
+     * All handlers whose deadlines have passed by then are served in that one wakeup.
+     * Same as @ref getEarliestDeadline() if no handler has slack.
+     */
+    MonotonicTime getNextWakeupTime() const;
+
+    /**
+     * Number of handlers that were served ahead of their own wakeup because an earlier deadline was delayed
+     * within its slack, i.e. the number of wakeups saved. Always zero if no handler has slack.
+     */
+    uint64_t getNumCoalescedDeadlines() const { return num_coalesced_deadlines_; }
 };
 
 /**
@@ -0,0 +1,560 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_NODE_SERVICE_CALL_PIPELINE_HPP_INCLUDED
+#define UAVCAN_NODE_SERVICE_CALL_PIPELINE_HPP_INCLUDED
+
+#include <uavcan/build_config.hpp>
+#include <uavcan/node/service_client.hpp>
+#include <uavcan/util/method_binder.hpp>
+
+namespace uavcan
+{
+
+class ServiceCallPipelineBase;
+
+/**
+ * Non-generic part of @ref ServiceCallFuture; see it for details.
+ */
+class UAVCAN_EXPORT ServiceCallFutureBase : Noncopyable
+{
+    friend class ServiceCallPipelineBase;
+
+public:
+    enum State
+    {
+        StateIdle,          ///< Was never enqueued
+        StatePending,       ///< Enqueued or being executed
+        StateSucceeded,     ///< The response has been received
+        StateFailed         ///< All attempts have timed out, the deadline has expired, or the call was cancelled
+    };
+
+private:
+    ServiceCallPipelineBase* owner_;
+    NodeID server_node_id_;
+    State state_;
+    uint8_t num_attempts_;
+
+protected:
+    ServiceCallFutureBase()
+        : owner_(UAVCAN_NULLPTR)
+        , state_(StateIdle)
+        , num_attempts_(0)
+    { }
+
+    ~ServiceCallFutureBase();
+
+public:
+    State getState() const { return state_; }
+
+    /**
+     * Whether the call has completed, successfully or not.
+     */
+    bool isReady() const { return (state_ == StateSucceeded) || (state_ == StateFailed); }
+
+    bool isSuccessful() const { return state_ == StateSucceeded; }
+
+    NodeID getServerNodeID() const { return server_node_id_; }
+
+    /**
+     * Number of requests that have been sent so far, including the retries.
+     */
+    unsigned getNumAttempts() const { return num_attempts_; }
+};
+
+/**
+ * Future-like handle of a call executed by @ref ServiceCallPipeline.
+ * The object is owned by the application; the pipeline stores the outcome of the call in it once the call completes.
+ * If the future is destroyed while the call is pending, the call is still executed, but the outcome is only
+ * delivered through the callback of the pipeline.
+ * A future can be reused once the previous call has completed.
+ *
+ * @tparam DataType_    Service data type.
+ */
+template <typename DataType_>
+class UAVCAN_EXPORT ServiceCallFuture : public ServiceCallFutureBase
+{
+    template <typename, typename> friend class ServiceCallPipeline;
+
+public:
+    typedef DataType_ DataType;
+    typedef typename DataType::Response ResponseType;
+
+private:
+    ResponseType response_;
+
+public:
+    /**
+     * Value is undefined unless the call has succeeded.
+     */
+    const ResponseType& getResponse() const { return response_; }
+};
+
+/**
+ * Non-generic part of @ref ServiceCallPipeline; see it for details.
+ */
+class UAVCAN_EXPORT ServiceCallPipelineBase : Noncopyable
+{
+    friend class ServiceCallFutureBase;
+
+public:
+    enum { DefaultWindowSize = 8 };
+    enum { DefaultMaxAttempts = 3 };
+
+protected:
+    /**
+     * The request is stored serialized, so that a job takes a small number of pool blocks regardless of the
+     * size of the request structure. Every job takes one block for itself, plus, unless the request is empty,
+     * one block for the buffer and one block per ~50 bytes of the serialized request.
+     * Every attempt sends the stored request as is, see @ref StoredRequest.
+     */
+    struct Job : public LinkedListNode<Job>
+    {
+        MonotonicTime deadline;
+        TransferBufferManagerEntry* request;
+        ServiceCallFutureBase* future;
+        ServiceCallID call_id;              ///< Valid while the job is in flight
+        NodeID server_node_id;
+        uint8_t num_attempts;
+
+        Job()
+            : request(UAVCAN_NULLPTR)
+            , future(UAVCAN_NULLPTR)
+            , num_attempts(0)
+        {
+            IsDynamicallyAllocatable<Job>::check();
+        }
+    };
+
+    /**
+     * Copies the serialized request of a job into the transfer, without decoding it.
+     */
+    class StoredRequest : public ITransferPayloadSource
+    {
+        const TransferBufferManagerEntry* const request_;
+
+    public:
+        explicit StoredRequest(const TransferBufferManagerEntry* request) : request_(request) { }
+
+        virtual int writePayload(ITransferBuffer& sink) const;
+    };
+
+private:
+    IPoolAllocator& allocator_;
+    Job* queue_head_;                       ///< Jobs waiting for a free slot in the window, oldest first
+    Job* queue_tail_;
+    LinkedListRoot<Job> in_flight_;
+    MonotonicDuration call_deadline_;
+    unsigned queue_len_;
+    unsigned num_in_flight_;
+    uint32_t num_succeeded_;
+    uint32_t num_failed_;
+    uint32_t num_retries_;
+    uint16_t window_size_;
+    uint8_t max_attempts_;
+
+    void detachFuture(const ServiceCallFutureBase& future);
+
+protected:
+    explicit ServiceCallPipelineBase(IPoolAllocator& allocator)
+        : allocator_(allocator)
+        , queue_head_(UAVCAN_NULLPTR)
+        , queue_tail_(UAVCAN_NULLPTR)
+        , queue_len_(0)
+        , num_in_flight_(0)
+        , num_succeeded_(0)
+        , num_failed_(0)
+        , num_retries_(0)
+        , window_size_(DefaultWindowSize)
+        , max_attempts_(DefaultMaxAttempts)
+    { }
+
+    ~ServiceCallPipelineBase() { discardAllJobs(); }
+
+    /**
+     * Returns null if there's no memory.
+     */
+    Job* makeJob(NodeID server_node_id, MonotonicTime deadline, const StaticTransferBufferImpl* encoded_request);
+
+    void destroyJob(Job*& job);
+
+    void pushBack(Job* job);
+    void pushFront(Job* job);
+    Job* popFront();
+
+    void addInFlight(Job* job, ServiceCallID call_id);
+
+    /**
+     * Removes the job from the window and returns it; returns null if there's no such job.
+     */
+    Job* takeInFlight(ServiceCallID call_id);
+
+    bool canIssueMoreCalls() const { return (queue_head_ != UAVCAN_NULLPTR) && (num_in_flight_ < window_size_); }
+
+    /**
+     * Job outcome accounting, also updates the future if it is attached.
+     */
+    void registerSuccess(Job& job);
+    void registerFailure(Job& job);
+    void registerRetry() { num_retries_++; }
+
+    /**
+     * Marks the attached futures as failed and releases the memory. The calls in flight must be cancelled
+     * separately.
+     */
+    void discardAllJobs();
+
+    /**
+     * Attaches the future to the job; returns false if the future is already pending.
+     */
+    bool attachFuture(Job& job, ServiceCallFutureBase& future);
+
+public:
+    /**
+     * Maximum number of calls in flight. Lowering the window doesn't affect the calls that are already in flight.
+     */
+    uint16_t getWindowSize() const { return window_size_; }
+    void setWindowSize(uint16_t x) { window_size_ = (x > 0) ? x : uint16_t(1); }
+
+    /**
+     * Maximum number of requests sent per call, i.e. one plus the maximum number of retries.
+     * Only the timed out requests are retried; a call that can't be issued at all fails immediately.
+     */
+    uint8_t getMaxAttempts() const { return max_attempts_; }
+    void setMaxAttempts(uint8_t x) { max_attempts_ = (x > 0) ? x : uint8_t(1); }
+
+    /**
+     * Maximum time from enqueueing a call to its completion, including the time spent in the queue and the retries.
+     * Zero means no limit, which is the default; then the call time is only limited by the number of attempts.
+     * The change doesn't affect calls that are already enqueued.
+     */
+    MonotonicDuration getCallDeadline() const { return call_deadline_; }
+    void setCallDeadline(MonotonicDuration x) { call_deadline_ = x; }
+
+    /**
+     * Number of calls waiting for a free slot in the window.
+     */
+    unsigned getNumQueuedCalls() const { return queue_len_; }
+
+    unsigned getNumCallsInFlight() const { return num_in_flight_; }
+
+    /**
+     * Whether there are calls that are either queued or in flight.
+     */
+    bool hasPendingCalls() const { return (queue_len_ > 0) || (num_in_flight_ > 0); }
+
+    uint32_t getNumSucceededCalls() const { return num_succeeded_; }
+    uint32_t getNumFailedCalls() const { return num_failed_; }
+
+    /**
+     * Number of requests that have been re-sent after a timeout.
+     */
+    uint32_t getNumRetries() const { return num_retries_; }
+};
+
+/**
+ * Executes a queue of service calls of the same type to arbitrary servers, keeping up to a limited number of calls
+ * in flight at once. This is useful for fleet-wide queries, e.g. to request some data from every node on the bus:
+ * with the window of N calls, the query takes about one round trip time per N nodes rather than per node.
+ *
+ * Timed out calls are retried up to the configured number of attempts; optionally, the total duration of every call
+ * can be limited with a deadline. Retries are issued before the calls that have not been started yet.
+ *
+ * The outcome of every call is delivered through the callback, if one is configured, and through the future,
+ * if one was passed to @ref enqueue(). Failures are reported as @ref ServiceCallResult::ErrorTimeout; note that
+ * the call ID of a call that has failed without being issued has a meaningless transfer ID.
+ *
+ * Enqueued requests are stored serialized in the memory pool, see @ref Job.
+ *
+ * @tparam DataType_        Service data type.
+ *
+ * @tparam Callback_        Same as for @ref ServiceClient.
+ */
+template <typename DataType_,
+#if UAVCAN_CPP_VERSION >= UAVCAN_CPP11
+          typename Callback_ = std::function<void (const ServiceCallResult<DataType_>&)>
+#else
+          typename Callback_ = void (*)(const ServiceCallResult<DataType_>&)
+#endif
+          >
+class UAVCAN_EXPORT ServiceCallPipeline : public ServiceCallPipelineBase
+{
+public:
+    typedef DataType_ DataType;
+    typedef typename DataType::Request RequestType;
+    typedef typename DataType::Response ResponseType;
+    typedef ServiceCallResult<DataType> ServiceCallResultType;
+    typedef ServiceCallFuture<DataType> FutureType;
+    typedef Callback_ Callback;
+
+private:
+    typedef ServiceCallPipeline<DataType, Callback> SelfType;
+    typedef MethodBinder<SelfType*, void (SelfType::*)(const ServiceCallResultType&)> ClientCallback;
+
+    struct ZeroTransferBuffer : public StaticTransferBufferImpl
+    {
+        ZeroTransferBuffer() : StaticTransferBufferImpl(UAVCAN_NULLPTR, 0) { }
+    };
+
+    typedef typename Select<RequestType::MaxBitLen == 0,
+                            ZeroTransferBuffer,
+                            StaticTransferBuffer<BitLenToByteLen<RequestType::MaxBitLen>::Result> >::Result Buffer;
+
+    struct EmptyResponse : public ReceivedDataStructure<ResponseType>
+    {
+        EmptyResponse() { }
+    };
+
+    ServiceClient<DataType, ClientCallback> client_;
+    MonotonicDuration attempt_timeout_;
+    Callback callback_;
+    bool has_callback_;
+
+    void handleCallResult(const ServiceCallResultType& result);
+
+    void complete(Job* job, const ServiceCallResultType& result);
+
+    void failWithoutCall(Job* job);
+
+    int issue(Job& job);
+
+    void issueQueuedCalls();
+
+public:
+    /**
+     * @param node      Node instance this pipeline will be registered with.
+     */
+    explicit ServiceCallPipeline(INode& node)
+        : ServiceCallPipelineBase(node.getAllocator())
+        , client_(node, ClientCallback(this, &SelfType::handleCallResult))
+        , attempt_timeout_(client_.getRequestTimeout())
+        , callback_()
+        , has_callback_(false)
+    { }
+
+    /**
+     * @param node      Node instance this pipeline will be registered with.
+     * @param callback  Callback instance that will receive the outcome of every call.
+     */
+    ServiceCallPipeline(INode& node, const Callback& callback)
+        : ServiceCallPipelineBase(node.getAllocator())
+        , client_(node, ClientCallback(this, &SelfType::handleCallResult))
+        , attempt_timeout_(client_.getRequestTimeout())
+        , callback_(callback)
+        , has_callback_(true)
+    { }
+
+    ~ServiceCallPipeline() { cancelAllCalls(); }
+
+    /**
+     * Adds the call to the queue and issues it right away if the window allows.
+     * The future is optional; if provided, it must not be pending.
+     * Note that the callback may be invoked before this method returns.
+     * Returns negative error code.
+     */
+    int enqueue(NodeID server_node_id, const RequestType& request, FutureType* future = UAVCAN_NULLPTR);
+
+    /**
+     * Discards all queued calls and cancels the calls in flight. The callback will not be invoked;
+     * the attached futures will be marked failed.
+     */
+    void cancelAllCalls()
+    {
+        client_.cancelAllCalls();
+        discardAllJobs();
+    }
+
+    /**
+     * Callback that receives the outcome of every call; optional if futures are used.
+     */
+    void setCallback(const Callback& cb)
+    {
+        callback_ = cb;
+        has_callback_ = true;
+    }
+
+    /**
+     * Timeout of a single attempt; it's further limited by the call deadline, if configured.
+     * See @ref ServiceClient::setRequestTimeout().
+     */
+    MonotonicDuration getAttemptTimeout() const { return attempt_timeout_; }
+    void setAttemptTimeout(MonotonicDuration x)
+    {
+        client_.setRequestTimeout(x);
+        attempt_timeout_ = client_.getRequestTimeout();
+    }
+
+    /**
+     * Priority of the request transfers, see @ref ServiceClient::setPriority().
+     */
+    TransferPriority getPriority() const { return client_.getPriority(); }
+    void setPriority(const TransferPriority prio) { client_.setPriority(prio); }
+
+    /**
+     * See @ref ServiceClient::getResponseFailureCount().
+     */
+    uint32_t getResponseFailureCount() const { return client_.getResponseFailureCount(); }
+
+    INode& getNode() const { return client_.getNode(); }
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename DataType_, typename Callback_>
+void ServiceCallPipeline<DataType_, Callback_>::complete(Job* job, const ServiceCallResultType& result)
+{
+    if (result.isSuccessful())
+    {
+        if (job->future != UAVCAN_NULLPTR)
+        {
+            static_cast<FutureType*>(job->future)->response_ = result.getResponse();
+        }
+        registerSuccess(*job);
+    }
+    else
+    {
+        registerFailure(*job);
+    }
+    destroyJob(job);
+
+    if (has_callback_)
+    {
+        if (coerceOrFallback<bool>(callback_, true))
+        {
+            callback_(result);
+        }
+        else
+        {
+            handleFatalError("Srv pipeline clbk");
+        }
+    }
+}
+
+template <typename DataType_, typename Callback_>
+void ServiceCallPipeline<DataType_, Callback_>::failWithoutCall(Job* job)
+{
+    EmptyResponse response;
+    const ServiceCallResultType result(ServiceCallResultType::ErrorTimeout,
+                                       ServiceCallID(job->server_node_id, TransferID()), response);
+    complete(job, result);
+}
+
+template <typename DataType_, typename Callback_>
+int ServiceCallPipeline<DataType_, Callback_>::issue(Job& job)
+{
+    MonotonicDuration timeout = attempt_timeout_;
+    if (!job.deadline.isZero())
+    {
+        timeout = min(timeout, job.deadline - getNode().getMonotonicTime());
+    }
+    client_.setRequestTimeout(timeout);
+
+    ServiceCallID call_id;
+    const int res = client_.call(job.server_node_id, StoredRequest(job.request), call_id);
+    if (res >= 0)
+    {
+        job.num_attempts++;
+        addInFlight(&job, call_id);
+    }
+    return res;
+}
+
+template <typename DataType_, typename Callback_>
+void ServiceCallPipeline<DataType_, Callback_>::issueQueuedCalls()
+{
+    while (canIssueMoreCalls())
+    {
+        Job* const job = popFront();
+        UAVCAN_ASSERT(job != UAVCAN_NULLPTR);
+
+        if (!job->deadline.isZero() && (getNode().getMonotonicTime() >= job->deadline))
+        {
+            UAVCAN_TRACE("ServiceCallPipeline", "Deadline expired in the queue, nid=%d",
+                         int(job->server_node_id.get()));
+            failWithoutCall(job);
+            continue;
+        }
+
+        const int res = issue(*job);
+        if (res < 0)
+        {
+            UAVCAN_TRACE("ServiceCallPipeline", "Failed to call nid=%d: %d", int(job->server_node_id.get()), res);
+            failWithoutCall(job);
+        }
+    }
+}
+
+template <typename DataType_, typename Callback_>
+void ServiceCallPipeline<DataType_, Callback_>::handleCallResult(const ServiceCallResultType& result)
+{
+    Job* const job = takeInFlight(result.getCallID());
+    if (job == UAVCAN_NULLPTR)
+    {
+        UAVCAN_ASSERT(0);   // Calls of the private client are only issued and cancelled by this class
+        return;
+    }
+
+    const bool can_retry = !result.isSuccessful() &&
+                           (job->num_attempts < getMaxAttempts()) &&
+                           (job->deadline.isZero() || (getNode().getMonotonicTime() < job->deadline));
+    if (can_retry)
+    {
+        UAVCAN_TRACE("ServiceCallPipeline", "Retrying nid=%d, attempt %d",
+                     int(job->server_node_id.get()), int(job->num_attempts) + 1);
+        registerRetry();
+        pushFront(job);
+    }
+    else
+    {
+        complete(job, result);
+    }
+
+    issueQueuedCalls();
+}
+
+template <typename DataType_, typename Callback_>
+int ServiceCallPipeline<DataType_, Callback_>::enqueue(NodeID server_node_id, const RequestType& request,
+                                                      FutureType* future)
+{
+    if (!server_node_id.isUnicast() || (server_node_id == getNode().getNodeID()))
+    {
+        return -ErrInvalidParam;
+    }
+
+    const StaticTransferBufferImpl* encoded_request = UAVCAN_NULLPTR;
+    Buffer buffer;
+    if (RequestType::MaxBitLen > 0)
+    {
+        BitStream bitstream(buffer);
+        ScalarCodec codec(bitstream);
+        if (RequestType::encode(request, codec) <= 0)
+        {
+            return -ErrInvalidMarshalData;
+        }
+        encoded_request = &buffer;
+    }
+
+    const MonotonicTime deadline = getCallDeadline().isZero() ? MonotonicTime() :
+                                   (getNode().getMonotonicTime() + getCallDeadline());
+
+    Job* job = makeJob(server_node_id, deadline, encoded_request);
+    if (job == UAVCAN_NULLPTR)
+    {
+        return -ErrMemory;
+    }
+
+    if ((future != UAVCAN_NULLPTR) && !attachFuture(*job, *future))
+    {
+        destroyJob(job);
+        return -ErrInvalidParam;
+    }
+
+    pushBack(job);
+    issueQueuedCalls();
+    return 0;
+}
+
+}
+
+#endif // UAVCAN_NODE_SERVICE_CALL_PIPELINE_HPP_INCLUDED
@@ -6,7 +6,6 @@
 #define UAVCAN_NODE_SERVICE_CLIENT_HPP_INCLUDED
 
 #include <uavcan/build_config.hpp>
-#include <uavcan/util/multiset.hpp>
 #include <uavcan/node/generic_publisher.hpp>
 #include <uavcan/node/generic_subscriber.hpp>
 
@@ -123,6 +122,7 @@ protected:
     class CallState : DeadlineHandler
     {
         ServiceClientBase& owner_;
+        CallState* next_in_bucket_;
         const ServiceCallID id_;
         bool timed_out_;
 
@@ -132,6 +132,7 @@ protected:
         CallState(INode& node, ServiceClientBase& owner, ServiceCallID call_id)
             : DeadlineHandler(node.getScheduler())
             , owner_(owner)
+            , next_in_bucket_(UAVCAN_NULLPTR)
             , id_(call_id)
             , timed_out_(false)
         {
@@ -143,33 +144,82 @@ protected:
 
         bool hasTimedOut() const { return timed_out_; }
 
-        static bool hasTimedOutPredicate(const CallState& cs) { return cs.hasTimedOut(); }
+        CallState* getNextInBucket() const { return next_in_bucket_; }
+        void setNextInBucket(CallState* x) { next_in_bucket_ = x; }
+    };
+
+    /**
+     * Pending calls, hashed by (server node ID, transfer ID). Every call state takes one pool block.
+     * As long as the number of pending calls doesn't exceed the number of buckets, a call is found, accepted or
+     * cancelled in constant time on average, no matter whether the calls are addressed to one server or to many.
+     * See UAVCAN_SERVICE_CLIENT_CALL_BUCKETS.
+     */
+    class CallRegistry : ::uavcan::Noncopyable
+    {
+    public:
+        enum { NumBuckets = UAVCAN_SERVICE_CLIENT_CALL_BUCKETS };
 
-        bool operator==(const CallState& rhs) const
+        /**
+         * The multiplier is odd, so that the consecutive transfer IDs of one server fall into different buckets,
+         * as well as the calls to different servers that happen to use the same transfer ID.
+         */
+        static unsigned getBucketIndex(ServiceCallID call_id)
         {
-            return (&owner_ == &rhs.owner_) && (id_ == rhs.id_);
+            return (unsigned(call_id.server_node_id.get()) + unsigned(call_id.transfer_id.get()) * 37U) %
+                   unsigned(NumBuckets);
         }
-    };
 
-    struct CallStateMatchingPredicate
-    {
-        const ServiceCallID id;
-        CallStateMatchingPredicate(ServiceCallID reference) : id(reference) { }
-        bool operator()(const CallState& state) const { return (state.getCallID() == id) && !state.hasTimedOut(); }
-    };
+    private:
+        IPoolAllocator& allocator_;
+        CallState* buckets_[NumBuckets];
+        unsigned size_;
 
-    struct ServerSearchPredicate
-    {
-        const NodeID server_node_id;
-        ServerSearchPredicate(NodeID nid) : server_node_id(nid) { }
-        bool operator()(const CallState& state) const { return state.getCallID().server_node_id == server_node_id; }
+        void unlinkAndDestroy(CallState* state);
+
+    public:
+        explicit CallRegistry(IPoolAllocator& allocator);
+
+        ~CallRegistry() { clear(); }
+
+        /**
+         * Returns null if there's no memory.
+         */
+        CallState* add(INode& node, ServiceClientBase& owner, ServiceCallID call_id);
+
+        /**
+         * Calls that have timed out are ignored.
+         */
+        CallState* find(ServiceCallID call_id) const;
+
+        /**
+         * Calls that have timed out are ignored.
+         */
+        void remove(ServiceCallID call_id);
+
+        /**
+         * Removes one call that has timed out, looking in the buckets starting from the specified one.
+         * The bucket index is updated, so that the next invocation doesn't traverse the buckets that have
+         * no timed out calls left. Returns false if there are no more timed out calls.
+         */
+        bool removeNextTimedOut(unsigned& inout_bucket_index, ServiceCallID& out_call_id);
+
+        void clear();
+
+        bool hasCallToServer(NodeID server_node_id) const;
+
+        const CallState* getByIndex(unsigned index) const;
+
+        unsigned getSize() const { return size_; }
+        bool isEmpty() const { return size_ == 0; }
     };
 
+    CallRegistry call_registry_;
     MonotonicDuration request_timeout_;
 
     ServiceClientBase(INode& node)
         : DeadlineHandler(node.getScheduler())
         , data_type_descriptor_(UAVCAN_NULLPTR)
+        , call_registry_(node.getAllocator())
         , request_timeout_(getDefaultRequestTimeout())
     { }
 
@@ -231,34 +281,6 @@ private:
     typedef GenericPublisher<DataType, RequestType> PublisherType;
     typedef GenericSubscriber<DataType, ResponseType, TransferListenerWithFilter> SubscriberType;
 
-    typedef Multiset<CallState> CallRegistry;
-
-    struct TimeoutCallbackCaller
-    {
-        ServiceClient& owner;
-
-        TimeoutCallbackCaller(ServiceClient& arg_owner) : owner(arg_owner) { }
-
-        void operator()(const CallState& state)
-        {
-            if (state.hasTimedOut())
-            {
-                UAVCAN_TRACE("ServiceClient::TimeoutCallbackCaller", "Timeout from nid=%d, tid=%d, dtname=%s",
-                             int(state.getCallID().server_node_id.get()), int(state.getCallID().transfer_id.get()),
-                             DataType::getDataTypeFullName());
-
-                typename SubscriberType::ReceivedDataStructureSpec rx_struct; // Default-initialized
-
-                ServiceCallResultType result(ServiceCallResultType::ErrorTimeout, state.getCallID(),
-                                             rx_struct);    // Mutable!
-
-                owner.invokeCallback(result);
-            }
-        }
-    };
-
-    CallRegistry call_registry_;
-
     PublisherType publisher_;
     Callback callback_;
 
@@ -272,6 +294,11 @@ private:
 
     int addCallState(ServiceCallID call_id);
 
+    /**
+     * Everything that has to be done before the request is published; the call is not cancelled on failure.
+     */
+    int startCall(NodeID server_node_id, ServiceCallID& out_call_id);
+
 public:
     /**
      * @param node      Node instance this client will be registered with.
@@ -280,7 +307,6 @@ public:
     explicit ServiceClient(INode& node, const Callback& callback = Callback())
         : SubscriberType(node)
         , ServiceClientBase(node)
-        , call_registry_(node.getAllocator())
         , publisher_(node, getDefaultRequestTimeout())
         , callback_(callback)
     {
@@ -330,6 +356,12 @@ public:
      */
     int call(NodeID server_node_id, const RequestType& request, ServiceCallID& out_call_id);
 
+    /**
+     * Same as the overload above, but the request is passed serialized, so that a request that is sent repeatedly
+     * doesn't have to be serialized every time. See @ref GenericPublisher::publishSerialized().
+     */
+    int call(NodeID server_node_id, const ITransferPayloadSource& serialized_request, ServiceCallID& out_call_id);
+
     /**
      * Cancels certain call referred via call ID structure.
      */
@@ -347,7 +379,7 @@ public:
 
     /**
      * This method allows to traverse pending calls. If the index is out of range, an invalid call ID will be returned.
-     * Warning: average complexity is O(index); worst case complexity is O(size).
+     * Warning: complexity is O(size).
      */
     ServiceCallID getCallIDByIndex(unsigned index) const;
 
@@ -358,14 +390,16 @@ public:
     void setCallback(const Callback& cb) { callback_ = cb; }
 
     /**
-     * Complexity is O(N) of number of pending calls.
-     * Note that the number of pending calls will not be updated until the callback is executed.
+     * Complexity is O(1).
+     * A call is removed before its callback is executed, both when the response arrives and when it times out.
+     * A call that has timed out is still counted until the scheduler has processed the timeout.
      */
     unsigned getNumPendingCalls() const { return call_registry_.getSize(); }
 
     /**
      * Complexity is O(1).
-     * Note that the number of pending calls will not be updated until the callback is executed.
+     * A call is removed before its callback is executed, both when the response arrives and when it times out.
+     * A call that has timed out is still counted until the scheduler has processed the timeout.
      */
     bool hasPendingCalls() const { return !call_registry_.isEmpty(); }
 
@@ -420,9 +454,7 @@ bool ServiceClient<DataType_, Callback_>::shouldAcceptFrame(const RxFrame& frame
 {
     UAVCAN_ASSERT(frame.getTransferType() == TransferTypeServiceResponse); // Other types filtered out by dispatcher
 
-    return UAVCAN_NULLPTR != call_registry_.find(CallStateMatchingPredicate(ServiceCallID(frame.getSrcNodeID(),
-                                                                                          frame.getTransferID())));
-
+    return UAVCAN_NULLPTR != call_registry_.find(ServiceCallID(frame.getSrcNodeID(), frame.getTransferID()));
 }
 
 template <typename DataType_, typename Callback_>
@@ -442,15 +474,23 @@ void ServiceClient<DataType_, Callback_>::handleDeadline(MonotonicTime)
 {
     UAVCAN_TRACE("ServiceClient", "Shared deadline event received");
     /*
-     * Invoking callbacks for timed out call state objects.
+     * Removing timed out call state objects and invoking their callbacks.
+     * The callbacks are allowed to make new calls and to cancel other calls.
      */
-    TimeoutCallbackCaller callback_caller(*this);
-    call_registry_.template forEach<TimeoutCallbackCaller&>(callback_caller);
-    /*
-     * Removing timed out objects.
-     * This operation cannot be merged with the previous one because that will not work with recursive calls.
-     */
-    call_registry_.removeAllWhere(&CallState::hasTimedOutPredicate);
+    unsigned bucket_index = 0;
+    ServiceCallID call_id;
+    while (call_registry_.removeNextTimedOut(bucket_index, call_id))
+    {
+        UAVCAN_TRACE("ServiceClient", "Timeout from nid=%d, tid=%d, dtname=%s",
+                     int(call_id.server_node_id.get()), int(call_id.transfer_id.get()),
+                     DataType::getDataTypeFullName());
+
+        typename SubscriberType::ReceivedDataStructureSpec rx_struct; // Default-initialized
+
+        ServiceCallResultType result(ServiceCallResultType::ErrorTimeout, call_id, rx_struct);    // Mutable!
+
+        invokeCallback(result);
+    }
     /*
      * Subscriber does not need to be registered if we don't have any pending calls.
      * Removing it makes processing of incoming frames a bit faster.
@@ -474,8 +514,7 @@ int ServiceClient<DataType_, Callback_>::addCallState(ServiceCallID call_id)
         }
     }
 
-    if (UAVCAN_NULLPTR == call_registry_.template emplace<INode&, ServiceClientBase&,
-                                                          ServiceCallID>(SubscriberType::getNode(), *this, call_id))
+    if (UAVCAN_NULLPTR == call_registry_.add(SubscriberType::getNode(), *this, call_id))
     {
         SubscriberType::stop();
         return -ErrMemory;
@@ -492,8 +531,7 @@ int ServiceClient<DataType_, Callback_>::call(NodeID server_node_id, const Reque
 }
 
 template <typename DataType_, typename Callback_>
-int ServiceClient<DataType_, Callback_>::call(NodeID server_node_id, const RequestType& request,
-                                              ServiceCallID& out_call_id)
+int ServiceClient<DataType_, Callback_>::startCall(NodeID server_node_id, ServiceCallID& out_call_id)
 {
     if (!coerceOrFallback<bool>(callback_, true))
     {
@@ -535,25 +573,52 @@ int ServiceClient<DataType_, Callback_>::call(NodeID server_node_id, const Reque
     }
     tl->installAcceptanceFilter(this);
 
-    /*
-     * Publishing the request
-     */
+    UAVCAN_ASSERT(server_node_id == out_call_id.server_node_id);
+    return 0;
+}
+
+template <typename DataType_, typename Callback_>
+int ServiceClient<DataType_, Callback_>::call(NodeID server_node_id, const RequestType& request,
+                                              ServiceCallID& out_call_id)
+{
+    const int start_res = startCall(server_node_id, out_call_id);
+    if (start_res < 0)
+    {
+        return start_res;
+    }
+
     const int publisher_res = publisher_.publish(request, TransferTypeServiceRequest, server_node_id,
                                                  out_call_id.transfer_id);
     if (publisher_res < 0)
     {
         cancelCall(out_call_id);
-        return publisher_res;
     }
+    return publisher_res;
+}
 
-    UAVCAN_ASSERT(server_node_id == out_call_id.server_node_id);
+template <typename DataType_, typename Callback_>
+int ServiceClient<DataType_, Callback_>::call(NodeID server_node_id, const ITransferPayloadSource& serialized_request,
+                                              ServiceCallID& out_call_id)
+{
+    const int start_res = startCall(server_node_id, out_call_id);
+    if (start_res < 0)
+    {
+        return start_res;
+    }
+
+    const int publisher_res = publisher_.publishSerialized(serialized_request, TransferTypeServiceRequest,
+                                                           server_node_id, out_call_id.transfer_id);
+    if (publisher_res < 0)
+    {
+        cancelCall(out_call_id);
+    }
     return publisher_res;
 }
 
 template <typename DataType_, typename Callback_>
 void ServiceClient<DataType_, Callback_>::cancelCall(ServiceCallID call_id)
 {
-    call_registry_.removeFirstWhere(CallStateMatchingPredicate(call_id));
+    call_registry_.remove(call_id);
     if (call_registry_.isEmpty())
     {
         SubscriberType::stop();
@@ -570,7 +635,7 @@ void ServiceClient<DataType_, Callback_>::cancelAllCalls()
 template <typename DataType_, typename Callback_>
 bool ServiceClient<DataType_, Callback_>::hasPendingCallToServer(NodeID server_node_id) const
 {
-    return UAVCAN_NULLPTR != call_registry_.find(ServerSearchPredicate(server_node_id));
+    return call_registry_.hasCallToServer(server_node_id);
 }
 
 template <typename DataType_, typename Callback_>
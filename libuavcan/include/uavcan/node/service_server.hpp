@@ -8,6 +8,8 @@
 #include <uavcan/build_config.hpp>
 #include <uavcan/node/generic_publisher.hpp>
 #include <uavcan/node/generic_subscriber.hpp>
+#include <uavcan/util/linked_list.hpp>
+#include <uavcan/dynamic_memory.hpp>
 
 #if !defined(UAVCAN_CPP_VERSION) || !defined(UAVCAN_CPP11)
 # error UAVCAN_CPP_VERSION
@@ -61,12 +63,117 @@ public:
     bool isResponseEnabled() const { return _enabled_; }
 };
 
+/**
+ * Identifies a service request whose response has been deferred, see @ref ServiceServer::deferResponse().
+ * The token is a plain value; it can be copied and stored anywhere until the response is sent.
+ */
+class UAVCAN_EXPORT ServiceResponseToken
+{
+    MonotonicTime deadline_;
+    NodeID client_node_id_;
+    TransferID transfer_id_;
+    TransferPriority priority_;
+
+public:
+    ServiceResponseToken() { }
+
+    ServiceResponseToken(NodeID client_node_id, TransferID transfer_id, TransferPriority priority,
+                         MonotonicTime deadline)
+        : deadline_(deadline)
+        , client_node_id_(client_node_id)
+        , transfer_id_(transfer_id)
+        , priority_(priority)
+    { }
+
+    NodeID getClientNodeID() const { return client_node_id_; }
+    TransferID getTransferID() const { return transfer_id_; }
+    TransferPriority getPriority() const { return priority_; }
+
+    /**
+     * The response will not be sent after this moment, since the client is likely to have given up by then.
+     */
+    MonotonicTime getDeadline() const { return deadline_; }
+
+    bool isValid() const { return client_node_id_.isUnicast(); }
+
+    bool operator==(const ServiceResponseToken& rhs) const
+    {
+        return (client_node_id_ == rhs.client_node_id_) && (transfer_id_ == rhs.transfer_id_);
+    }
+};
+
+/**
+ * Bounded storage of the tokens of deferred responses; internal for @ref ServiceServer.
+ * Every outstanding token takes one pool block. Expired tokens are removed when the storage is accessed.
+ */
+class UAVCAN_EXPORT DeferredResponseRegistry : Noncopyable
+{
+    struct Entry : public LinkedListNode<Entry>
+    {
+        ServiceResponseToken token;
+
+        explicit Entry(const ServiceResponseToken& arg_token)
+            : token(arg_token)
+        {
+            IsDynamicallyAllocatable<Entry>::check();
+        }
+    };
+
+    IPoolAllocator& allocator_;
+    LinkedListRoot<Entry> list_;
+    uint16_t size_;
+    uint16_t capacity_;
+
+    void destroy(Entry* entry);
+
+public:
+    DeferredResponseRegistry(IPoolAllocator& allocator, uint16_t capacity)
+        : allocator_(allocator)
+        , size_(0)
+        , capacity_(capacity)
+    { }
+
+    ~DeferredResponseRegistry() { clear(); }
+
+    /**
+     * Returns -ErrMemory if the capacity is exhausted or the pool is out of memory.
+     */
+    int add(const ServiceResponseToken& token, MonotonicTime current_time);
+
+    /**
+     * Returns false if there is no such token or it has expired.
+     */
+    bool remove(const ServiceResponseToken& token, MonotonicTime current_time);
+
+    void removeExpired(MonotonicTime current_time);
+
+    void clear();
+
+    uint16_t getSize() const { return size_; }
+
+    uint16_t getCapacity() const { return capacity_; }
+    void setCapacity(uint16_t x) { capacity_ = x; }
+};
+
 /**
  * Use this class to implement UAVCAN service servers.
  *
  * Note that the references passed to the callback may point to stack-allocated objects, which means that the
  * references get invalidated once the callback returns.
  *
+ * If the response can't be produced right away, e.g. because it depends on slow storage or another node, the
+ * callback can defer it instead of blocking the spin loop:
+ *
+ *  void handleRequest(const ReceivedDataStructure<Foo::Request>& request,
+ *                     ServiceResponseDataStructure<Foo::Response>& response)
+ *  {
+ *      ServiceResponseToken token;
+ *      if (server.deferResponse(request, response, token) >= 0)
+ *      {
+ *          startLookup(request, token);      // Will call server.respond(token, ...) once done
+ *      }
+ *  }
+ *
  * @tparam DataType_        Service data type.
  *
  * @tparam Callback_        Service calls will be delivered through the callback of this type, and service
@@ -102,8 +209,25 @@ private:
 
     PublisherType publisher_;
     Callback callback_;
+    DeferredResponseRegistry deferred_responses_;
+    MonotonicDuration deferred_response_timeout_;
     uint32_t response_failure_count_;
 
+    int publishResponse(const ResponseType& response, NodeID client_node_id, TransferID transfer_id,
+                        TransferPriority priority)
+    {
+        publisher_.setPriority(priority);      // Responding at the same priority.
+
+        const int res = publisher_.publish(response, TransferTypeServiceResponse, client_node_id, transfer_id);
+        if (res < 0)
+        {
+            UAVCAN_TRACE("ServiceServer", "Response publication failure: %i", res);
+            publisher_.getNode().getDispatcher().getTransferPerfCounter().addError();
+            response_failure_count_++;
+        }
+        return res;
+    }
+
     virtual void handleReceivedDataStruct(ReceivedDataStructure<RequestType>& request)
     {
         UAVCAN_ASSERT(request.getTransferType() == TransferTypeServiceRequest);
@@ -122,16 +246,7 @@ private:
 
         if (response.isResponseEnabled())
         {
-            publisher_.setPriority(request.getPriority());      // Responding at the same priority.
-
-            const int res = publisher_.publish(response, TransferTypeServiceResponse, request.getSrcNodeID(),
-                                               request.getTransferID());
-            if (res < 0)
-            {
-                UAVCAN_TRACE("ServiceServer", "Response publication failure: %i", res);
-                publisher_.getNode().getDispatcher().getTransferPerfCounter().addError();
-                response_failure_count_++;
-            }
+            (void)publishResponse(response, request.getSrcNodeID(), request.getTransferID(), request.getPriority());
         }
         else
         {
@@ -144,6 +259,8 @@ public:
         : SubscriberType(node)
         , publisher_(node, getDefaultTxTimeout())
         , callback_()
+        , deferred_responses_(node.getAllocator(), DefaultMaxDeferredResponses)
+        , deferred_response_timeout_(getDefaultDeferredResponseTimeout())
         , response_failure_count_(0)
     {
         UAVCAN_ASSERT(getTxTimeout() == getDefaultTxTimeout());  // Making sure it is valid
@@ -180,6 +297,82 @@ public:
      */
     using SubscriberType::stop;
 
+    /**
+     * Defers the response to the request that is being processed; must be called from the request callback.
+     * The response passed to the callback will not be sent; instead, the application shall send the response
+     * later with @ref respond(), using the returned token. The response must be sent from the same thread that
+     * spins the node, but it doesn't have to be done from a callback.
+     *
+     * The number of outstanding deferred responses is limited, see @ref setMaxDeferredResponses(); the responses
+     * that have not been sent before the deadline are discarded and don't count towards the limit.
+     *
+     * Returns negative error code; in case of failure, the response passed to the callback will be sent as usual.
+     */
+    int deferResponse(const ReceivedDataStructure<RequestType>& request,
+                      ServiceResponseDataStructure<ResponseType>& response,
+                      ServiceResponseToken& out_token)
+    {
+        const MonotonicTime now = publisher_.getNode().getMonotonicTime();
+        const MonotonicTime request_ts = request.getMonotonicTimestamp().isZero() ?
+                                         now : request.getMonotonicTimestamp();
+
+        const ServiceResponseToken token(request.getSrcNodeID(), request.getTransferID(), request.getPriority(),
+                                         request_ts + deferred_response_timeout_);
+        const int res = deferred_responses_.add(token, now);
+        if (res < 0)
+        {
+            UAVCAN_TRACE("ServiceServer", "Response can't be deferred: %i", res);
+            return res;
+        }
+        response.setResponseEnabled(false);
+        out_token = token;
+        return 0;
+    }
+
+    /**
+     * Sends the deferred response.
+     * Returns -ErrInvalidParam if the token is unknown, was already used, or has expired.
+     * Otherwise returns the result of the publication, like @ref Publisher.
+     */
+    int respond(const ServiceResponseToken& token, const ResponseType& response)
+    {
+        if (!deferred_responses_.remove(token, publisher_.getNode().getMonotonicTime()))
+        {
+            UAVCAN_TRACE("ServiceServer", "Unknown or expired response token");
+            return -ErrInvalidParam;
+        }
+        return publishResponse(response, token.getClientNodeID(), token.getTransferID(), token.getPriority());
+    }
+
+    /**
+     * Releases the token without sending the response; the client will time out.
+     */
+    void cancelDeferredResponse(const ServiceResponseToken& token)
+    {
+        (void)deferred_responses_.remove(token, publisher_.getNode().getMonotonicTime());
+    }
+
+    /**
+     * Number of deferred responses that have not been sent yet, including the expired ones that have not been
+     * cleaned up yet.
+     */
+    unsigned getNumDeferredResponses() const { return deferred_responses_.getSize(); }
+
+    /**
+     * Limit of outstanding deferred responses; every one takes a pool block.
+     */
+    enum { DefaultMaxDeferredResponses = 8 };
+    uint16_t getMaxDeferredResponses() const { return deferred_responses_.getCapacity(); }
+    void setMaxDeferredResponses(uint16_t x) { deferred_responses_.setCapacity(x); }
+
+    /**
+     * Time since the reception of the request after which the deferred response can no longer be sent.
+     * Should match the request timeout of the clients, which is 1 second by default.
+     */
+    static MonotonicDuration getDefaultDeferredResponseTimeout() { return MonotonicDuration::fromMSec(1000); }
+    MonotonicDuration getDeferredResponseTimeout() const { return deferred_response_timeout_; }
+    void setDeferredResponseTimeout(MonotonicDuration x) { deferred_response_timeout_ = x; }
+
     static MonotonicDuration getDefaultTxTimeout() { return MonotonicDuration::fromMSec(1000); }
     static MonotonicDuration getMinTxTimeout() { return PublisherType::getMinTxTimeout(); }
     static MonotonicDuration getMaxTxTimeout() { return PublisherType::getMaxTxTimeout(); }
@@ -97,6 +97,35 @@ public:
     using BaseType::allowAnonymousTransfers;
     using BaseType::stop;
     using BaseType::getFailureCount;
+    using BaseType::setFieldMask;
+    using BaseType::getFieldMask;
+};
+
+/**
+ * Same as @ref Subscriber, except that multi frame transfers are decoded frame by frame as they arrive,
+ * rather than being reassembled in the memory pool first. This reduces the pool usage and the reception latency
+ * at the cost of keeping an instance of the data structure inside the subscriber object.
+ *
+ * Only one transfer at a time is decoded this way; transfers from other nodes that arrive concurrently are
+ * buffered as usual. Partially decoded data is discarded if the transfer times out or its CRC is wrong.
+ */
+template <typename DataType_,
+#if UAVCAN_CPP_VERSION >= UAVCAN_CPP11
+          typename Callback_ = std::function<void (const ReceivedDataStructure<DataType_>&)>
+#else
+          typename Callback_ = void (*)(const ReceivedDataStructure<DataType_>&)
+#endif
+          >
+class UAVCAN_EXPORT StreamingSubscriber : public Subscriber<DataType_, Callback_>
+{
+    typename Subscriber<DataType_, Callback_>::StreamDecoder decoder_;
+
+public:
+    explicit StreamingSubscriber(INode& node)
+        : Subscriber<DataType_, Callback_>(node)
+    {
+        this->setStreamDecoder(&decoder_);
+    }
 };
 
 }
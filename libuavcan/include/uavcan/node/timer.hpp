@@ -55,6 +55,14 @@ public:
     using DeadlineHandler::getDeadline;
     using DeadlineHandler::getScheduler;
 
+    /**
+     * Allows the scheduler to delay the event by up to the slack, in order to serve it together with other
+     * deadlines. Housekeeping timers should use it. @ref TimerEvent::scheduled_time is not affected by the slack,
+     * and periodic timers do not accumulate the delay.
+     */
+    using DeadlineHandler::getSlack;
+    using DeadlineHandler::setSlack;
+
     explicit TimerBase(INode& node)
         : DeadlineHandler(node.getScheduler())
         , period_(MonotonicDuration::getInfinite())
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_NODE_VIEW_SUBSCRIBER_HPP_INCLUDED
+#define UAVCAN_NODE_VIEW_SUBSCRIBER_HPP_INCLUDED
+
+#include <uavcan/build_config.hpp>
+#include <uavcan/node/generic_subscriber.hpp>
+
+#if !defined(UAVCAN_CPP_VERSION) || !defined(UAVCAN_CPP11)
+# error UAVCAN_CPP_VERSION
+#endif
+
+#if UAVCAN_CPP_VERSION >= UAVCAN_CPP11
+# include <functional>
+#endif
+
+namespace uavcan
+{
+/**
+ * Undecoded received message: the generated view type of the message (DataType_::View) over the transfer payload,
+ * extended with the extra information obtained from the transport layer, like @ref ReceivedDataStructure.
+ *
+ * The view reads the primitive fields of the fixed layout prefix of the message directly from the payload, e.g.:
+ *  void callback(const ReceivedDataView<protocol::NodeStatus>& view)
+ *  {
+ *      if (view.health() != protocol::NodeStatus::HEALTH_OK)
+ *      {
+ *          protocol::NodeStatus msg;
+ *          if (view.materialize(msg) > 0) { ... }
+ *      }
+ *  }
+ *
+ * The object refers to the transfer payload, which is only valid until the callback returns.
+ */
+template <typename DataType_>
+class UAVCAN_EXPORT ReceivedDataView : public DataType_::View, Noncopyable
+{
+    const IncomingTransfer& transfer_;
+
+public:
+    typedef DataType_ DataType;
+
+    explicit ReceivedDataView(IncomingTransfer& transfer)
+        : DataType_::View(transfer)
+        , transfer_(transfer)
+    { }
+
+    MonotonicTime getMonotonicTimestamp() const { return transfer_.getMonotonicTimestamp(); }
+    UtcTime getUtcTimestamp()             const { return transfer_.getUtcTimestamp(); }
+    TransferPriority getPriority()        const { return transfer_.getPriority(); }
+    TransferType getTransferType()        const { return transfer_.getTransferType(); }
+    TransferID getTransferID()            const { return transfer_.getTransferID(); }
+    NodeID getSrcNodeID()                 const { return transfer_.getSrcNodeID(); }
+    uint8_t getIfaceIndex()               const { return transfer_.getIfaceIndex(); }
+    bool isAnonymousTransfer()            const { return transfer_.isAnonymousTransfer(); }
+};
+
+/**
+ * Same as @ref Subscriber, except that the messages are delivered undecoded, as @ref ReceivedDataView<>.
+ * This is cheaper when the application needs only a few fields of the messages, or only a fraction of the
+ * received messages (e.g. monitoring tools); the full message can still be decoded with materialize().
+ *
+ * Decoding errors are detected only by materialize(), so getFailureCount() does not count them.
+ *
+ * @tparam DataType_        Message data type.
+ *
+ * @tparam Callback_        Type of the callback that will be used to deliver received messages
+ *                          into the application. The argument is const ReceivedDataView<DataType_>&.
+ *                          In C++11 mode this type defaults to std::function<>.
+ *                          In C++03 mode this type defaults to a plain function pointer; use binder to
+ *                          call member functions as callbacks.
+ */
+template <typename DataType_,
+#if UAVCAN_CPP_VERSION >= UAVCAN_CPP11
+          typename Callback_ = std::function<void (const ReceivedDataView<DataType_>&)>
+#else
+          typename Callback_ = void (*)(const ReceivedDataView<DataType_>&)
+#endif
+          >
+class UAVCAN_EXPORT ViewSubscriber : public GenericSubscriberBase
+{
+public:
+    typedef DataType_ DataType;
+    typedef Callback_ Callback;
+
+private:
+    typedef ViewSubscriber<DataType_, Callback_> SelfType;
+
+    class TransferForwarder : public TransferListener
+    {
+        SelfType& obj_;
+
+        void handleIncomingTransfer(IncomingTransfer& transfer)
+        {
+            obj_.handleIncomingTransfer(transfer);
+        }
+
+    public:
+        TransferForwarder(SelfType& obj, const DataTypeDescriptor& data_type, uint16_t max_buffer_size,
+                          IPoolAllocator& allocator)
+            : TransferListener(obj.node_.getDispatcher().getTransferPerfCounter(), data_type, max_buffer_size,
+                               allocator)
+            , obj_(obj)
+        { }
+    };
+
+    LazyConstructor<TransferForwarder> forwarder_;
+    Callback callback_;
+
+    int checkInit();
+
+    void handleIncomingTransfer(IncomingTransfer& transfer)
+    {
+        ReceivedDataView<DataType> view(transfer);
+        if (coerceOrFallback<bool>(callback_, true))
+        {
+            callback_(view);
+        }
+        else
+        {
+            handleFatalError("Sub clbk");
+        }
+    }
+
+public:
+    explicit ViewSubscriber(INode& node)
+        : GenericSubscriberBase(node)
+        , callback_()
+    {
+        StaticAssert<DataTypeKind(DataType::DataTypeKind) == DataTypeKindMessage>::check();
+    }
+
+    virtual ~ViewSubscriber() { stop(); }
+
+    /**
+     * Begin receiving messages.
+     * Each message will be passed to the application via the callback.
+     * Returns negative error code.
+     */
+    int start(const Callback& callback);
+
+    /**
+     * By default, anonymous transfers will be ignored.
+     * This option allows to enable reception of anonymous transfers.
+     */
+    void allowAnonymousTransfers()
+    {
+        forwarder_->allowAnonymousTransfers();
+    }
+
+    /**
+     * Terminate the subscription.
+     * Dispatcher core will remove this instance from the subscribers list.
+     */
+    void stop()
+    {
+        UAVCAN_TRACE("ViewSubscriber", "Stop; dtname=%s", DataType::getDataTypeFullName());
+        GenericSubscriberBase::stop(forwarder_);
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename DataType_, typename Callback_>
+int ViewSubscriber<DataType_, Callback_>::checkInit()
+{
+    if (forwarder_)
+    {
+        return 0;
+    }
+
+    GlobalDataTypeRegistry::instance().freeze();
+    const DataTypeDescriptor* const descr =
+        GlobalDataTypeRegistry::instance().find(DataTypeKind(DataType::DataTypeKind), DataType::getDataTypeFullName());
+    if (descr == UAVCAN_NULLPTR)
+    {
+        UAVCAN_TRACE("ViewSubscriber", "Type [%s] is not registered", DataType::getDataTypeFullName());
+        return -ErrUnknownDataType;
+    }
+
+    static const uint16_t MaxBufferSize = BitLenToByteLen<DataType::MaxBitLen>::Result;
+
+    forwarder_.template construct<SelfType&, const DataTypeDescriptor&, uint16_t, IPoolAllocator&>
+        (*this, *descr, MaxBufferSize, node_.getAllocator());
+
+    return 0;
+}
+
+template <typename DataType_, typename Callback_>
+int ViewSubscriber<DataType_, Callback_>::start(const Callback& callback)
+{
+    stop();
+
+    if (!coerceOrFallback<bool>(callback, true))
+    {
+        UAVCAN_TRACE("ViewSubscriber", "Invalid callback");
+        return -ErrInvalidParam;
+    }
+    callback_ = callback;
+
+    const int res = checkInit();
+    if (res < 0)
+    {
+        UAVCAN_TRACE("ViewSubscriber", "Initialization failure [%s]", DataType::getDataTypeFullName());
+        return res;
+    }
+
+    UAVCAN_TRACE("ViewSubscriber", "Start; dtname=%s", DataType::getDataTypeFullName());
+    return GenericSubscriberBase::genericStart(forwarder_, &Dispatcher::registerMessageListener);
+}
+
+}
+
+#endif // UAVCAN_NODE_VIEW_SUBSCRIBER_HPP_INCLUDED
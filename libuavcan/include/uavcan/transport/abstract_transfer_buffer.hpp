@@ -7,6 +7,7 @@
 
 #include <uavcan/build_config.hpp>
 #include <uavcan/std.hpp>
+#include <uavcan/error.hpp>
 
 namespace uavcan
 {
@@ -20,6 +21,20 @@ public:
 
     virtual int read(unsigned offset, uint8_t* data, unsigned len) const = 0;
     virtual int write(unsigned offset, const uint8_t* data, unsigned len) = 0;
+
+    /**
+     * Zero-copy read access: points out_data to the contiguous piece of the stored data that begins at the offset.
+     * Returns the length of the piece, which may be less than the remaining length of the data if the buffer
+     * is fragmented; zero if the offset is beyond the end of the data; negative error code if the buffer does
+     * not support direct access (the default) - read() should be used then.
+     * The pointer is invalidated by any modification of the buffer.
+     */
+    virtual int peek(unsigned offset, const uint8_t*& out_data) const
+    {
+        (void)offset;
+        out_data = UAVCAN_NULLPTR;
+        return -ErrLogic;
+    }
 };
 
 }
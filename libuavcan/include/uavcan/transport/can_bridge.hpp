@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#ifndef UAVCAN_TRANSPORT_CAN_BRIDGE_HPP_INCLUDED
+#define UAVCAN_TRANSPORT_CAN_BRIDGE_HPP_INCLUDED
+
+#include <uavcan/error.hpp>
+#include <uavcan/std.hpp>
+#include <uavcan/build_config.hpp>
+#include <uavcan/data_type.hpp>
+#include <uavcan/transport/can_io.hpp>
+#include <uavcan/transport/transfer.hpp>
+
+namespace uavcan
+{
+/**
+ * Forwards CAN frames between two buses, without reassembling the transfers.
+ *
+ * Every UAVCAN frame received from one bus is checked against the data type filter of its direction, its CAN ID
+ * is rewritten according to the node ID mapping, and it is sent to the interface with the same index on the other
+ * bus (the last interface, if the other bus has fewer of them). Transfer payloads and CRC are not affected by the
+ * CAN ID rewriting. Non-UAVCAN frames (standard IDs, RTR, error frames) are never forwarded.
+ *
+ * The TX deadline of a forwarded frame is its RX timestamp plus the latency budget, so frames that could not be
+ * delivered in time are dropped by the TX queue instead of being delivered late.
+ *
+ * The bridge remembers the last few frames it has sent to each bus, and ignores them if they are received back
+ * from that bus (e.g. if the driver echoes transmitted frames, or if the buses are also joined by another bridge).
+ */
+class UAVCAN_EXPORT CanBridge : Noncopyable
+{
+public:
+    enum Direction
+    {
+        DirectionAToB,
+        DirectionBToA
+    };
+
+    /**
+     * Maximum number of data type filter rules per direction.
+     */
+    static const uint8_t MaxFilterRules = 16;
+
+    /**
+     * Number of frames per bus that are remembered for loop detection.
+     */
+    static const uint8_t EchoHistoryDepth = 16;
+
+    struct Counters
+    {
+        uint64_t frames_forwarded;
+        uint64_t frames_filtered;   ///< Rejected by the data type filter
+        uint64_t frames_dropped;    ///< Expired before they could be sent, or TX failure
+        uint64_t echoes_ignored;    ///< Frames that were forwarded by this bridge and then received back
+
+        Counters()
+            : frames_forwarded(0)
+            , frames_filtered(0)
+            , frames_dropped(0)
+            , echoes_ignored(0)
+        { }
+    };
+
+private:
+    struct FilterRule
+    {
+        uint16_t data_type_id;
+        uint8_t kind;
+        bool allow;
+
+        FilterRule()
+            : data_type_id(0)
+            , kind(0)
+            , allow(false)
+        { }
+    };
+
+    struct EchoEntry
+    {
+        MonotonicTime deadline;
+        CanFrame frame;
+    };
+
+    struct Side
+    {
+        CanIOManager canio;
+        Counters counters;                                  ///< Frames received from this side
+        FilterRule rules[MaxFilterRules];                   ///< Frames received from this side
+        uint8_t node_id_map[NodeID::Max + 1];               ///< Frames received from this side
+        EchoEntry echo_history[EchoHistoryDepth];           ///< Frames sent to this side
+        uint8_t num_rules;
+        uint8_t echo_history_pos;
+        bool allow_by_default;
+
+        Side(ICanDriver& driver, IPoolAllocator& allocator, ISystemClock& sysclock, std::size_t mem_blocks_per_iface)
+            : canio(driver, allocator, sysclock, mem_blocks_per_iface)
+            , num_rules(0)
+            , echo_history_pos(0)
+            , allow_by_default(true)
+        {
+            for (uint8_t i = 0; i <= NodeID::Max; i++)
+            {
+                node_id_map[i] = i;
+            }
+        }
+    };
+
+    Side side_a_;
+    Side side_b_;
+    ISystemClock& sysclock_;
+    MonotonicDuration latency_budget_;
+
+    static bool isAllowedByFilter(const Side& side, uint32_t can_id);
+    static void rewriteCanID(const Side& side, CanFrame& frame);
+    static bool checkAndRemoveEcho(Side& side, const CanFrame& frame, MonotonicTime ts);
+    static void addToEchoHistory(Side& side, const CanFrame& frame, MonotonicTime deadline);
+
+    Side& getSourceSide(Direction dir) { return (dir == DirectionAToB) ? side_a_ : side_b_; }
+    Side& getTargetSide(Direction dir) { return (dir == DirectionAToB) ? side_b_ : side_a_; }
+
+    void forward(Direction dir, const CanRxFrame& frame);
+    int receiveAndForward(Direction dir, MonotonicTime blocking_deadline);
+
+public:
+    /**
+     * @param driver_a, driver_b        The buses; each may have several redundant interfaces.
+     *
+     * @param allocator                 TX queues are allocated from it.
+     *
+     * @param sysclock                  System clock.
+     *
+     * @param latency_budget            Forwarded frames are dropped if they could not be sent within this time
+     *                                  since they were received.
+     *
+     * @param mem_blocks_per_iface      TX queue quota, see @ref CanIOManager.
+     */
+    CanBridge(ICanDriver& driver_a, ICanDriver& driver_b, IPoolAllocator& allocator, ISystemClock& sysclock,
+              MonotonicDuration latency_budget = getDefaultLatencyBudget(), std::size_t mem_blocks_per_iface = 0)
+        : side_a_(driver_a, allocator, sysclock, mem_blocks_per_iface)
+        , side_b_(driver_b, allocator, sysclock, mem_blocks_per_iface)
+        , sysclock_(sysclock)
+        , latency_budget_(latency_budget)
+    { }
+
+    /**
+     * Frames received from one bus are forwarded to the other one until the deadline.
+     * The two drivers cannot be waited on together, so the bridge blocks on each bus in turns, for at most
+     * a quarter of the latency budget, but not less than 1 ms; a frame may wait for that long before it is
+     * forwarded.
+     * Returns negative error code.
+     */
+    int spin(MonotonicTime deadline);
+
+    /**
+     * Forwards all frames that are currently pending in the RX queues of both buses, then returns.
+     * Returns the number of forwarded frames or negative error code.
+     */
+    int spinOnce();
+
+    /**
+     * Data type filter. Data types that have no rule are forwarded according to the default policy,
+     * which is to forward everything.
+     * Returns negative error code.
+     * @{
+     */
+    void setDefaultFilterPolicy(Direction dir, bool allow);
+    int addFilterRule(Direction dir, DataTypeKind kind, DataTypeID data_type_id, bool allow);
+    void removeAllFilterRules(Direction dir);
+    /**
+     * @}
+     */
+
+    /**
+     * The node that has the specified ID on the bus A will be seen with the other ID on the bus B, and vice versa.
+     * Both source and destination node IDs are rewritten. Anonymous frames are not affected.
+     * Re-mapping an ID replaces its previous mapping in both directions; the IDs that were paired with
+     * either of the specified ones before are paired with each other, so every node remains reachable.
+     * Returns negative error code.
+     */
+    int setNodeIDMapping(NodeID node_id_on_a, NodeID node_id_on_b);
+
+    MonotonicDuration getLatencyBudget() const { return latency_budget_; }
+    void setLatencyBudget(MonotonicDuration x) { latency_budget_ = x; }
+
+    /**
+     * Counters of frames received from the bus that is the source of the specified direction.
+     */
+    const Counters& getCounters(Direction dir) const
+    {
+        return (dir == DirectionAToB) ? side_a_.counters : side_b_.counters;
+    }
+
+    static MonotonicDuration getDefaultLatencyBudget() { return MonotonicDuration::fromMSec(10); }
+};
+
+}
+
+#endif // UAVCAN_TRANSPORT_CAN_BRIDGE_HPP_INCLUDED
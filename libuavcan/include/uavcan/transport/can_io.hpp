@@ -37,6 +37,16 @@ struct UAVCAN_EXPORT CanRxFrame : public CanFrame
 };
 
 
+/**
+ * Library-level IO flag; it is never passed to the driver.
+ * If the TX queue already contains a single-frame transfer with the same CAN ID and QoS that was also enqueued
+ * with this flag, the queued frame is replaced with the new one instead of enqueueing both. Since the CAN ID
+ * includes the data type, the source and the destination, the replaced frame always carries an older sample of
+ * the same data. Frames of multi-frame transfers are never replaced.
+ */
+static const CanIOFlags CanIOFlagReplaceQueued = 0x8000;
+
+
 class UAVCAN_EXPORT CanTxQueue : Noncopyable
 {
 public:
@@ -90,14 +100,19 @@ private:
     LimitedPoolAllocator allocator_;
     ISystemClock& sysclock_;
     uint32_t rejected_frames_cnt_;
+    uint32_t replaced_frames_cnt_;
 
     void registerRejectedFrame();
 
+    static bool isSingleFrameTransfer(const CanFrame& frame);
+    Entry* findReplaceableEntry(const CanFrame& frame, Qos qos);
+
 public:
     CanTxQueue(IPoolAllocator& allocator, ISystemClock& sysclock, std::size_t allocator_quota)
         : allocator_(allocator, allocator_quota)
         , sysclock_(sysclock)
         , rejected_frames_cnt_(0)
+        , replaced_frames_cnt_(0)
     { }
 
     ~CanTxQueue();
@@ -113,9 +128,103 @@ public:
 
     uint32_t getRejectedFrameCount() const { return rejected_frames_cnt_; }
 
+    /// Number of queued frames that were replaced with newer ones, see @ref CanIOFlagReplaceQueued.
+    uint32_t getReplacedFrameCount() const { return replaced_frames_cnt_; }
+
     bool isEmpty() const { return queue_.isEmpty(); }
 };
 
+/**
+ * Received frames waiting to be processed, ordered by CAN ID priority.
+ * Frames with equal CAN ID keep the order of arrival, so the frames of a multi-frame transfer are never reordered.
+ */
+class UAVCAN_EXPORT CanRxQueue : Noncopyable
+{
+public:
+    struct Entry : public LinkedListNode<Entry>
+    {
+        CanRxFrame frame;
+
+        explicit Entry(const CanRxFrame& arg_frame)
+            : frame(arg_frame)
+        {
+            IsDynamicallyAllocatable<Entry>::check();
+        }
+
+        static void destroy(Entry*& obj, IPoolAllocator& allocator);
+    };
+
+private:
+    class PriorityInsertionComparator
+    {
+        const CanFrame& frm_;
+    public:
+        explicit PriorityInsertionComparator(const CanFrame& frm) : frm_(frm) { }
+        bool operator()(const Entry* entry)
+        {
+            UAVCAN_ASSERT(entry);
+            return frm_.priorityHigherThan(entry->frame);
+        }
+    };
+
+    LinkedListRoot<Entry> queue_;
+    IPoolAllocator& allocator_;
+    uint16_t length_;
+
+public:
+    explicit CanRxQueue(IPoolAllocator& allocator)
+        : allocator_(allocator)
+        , length_(0)
+    { }
+
+    ~CanRxQueue() { clear(); }
+
+    /**
+     * Returns false if there's not enough memory; the frame is not queued then.
+     */
+    bool push(const CanRxFrame& frame);
+
+    /**
+     * Removes the highest priority frame. Returns false if the queue is empty.
+     */
+    bool pop(CanRxFrame& out_frame);
+
+    void clear();
+
+    /**
+     * Removes the frames for which the predicate returns true. Returns the number of removed frames.
+     * Predicate prototype: bool (const CanRxFrame& frame)
+     */
+    template <typename Predicate>
+    unsigned removeWhere(Predicate predicate);
+
+    unsigned getLength() const { return length_; }
+
+    bool isEmpty() const { return queue_.isEmpty(); }
+};
+
+
+template <typename Predicate>
+unsigned CanRxQueue::removeWhere(Predicate predicate)
+{
+    unsigned num_removed = 0;
+    Entry* p = queue_.get();
+    while (p)
+    {
+        Entry* const next = p->getNextListNode();
+        if (predicate(static_cast<const CanRxFrame&>(p->frame)))
+        {
+            queue_.remove(p);
+            Entry::destroy(p, allocator_);
+            UAVCAN_ASSERT(length_ > 0);
+            length_--;
+            num_removed++;
+        }
+        p = next;
+    }
+    return num_removed;
+}
+
 
 struct UAVCAN_EXPORT CanIfacePerfCounters
 {
@@ -29,6 +29,8 @@ class UAVCAN_EXPORT TransferCRC
 {
 #if !UAVCAN_TINY
     static const uint16_t Table[256];
+
+    static uint16_t addSliced(uint16_t crc, const uint8_t* bytes, unsigned len);
 #endif
 
     uint16_t value_;
@@ -63,6 +65,7 @@ public:
     }
 #endif
 
+#if UAVCAN_TINY
     void add(const uint8_t* bytes, unsigned len)
     {
         UAVCAN_ASSERT(bytes);
@@ -71,6 +74,13 @@ public:
             add(*bytes++);
         }
     }
+#else
+    /**
+     * Processes several bytes per step, see UAVCAN_CRC_SLICING_FACTOR and UAVCAN_CRC_PCLMUL.
+     * The result is the same as that of calling add(uint8_t) for every byte.
+     */
+    void add(const uint8_t* bytes, unsigned len);
+#endif
 
     uint16_t get() const { return value_; }
 };
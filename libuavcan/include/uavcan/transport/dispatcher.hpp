@@ -72,6 +72,59 @@ public:
      */
     virtual void handleRxFrame(const CanRxFrame& frame, CanIOFlags flags) = 0;
 };
+
+/**
+ * Per data type counters of the frames that were dropped by the RX overload protection.
+ * The counters are kept in a fixed-size hash table, see @ref UAVCAN_RX_DROP_COUNTER_TABLE_SIZE; once it is full,
+ * the drops of other data types are accounted in the total counter only.
+ */
+class UAVCAN_EXPORT RxDropCounterRegistry : Noncopyable
+{
+    enum { TableSize = UAVCAN_RX_DROP_COUNTER_TABLE_SIZE };
+
+    struct Entry
+    {
+        uint64_t num_frames;            ///< Zero if the entry is not used
+        DataTypeID data_type_id;
+        uint8_t kind;
+
+        Entry()
+            : num_frames(0)
+            , kind(0)
+        { }
+    };
+
+    Entry table_[TableSize];
+    uint64_t num_frames_;
+    uint8_t num_data_types_;
+
+    static unsigned getBucket(DataTypeKind kind, DataTypeID data_type_id);
+
+    Entry* find(DataTypeKind kind, DataTypeID data_type_id, bool allow_insertion);
+
+public:
+    RxDropCounterRegistry()
+        : num_frames_(0)
+        , num_data_types_(0)
+    { }
+
+    void registerDrop(DataTypeKind kind, DataTypeID data_type_id);
+
+    /**
+     * Number of dropped frames, all data types combined.
+     */
+    uint64_t getNumDroppedFrames() const { return num_frames_; }
+
+    /**
+     * Number of dropped frames of the specified data type.
+     */
+    uint64_t getNumDroppedFrames(DataTypeKind kind, DataTypeID data_type_id) const;
+
+    /**
+     * Number of data types that had at least one frame dropped and got a counter of their own.
+     */
+    unsigned getNumDataTypes() const { return num_data_types_; }
+};
 #endif
 
 /**
@@ -121,10 +174,20 @@ class UAVCAN_EXPORT Dispatcher : Noncopyable
 #if !UAVCAN_TINY
     LoopbackFrameListenerRegistry loopback_listeners_;
     IRxFrameListener* rx_listener_;
+    WildcardTransferListener* wildcard_listener_;
+    CanRxQueue rx_staging_;
+    uint16_t rx_staging_capacity_;
+    uint16_t rx_frame_budget_;
+    RxDropCounterRegistry rx_drop_counters_;
+    MonotonicDuration rx_time_budget_;
+    TransferPriority rx_drop_priority_threshold_;
+    uint8_t rx_drop_policies_;
+    bool rx_overloaded_;
 #endif
 
     NodeID self_node_id_;
     bool self_node_id_is_set_;
+    uint32_t listener_revision_;
 
     void handleFrame(const CanRxFrame& can_frame);
 
@@ -132,6 +195,24 @@ class UAVCAN_EXPORT Dispatcher : Noncopyable
 
     void notifyRxFrameListener(const CanRxFrame& can_frame, CanIOFlags flags);
 
+#if !UAVCAN_TINY
+    class RxDropPredicate
+    {
+        Dispatcher& owner_;
+    public:
+        explicit RxDropPredicate(Dispatcher& owner) : owner_(owner) { }
+        bool operator()(const CanRxFrame& frame) const { return owner_.dropRxFrameIfOverloaded(frame); }
+    };
+
+    bool dropRxFrameIfOverloaded(const CanRxFrame& can_frame);
+    void updateRxOverloadState(MonotonicDuration processing_time);
+
+    int stageRxFrames(MonotonicTime blocking_deadline, int& inout_num_frames_processed);
+    bool processStagedRxFrames(int& inout_num_frames_processed, MonotonicDuration& inout_processing_time);
+    int spinStaged(MonotonicTime deadline);
+    int flushStagedRxFrames();
+#endif
+
 public:
     Dispatcher(ICanDriver& driver, IPoolAllocator& allocator, ISystemClock& sysclock)
         : canio_(driver, allocator, sysclock)
@@ -139,18 +220,28 @@ public:
         , outgoing_transfer_reg_(allocator)
 #if !UAVCAN_TINY
         , rx_listener_(UAVCAN_NULLPTR)
+        , wildcard_listener_(UAVCAN_NULLPTR)
+        , rx_staging_(allocator)
+        , rx_staging_capacity_(0)
+        , rx_frame_budget_(0)
+        , rx_drop_priority_threshold_(TransferPriority::Default)
+        , rx_drop_policies_(0)
+        , rx_overloaded_(false)
 #endif
         , self_node_id_(NodeID::Broadcast)  // Default
         , self_node_id_is_set_(false)
+        , listener_revision_(0)
     { }
 
     /**
      * This version returns strictly when the deadline is reached.
+     * If RX staging is enabled and the RX frame budget is exhausted, it returns early; see @ref setRxFrameBudget().
      */
     int spin(MonotonicTime deadline);
 
     /**
-     * This version does not return until all available frames are processed.
+     * This version does not return until all available frames are processed,
+     * or until the RX frame budget is exhausted if RX staging is enabled.
      */
     int spinOnce();
 
@@ -201,17 +292,114 @@ public:
      * @}
      */
 
+    /**
+     * Incremented every time the set of message listeners, the RX frame listener or the wildcard listener changes.
+     * Service listeners are not accounted for, because response listeners come and go with every call.
+     * Allows the frame routers that sit in front of the dispatcher to cache its subscriptions.
+     */
+    uint32_t getListenerRevision() const { return listener_revision_; }
+
     OutgoingTransferRegistry& getOutgoingTransferRegistry() { return outgoing_transfer_reg_; }
 
 #if !UAVCAN_TINY
     LoopbackFrameListenerRegistry& getLoopbackFrameListenerRegistry() { return loopback_listeners_; }
 
+    /**
+     * RX staging makes the dispatcher process the received frames in the order of their CAN priority
+     * rather than in the order of arrival, which matters when the bus delivers more than the node can handle.
+     * Every spin reads all pending frames from the driver into the staging queue, up to its capacity, then
+     * processes the staged frames starting from the highest priority; frames with equal CAN ID keep their order.
+     * Loopback frames are never staged.
+     * Zero capacity disables staging (this is the default); frames that are already staged will be processed
+     * by the next spin anyway. The staging queue takes one pool block per frame.
+     */
+    uint16_t getRxStagingCapacity() const { return rx_staging_capacity_; }
+    void setRxStagingCapacity(uint16_t capacity) { rx_staging_capacity_ = capacity; }
+
+    /**
+     * Maximum number of staged frames processed per spin; zero means no limit (this is the default).
+     * When the budget is exhausted, the spin returns and the remaining frames, which are the lowest priority ones,
+     * wait in the staging queue for the next spin, so the timers and the rest of the application get the CPU
+     * time even if the bus floods the node with low priority traffic.
+     * Has no effect if RX staging is disabled.
+     */
+    uint16_t getRxFrameBudget() const { return rx_frame_budget_; }
+    void setRxFrameBudget(uint16_t num_frames) { rx_frame_budget_ = num_frames; }
+
+    unsigned getNumStagedRxFrames() const { return rx_staging_.getLength(); }
+
+    /**
+     * RX overload protection. It requires RX staging to be enabled, see @ref setRxStagingCapacity().
+     *
+     * The dispatcher is overloaded if a spin could not process all staged frames because of the frame budget or
+     * the time budget, or if the time it spent processing the staged frames reached the time budget.
+     * Upon entering the overload state, the backlog is purged according to the drop policies, and while the
+     * overload lasts, the frames matching the policies are dropped as soon as they are received.
+     * The overload state ends with the first spin that processes the whole backlog using less than half of the time
+     * budget. The frames that don't match any policy are never dropped; they are processed in the order of priority.
+     *
+     * Dropped frames are not delivered to the RX frame listener either. Dropping a frame of a multi-frame transfer
+     * loses the whole transfer.
+     */
+    enum RxDropPolicy
+    {
+        RxDropLowPriorityMessages = 1,  ///< Messages with priority lower than @ref setRxDropPriorityThreshold()
+        RxDropAnonymousTransfers  = 2,  ///< Transfers from anonymous nodes
+        RxDropServiceRequests     = 4   ///< Service requests; responses are kept because this node is waiting for them
+    };
+
+    /**
+     * Bit mask of @ref RxDropPolicy values. Zero disables dropping (this is the default).
+     */
+    uint8_t getRxDropPolicies() const { return rx_drop_policies_; }
+    void setRxDropPolicies(uint8_t policies) { rx_drop_policies_ = policies; }
+
+    /**
+     * Messages with priority lower than this are dropped under overload if @ref RxDropLowPriorityMessages is set.
+     * Default is @ref TransferPriority::Default.
+     */
+    TransferPriority getRxDropPriorityThreshold() const { return rx_drop_priority_threshold_; }
+    void setRxDropPriorityThreshold(TransferPriority priority) { rx_drop_priority_threshold_ = priority; }
+
+    /**
+     * Maximum time a spin may spend processing the staged frames; zero means no limit (this is the default).
+     * When the budget is exhausted, the spin returns like it does when the frame budget is exhausted.
+     */
+    MonotonicDuration getRxTimeBudget() const { return rx_time_budget_; }
+    void setRxTimeBudget(MonotonicDuration budget) { rx_time_budget_ = budget; }
+
+    bool isRxOverloaded() const { return rx_overloaded_; }
+
+    const RxDropCounterRegistry& getRxDropCounters() const { return rx_drop_counters_; }
+
     IRxFrameListener* getRxFrameListener() const { return rx_listener_; }
-    void removeRxFrameListener() { rx_listener_ = UAVCAN_NULLPTR; }
+    void removeRxFrameListener()
+    {
+        rx_listener_ = UAVCAN_NULLPTR;
+        listener_revision_++;
+    }
     void installRxFrameListener(IRxFrameListener* listener)
     {
         UAVCAN_ASSERT(listener != UAVCAN_NULLPTR);
         rx_listener_ = listener;
+        listener_revision_++;
+    }
+
+    /**
+     * The wildcard listener receives transfers of all data types, in addition to the regular listeners.
+     * Only one wildcard listener can be installed; the object must be removed before it is destroyed.
+     */
+    WildcardTransferListener* getWildcardTransferListener() const { return wildcard_listener_; }
+    void removeWildcardTransferListener()
+    {
+        wildcard_listener_ = UAVCAN_NULLPTR;
+        listener_revision_++;
+    }
+    void installWildcardTransferListener(WildcardTransferListener* listener)
+    {
+        UAVCAN_ASSERT(listener != UAVCAN_NULLPTR);
+        wildcard_listener_ = listener;
+        listener_revision_++;
     }
 #endif
 
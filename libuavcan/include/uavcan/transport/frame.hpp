@@ -16,8 +16,10 @@ namespace uavcan
 
 class UAVCAN_EXPORT Frame
 {
+public:
     enum { PayloadCapacity = 7 };       // Will be redefined when CAN FD is available
 
+private:
     uint8_t payload_[PayloadCapacity];
     TransferPriority transfer_priority_;
     TransferType transfer_type_;
@@ -90,6 +92,12 @@ public:
     bool parse(const CanFrame& can_frame);
     bool compile(CanFrame& can_frame) const;
 
+    /**
+     * Parses only the fields that are encoded in the CAN ID; the payload and the tail byte are not touched.
+     * This is cheaper than @ref parse(), but the frame is not validated.
+     */
+    bool parseCanID(const CanFrame& can_frame);
+
     bool isValid() const;
 
     bool operator!=(const Frame& rhs) const { return !operator==(rhs); }
@@ -8,6 +8,7 @@
 #include <uavcan/std.hpp>
 #include <uavcan/error.hpp>
 #include <uavcan/transport/frame.hpp>
+#include <uavcan/transport/crc.hpp>
 #include <uavcan/transport/abstract_transfer_buffer.hpp>
 #include <uavcan/util/linked_list.hpp>
 #include <uavcan/dynamic_memory.hpp>
@@ -34,6 +35,7 @@ public:
 
     virtual int read(unsigned offset, uint8_t* data, unsigned len) const;
     virtual int write(unsigned offset, const uint8_t* data, unsigned len);
+    virtual int peek(unsigned offset, const uint8_t*& out_data) const;
 
     void reset();
 
@@ -141,6 +143,11 @@ public:
     virtual int read(unsigned offset, uint8_t* data, unsigned len) const;
     virtual int write(unsigned offset, const uint8_t* data, unsigned len);
 
+    /**
+     * The data is stored in blocks of the memory pool, so the returned pieces never cross block boundaries.
+     */
+    virtual int peek(unsigned offset, const uint8_t*& out_data) const;
+
     void reset(const TransferBufferManagerKey& key = TransferBufferManagerKey());
 
     const TransferBufferManagerKey& getKey() const { return key_; }
@@ -172,26 +179,136 @@ public:
     bool isEmpty() const;
 
     unsigned getNumBuffers() const;
+
+    uint16_t getMaxBufferSize() const { return max_buf_size_; }
+};
+
+/**
+ * Transfer buffer that does not store the payload, but consumes it as it arrives instead, e.g. a streaming decoder.
+ * It can be used by one transfer at a time; transfers that arrive while it is busy are buffered by
+ * TransferBufferManager as usual. The payload is written strictly in order; the payload CRC is computed on the fly,
+ * since the payload can't be read back. Payload beyond the maximum size is rejected, same as by
+ * TransferBufferManager.
+ */
+class UAVCAN_EXPORT StreamingTransferBuffer : public ITransferBuffer
+{
+    TransferBufferManagerKey owner_;
+    TransferCRC crc_base_;
+    TransferCRC crc_;
+    uint16_t write_pos_;
+    uint16_t max_size_;
+    bool aborted_;
+
+    /// Reading is not possible
+    virtual int read(unsigned offset, uint8_t* data, unsigned len) const;
+
+protected:
+    StreamingTransferBuffer()
+        : write_pos_(0)
+        , max_size_(0xFFFFU)
+        , aborted_(false)
+    { }
+
+    /**
+     * Called when a new transfer begins; the state left by the previous transfer, if any, must be discarded.
+     */
+    virtual void handleStreamStart() = 0;
+
+    /**
+     * Consumes the next piece of the payload. Returning false aborts the transfer.
+     */
+    virtual bool handleStreamData(const uint8_t* data, unsigned len) = 0;
+
+public:
+    virtual int write(unsigned offset, const uint8_t* data, unsigned len);
+
+    void setCrcBase(const TransferCRC& crc_base) { crc_base_ = crc_base; }
+    void setMaxSize(uint16_t max_size) { max_size_ = max_size; }
+
+    /**
+     * Returns true if a write has been rejected since the last call, i.e. the current transfer has been aborted.
+     */
+    bool yieldAbort()
+    {
+        const bool res = aborted_;
+        aborted_ = false;
+        return res;
+    }
+
+    /**
+     * Returns false if the buffer is being used by another transfer.
+     */
+    bool acquire(const TransferBufferManagerKey& key);
+    void release() { owner_ = TransferBufferManagerKey(); }
+
+    bool isAcquiredBy(const TransferBufferManagerKey& key) const { return !owner_.isEmpty() && (owner_ == key); }
+
+    /**
+     * CRC of the payload received so far.
+     */
+    uint16_t getCrc() const { return crc_.get(); }
+};
+
+/**
+ * Gives the transfer receiver access to the buffer of one transfer.
+ */
+class UAVCAN_EXPORT ITransferBufferAccessor
+{
+public:
+    virtual ~ITransferBufferAccessor() { }
+
+    virtual ITransferBuffer* access() = 0;
+    virtual ITransferBuffer* create() = 0;
+    virtual void remove() = 0;
 };
 
 /**
  * Convinience class.
  */
-class UAVCAN_EXPORT TransferBufferAccessor
+class UAVCAN_EXPORT TransferBufferAccessor : public ITransferBufferAccessor
 {
     TransferBufferManager& bufmgr_;
     const TransferBufferManagerKey key_;
+    StreamingTransferBuffer* const stream_buf_;
 
 public:
-    TransferBufferAccessor(TransferBufferManager& bufmgr, TransferBufferManagerKey key) :
+    TransferBufferAccessor(TransferBufferManager& bufmgr, TransferBufferManagerKey key,
+                           StreamingTransferBuffer* stream_buf = UAVCAN_NULLPTR) :
         bufmgr_(bufmgr),
-        key_(key)
+        key_(key),
+        stream_buf_(stream_buf)
     {
         UAVCAN_ASSERT(!key.isEmpty());
     }
-    ITransferBuffer* access() { return bufmgr_.access(key_); }
-    ITransferBuffer* create() { return bufmgr_.create(key_); }
-    void remove() { bufmgr_.remove(key_); }
+
+    virtual ITransferBuffer* access()
+    {
+        return isStreaming() ? stream_buf_ : bufmgr_.access(key_);
+    }
+
+    /**
+     * The streaming buffer is preferred if it's available.
+     */
+    virtual ITransferBuffer* create()
+    {
+        if ((stream_buf_ != UAVCAN_NULLPTR) && stream_buf_->acquire(key_))
+        {
+            bufmgr_.remove(key_);
+            return stream_buf_;
+        }
+        return bufmgr_.create(key_);
+    }
+
+    virtual void remove()
+    {
+        if (isStreaming())
+        {
+            stream_buf_->release();
+        }
+        bufmgr_.remove(key_);
+    }
+
+    bool isStreaming() const { return (stream_buf_ != UAVCAN_NULLPTR) && stream_buf_->isAcquiredBy(key_); }
 };
 
 }
@@ -8,6 +8,7 @@
 #include <cassert>
 #include <uavcan/error.hpp>
 #include <uavcan/std.hpp>
+#include <uavcan/dynamic_memory.hpp>
 #include <uavcan/transport/transfer_receiver.hpp>
 #include <uavcan/transport/perf_counter.hpp>
 #include <uavcan/util/linked_list.hpp>
@@ -20,6 +21,8 @@ namespace uavcan
 {
 /**
  * Container for received transfer.
+ * The payload can be accessed without copying with peek() (see @ref ITransferBuffer::peek()); it then points
+ * directly into the received frame or into the reassembly buffer.
  */
 class UAVCAN_EXPORT IncomingTransfer : public ITransferBuffer
 {
@@ -77,6 +80,7 @@ class UAVCAN_EXPORT SingleFrameIncomingTransfer : public IncomingTransfer
 public:
     explicit SingleFrameIncomingTransfer(const RxFrame& frm);
     virtual int read(unsigned offset, uint8_t* data, unsigned len) const;
+    virtual int peek(unsigned offset, const uint8_t*& out_data) const;
     virtual bool isAnonymousTransfer() const;
 };
 
@@ -85,11 +89,12 @@ public:
  */
 class UAVCAN_EXPORT MultiFrameIncomingTransfer : public IncomingTransfer, Noncopyable
 {
-    TransferBufferAccessor& buf_acc_;
+    ITransferBufferAccessor& buf_acc_;
 public:
     MultiFrameIncomingTransfer(MonotonicTime ts_mono, UtcTime ts_utc, const RxFrame& last_frame,
-                               TransferBufferAccessor& tba);
+                               ITransferBufferAccessor& tba);
     virtual int read(unsigned offset, uint8_t* data, unsigned len) const;
+    virtual int peek(unsigned offset, const uint8_t*& out_data) const;
     virtual void release() { buf_acc_.remove(); }
 };
 
@@ -103,30 +108,50 @@ class UAVCAN_EXPORT TransferListener : public LinkedListNode<TransferListener>
     Map<TransferBufferManagerKey, TransferReceiver> receivers_;
     TransferPerfCounter& perf_;
     const TransferCRC crc_base_;                      ///< Pre-initialized with data type hash, thus constant
+    StreamingTransferBuffer* stream_buf_;
     bool allow_anonymous_transfers_;
 
     class TimedOutReceiverPredicate
     {
         const MonotonicTime ts_;
         TransferBufferManager& parent_bufmgr_;
+        StreamingTransferBuffer* const parent_stream_buf_;
 
     public:
-        TimedOutReceiverPredicate(MonotonicTime arg_ts, TransferBufferManager& arg_bufmgr)
+        TimedOutReceiverPredicate(MonotonicTime arg_ts, TransferBufferManager& arg_bufmgr,
+                                  StreamingTransferBuffer* arg_stream_buf)
             : ts_(arg_ts)
             , parent_bufmgr_(arg_bufmgr)
+            , parent_stream_buf_(arg_stream_buf)
         { }
 
         bool operator()(const TransferBufferManagerKey& key, const TransferReceiver& value) const;
     };
 
-    bool checkPayloadCrc(const uint16_t compare_with, const ITransferBuffer& tbb) const;
-
 protected:
     void handleReception(TransferReceiver& receiver, const RxFrame& frame, TransferBufferAccessor& tba);
     void handleAnonymousTransferReception(const RxFrame& frame);
 
     virtual void handleIncomingTransfer(IncomingTransfer& transfer) = 0;
 
+    /**
+     * Invoked instead of handleIncomingTransfer() for multi frame transfers that were received through the
+     * streaming buffer (see @ref installStreamingBuffer()), once the transfer CRC has been verified.
+     * The payload can't be read from the transfer object; it has been consumed by the streaming buffer already.
+     */
+    virtual void handleStreamedTransfer(IncomingTransfer& transfer)
+    {
+        (void)transfer;
+        UAVCAN_ASSERT(0);   // Must be overridden if the streaming buffer is used
+    }
+
+    /**
+     * Invoked when a multi frame transfer that was being received through the streaming buffer is discarded,
+     * either because the streaming buffer has rejected its payload, or because it has failed the CRC check.
+     * Whatever has been decoded from the streamed payload must be discarded.
+     */
+    virtual void handleStreamedTransferFailure() { }
+
 public:
     TransferListener(TransferPerfCounter& perf, const DataTypeDescriptor& data_type,
                      uint16_t max_buffer_size, IPoolAllocator& allocator)
@@ -135,6 +160,7 @@ public:
         , receivers_(allocator)
         , perf_(perf)
         , crc_base_(data_type.getSignature().toTransferCRC())
+        , stream_buf_(UAVCAN_NULLPTR)
         , allow_anonymous_transfers_(false)
     { }
 
@@ -148,6 +174,13 @@ public:
      */
     void allowAnonymousTransfers() { allow_anonymous_transfers_ = true; }
 
+    /**
+     * Multi frame transfers will be fed into the streaming buffer frame by frame as they arrive, instead of being
+     * reassembled in the pool-allocated buffers. Only one transfer at a time can be streamed; others will be
+     * buffered as usual. The object must outlive the listener. Pass null to disable.
+     */
+    void installStreamingBuffer(StreamingTransferBuffer* stream_buf);
+
     void cleanup(MonotonicTime ts);
 
     virtual void handleFrame(const RxFrame& frame);
@@ -189,6 +222,165 @@ public:
     }
 };
 
+/**
+ * Receives transfers of all data types, e.g. for sniffers, bridges and recorders.
+ * One instance can be installed into the dispatcher, see @ref Dispatcher::installWildcardTransferListener().
+ *
+ * All frames on the bus are accepted, including service transfers addressed to other nodes. Transfers are reassembled
+ * in a single table keyed by source node ID, data type ID, transfer type and destination node ID (the latter is
+ * needed because the transfer ID of a service call is maintained per destination node); the transfer IDs are tracked
+ * and the CRC of multi frame transfers is verified in the same way as by the regular transfer listeners.
+ * The table is separate from the ones of the regular listeners, so that their keys don't carry the extra fields.
+ *
+ * The reassembly memory is drawn from the node's allocator, but it is limited to the specified number of blocks,
+ * so that the wildcard listener can't starve the regular subscribers of memory.
+ *
+ * The received transfers are passed to handleIncomingTransfer() together with the data type ID and the destination
+ * node ID; the payload can be accessed with IncomingTransfer::read() or IncomingTransfer::peek().
+ */
+class UAVCAN_EXPORT WildcardTransferListener : Noncopyable
+{
+    class SessionKey
+    {
+        NodeID src_node_id_;
+        NodeID dst_node_id_;
+        uint16_t data_type_id_;
+        uint8_t transfer_type_;
+
+    public:
+        SessionKey()
+            : data_type_id_(0)
+            , transfer_type_(TransferType(0))
+        {
+            UAVCAN_ASSERT(isEmpty());
+        }
+
+        explicit SessionKey(const RxFrame& frame)
+            : src_node_id_(frame.getSrcNodeID())
+            , dst_node_id_(frame.getDstNodeID())
+            , data_type_id_(frame.getDataTypeID().get())
+            , transfer_type_(frame.getTransferType())
+        {
+            UAVCAN_ASSERT(!isEmpty());
+        }
+
+        bool operator==(const SessionKey& rhs) const
+        {
+            return src_node_id_ == rhs.src_node_id_ && dst_node_id_ == rhs.dst_node_id_ &&
+                   data_type_id_ == rhs.data_type_id_ && transfer_type_ == rhs.transfer_type_;
+        }
+
+        bool isEmpty() const { return !src_node_id_.isValid(); }
+
+#if UAVCAN_TOSTRING
+        std::string toString() const;
+#endif
+    };
+
+    /**
+     * The reassembly buffer is owned by the session rather than by a TransferBufferManager.
+     */
+    struct Session
+    {
+        TransferReceiver receiver;
+        TransferBufferManagerEntry* buffer;
+
+        Session() : buffer(UAVCAN_NULLPTR) { }
+    };
+
+    class SessionBufferAccessor : public ITransferBufferAccessor
+    {
+        IPoolAllocator& allocator_;
+        TransferBufferManagerEntry*& buffer_;
+        const uint16_t max_buffer_size_;
+
+    public:
+        SessionBufferAccessor(IPoolAllocator& allocator, TransferBufferManagerEntry*& buffer, uint16_t max_buffer_size)
+            : allocator_(allocator)
+            , buffer_(buffer)
+            , max_buffer_size_(max_buffer_size)
+        { }
+
+        virtual ITransferBuffer* access() { return buffer_; }
+        virtual ITransferBuffer* create();
+        virtual void remove();
+    };
+
+    class TimedOutSessionPredicate
+    {
+        const MonotonicTime ts_;
+        IPoolAllocator& allocator_;
+
+    public:
+        TimedOutSessionPredicate(MonotonicTime arg_ts, IPoolAllocator& arg_allocator)
+            : ts_(arg_ts)
+            , allocator_(arg_allocator)
+        { }
+
+        bool operator()(const SessionKey& key, const Session& value) const;
+    };
+
+    LimitedPoolAllocator allocator_;
+    Map<SessionKey, Session> sessions_;
+    TransferPerfCounter perf_;
+    const uint16_t max_buffer_size_;
+    bool allow_anonymous_transfers_;
+
+    bool getCrcBase(const RxFrame& frame, TransferCRC& out_crc);
+
+    void handleReception(TransferReceiver& receiver, const RxFrame& frame, ITransferBufferAccessor& tba);
+
+protected:
+    /**
+     * Invoked for every received transfer.
+     * The transfer object and its payload are only valid until this method returns.
+     */
+    virtual void handleIncomingTransfer(DataTypeID data_type_id, NodeID dst_node_id, IncomingTransfer& transfer) = 0;
+
+    /**
+     * The data type signature is needed to verify the CRC of multi frame transfers.
+     * Multi frame transfers of data types whose signature is unknown (i.e. this method returns false) are ignored,
+     * no memory is allocated for them. Single frame transfers are always accepted.
+     */
+    virtual bool getDataTypeSignature(DataTypeKind kind, DataTypeID data_type_id,
+                                      DataTypeSignature& out_signature) = 0;
+
+public:
+    /**
+     * @param allocator         The node's allocator; the reassembly buffers and the receiver states are allocated
+     *                          from it.
+     *
+     * @param max_blocks        Maximum number of blocks this listener may hold in the allocator.
+     *
+     * @param max_buffer_size   Longer transfers will be discarded.
+     */
+    WildcardTransferListener(IPoolAllocator& allocator, std::size_t max_blocks, uint16_t max_buffer_size)
+        : allocator_(allocator, max_blocks)
+        , sessions_(allocator_)
+        , max_buffer_size_(max_buffer_size)
+        , allow_anonymous_transfers_(false)
+    { }
+
+    virtual ~WildcardTransferListener();
+
+    /**
+     * By default, anonymous transfers will be ignored.
+     * This option allows to enable reception of anonymous transfers.
+     */
+    void allowAnonymousTransfers() { allow_anonymous_transfers_ = true; }
+
+    void cleanup(MonotonicTime ts);
+
+    void handleFrame(const RxFrame& frame);
+
+    /**
+     * Number of transfers currently being reassembled or tracked.
+     */
+    unsigned getNumReceivers() const { return sessions_.getSize(); }
+
+    const TransferPerfCounter& getPerfCounter() const { return perf_; }
+};
+
 }
 
 #endif // UAVCAN_TRANSPORT_TRANSFER_LISTENER_HPP_INCLUDED
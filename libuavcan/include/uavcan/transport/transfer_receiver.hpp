@@ -65,7 +65,7 @@ private:
 
     bool validate(const RxFrame& frame) const;
     bool writePayload(const RxFrame& frame, ITransferBuffer& buf);
-    ResultCode receive(const RxFrame& frame, TransferBufferAccessor& tba);
+    ResultCode receive(const RxFrame& frame, ITransferBufferAccessor& tba);
 
 public:
     TransferReceiver() :
@@ -79,7 +79,7 @@ public:
 
     bool isTimedOut(MonotonicTime current_ts) const;
 
-    ResultCode addFrame(const RxFrame& frame, TransferBufferAccessor& tba);
+    ResultCode addFrame(const RxFrame& frame, ITransferBufferAccessor& tba);
 
     uint8_t yieldErrorCount();
 
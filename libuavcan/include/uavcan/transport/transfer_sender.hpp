@@ -13,9 +13,28 @@
 #include <uavcan/transport/crc.hpp>
 #include <uavcan/transport/transfer.hpp>
 #include <uavcan/transport/dispatcher.hpp>
+#include <uavcan/transport/abstract_transfer_buffer.hpp>
 
 namespace uavcan
 {
+/**
+ * Source of the transfer payload for the streaming send() methods of @ref TransferSender.
+ * The payload is written into the sink in order, starting from the offset zero; the last written byte may be
+ * overwritten by the next write, as @ref BitStream does. Nothing else is allowed.
+ * Since multi-frame transfers carry the CRC in the first frame, the payload will be requested twice:
+ * once to compute the CRC, and once more to fill the frames. The output must be identical both times.
+ */
+class UAVCAN_EXPORT ITransferPayloadSource
+{
+public:
+    virtual ~ITransferPayloadSource() { }
+
+    /**
+     * Returns negative error code on failure.
+     */
+    virtual int writePayload(ITransferBuffer& sink) const = 0;
+};
+
 
 class UAVCAN_EXPORT TransferSender
 {
@@ -33,6 +52,12 @@ class UAVCAN_EXPORT TransferSender
 
     void registerError() const;
 
+    TransferID* accessTransferID(MonotonicTime tx_deadline, TransferType transfer_type, NodeID dst_node_id) const;
+
+    int sendImpl(const uint8_t* payload, unsigned payload_len, const TransferCRC* payload_crc,
+                 MonotonicTime tx_deadline, MonotonicTime blocking_deadline, TransferType transfer_type,
+                 NodeID dst_node_id, TransferID tid) const;
+
 public:
     enum { AllIfacesMask = 0xFF };
 
@@ -108,6 +133,38 @@ public:
      */
     int send(const uint8_t* payload, unsigned payload_len, MonotonicTime tx_deadline,
              MonotonicTime blocking_deadline, TransferType transfer_type, NodeID dst_node_id) const;
+
+    /**
+     * Versions of the methods above where the transfer CRC is supplied by the caller instead of being computed
+     * from the payload, which allows to send the same payload repeatedly at the cost of a memory copy.
+     * The CRC must be obtained from @ref computeTransferCRC() for the same payload.
+     */
+    int send(const uint8_t* payload, unsigned payload_len, const TransferCRC& payload_crc, MonotonicTime tx_deadline,
+             MonotonicTime blocking_deadline, TransferType transfer_type, NodeID dst_node_id, TransferID tid) const;
+
+    int send(const uint8_t* payload, unsigned payload_len, const TransferCRC& payload_crc, MonotonicTime tx_deadline,
+             MonotonicTime blocking_deadline, TransferType transfer_type, NodeID dst_node_id) const;
+
+    /**
+     * Transfer CRC of the payload, which is only needed if the payload doesn't fit one frame.
+     */
+    TransferCRC computeTransferCRC(const uint8_t* payload, unsigned payload_len) const;
+
+    /**
+     * Whether the payload of this length will be sent in a multi frame transfer, so it needs the transfer CRC.
+     */
+    static bool isMultiFrameTransfer(unsigned payload_len) { return payload_len > Frame::PayloadCapacity; }
+
+    /**
+     * Streaming versions of the methods above; the payload is written directly into the outgoing frames, and the
+     * transfer CRC is computed on the fly. Memory usage does not depend on the payload length.
+     * See @ref ITransferPayloadSource.
+     */
+    int send(const ITransferPayloadSource& payload, MonotonicTime tx_deadline, MonotonicTime blocking_deadline,
+             TransferType transfer_type, NodeID dst_node_id, TransferID tid) const;
+
+    int send(const ITransferPayloadSource& payload, MonotonicTime tx_deadline, MonotonicTime blocking_deadline,
+             TransferType transfer_type, NodeID dst_node_id) const;
 };
 
 }
@@ -14,9 +14,17 @@
 #include <uavcan/node/node.hpp>
 #include <uavcan/node/timer.hpp>
 #include <uavcan/node/publisher.hpp>
+#include <uavcan/node/caching_publisher.hpp>
+#include <uavcan/node/conflating_publisher.hpp>
 #include <uavcan/node/subscriber.hpp>
+#include <uavcan/node/view_subscriber.hpp>
+#include <uavcan/node/queued_subscriber.hpp>
+#include <uavcan/node/raw_publisher.hpp>
+#include <uavcan/node/raw_subscriber.hpp>
 #include <uavcan/node/service_server.hpp>
 #include <uavcan/node/service_client.hpp>
+#include <uavcan/node/service_call_pipeline.hpp>
+#include <uavcan/node/coroutine.hpp>
 #include <uavcan/node/global_data_type_registry.hpp>
 
 // Util
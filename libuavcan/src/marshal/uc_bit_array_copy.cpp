@@ -9,17 +9,14 @@
 
 namespace uavcan
 {
-void bitarrayCopy(const unsigned char* src, std::size_t src_offset, std::size_t src_len,
-                  unsigned char* dst, std::size_t dst_offset)
+namespace
+{
+/**
+ * Copies up to 8 bits per iteration. Works with arbitrary offsets.
+ */
+void bitarrayCopyBytewise(const unsigned char* src, std::size_t src_offset, std::size_t src_len,
+                          unsigned char* dst, std::size_t dst_offset)
 {
-    /*
-     * Should never be called on a zero-length buffer. The caller will also ensure that the bit
-     * offsets never exceed one byte.
-     */
-
-    UAVCAN_ASSERT(src_len > 0U);
-    UAVCAN_ASSERT(src_offset < 8U && dst_offset < 8U);
-
     const std::size_t last_bit = src_offset + src_len;
     while (last_bit - src_offset)
     {
@@ -56,4 +53,105 @@ void bitarrayCopy(const unsigned char* src, std::size_t src_offset, std::size_t
         dst_offset += copy_bits;
     }
 }
+
+#if UAVCAN_WORDWISE_BITARRAY_COPY
+
+/// Native machine word; 64-bit arithmetic is avoided on 32-bit targets because it is emulated there.
+typedef Select<(sizeof(void*) >= 8), uint64_t, uint32_t>::Result BitarrayCopyWord;
+
+const unsigned BitsPerWord = sizeof(BitarrayCopyWord) * 8U;
+
+/*
+ * Bits are stored MSB first, hence the words are loaded and stored in big endian order regardless of the
+ * native byte order. The compiler reduces these loops into a single load/store with byte swap where possible.
+ */
+inline BitarrayCopyWord loadWordBigEndian(const unsigned char* p)
+{
+    BitarrayCopyWord w = 0;
+    for (unsigned i = 0; i < sizeof(BitarrayCopyWord); i++)
+    {
+        w = BitarrayCopyWord(w << 8) | p[i];
+    }
+    return w;
+}
+
+inline void storeWordBigEndian(BitarrayCopyWord w, unsigned char* p)
+{
+    for (unsigned i = sizeof(BitarrayCopyWord); i > 0; i--)
+    {
+        p[i - 1] = static_cast<unsigned char>(w & 0xFFU);
+        w = BitarrayCopyWord(w >> 8);
+    }
+}
+
+#endif
+
+}
+
+void bitarrayCopy(const unsigned char* src, std::size_t src_offset, std::size_t src_len,
+                  unsigned char* dst, std::size_t dst_offset)
+{
+    /*
+     * Should never be called on a zero-length buffer. The caller will also ensure that the bit
+     * offsets never exceed one byte.
+     */
+
+    UAVCAN_ASSERT(src_len > 0U);
+    UAVCAN_ASSERT(src_offset < 8U && dst_offset < 8U);
+
+#if UAVCAN_WORDWISE_BITARRAY_COPY
+    /*
+     * Copy the leading bits byte-wise until the destination is byte aligned.
+     * Afterwards every destination word can be overwritten entirely, so no read-modify-write is needed.
+     */
+    if (dst_offset > 0U)
+    {
+        const std::size_t head_bits = uavcan::min(src_len, std::size_t(8U - dst_offset));
+        bitarrayCopyBytewise(src, src_offset, head_bits, dst, dst_offset);
+        src_offset += head_bits;
+        src_len -= head_bits;
+        dst_offset = 0U;
+        dst++;
+    }
+
+    src += src_offset / 8U;
+    const unsigned src_shift = unsigned(src_offset % 8U);
+
+    if (src_shift == 0U)
+    {
+        // Both sides are byte aligned
+        const std::size_t num_bytes = src_len / 8U;
+        (void)std::memcpy(dst, src, num_bytes);
+        src += num_bytes;
+        dst += num_bytes;
+        src_len -= num_bytes * 8U;
+    }
+    else
+    {
+        /*
+         * Each output word is assembled from two adjacent unaligned source words. The trailing byte of the
+         * second word is always within the source array, because at least BitsPerWord bits beyond the
+         * first source bit remain to be copied, and the first source bit is not aligned.
+         */
+        while (src_len >= BitsPerWord)
+        {
+            const BitarrayCopyWord w =
+                BitarrayCopyWord(loadWordBigEndian(src) << src_shift) |
+                BitarrayCopyWord(src[sizeof(BitarrayCopyWord)] >> (8U - src_shift));
+            storeWordBigEndian(w, dst);
+            src += sizeof(BitarrayCopyWord);
+            dst += sizeof(BitarrayCopyWord);
+            src_len -= BitsPerWord;
+        }
+    }
+
+    // Portable tail, less than one word
+    if (src_len > 0U)
+    {
+        bitarrayCopyBytewise(src, src_shift, src_len, dst, 0U);
+    }
+#else
+    bitarrayCopyBytewise(src, src_offset, src_len, dst, dst_offset);
+#endif
+}
 }
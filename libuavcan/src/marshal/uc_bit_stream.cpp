@@ -75,6 +75,60 @@ int BitStream::read(uint8_t* bytes, const unsigned bitlen)
     return ResultOk;
 }
 
+int BitStream::writeAlignedBytes(const uint8_t* bytes, const unsigned bytelen)
+{
+    UAVCAN_ASSERT(isByteAligned());
+    UAVCAN_ASSERT(byte_cache_ == 0);
+
+    const int write_res = buf_.write(bit_offset_ / 8, bytes, bytelen);
+    if (write_res < 0)
+    {
+        return write_res;
+    }
+    if (static_cast<unsigned>(write_res) < bytelen)
+    {
+        return ResultOutOfBuffer;
+    }
+
+    bit_offset_ += bytelen * 8;
+    return ResultOk;
+}
+
+int BitStream::readAlignedBytes(uint8_t* bytes, const unsigned bytelen, const unsigned unit)
+{
+    UAVCAN_ASSERT(isByteAligned());
+    UAVCAN_ASSERT(unit > 0);
+
+    const int read_res = buf_.read(bit_offset_ / 8, bytes, bytelen);
+    if (read_res <= 0)
+    {
+        return read_res;
+    }
+    const unsigned consumed = static_cast<unsigned>(read_res) - (static_cast<unsigned>(read_res) % unit);
+    bit_offset_ += consumed * 8;
+    return int(consumed);
+}
+
+int BitStream::skip(const unsigned bitlen)
+{
+    if (bitlen == 0)
+    {
+        return ResultOk;
+    }
+    uint8_t last_byte = 0;
+    const int read_res = buf_.read((bit_offset_ + bitlen - 1) / 8, &last_byte, 1U);
+    if (read_res < 0)
+    {
+        return read_res;
+    }
+    if (read_res < 1)
+    {
+        return ResultOutOfBuffer;
+    }
+    bit_offset_ += bitlen;
+    return ResultOk;
+}
+
 #if UAVCAN_TOSTRING
 std::string BitStream::toString() const
 {
@@ -6,6 +6,20 @@
 #include <uavcan/build_config.hpp>
 #include <cmath>
 
+#if UAVCAN_FLOAT16_SIMD && !UAVCAN_USE_EXTERNAL_FLOAT16_CONVERSION
+# if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#  include <emmintrin.h>
+#  define UAVCAN_FLOAT16_SSE2 1
+# elif defined(__aarch64__) && defined(__ARM_NEON)
+/*
+ * 32-bit ARM is excluded because its NEON unit always flushes denormals to zero, unlike the VFP, which would make
+ * the results differ from the scalar conversion for small values.
+ */
+#  include <arm_neon.h>
+#  define UAVCAN_FLOAT16_NEON 1
+# endif
+#endif
+
 namespace uavcan
 {
 
@@ -86,4 +100,190 @@ float IEEE754Converter::halfToNativeIeee(uint16_t value)
 
 #endif // !UAVCAN_USE_EXTERNAL_FLOAT16_CONVERSION
 
+/*
+ * The SIMD kernels below are vectorized versions of the scalar algorithms above, so that the results are identical,
+ * including the rounding (which is not the same as that of the F16C and ARMv8 conversion instructions) and the
+ * NaN encoding. The scalar versions handle the tails that do not fill a whole vector.
+ */
+#if defined(UAVCAN_FLOAT16_SSE2)
+
+namespace
+{
+
+inline __m128i nativeIeeeToHalfSSE2(__m128 value)
+{
+    const __m128i sign_mask = _mm_set1_epi32(int(0x80000000U));
+    const __m128i round_mask = _mm_set1_epi32(~0xFFF);
+    const __m128i f32infty = _mm_set1_epi32(255 << 23);
+    const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(15 << 23));
+    const __m128 clamp = _mm_castsi128_ps(_mm_set1_epi32((31 << 23) - 0x1000));    // f16infty before rounding
+
+    const __m128i in = _mm_castps_si128(value);
+    const __m128i sign = _mm_and_si128(in, sign_mask);
+    const __m128i abs = _mm_xor_si128(in, sign);
+
+    // Inf or NaN; signed comparison is fine because the sign bit is cleared
+    const __m128i is_nan = _mm_cmpgt_epi32(abs, f32infty);
+    const __m128i is_finite = _mm_cmpgt_epi32(f32infty, abs);
+    const __m128i infnan = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(is_nan, _mm_set1_epi32(0x03FF)));
+
+    // (De)normalized number or zero; the clamping is done on positive floats, which compare like integers
+    const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_and_si128(abs, round_mask)), magic);
+    const __m128i rounded = _mm_sub_epi32(_mm_castps_si128(_mm_min_ps(scaled, clamp)), round_mask);
+    const __m128i finite = _mm_srli_epi32(rounded, 13);
+
+    const __m128i out = _mm_or_si128(_mm_and_si128(is_finite, finite), _mm_andnot_si128(is_finite, infnan));
+    return _mm_or_si128(out, _mm_srli_epi32(sign, 16));
+}
+
+inline __m128 halfToNativeIeeeSSE2(__m128i value)
+{
+    const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+    const __m128i was_infnan = _mm_set1_epi32(0x7BFF);
+
+    const __m128i expmant = _mm_and_si128(value, _mm_set1_epi32(0x7FFF));
+    const __m128i sign = _mm_slli_epi32(_mm_xor_si128(value, expmant), 16);
+    const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), magic);
+    const __m128i infnan_exp = _mm_and_si128(_mm_cmpgt_epi32(expmant, was_infnan), _mm_set1_epi32(255 << 23));
+
+    return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infnan_exp)));
+}
+
+/// Narrows 32-bit lanes holding 16-bit values; the sign extension prevents the signed saturation of PACKSSDW.
+inline __m128i packLow16SSE2(__m128i a, __m128i b)
+{
+    a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+    return _mm_packs_epi32(a, b);
+}
+
+}
+
+void IEEE754Converter::nativeIeeeToHalfArray(const float* src, uint16_t* dst, unsigned count)
+{
+    for (; count >= 8; count -= 8)
+    {
+        const __m128i lo = nativeIeeeToHalfSSE2(_mm_loadu_ps(src));
+        const __m128i hi = nativeIeeeToHalfSSE2(_mm_loadu_ps(src + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), packLow16SSE2(lo, hi));
+        src += 8;
+        dst += 8;
+    }
+    while (count-- > 0)
+    {
+        *dst++ = nativeIeeeToHalf(*src++);
+    }
+}
+
+void IEEE754Converter::halfToNativeIeeeArray(const uint16_t* src, float* dst, unsigned count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for (; count >= 8; count -= 8)
+    {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        _mm_storeu_ps(dst, halfToNativeIeeeSSE2(_mm_unpacklo_epi16(in, zero)));
+        _mm_storeu_ps(dst + 4, halfToNativeIeeeSSE2(_mm_unpackhi_epi16(in, zero)));
+        src += 8;
+        dst += 8;
+    }
+    while (count-- > 0)
+    {
+        *dst++ = halfToNativeIeee(*src++);
+    }
+}
+
+#elif defined(UAVCAN_FLOAT16_NEON)
+
+namespace
+{
+
+inline uint16x4_t nativeIeeeToHalfNEON(float32x4_t value)
+{
+    const uint32x4_t round_mask = vdupq_n_u32(~0xFFFU);
+    const uint32x4_t f32infty = vdupq_n_u32(255U << 23);
+    const float32x4_t magic = vreinterpretq_f32_u32(vdupq_n_u32(15U << 23));
+    const uint32x4_t clamp = vdupq_n_u32((31U << 23) - 0x1000U);      // f16infty before rounding
+
+    const uint32x4_t in = vreinterpretq_u32_f32(value);
+    const uint32x4_t sign = vandq_u32(in, vdupq_n_u32(0x80000000U));
+    const uint32x4_t abs = veorq_u32(in, sign);
+
+    const uint32x4_t is_finite = vcltq_u32(abs, f32infty);
+    const uint32x4_t infnan = vbslq_u32(vcgtq_u32(abs, f32infty), vdupq_n_u32(0x7FFFU), vdupq_n_u32(0x7C00U));
+
+    const float32x4_t scaled = vmulq_f32(vreinterpretq_f32_u32(vandq_u32(abs, round_mask)), magic);
+    const uint32x4_t rounded = vsubq_u32(vminq_u32(vreinterpretq_u32_f32(scaled), clamp), round_mask);
+    const uint32x4_t finite = vshrq_n_u32(rounded, 13);
+
+    const uint32x4_t out = vorrq_u32(vbslq_u32(is_finite, finite, infnan), vshrq_n_u32(sign, 16));
+    return vmovn_u32(out);
+}
+
+inline float32x4_t halfToNativeIeeeNEON(uint16x4_t value)
+{
+    const float32x4_t magic = vreinterpretq_f32_u32(vdupq_n_u32((254U - 15U) << 23));
+
+    const uint32x4_t in = vmovl_u16(value);
+    const uint32x4_t expmant = vandq_u32(in, vdupq_n_u32(0x7FFFU));
+    const uint32x4_t sign = vshlq_n_u32(veorq_u32(in, expmant), 16);
+    const float32x4_t scaled = vmulq_f32(vreinterpretq_f32_u32(vshlq_n_u32(expmant, 13)), magic);
+    const uint32x4_t infnan_exp = vandq_u32(vcgtq_u32(expmant, vdupq_n_u32(0x7BFFU)), vdupq_n_u32(255U << 23));
+
+    return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(scaled), vorrq_u32(sign, infnan_exp)));
+}
+
+}
+
+void IEEE754Converter::nativeIeeeToHalfArray(const float* src, uint16_t* dst, unsigned count)
+{
+    for (; count >= 8; count -= 8)
+    {
+        const uint16x4_t lo = nativeIeeeToHalfNEON(vld1q_f32(src));
+        const uint16x4_t hi = nativeIeeeToHalfNEON(vld1q_f32(src + 4));
+        vst1q_u16(dst, vcombine_u16(lo, hi));
+        src += 8;
+        dst += 8;
+    }
+    while (count-- > 0)
+    {
+        *dst++ = nativeIeeeToHalf(*src++);
+    }
+}
+
+void IEEE754Converter::halfToNativeIeeeArray(const uint16_t* src, float* dst, unsigned count)
+{
+    for (; count >= 8; count -= 8)
+    {
+        const uint16x8_t in = vld1q_u16(src);
+        vst1q_f32(dst, halfToNativeIeeeNEON(vget_low_u16(in)));
+        vst1q_f32(dst + 4, halfToNativeIeeeNEON(vget_high_u16(in)));
+        src += 8;
+        dst += 8;
+    }
+    while (count-- > 0)
+    {
+        *dst++ = halfToNativeIeee(*src++);
+    }
+}
+
+#else
+
+void IEEE754Converter::nativeIeeeToHalfArray(const float* src, uint16_t* dst, unsigned count)
+{
+    while (count-- > 0)
+    {
+        *dst++ = nativeIeeeToHalf(*src++);
+    }
+}
+
+void IEEE754Converter::halfToNativeIeeeArray(const uint16_t* src, float* dst, unsigned count)
+{
+    while (count-- > 0)
+    {
+        *dst++ = halfToNativeIeee(*src++);
+    }
+}
+
+#endif
+
 }
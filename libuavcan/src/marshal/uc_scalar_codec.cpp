@@ -43,4 +43,68 @@ int ScalarCodec::decodeBytesImpl(uint8_t* const bytes, const unsigned bitlen)
     return read_res;
 }
 
+namespace
+{
+/// One byte of BitStream::MaxBitsPerRW is reserved for the bit offset of an unaligned stream
+const unsigned FixedLayoutBitsPerChunk = BitStream::MaxBitsPerRW - 8;
+}
+
+int ScalarCodec::encodeFixedLayout(const uint8_t* bytes, unsigned bitlen)
+{
+    UAVCAN_ASSERT(bytes);
+    if (stream_.isByteAligned() && (bitlen >= 8))
+    {
+        const int res = stream_.writeAlignedBytes(bytes, bitlen / 8);
+        if (res <= 0)
+        {
+            return res;
+        }
+        bytes += bitlen / 8;
+        bitlen %= 8;
+    }
+    while (bitlen > 0)
+    {
+        const unsigned chunk_bits = min(bitlen, FixedLayoutBitsPerChunk);
+        const int res = stream_.write(bytes, chunk_bits);
+        if (res <= 0)
+        {
+            return res;
+        }
+        bytes += chunk_bits / 8;
+        bitlen -= chunk_bits;
+    }
+    return BitStream::ResultOk;
+}
+
+int ScalarCodec::decodeFixedLayout(uint8_t* bytes, unsigned bitlen)
+{
+    UAVCAN_ASSERT(bytes);
+    if (stream_.isByteAligned() && (bitlen >= 8))
+    {
+        const int res = stream_.readAlignedBytes(bytes, bitlen / 8);
+        if (res < 0)
+        {
+            return res;
+        }
+        if (static_cast<unsigned>(res) < (bitlen / 8))
+        {
+            return BitStream::ResultOutOfBuffer;
+        }
+        bytes += bitlen / 8;
+        bitlen %= 8;
+    }
+    while (bitlen > 0)
+    {
+        const unsigned chunk_bits = min(bitlen, FixedLayoutBitsPerChunk);
+        const int res = stream_.read(bytes, chunk_bits);
+        if (res <= 0)
+        {
+            return res;
+        }
+        bytes += chunk_bits / 8;
+        bitlen -= chunk_bits;
+    }
+    return BitStream::ResultOk;
+}
+
 }
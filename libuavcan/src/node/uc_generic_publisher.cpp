@@ -28,7 +28,17 @@ int GenericPublisherBase::doInit(DataTypeKind dtkind, const char* dtname, CanTxQ
         return -ErrUnknownDataType;
     }
 
-    sender_.init(*descr, qos);
+    return doInit(*descr, qos);
+}
+
+int GenericPublisherBase::doInit(const DataTypeDescriptor& descr, CanTxQueue::Qos qos)
+{
+    if (isInited())
+    {
+        return 0;
+    }
+
+    sender_.init(descr, qos);
 
     return 0;
 }
@@ -40,16 +50,35 @@ MonotonicTime GenericPublisherBase::getTxDeadline() const
 
 int GenericPublisherBase::genericPublish(const StaticTransferBufferImpl& buffer, TransferType transfer_type,
                                          NodeID dst_node_id, TransferID* tid, MonotonicTime blocking_deadline)
+{
+    return genericPublish(buffer.getRawPtr(), buffer.getMaxWritePos(), transfer_type, dst_node_id, tid,
+                          blocking_deadline);
+}
+
+int GenericPublisherBase::genericPublish(const uint8_t* payload, unsigned payload_len, TransferType transfer_type,
+                                         NodeID dst_node_id, TransferID* tid, MonotonicTime blocking_deadline)
+{
+    if (tid)
+    {
+        return sender_.send(payload, payload_len, getTxDeadline(), blocking_deadline, transfer_type, dst_node_id,
+                            *tid);
+    }
+    else
+    {
+        return sender_.send(payload, payload_len, getTxDeadline(), blocking_deadline, transfer_type, dst_node_id);
+    }
+}
+
+int GenericPublisherBase::genericPublish(const ITransferPayloadSource& payload, TransferType transfer_type,
+                                         NodeID dst_node_id, TransferID* tid, MonotonicTime blocking_deadline)
 {
     if (tid)
     {
-        return sender_.send(buffer.getRawPtr(), buffer.getMaxWritePos(), getTxDeadline(),
-                            blocking_deadline, transfer_type, dst_node_id, *tid);
+        return sender_.send(payload, getTxDeadline(), blocking_deadline, transfer_type, dst_node_id, *tid);
     }
     else
     {
-        return sender_.send(buffer.getRawPtr(), buffer.getMaxWritePos(), getTxDeadline(),
-                            blocking_deadline, transfer_type, dst_node_id);
+        return sender_.send(payload, getTxDeadline(), blocking_deadline, transfer_type, dst_node_id);
     }
 }
 
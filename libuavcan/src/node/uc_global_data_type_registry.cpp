@@ -6,6 +6,7 @@
 #include <uavcan/debug.hpp>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 
 namespace uavcan
 {
@@ -59,6 +60,56 @@ GlobalDataTypeRegistry::RegistrationResult GlobalDataTypeRegistry::remove(Entry*
     return RegistrationResultOk;
 }
 
+const DataTypeDescriptor* GlobalDataTypeRegistry::findInTable(DataTypeKind kind, const char* name) const
+{
+    // Binary search within the range of the requested kind; the table is ordered by name
+    unsigned low = (kind == DataTypeKindMessage) ? 0U : table_num_msgs_;
+    unsigned high = (kind == DataTypeKindMessage) ? table_num_msgs_ : table_size_;
+    while (low < high)
+    {
+        const unsigned mid = low + (high - low) / 2U;
+        const int cmp = std::strncmp(table_[mid].getFullName(), name, DataTypeDescriptor::MaxFullNameLen);
+        if (cmp == 0)
+        {
+            return &table_[mid];
+        }
+        if (cmp < 0)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return UAVCAN_NULLPTR;
+}
+
+const DataTypeDescriptor* GlobalDataTypeRegistry::findInTable(DataTypeKind kind, DataTypeID dtid) const
+{
+    // Same as above, over the ID order array
+    unsigned low = (kind == DataTypeKindMessage) ? 0U : table_num_msgs_;
+    unsigned high = (kind == DataTypeKindMessage) ? table_num_msgs_ : table_size_;
+    while (low < high)
+    {
+        const unsigned mid = low + (high - low) / 2U;
+        const DataTypeDescriptor& dtd = table_[table_id_order_[mid]];
+        if (dtd.getID() == dtid)
+        {
+            return &dtd;
+        }
+        if (dtd.getID() < dtid)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return UAVCAN_NULLPTR;
+}
+
 GlobalDataTypeRegistry::RegistrationResult GlobalDataTypeRegistry::registImpl(Entry* dtd)
 {
     if (!dtd || !dtd->descriptor.isValid())
@@ -92,6 +143,11 @@ GlobalDataTypeRegistry::RegistrationResult GlobalDataTypeRegistry::registImpl(En
             }
             p = p->getNextListNode();
         }
+        if ((findInTable(dtd->descriptor.getKind(), dtd->descriptor.getID()) != UAVCAN_NULLPTR) ||
+            (findInTable(dtd->descriptor.getKind(), dtd->descriptor.getFullName()) != UAVCAN_NULLPTR))
+        {
+            return RegistrationResultCollision;
+        }
     }
 #if UAVCAN_DEBUG
     const unsigned len_before = list->getLength();
@@ -125,6 +181,153 @@ GlobalDataTypeRegistry::RegistrationResult GlobalDataTypeRegistry::registImpl(En
     return RegistrationResultOk;
 }
 
+#if UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE > 0
+
+uint32_t GlobalDataTypeRegistry::computeNameHash(const char* name)
+{
+    uint32_t hash = 2166136261U;                        // FNV-1a
+    for (unsigned i = 0; (i < DataTypeDescriptor::MaxFullNameLen) && (name[i] != '\0'); i++)
+    {
+        hash ^= uint8_t(name[i]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+unsigned GlobalDataTypeRegistry::getNameBucket(DataTypeKind kind, uint32_t name_hash)
+{
+    return unsigned((name_hash ^ (name_hash >> 16) ^ unsigned(kind)) & (IndexSize - 1U));
+}
+
+unsigned GlobalDataTypeRegistry::getIDBucket(DataTypeKind kind, DataTypeID dtid)
+{
+    // Registered IDs tend to be clustered, so the low bits are distributed well enough
+    return unsigned((dtid.get() + (unsigned(kind) * (IndexSize / 2U))) & (IndexSize - 1U));
+}
+
+void GlobalDataTypeRegistry::buildIndex()
+{
+    StaticAssert<((IndexSize & (IndexSize - 1)) == 0)>::check();    // Must be a power of two
+
+    clearIndex();
+
+    const List* const lists[] = { &msgs_, &srvs_ };
+    for (unsigned i = 0; i < (sizeof(lists) / sizeof(lists[0])); i++)
+    {
+        for (Entry* p = lists[i]->get(); p != UAVCAN_NULLPTR; p = p->getNextListNode())
+        {
+            const DataTypeKind kind = p->descriptor.getKind();
+            p->name_hash = computeNameHash(p->descriptor.getFullName());
+
+            Entry*& name_bucket = name_index_[getNameBucket(kind, p->name_hash)];
+            p->next_by_name = name_bucket;
+            name_bucket = p;
+
+            Entry*& id_bucket = id_index_[getIDBucket(kind, p->descriptor.getID())];
+            p->next_by_id = id_bucket;
+            id_bucket = p;
+        }
+    }
+}
+
+void GlobalDataTypeRegistry::clearIndex()
+{
+    for (unsigned i = 0; i < IndexSize; i++)
+    {
+        name_index_[i] = UAVCAN_NULLPTR;
+        id_index_[i] = UAVCAN_NULLPTR;
+    }
+}
+
+#endif
+
+GlobalDataTypeRegistry::RegistrationResult
+GlobalDataTypeRegistry::adoptTable(const DataTypeDescriptor* table, const uint16_t* id_order, uint16_t size)
+{
+    if (isFrozen())
+    {
+        return RegistrationResultFrozen;
+    }
+    if (((table == UAVCAN_NULLPTR) || (id_order == UAVCAN_NULLPTR)) && (size > 0))
+    {
+        return RegistrationResultInvalidParams;
+    }
+
+    /*
+     * Both ordering checks are linear. Strictly ascending names rule out name collisions within the table;
+     * strictly ascending IDs rule out ID collisions, and also make sure that the ID order array lists every
+     * table index of its kind exactly once.
+     */
+    uint16_t num_msgs = 0;
+    for (uint16_t i = 0; i < size; i++)
+    {
+        const DataTypeDescriptor& dtd = table[i];
+        if (!dtd.isValid())
+        {
+            return RegistrationResultInvalidParams;
+        }
+        if (dtd.getKind() == DataTypeKindMessage)
+        {
+            if (num_msgs != i)
+            {
+                return RegistrationResultInvalidParams;     // Messages must go first
+            }
+            num_msgs++;
+        }
+        if ((i > 0) && (table[i - 1].getKind() == dtd.getKind()) &&
+            (std::strncmp(table[i - 1].getFullName(), dtd.getFullName(), DataTypeDescriptor::MaxFullNameLen) >= 0))
+        {
+            return RegistrationResultInvalidParams;
+        }
+    }
+    for (uint16_t i = 0; i < size; i++)
+    {
+        const uint16_t begin = uint16_t((i < num_msgs) ? 0U : num_msgs);
+        const uint16_t end = uint16_t((i < num_msgs) ? num_msgs : size);
+        if ((id_order[i] < begin) || (id_order[i] >= end))
+        {
+            return RegistrationResultInvalidParams;
+        }
+        if ((i > begin) && (table[id_order[i - 1]].getID() >= table[id_order[i]].getID()))
+        {
+            const bool collision = (id_order[i - 1] != id_order[i]) &&
+                                   (table[id_order[i - 1]].getID() == table[id_order[i]].getID());
+            return collision ? RegistrationResultCollision : RegistrationResultInvalidParams;
+        }
+    }
+
+    const DataTypeDescriptor* const old_table = table_;
+    const uint16_t* const old_table_id_order = table_id_order_;
+    const uint16_t old_table_size = table_size_;
+    const uint16_t old_table_num_msgs = table_num_msgs_;
+    table_ = table;
+    table_id_order_ = id_order;
+    table_size_ = size;
+    table_num_msgs_ = num_msgs;
+
+    // Collisions with the data types that were registered individually
+    const List* const lists[] = { &msgs_, &srvs_ };
+    for (unsigned i = 0; i < (sizeof(lists) / sizeof(lists[0])); i++)
+    {
+        for (const Entry* p = lists[i]->get(); p != UAVCAN_NULLPTR; p = p->getNextListNode())
+        {
+            if ((findInTable(p->descriptor.getKind(), p->descriptor.getID()) != UAVCAN_NULLPTR) ||
+                (findInTable(p->descriptor.getKind(), p->descriptor.getFullName()) != UAVCAN_NULLPTR))
+            {
+                table_ = old_table;
+                table_id_order_ = old_table_id_order;
+                table_size_ = old_table_size;
+                table_num_msgs_ = old_table_num_msgs;
+                return RegistrationResultCollision;
+            }
+        }
+    }
+
+    UAVCAN_TRACE("GlobalDataTypeRegistry", "Adopted table; num msgs: %u, num srvs: %u",
+                 unsigned(num_msgs), unsigned(size - num_msgs));
+    return RegistrationResultOk;
+}
+
 GlobalDataTypeRegistry& GlobalDataTypeRegistry::instance()
 {
     static GlobalDataTypeRegistry singleton;
@@ -136,6 +339,7 @@ void GlobalDataTypeRegistry::freeze()
     if (!frozen_)
     {
         frozen_ = true;
+        buildIndex();
         UAVCAN_TRACE("GlobalDataTypeRegistry", "Frozen; num msgs: %u, num srvs: %u",
                      getNumMessageTypes(), getNumServiceTypes());
     }
@@ -164,6 +368,20 @@ const DataTypeDescriptor* GlobalDataTypeRegistry::find(DataTypeKind kind, const
         UAVCAN_ASSERT(0);
         return UAVCAN_NULLPTR;
     }
+#if UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE > 0
+    if (frozen_)
+    {
+        const uint32_t name_hash = computeNameHash(name);
+        for (Entry* p = name_index_[getNameBucket(kind, name_hash)]; p != UAVCAN_NULLPTR; p = p->next_by_name)
+        {
+            if ((p->name_hash == name_hash) && p->descriptor.match(kind, name))
+            {
+                return &p->descriptor;
+            }
+        }
+        return findInTable(kind, name);
+    }
+#endif
     Entry* p = list->get();
     while (p)
     {
@@ -173,7 +391,7 @@ const DataTypeDescriptor* GlobalDataTypeRegistry::find(DataTypeKind kind, const
         }
         p = p->getNextListNode();
     }
-    return UAVCAN_NULLPTR;
+    return findInTable(kind, name);
 }
 
 const DataTypeDescriptor* GlobalDataTypeRegistry::find(DataTypeKind kind, DataTypeID dtid) const
@@ -184,6 +402,19 @@ const DataTypeDescriptor* GlobalDataTypeRegistry::find(DataTypeKind kind, DataTy
         UAVCAN_ASSERT(0);
         return UAVCAN_NULLPTR;
     }
+#if UAVCAN_DATA_TYPE_REGISTRY_INDEX_SIZE > 0
+    if (frozen_)
+    {
+        for (Entry* p = id_index_[getIDBucket(kind, dtid)]; p != UAVCAN_NULLPTR; p = p->next_by_id)
+        {
+            if (p->descriptor.match(kind, dtid))
+            {
+                return &p->descriptor;
+            }
+        }
+        return findInTable(kind, dtid);
+    }
+#endif
     Entry* p = list->get();
     while (p)
     {
@@ -191,9 +422,13 @@ const DataTypeDescriptor* GlobalDataTypeRegistry::find(DataTypeKind kind, DataTy
         {
             return &p->descriptor;
         }
+        if (p->descriptor.getID() > dtid)       // The list is ordered by ID
+        {
+            break;
+        }
         p = p->getNextListNode();
     }
-    return UAVCAN_NULLPTR;
+    return findInTable(kind, dtid);
 }
 
 }
@@ -0,0 +1,578 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <uavcan/build_config.hpp>
+
+#if !UAVCAN_TINY
+
+#include <uavcan/node/multi_node_host.hpp>
+#include <uavcan/debug.hpp>
+
+namespace uavcan
+{
+/*
+ * MultiNodeHostPort::Iface
+ */
+int16_t MultiNodeHostPort::Iface::send(const CanFrame& frame, MonotonicTime tx_deadline, CanIOFlags flags)
+{
+    UAVCAN_ASSERT(port_ != UAVCAN_NULLPTR);
+    return port_->host_.sendFromPort(port_, index_, frame, tx_deadline, flags);
+}
+
+int16_t MultiNodeHostPort::Iface::receive(CanFrame& out_frame, MonotonicTime& out_ts_monotonic, UtcTime& out_ts_utc,
+                                          CanIOFlags& out_flags)
+{
+    UAVCAN_ASSERT(port_ != UAVCAN_NULLPTR);
+    return port_->popRx(index_, out_frame, out_ts_monotonic, out_ts_utc, out_flags);
+}
+
+/*
+ * MultiNodeHostPort
+ */
+MultiNodeHostPort::MultiNodeHostPort(MultiNodeHost& host)
+    : host_(host)
+    , node_(UAVCAN_NULLPTR)
+    , rx_queue_len_(0)
+    , listener_revision_(0)
+    , receives_all_(false)
+    , index_valid_(false)
+    , rx_frames_dropped_(0)
+{
+    for (uint8_t i = 0; i < MaxCanIfaces; i++)
+    {
+        ifaces_[i].init(this, i);
+        rx_head_[i] = UAVCAN_NULLPTR;
+        rx_tail_[i] = UAVCAN_NULLPTR;
+        tx_credits_[i] = 0;
+    }
+    host_.addPort(this);
+}
+
+MultiNodeHostPort::~MultiNodeHostPort()
+{
+    host_.removePort(this);
+    clearRx();
+}
+
+bool MultiNodeHostPort::pushRx(const CanRxFrame& frame, CanIOFlags flags)
+{
+    UAVCAN_ASSERT(frame.iface_index < MaxCanIfaces);
+    if (rx_queue_len_ >= host_.rx_queue_capacity_)
+    {
+        rx_frames_dropped_++;
+        return false;
+    }
+
+    void* const praw = host_.allocator_.allocate(sizeof(RxQueueEntry));
+    if (praw == UAVCAN_NULLPTR)
+    {
+        rx_frames_dropped_++;
+        return false;
+    }
+    RxQueueEntry* const entry = new (praw) RxQueueEntry(frame, flags);
+
+    const uint8_t index = frame.iface_index;
+    if (rx_tail_[index] == UAVCAN_NULLPTR)
+    {
+        rx_head_[index] = entry;
+    }
+    else
+    {
+        rx_tail_[index]->next = entry;
+    }
+    rx_tail_[index] = entry;
+    rx_queue_len_++;
+    return true;
+}
+
+int16_t MultiNodeHostPort::popRx(uint8_t iface_index, CanFrame& out_frame, MonotonicTime& out_ts_monotonic,
+                                 UtcTime& out_ts_utc, CanIOFlags& out_flags)
+{
+    UAVCAN_ASSERT(iface_index < MaxCanIfaces);
+    RxQueueEntry* const entry = rx_head_[iface_index];
+    if (entry == UAVCAN_NULLPTR)
+    {
+        return 0;
+    }
+
+    out_frame = entry->frame;
+    out_ts_monotonic = entry->frame.ts_mono;
+    out_ts_utc = entry->frame.ts_utc;
+    out_flags = entry->flags;
+
+    rx_head_[iface_index] = entry->next;
+    if (rx_head_[iface_index] == UAVCAN_NULLPTR)
+    {
+        rx_tail_[iface_index] = UAVCAN_NULLPTR;
+    }
+    UAVCAN_ASSERT(rx_queue_len_ > 0);
+    rx_queue_len_--;
+
+    entry->~RxQueueEntry();
+    host_.allocator_.deallocate(entry);
+    return 1;
+}
+
+void MultiNodeHostPort::clearRx()
+{
+    for (uint8_t i = 0; i < MaxCanIfaces; i++)
+    {
+        CanFrame frame;
+        MonotonicTime ts_mono;
+        UtcTime ts_utc;
+        CanIOFlags flags = 0;
+        while (popRx(i, frame, ts_mono, ts_utc, flags) > 0)
+        { }
+    }
+    UAVCAN_ASSERT(rx_queue_len_ == 0);
+}
+
+bool MultiNodeHostPort::hasPendingRx() const
+{
+    return rx_queue_len_ > 0;
+}
+
+bool MultiNodeHostPort::needsSpin(MonotonicTime ts) const
+{
+    if (node_ == UAVCAN_NULLPTR)
+    {
+        return false;
+    }
+    return hasPendingRx() ||
+           (node_->getDispatcher().getCanIOManager().makePendingTxMask() != 0) ||
+           (node_->getScheduler().getDeadlineScheduler().getNextWakeupTime() <= ts);
+}
+
+void MultiNodeHostPort::setNode(INode& node)
+{
+    UAVCAN_ASSERT(&node.getDispatcher().getCanIOManager().getCanDriver() == this);
+    node_ = &node;
+    index_valid_ = false;
+    host_.refreshPort(this);
+}
+
+ICanIface* MultiNodeHostPort::getIface(uint8_t iface_index)
+{
+    return (iface_index < getNumIfaces()) ? &ifaces_[iface_index] : UAVCAN_NULLPTR;
+}
+
+const ICanIface* MultiNodeHostPort::getIface(uint8_t iface_index) const
+{
+    return (iface_index < getNumIfaces()) ? &ifaces_[iface_index] : UAVCAN_NULLPTR;
+}
+
+uint8_t MultiNodeHostPort::getNumIfaces() const
+{
+    return host_.canio_.getNumIfaces();
+}
+
+int16_t MultiNodeHostPort::select(CanSelectMasks& inout_masks, const CanFrame* (&)[MaxCanIfaces], MonotonicTime)
+{
+    /*
+     * Never blocks - the waiting is done by the host on the real driver.
+     */
+    uint8_t read_mask = 0;
+    uint8_t write_mask = 0;
+    int16_t num_ready = 0;
+    for (uint8_t i = 0; i < getNumIfaces(); i++)
+    {
+        const uint8_t mask = uint8_t(1U << i);
+        const bool readable = ((inout_masks.read & mask) != 0) && (rx_head_[i] != UAVCAN_NULLPTR);
+        const bool writeable = ((inout_masks.write & mask) != 0) && (tx_credits_[i] > 0);
+        if (readable)
+        {
+            read_mask = uint8_t(read_mask | mask);
+        }
+        if (writeable)
+        {
+            write_mask = uint8_t(write_mask | mask);
+        }
+        if (readable || writeable)
+        {
+            num_ready++;
+        }
+    }
+    inout_masks.read = read_mask;
+    inout_masks.write = write_mask;
+    return num_ready;
+}
+
+/*
+ * MultiNodeHost
+ */
+MultiNodeHost::MultiNodeHost(ICanDriver& can_driver, ISystemClock& system_clock, IPoolAllocator& allocator)
+    : canio_(can_driver, allocator, system_clock)
+    , sysclock_(system_clock)
+    , allocator_(allocator)
+    , num_promiscuous_ports_(0)
+    , tx_frames_per_round_(DefaultTxFramesPerRound)
+    , rx_queue_capacity_(DefaultRxQueueCapacity)
+    , frames_routed_(0)
+    , frames_delivered_(0)
+{
+    for (unsigned i = 0; i <= NodeID::Max; i++)
+    {
+        ports_by_node_id_[i] = UAVCAN_NULLPTR;
+    }
+    for (unsigned i = 0; i < SubscriptionIndexSize; i++)
+    {
+        subscriptions_[i] = UAVCAN_NULLPTR;
+    }
+}
+
+MultiNodeHost::~MultiNodeHost()
+{
+    UAVCAN_ASSERT(ports_.isEmpty());    // The ports must be destroyed before the host
+}
+
+void MultiNodeHost::addPort(MultiNodeHostPort* port)
+{
+    UAVCAN_ASSERT(port != UAVCAN_NULLPTR);
+    ports_.insert(port);
+    setPortReceivesAll(port, true);     // Until the node is bound, we don't know what it needs
+    for (uint8_t i = 0; i < MaxCanIfaces; i++)
+    {
+        port->tx_credits_[i] = tx_frames_per_round_;
+    }
+}
+
+void MultiNodeHost::removePort(MultiNodeHostPort* port)
+{
+    UAVCAN_ASSERT(port != UAVCAN_NULLPTR);
+    removeSubscriptions(port);
+    setPortReceivesAll(port, false);
+    if (port->node_id_.isUnicast() && (ports_by_node_id_[port->node_id_.get()] == port))
+    {
+        ports_by_node_id_[port->node_id_.get()] = UAVCAN_NULLPTR;
+    }
+    ports_.remove(port);
+}
+
+void MultiNodeHost::removeSubscriptions(MultiNodeHostPort* port)
+{
+    for (unsigned i = 0; i < SubscriptionIndexSize; i++)
+    {
+        Subscription** pp = &subscriptions_[i];
+        while (*pp != UAVCAN_NULLPTR)
+        {
+            Subscription* const sub = *pp;
+            if (sub->port == port)
+            {
+                *pp = sub->next;
+                sub->~Subscription();
+                allocator_.deallocate(sub);
+            }
+            else
+            {
+                pp = &sub->next;
+            }
+        }
+    }
+}
+
+bool MultiNodeHost::addSubscriptions(MultiNodeHostPort* port)
+{
+    UAVCAN_ASSERT(port->node_ != UAVCAN_NULLPTR);
+    const TransferListener* listener = port->node_->getDispatcher().getListOfMessageListeners().get();
+    int prev_data_type_id = -1;
+    while (listener != UAVCAN_NULLPTR)
+    {
+        const uint16_t data_type_id = listener->getDataTypeDescriptor().getID().get();
+        if (int(data_type_id) != prev_data_type_id)     // The list is ordered by data type ID
+        {
+            void* const praw = allocator_.allocate(sizeof(Subscription));
+            if (praw == UAVCAN_NULLPTR)
+            {
+                return false;
+            }
+            Subscription* const sub = new (praw) Subscription(port, data_type_id);
+            Subscription*& bucket = subscriptions_[computeSubscriptionBucket(data_type_id)];
+            sub->next = bucket;
+            bucket = sub;
+            prev_data_type_id = int(data_type_id);
+        }
+        listener = listener->getNextListNode();
+    }
+    return true;
+}
+
+void MultiNodeHost::setPortReceivesAll(MultiNodeHostPort* port, bool receives_all)
+{
+    if (port->receives_all_ != receives_all)
+    {
+        port->receives_all_ = receives_all;
+        if (receives_all)
+        {
+            num_promiscuous_ports_++;
+        }
+        else
+        {
+            UAVCAN_ASSERT(num_promiscuous_ports_ > 0);
+            num_promiscuous_ports_--;
+        }
+    }
+}
+
+void MultiNodeHost::refreshPort(MultiNodeHostPort* port)
+{
+    if (port->node_ == UAVCAN_NULLPTR)
+    {
+        return;
+    }
+    const Dispatcher& dispatcher = port->node_->getDispatcher();
+
+    const NodeID node_id = dispatcher.getNodeID();
+    if (node_id != port->node_id_)
+    {
+        if (port->node_id_.isUnicast() && (ports_by_node_id_[port->node_id_.get()] == port))
+        {
+            ports_by_node_id_[port->node_id_.get()] = UAVCAN_NULLPTR;
+        }
+        port->node_id_ = node_id;
+        if (node_id.isUnicast())
+        {
+            if (ports_by_node_id_[node_id.get()] == UAVCAN_NULLPTR)
+            {
+                ports_by_node_id_[node_id.get()] = port;
+            }
+            else
+            {
+                UAVCAN_TRACE("MultiNodeHost", "Node ID %d is used by more than one hosted node", int(node_id.get()));
+            }
+        }
+    }
+
+    if (!port->index_valid_ || (port->listener_revision_ != dispatcher.getListenerRevision()))
+    {
+        port->listener_revision_ = dispatcher.getListenerRevision();
+        port->index_valid_ = true;
+
+        removeSubscriptions(port);
+        bool receives_all = (dispatcher.getRxFrameListener() != UAVCAN_NULLPTR) ||
+                            (dispatcher.getWildcardTransferListener() != UAVCAN_NULLPTR);
+        if (!receives_all && !addSubscriptions(port))
+        {
+            UAVCAN_TRACE("MultiNodeHost", "Subscription index OOM, falling back to unfiltered RX");
+            removeSubscriptions(port);
+            receives_all = true;
+        }
+        setPortReceivesAll(port, receives_all);
+    }
+}
+
+void MultiNodeHost::refreshPorts()
+{
+    MultiNodeHostPort* port = ports_.get();
+    while (port != UAVCAN_NULLPTR)
+    {
+        refreshPort(port);
+        for (uint8_t i = 0; i < MaxCanIfaces; i++)
+        {
+            port->tx_credits_[i] = tx_frames_per_round_;
+        }
+        port = port->getNextListNode();
+    }
+}
+
+void MultiNodeHost::deliver(MultiNodeHostPort* port, const CanRxFrame& frame, CanIOFlags flags)
+{
+    if (port->pushRx(frame, flags))
+    {
+        frames_delivered_++;
+    }
+}
+
+void MultiNodeHost::route(const CanRxFrame& frame, CanIOFlags flags, const MultiNodeHostPort* origin)
+{
+    frames_routed_++;
+
+    Frame parsed;
+    const bool parsed_ok = parsed.parse(frame);
+
+    if (flags & CanIOFlagLoopback)
+    {
+        // Loopback frames go back to the sender only; anonymous ones can't be attributed to any node
+        if (parsed_ok && parsed.getSrcNodeID().isUnicast())
+        {
+            MultiNodeHostPort* const port = ports_by_node_id_[parsed.getSrcNodeID().get()];
+            if (port != UAVCAN_NULLPTR)
+            {
+                deliver(port, frame, flags);
+            }
+        }
+        return;
+    }
+
+    if (parsed_ok)
+    {
+        const NodeID dst = parsed.getDstNodeID();
+        if (dst.isUnicast())
+        {
+            MultiNodeHostPort* const port = ports_by_node_id_[dst.get()];
+            if ((port != UAVCAN_NULLPTR) && (port != origin) && !port->receives_all_)
+            {
+                deliver(port, frame, flags);
+            }
+        }
+        else if (parsed.getTransferType() == TransferTypeMessageBroadcast)
+        {
+            // Ports that receive all frames have no subscriptions in the index
+            const uint16_t data_type_id = parsed.getDataTypeID().get();
+            Subscription* sub = subscriptions_[computeSubscriptionBucket(data_type_id)];
+            while (sub != UAVCAN_NULLPTR)
+            {
+                if ((sub->data_type_id == data_type_id) && (sub->port != origin))
+                {
+                    deliver(sub->port, frame, flags);
+                }
+                sub = sub->next;
+            }
+        }
+    }
+
+    if (num_promiscuous_ports_ > 0)
+    {
+        MultiNodeHostPort* port = ports_.get();
+        while (port != UAVCAN_NULLPTR)
+        {
+            if (port->receives_all_ && (port != origin))
+            {
+                deliver(port, frame, flags);
+            }
+            port = port->getNextListNode();
+        }
+    }
+}
+
+int16_t MultiNodeHost::sendFromPort(MultiNodeHostPort* port, uint8_t iface_index, const CanFrame& frame,
+                                    MonotonicTime tx_deadline, CanIOFlags flags)
+{
+    UAVCAN_ASSERT(iface_index < MaxCanIfaces);
+    if (port->tx_credits_[iface_index] == 0)
+    {
+        return 0;
+    }
+
+    // Non-blocking; if the bus is busy, the frame waits in the shared queue, ordered by CAN priority
+    const int res = canio_.send(frame, tx_deadline, MonotonicTime(), uint8_t(1U << iface_index),
+                                CanTxQueue::Volatile, flags);
+    if (res < 0)
+    {
+        return int16_t(res);
+    }
+    port->tx_credits_[iface_index]--;
+
+    // The real driver doesn't report our own frames back, so the other hosted nodes get them from here.
+    // The loopback flag is not propagated; the loopback frame will be reported by the real driver.
+    CanRxFrame rx_frame;
+    static_cast<CanFrame&>(rx_frame) = frame;
+    rx_frame.ts_mono = sysclock_.getMonotonic();
+    rx_frame.iface_index = iface_index;
+    route(rx_frame, 0, port);
+
+    return 1;
+}
+
+int MultiNodeHost::receiveAndRoute(MonotonicTime blocking_deadline)
+{
+    int num_frames = 0;
+    while (true)
+    {
+        CanIOFlags flags = 0;
+        CanRxFrame frame;
+        const int res = canio_.receive(frame, blocking_deadline, flags);
+        if (res < 0)
+        {
+            return res;
+        }
+        if (res == 0)
+        {
+            break;
+        }
+        route(frame, flags, UAVCAN_NULLPTR);
+        num_frames++;
+        blocking_deadline = MonotonicTime();        // Only the first frame is waited for
+    }
+    return num_frames;
+}
+
+int MultiNodeHost::spinPorts()
+{
+    const MonotonicTime ts = sysclock_.getMonotonic();
+    int retval = 0;
+    MultiNodeHostPort* port = ports_.get();
+    while (port != UAVCAN_NULLPTR)
+    {
+        MultiNodeHostPort* const next = port->getNextListNode();
+        if (port->needsSpin(ts))
+        {
+            const int res = port->node_->spinOnce();
+            if (res < 0)
+            {
+                UAVCAN_TRACE("MultiNodeHost", "Hosted node spin failure: %d", res);
+                retval = res;           // One failing node shall not stop the others
+            }
+        }
+        port = next;
+    }
+    return retval;
+}
+
+MonotonicTime MultiNodeHost::computeNextDeadline(MonotonicTime spin_deadline) const
+{
+    MonotonicTime deadline = spin_deadline;
+    const MultiNodeHostPort* port = ports_.get();
+    while (port != UAVCAN_NULLPTR)
+    {
+        if (port->node_ != UAVCAN_NULLPTR)
+        {
+            if (port->hasPendingRx() || (port->node_->getDispatcher().getCanIOManager().makePendingTxMask() != 0))
+            {
+                return MonotonicTime();
+            }
+            deadline = min(deadline, port->node_->getScheduler().getDeadlineScheduler().getNextWakeupTime());
+        }
+        port = port->getNextListNode();
+    }
+    return deadline;
+}
+
+int MultiNodeHost::spinOnce()
+{
+    refreshPorts();
+    const int num_frames = receiveAndRoute(MonotonicTime());
+    if (num_frames < 0)
+    {
+        return num_frames;
+    }
+    const int res = spinPorts();
+    return (res < 0) ? res : num_frames;
+}
+
+int MultiNodeHost::spin(MonotonicTime deadline)
+{
+    while (true)
+    {
+        refreshPorts();
+        int res = receiveAndRoute(computeNextDeadline(deadline));
+        if (res < 0)
+        {
+            return res;
+        }
+        res = spinPorts();
+        if (res < 0)
+        {
+            return res;
+        }
+        if (sysclock_.getMonotonic() >= deadline)
+        {
+            break;
+        }
+    }
+    return 0;
+}
+
+}
+
+#endif
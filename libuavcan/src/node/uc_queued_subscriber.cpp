@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <uavcan/node/queued_subscriber.hpp>
+
+namespace uavcan
+{
+namespace
+{
+
+struct AppendToTail
+{
+    bool operator()(const void*) const { return false; }
+};
+
+}
+
+const uint16_t QueuedSubscriberBase::DefaultCapacity;
+
+/*
+ * QueuedSubscriberBase::Entry
+ */
+void QueuedSubscriberBase::Entry::destroy(Entry*& obj, IPoolAllocator& allocator)
+{
+    if (obj != UAVCAN_NULLPTR)
+    {
+        TransferBufferManagerEntry::destroy(obj->payload, allocator);
+        obj->~Entry();
+        allocator.deallocate(obj);
+        obj = UAVCAN_NULLPTR;
+    }
+}
+
+/*
+ * QueuedSubscriberBase::QueuedIncomingTransfer
+ */
+int QueuedSubscriberBase::QueuedIncomingTransfer::read(unsigned offset, uint8_t* data, unsigned len) const
+{
+    if (payload_ == UAVCAN_NULLPTR)
+    {
+        UAVCAN_ASSERT(0);
+        return -ErrLogic;
+    }
+    return payload_->read(offset, data, len);
+}
+
+int QueuedSubscriberBase::QueuedIncomingTransfer::peek(unsigned offset, const uint8_t*& out_data) const
+{
+    if (payload_ == UAVCAN_NULLPTR)
+    {
+        UAVCAN_ASSERT(0);
+        return -ErrLogic;
+    }
+    return payload_->peek(offset, out_data);
+}
+
+/*
+ * QueuedSubscriberBase
+ */
+QueuedSubscriberBase::Entry* QueuedSubscriberBase::findReplaceableEntry(NodeID src_node_id) const
+{
+    if (policy_ == PolicyKeepLatest)
+    {
+        return queue_.get();
+    }
+    if (policy_ == PolicyKeepLatestPerSource)
+    {
+        Entry* p = queue_.get();
+        while (p)
+        {
+            if (p->src_node_id == src_node_id.get())
+            {
+                return p;
+            }
+            p = p->getNextListNode();
+        }
+    }
+    return UAVCAN_NULLPTR;
+}
+
+QueuedSubscriberBase::Entry* QueuedSubscriberBase::makeEntry(IncomingTransfer& transfer, uint16_t max_payload_len)
+{
+    void* const praw = allocator_.allocate(sizeof(Entry));
+    if (praw == UAVCAN_NULLPTR)
+    {
+        return UAVCAN_NULLPTR;
+    }
+    Entry* entry = new (praw) Entry();
+
+    entry->payload = TransferBufferManagerEntry::instantiate(allocator_, max_payload_len);
+    if (entry->payload == UAVCAN_NULLPTR)
+    {
+        Entry::destroy(entry, allocator_);
+        return UAVCAN_NULLPTR;
+    }
+
+    // The payload is copied piece by piece, so it doesn't need to be reassembled in a temporary buffer
+    unsigned offset = 0;
+    const uint8_t* data = UAVCAN_NULLPTR;
+    int len = 0;
+    while ((len = transfer.peek(offset, data)) > 0)
+    {
+        if (entry->payload->write(offset, data, unsigned(len)) != len)
+        {
+            UAVCAN_TRACE("QueuedSubscriber", "Payload OOM");
+            Entry::destroy(entry, allocator_);
+            return UAVCAN_NULLPTR;
+        }
+        offset += unsigned(len);
+    }
+    if (len < 0)
+    {
+        Entry::destroy(entry, allocator_);
+        return UAVCAN_NULLPTR;
+    }
+
+    entry->ts_mono = transfer.getMonotonicTimestamp();
+    entry->ts_utc = transfer.getUtcTimestamp();
+    entry->priority = transfer.getPriority().get();
+    entry->transfer_id = transfer.getTransferID().get();
+    entry->src_node_id = transfer.getSrcNodeID().get();
+    entry->iface_index = transfer.getIfaceIndex();
+    entry->anonymous = transfer.isAnonymousTransfer();
+    return entry;
+}
+
+void QueuedSubscriberBase::enqueue(IncomingTransfer& transfer, uint16_t max_payload_len)
+{
+    Entry* replaceable = findReplaceableEntry(transfer.getSrcNodeID());
+
+    if ((replaceable == UAVCAN_NULLPTR) && (policy_ != PolicyKeepLatest) && (queue_len_ >= capacity_))
+    {
+        UAVCAN_TRACE("QueuedSubscriber", "Queue is full");
+        dropped_count_++;
+        return;
+    }
+
+    Entry* entry = makeEntry(transfer, max_payload_len);
+    if ((entry == UAVCAN_NULLPTR) && (replaceable != UAVCAN_NULLPTR))
+    {
+        // The memory of the entry that is going to be replaced anyway can be reused
+        queue_.remove(replaceable);
+        queue_len_--;
+        Entry::destroy(replaceable, allocator_);
+        conflated_count_++;
+        entry = makeEntry(transfer, max_payload_len);
+    }
+
+    if (entry == UAVCAN_NULLPTR)
+    {
+        UAVCAN_TRACE("QueuedSubscriber", "Pool quota exhausted");
+        dropped_count_++;
+        return;
+    }
+
+    if (replaceable != UAVCAN_NULLPTR)
+    {
+        queue_.remove(replaceable);
+        queue_len_--;
+        Entry::destroy(replaceable, allocator_);
+        conflated_count_++;
+    }
+
+    queue_.insertBefore(entry, AppendToTail());     // The oldest entry is always the first one
+    queue_len_++;
+}
+
+QueuedSubscriberBase::Entry* QueuedSubscriberBase::popFront()
+{
+    Entry* const entry = queue_.get();
+    if (entry != UAVCAN_NULLPTR)
+    {
+        queue_.remove(entry);
+        queue_len_--;
+    }
+    return entry;
+}
+
+void QueuedSubscriberBase::clear()
+{
+    Entry* entry = popFront();
+    while (entry != UAVCAN_NULLPTR)
+    {
+        destroyEntry(entry);
+        entry = popFront();
+    }
+}
+
+}
@@ -86,6 +86,20 @@ bool DeadlineScheduler::doesExist(const DeadlineHandler* mdh) const
 
 MonotonicTime DeadlineScheduler::pollAndGetMonotonicTime(ISystemClock& sysclock)
 {
+    /*
+     * Deadlines past the earliest one but not past the wakeup time are served now only thanks to the slack;
+     * these are the wakeups saved. Handlers that are merely late, e.g. after a long spin, are not counted.
+     */
+    const MonotonicTime trigger_deadline = getEarliestDeadline();
+    const MonotonicTime wakeup = getNextWakeupTime();
+    {
+        const MonotonicTime ts = sysclock.getMonotonic();
+        if (ts < wakeup)                // Handlers that are already due can wait for the rest of their group
+        {
+            return ts;
+        }
+    }
+
     while (true)
     {
         DeadlineHandler* const mdh = handlers_.get();
@@ -107,6 +121,10 @@ MonotonicTime DeadlineScheduler::pollAndGetMonotonicTime(ISystemClock& sysclock)
         }
 
         handlers_.remove(mdh);
+        if ((mdh->getDeadline() > trigger_deadline) && (mdh->getDeadline() <= wakeup))
+        {
+            num_coalesced_deadlines_++;
+        }
         mdh->handleDeadline(ts);   // This handler can be re-registered immediately
     }
     UAVCAN_ASSERT(0);
@@ -123,12 +141,26 @@ MonotonicTime DeadlineScheduler::getEarliestDeadline() const
     return MonotonicTime::getMax();
 }
 
+MonotonicTime DeadlineScheduler::getNextWakeupTime() const
+{
+    MonotonicTime wakeup = MonotonicTime::getMax();
+    const DeadlineHandler* p = handlers_.get();
+    while ((p != UAVCAN_NULLPTR) && (p->getDeadline() <= wakeup))   // Ordered by deadline, so the rest is later
+    {
+        const MonotonicTime latest =
+            p->getSlack().isZero() ? p->getDeadline() : (p->getDeadline() + p->getSlack());
+        wakeup = min(wakeup, latest);
+        p = p->getNextListNode();
+    }
+    return wakeup;
+}
+
 /*
  * Scheduler
  */
 MonotonicTime Scheduler::computeDispatcherSpinDeadline(MonotonicTime spin_deadline) const
 {
-    const MonotonicTime earliest = min(deadline_scheduler_.getEarliestDeadline(), spin_deadline);
+    const MonotonicTime earliest = min(deadline_scheduler_.getNextWakeupTime(), spin_deadline);
     const MonotonicTime ts = getMonotonicTime();
     if (earliest > ts)
     {
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <uavcan/node/service_call_pipeline.hpp>
+
+namespace uavcan
+{
+/*
+ * ServiceCallFutureBase
+ */
+ServiceCallFutureBase::~ServiceCallFutureBase()
+{
+    if (owner_ != UAVCAN_NULLPTR)
+    {
+        owner_->detachFuture(*this);
+    }
+}
+
+/*
+ * ServiceCallPipelineBase
+ */
+void ServiceCallPipelineBase::detachFuture(const ServiceCallFutureBase& future)
+{
+    for (Job* p = queue_head_; p != UAVCAN_NULLPTR; p = p->getNextListNode())
+    {
+        if (p->future == &future)
+        {
+            p->future = UAVCAN_NULLPTR;
+            return;
+        }
+    }
+    for (Job* p = in_flight_.get(); p != UAVCAN_NULLPTR; p = p->getNextListNode())
+    {
+        if (p->future == &future)
+        {
+            p->future = UAVCAN_NULLPTR;
+            return;
+        }
+    }
+}
+
+int ServiceCallPipelineBase::StoredRequest::writePayload(ITransferBuffer& sink) const
+{
+    if (request_ == UAVCAN_NULLPTR)
+    {
+        return 0;                       // Empty request
+    }
+
+    unsigned offset = 0;
+    while (true)
+    {
+        const uint8_t* data = UAVCAN_NULLPTR;
+        const int len = request_->peek(offset, data);
+        if (len <= 0)
+        {
+            return len;
+        }
+        const int res = sink.write(offset, data, unsigned(len));
+        if (res != len)
+        {
+            return (res < 0) ? res : -ErrLogic;
+        }
+        offset += unsigned(len);
+    }
+}
+
+ServiceCallPipelineBase::Job* ServiceCallPipelineBase::makeJob(NodeID server_node_id, MonotonicTime deadline,
+                                                               const StaticTransferBufferImpl* encoded_request)
+{
+    void* const praw = allocator_.allocate(sizeof(Job));
+    if (praw == UAVCAN_NULLPTR)
+    {
+        return UAVCAN_NULLPTR;
+    }
+    Job* job = new (praw) Job();
+    job->server_node_id = server_node_id;
+    job->deadline = deadline;
+
+    if (encoded_request != UAVCAN_NULLPTR)
+    {
+        const uint16_t len = encoded_request->getMaxWritePos();
+        job->request = TransferBufferManagerEntry::instantiate(allocator_, len);
+        if ((job->request == UAVCAN_NULLPTR) ||
+            (job->request->write(0, encoded_request->getRawPtr(), len) != int(len)))
+        {
+            UAVCAN_TRACE("ServiceCallPipeline", "Request OOM");
+            destroyJob(job);
+            return UAVCAN_NULLPTR;
+        }
+    }
+    return job;
+}
+
+void ServiceCallPipelineBase::destroyJob(Job*& job)
+{
+    if (job != UAVCAN_NULLPTR)
+    {
+        TransferBufferManagerEntry::destroy(job->request, allocator_);
+        job->~Job();
+        allocator_.deallocate(job);
+        job = UAVCAN_NULLPTR;
+    }
+}
+
+void ServiceCallPipelineBase::pushBack(Job* job)
+{
+    UAVCAN_ASSERT(job != UAVCAN_NULLPTR);
+    job->setNextListNode(UAVCAN_NULLPTR);
+    if (queue_tail_ == UAVCAN_NULLPTR)
+    {
+        queue_head_ = job;
+    }
+    else
+    {
+        queue_tail_->setNextListNode(job);
+    }
+    queue_tail_ = job;
+    queue_len_++;
+}
+
+void ServiceCallPipelineBase::pushFront(Job* job)
+{
+    UAVCAN_ASSERT(job != UAVCAN_NULLPTR);
+    job->setNextListNode(queue_head_);
+    queue_head_ = job;
+    if (queue_tail_ == UAVCAN_NULLPTR)
+    {
+        queue_tail_ = job;
+    }
+    queue_len_++;
+}
+
+ServiceCallPipelineBase::Job* ServiceCallPipelineBase::popFront()
+{
+    Job* const job = queue_head_;
+    if (job != UAVCAN_NULLPTR)
+    {
+        queue_head_ = job->getNextListNode();
+        if (queue_head_ == UAVCAN_NULLPTR)
+        {
+            queue_tail_ = UAVCAN_NULLPTR;
+        }
+        job->setNextListNode(UAVCAN_NULLPTR);
+        queue_len_--;
+    }
+    return job;
+}
+
+void ServiceCallPipelineBase::addInFlight(Job* job, ServiceCallID call_id)
+{
+    UAVCAN_ASSERT(job != UAVCAN_NULLPTR);
+    job->call_id = call_id;
+    if (job->future != UAVCAN_NULLPTR)
+    {
+        job->future->num_attempts_ = job->num_attempts;
+    }
+    in_flight_.insert(job);
+    num_in_flight_++;
+}
+
+ServiceCallPipelineBase::Job* ServiceCallPipelineBase::takeInFlight(ServiceCallID call_id)
+{
+    for (Job* p = in_flight_.get(); p != UAVCAN_NULLPTR; p = p->getNextListNode())
+    {
+        if (p->call_id == call_id)
+        {
+            in_flight_.remove(p);
+            num_in_flight_--;
+            p->call_id = ServiceCallID();
+            return p;
+        }
+    }
+    return UAVCAN_NULLPTR;
+}
+
+void ServiceCallPipelineBase::registerSuccess(Job& job)
+{
+    num_succeeded_++;
+    if (job.future != UAVCAN_NULLPTR)
+    {
+        job.future->state_ = ServiceCallFutureBase::StateSucceeded;
+        job.future->owner_ = UAVCAN_NULLPTR;
+        job.future = UAVCAN_NULLPTR;
+    }
+}
+
+void ServiceCallPipelineBase::registerFailure(Job& job)
+{
+    num_failed_++;
+    if (job.future != UAVCAN_NULLPTR)
+    {
+        job.future->state_ = ServiceCallFutureBase::StateFailed;
+        job.future->owner_ = UAVCAN_NULLPTR;
+        job.future = UAVCAN_NULLPTR;
+    }
+}
+
+void ServiceCallPipelineBase::discardAllJobs()
+{
+    while (Job* job = popFront())
+    {
+        registerFailure(*job);
+        destroyJob(job);
+    }
+    while (Job* job = in_flight_.get())
+    {
+        in_flight_.remove(job);
+        num_in_flight_--;
+        registerFailure(*job);
+        destroyJob(job);
+    }
+    UAVCAN_ASSERT(queue_len_ == 0);
+    UAVCAN_ASSERT(num_in_flight_ == 0);
+}
+
+bool ServiceCallPipelineBase::attachFuture(Job& job, ServiceCallFutureBase& future)
+{
+    if (future.owner_ != UAVCAN_NULLPTR)
+    {
+        return false;
+    }
+    future.owner_ = this;
+    future.server_node_id_ = job.server_node_id;
+    future.state_ = ServiceCallFutureBase::StatePending;
+    future.num_attempts_ = 0;
+    job.future = &future;
+    return true;
+}
+
+}
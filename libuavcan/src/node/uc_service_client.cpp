@@ -25,6 +25,157 @@ void ServiceClientBase::CallState::handleDeadline(MonotonicTime)
     UAVCAN_TRACE("ServiceClient::CallState", "Relaying execution to the owner's handler via timer callback");
 }
 
+/*
+ * ServiceClientBase::CallRegistry
+ */
+ServiceClientBase::CallRegistry::CallRegistry(IPoolAllocator& allocator)
+    : allocator_(allocator)
+    , size_(0)
+{
+    IsDynamicallyAllocatable<CallState>::check();
+    StaticAssert<(NumBuckets > 0)>::check();
+    fill_n(buckets_, unsigned(NumBuckets), static_cast<CallState*>(UAVCAN_NULLPTR));
+}
+
+void ServiceClientBase::CallRegistry::unlinkAndDestroy(CallState* state)
+{
+    CallState*& head = buckets_[getBucketIndex(state->getCallID())];
+    if (head == state)
+    {
+        head = state->getNextInBucket();
+    }
+    else
+    {
+        CallState* p = head;
+        while ((p != UAVCAN_NULLPTR) && (p->getNextInBucket() != state))
+        {
+            p = p->getNextInBucket();
+        }
+        if (p == UAVCAN_NULLPTR)
+        {
+            UAVCAN_ASSERT(0);
+            return;
+        }
+        p->setNextInBucket(state->getNextInBucket());
+    }
+
+    state->~CallState();
+    allocator_.deallocate(state);
+    UAVCAN_ASSERT(size_ > 0);
+    size_--;
+}
+
+ServiceClientBase::CallState*
+ServiceClientBase::CallRegistry::add(INode& node, ServiceClientBase& owner, ServiceCallID call_id)
+{
+    void* const praw = allocator_.allocate(sizeof(CallState));
+    if (praw == UAVCAN_NULLPTR)
+    {
+        return UAVCAN_NULLPTR;
+    }
+    CallState* const state = new (praw) CallState(node, owner, call_id);
+
+    CallState*& head = buckets_[getBucketIndex(call_id)];
+    state->setNextInBucket(head);
+    head = state;
+    size_++;
+    return state;
+}
+
+ServiceClientBase::CallState* ServiceClientBase::CallRegistry::find(ServiceCallID call_id) const
+{
+    CallState* p = buckets_[getBucketIndex(call_id)];
+    while (p != UAVCAN_NULLPTR)
+    {
+        if ((p->getCallID() == call_id) && !p->hasTimedOut())
+        {
+            return p;
+        }
+        p = p->getNextInBucket();
+    }
+    return UAVCAN_NULLPTR;
+}
+
+void ServiceClientBase::CallRegistry::remove(ServiceCallID call_id)
+{
+    CallState* const state = find(call_id);
+    if (state != UAVCAN_NULLPTR)
+    {
+        unlinkAndDestroy(state);
+    }
+}
+
+bool ServiceClientBase::CallRegistry::removeNextTimedOut(unsigned& inout_bucket_index, ServiceCallID& out_call_id)
+{
+    for (; inout_bucket_index < unsigned(NumBuckets); inout_bucket_index++)
+    {
+        CallState* p = buckets_[inout_bucket_index];
+        while (p != UAVCAN_NULLPTR)
+        {
+            if (p->hasTimedOut())
+            {
+                out_call_id = p->getCallID();
+                unlinkAndDestroy(p);
+                return true;
+            }
+            p = p->getNextInBucket();
+        }
+    }
+    return false;
+}
+
+void ServiceClientBase::CallRegistry::clear()
+{
+    for (unsigned i = 0; i < unsigned(NumBuckets); i++)
+    {
+        while (buckets_[i] != UAVCAN_NULLPTR)
+        {
+            unlinkAndDestroy(buckets_[i]);
+        }
+    }
+    UAVCAN_ASSERT(size_ == 0);
+}
+
+bool ServiceClientBase::CallRegistry::hasCallToServer(NodeID server_node_id) const
+{
+    /*
+     * Every call to the server is kept in one of the buckets its transfer IDs map to, so the other buckets
+     * need not be checked.
+     */
+    for (unsigned tid = 0; tid <= TransferID::Max; tid++)
+    {
+        const ServiceCallID call_id(server_node_id, TransferID(uint8_t(tid)));
+        const CallState* p = buckets_[getBucketIndex(call_id)];
+        while (p != UAVCAN_NULLPTR)
+        {
+            if (p->getCallID() == call_id)
+            {
+                return true;
+            }
+            p = p->getNextInBucket();
+        }
+    }
+    return false;
+}
+
+const ServiceClientBase::CallState* ServiceClientBase::CallRegistry::getByIndex(unsigned index) const
+{
+    for (unsigned i = 0; i < unsigned(NumBuckets); i++)
+    {
+        const CallState* p = buckets_[i];
+        while (p != UAVCAN_NULLPTR)
+        {
+            if (index == 0)
+            {
+                return p;
+            }
+            index--;
+            p = p->getNextInBucket();
+        }
+    }
+    return UAVCAN_NULLPTR;
+}
+
 /*
  * ServiceClientBase
  */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <uavcan/node/service_server.hpp>
+#include <new>
+
+namespace uavcan
+{
+/*
+ * DeferredResponseRegistry
+ */
+void DeferredResponseRegistry::destroy(Entry* entry)
+{
+    UAVCAN_ASSERT(entry != UAVCAN_NULLPTR);
+    UAVCAN_ASSERT(size_ > 0);
+    list_.remove(entry);
+    entry->~Entry();
+    allocator_.deallocate(entry);
+    size_--;
+}
+
+int DeferredResponseRegistry::add(const ServiceResponseToken& token, MonotonicTime current_time)
+{
+    if (!token.isValid())
+    {
+        return -ErrInvalidParam;
+    }
+
+    removeExpired(current_time);
+
+    if (size_ >= capacity_)
+    {
+        return -ErrMemory;
+    }
+
+    void* const praw = allocator_.allocate(sizeof(Entry));
+    if (praw == UAVCAN_NULLPTR)
+    {
+        return -ErrMemory;
+    }
+    list_.insert(new (praw) Entry(token));
+    size_++;
+    return 0;
+}
+
+bool DeferredResponseRegistry::remove(const ServiceResponseToken& token, MonotonicTime current_time)
+{
+    Entry* p = list_.get();
+    while (p != UAVCAN_NULLPTR)
+    {
+        Entry* const next = p->getNextListNode();
+        if (p->token == token)
+        {
+            const bool expired = p->token.getDeadline() < current_time;
+            destroy(p);
+            return !expired;
+        }
+        p = next;
+    }
+    return false;
+}
+
+void DeferredResponseRegistry::removeExpired(MonotonicTime current_time)
+{
+    Entry* p = list_.get();
+    while (p != UAVCAN_NULLPTR)
+    {
+        Entry* const next = p->getNextListNode();
+        if (p->token.getDeadline() < current_time)
+        {
+            UAVCAN_TRACE("DeferredResponseRegistry", "Expired: client %i tid %i",
+                         int(p->token.getClientNodeID().get()), int(p->token.getTransferID().get()));
+            destroy(p);
+        }
+        p = next;
+    }
+}
+
+void DeferredResponseRegistry::clear()
+{
+    while (list_.get() != UAVCAN_NULLPTR)
+    {
+        destroy(list_.get());
+    }
+}
+
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <uavcan/transport/can_bridge.hpp>
+#include <uavcan/debug.hpp>
+
+namespace uavcan
+{
+
+const uint8_t CanBridge::MaxFilterRules;
+const uint8_t CanBridge::EchoHistoryDepth;
+
+/*
+ * CAN ID layout, refer to the specification and to Frame::parse()
+ */
+static const uint32_t CanIDServiceNotMessageMask = 1U << 7;
+static const uint32_t CanIDSrcNodeIDMask = NodeID::Max;
+static const unsigned CanIDDstNodeIDOffset = 8;
+
+bool CanBridge::isAllowedByFilter(const Side& side, uint32_t can_id)
+{
+    const bool service = (can_id & CanIDServiceNotMessageMask) != 0;
+    const DataTypeKind kind = service ? DataTypeKindService : DataTypeKindMessage;
+    uint16_t dtid = uint16_t(service ? ((can_id >> 16) & 0xFFU) : ((can_id >> 8) & 0xFFFFU));
+    if (!service && ((can_id & CanIDSrcNodeIDMask) == 0))
+    {
+        dtid = uint16_t(dtid & 3U);     // Anonymous message, removing the discriminator
+    }
+
+    for (uint8_t i = 0; i < side.num_rules; i++)
+    {
+        if ((side.rules[i].data_type_id == dtid) && (side.rules[i].kind == kind))
+        {
+            return side.rules[i].allow;
+        }
+    }
+    return side.allow_by_default;
+}
+
+void CanBridge::rewriteCanID(const Side& side, CanFrame& frame)
+{
+    uint32_t id = frame.id & CanFrame::MaskExtID;
+
+    const uint32_t src = id & CanIDSrcNodeIDMask;
+    id = (id & ~CanIDSrcNodeIDMask) | side.node_id_map[src];      // Zero (anonymous) is always mapped to itself
+
+    if ((id & CanIDServiceNotMessageMask) != 0)
+    {
+        const uint32_t dst = (id >> CanIDDstNodeIDOffset) & CanIDSrcNodeIDMask;
+        id = (id & ~(CanIDSrcNodeIDMask << CanIDDstNodeIDOffset)) |
+             (uint32_t(side.node_id_map[dst]) << CanIDDstNodeIDOffset);
+    }
+
+    frame.id = id | CanFrame::FlagEFF;
+}
+
+bool CanBridge::checkAndRemoveEcho(Side& side, const CanFrame& frame, MonotonicTime ts)
+{
+    for (uint8_t i = 0; i < EchoHistoryDepth; i++)
+    {
+        EchoEntry& entry = side.echo_history[i];
+        if (!entry.deadline.isZero() && (ts <= entry.deadline) && (entry.frame == frame))
+        {
+            entry.deadline = MonotonicTime();
+            return true;
+        }
+    }
+    return false;
+}
+
+void CanBridge::addToEchoHistory(Side& side, const CanFrame& frame, MonotonicTime deadline)
+{
+    EchoEntry& entry = side.echo_history[side.echo_history_pos];
+    entry.frame = frame;
+    entry.deadline = deadline;
+    side.echo_history_pos = uint8_t((side.echo_history_pos + 1U) % EchoHistoryDepth);
+}
+
+void CanBridge::forward(Direction dir, const CanRxFrame& frame)
+{
+    Side& src = getSourceSide(dir);
+    Side& dst = getTargetSide(dir);
+
+    if (frame.isErrorFrame() || frame.isRemoteTransmissionRequest() || !frame.isExtended() || (frame.dlc < 1))
+    {
+        return;
+    }
+
+    if (checkAndRemoveEcho(src, frame, frame.ts_mono))
+    {
+        UAVCAN_TRACE("CanBridge", "Echo ignored: %s", frame.toString().c_str());
+        src.counters.echoes_ignored++;
+        return;
+    }
+
+    if (!isAllowedByFilter(src, frame.id & CanFrame::MaskExtID))
+    {
+        src.counters.frames_filtered++;
+        return;
+    }
+
+    CanFrame out_frame(frame);
+    rewriteCanID(src, out_frame);
+
+    const MonotonicTime tx_deadline = frame.ts_mono + latency_budget_;
+    const uint8_t num_dst_ifaces = dst.canio.getNumIfaces();
+    const uint8_t iface_index = (frame.iface_index < num_dst_ifaces) ? frame.iface_index : uint8_t(num_dst_ifaces - 1U);
+
+    if (sysclock_.getMonotonic() > tx_deadline)
+    {
+        src.counters.frames_dropped++;
+        return;
+    }
+
+    addToEchoHistory(dst, out_frame, tx_deadline + latency_budget_);
+
+    const int res = dst.canio.send(out_frame, tx_deadline, MonotonicTime(), uint8_t(1U << iface_index),
+                                   CanTxQueue::Volatile, CanIOFlags(0));
+    if (res < 0)
+    {
+        UAVCAN_TRACE("CanBridge", "Frame dropped [res=%i]: %s", res, frame.toString().c_str());
+        src.counters.frames_dropped++;
+    }
+    else
+    {
+        src.counters.frames_forwarded++;
+    }
+}
+
+int CanBridge::receiveAndForward(Direction dir, MonotonicTime blocking_deadline)
+{
+    CanRxFrame frame;
+    CanIOFlags flags = 0;
+    const int res = getSourceSide(dir).canio.receive(frame, blocking_deadline, flags);
+    if (res > 0 && ((flags & CanIOFlagLoopback) == 0))
+    {
+        forward(dir, frame);
+    }
+    return res;
+}
+
+int CanBridge::spin(MonotonicTime deadline)
+{
+    /*
+     * The buses are served by different drivers that cannot be waited on together, so the bridge blocks on them
+     * in turns. The blocking time is limited to make sure that the frames from the other bus are not delayed for
+     * longer than a fraction of the latency budget. The lower limit keeps a zero budget from turning this into
+     * a busy loop.
+     */
+    const MonotonicDuration poll_interval = max(MonotonicDuration::fromUSec(latency_budget_.toUSec() / 4),
+                                                MonotonicDuration::fromMSec(1));
+    Direction blocking_dir = DirectionAToB;
+    do
+    {
+        const MonotonicTime ts = sysclock_.getMonotonic();
+        const MonotonicTime blocking_deadline = min(deadline, ts + poll_interval);
+
+        int res = receiveAndForward(blocking_dir, blocking_deadline);
+        blocking_dir = (blocking_dir == DirectionAToB) ? DirectionBToA : DirectionAToB;
+        if (res < 0)
+        {
+            return res;
+        }
+
+        res = spinOnce();
+        if (res < 0)
+        {
+            return res;
+        }
+    }
+    while (sysclock_.getMonotonic() < deadline);
+
+    return 0;
+}
+
+int CanBridge::spinOnce()
+{
+    int num_forwarded = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        const Direction dir = (i == 0) ? DirectionAToB : DirectionBToA;
+        const uint64_t forwarded_before = getSourceSide(dir).counters.frames_forwarded;
+        while (true)
+        {
+            const int res = receiveAndForward(dir, MonotonicTime());
+            if (res < 0)
+            {
+                return res;
+            }
+            if (res == 0)
+            {
+                break;
+            }
+        }
+        num_forwarded += int(getSourceSide(dir).counters.frames_forwarded - forwarded_before);
+    }
+    return num_forwarded;
+}
+
+void CanBridge::setDefaultFilterPolicy(Direction dir, bool allow)
+{
+    getSourceSide(dir).allow_by_default = allow;
+}
+
+int CanBridge::addFilterRule(Direction dir, DataTypeKind kind, DataTypeID data_type_id, bool allow)
+{
+    if (!data_type_id.isValidForDataTypeKind(kind))
+    {
+        return -ErrInvalidParam;
+    }
+
+    Side& side = getSourceSide(dir);
+    for (uint8_t i = 0; i < side.num_rules; i++)
+    {
+        if ((side.rules[i].data_type_id == data_type_id.get()) && (side.rules[i].kind == kind))
+        {
+            side.rules[i].allow = allow;
+            return 0;
+        }
+    }
+
+    if (side.num_rules >= MaxFilterRules)
+    {
+        return -ErrMemory;
+    }
+    FilterRule& rule = side.rules[side.num_rules++];
+    rule.data_type_id = data_type_id.get();
+    rule.kind = uint8_t(kind);
+    rule.allow = allow;
+    return 0;
+}
+
+void CanBridge::removeAllFilterRules(Direction dir)
+{
+    getSourceSide(dir).num_rules = 0;
+}
+
+int CanBridge::setNodeIDMapping(NodeID node_id_on_a, NodeID node_id_on_b)
+{
+    if (!node_id_on_a.isUnicast() || !node_id_on_b.isUnicast())
+    {
+        return -ErrInvalidParam;
+    }
+    const uint8_t a = node_id_on_a.get();
+    const uint8_t b = node_id_on_b.get();
+
+    /*
+     * The maps are kept inverse to each other: the IDs that were previously paired with A and B are paired
+     * together, so that no stale reverse entry keeps routing frames to the previously mapped node.
+     */
+    const uint8_t prev_b = side_a_.node_id_map[a];
+    const uint8_t prev_a = side_b_.node_id_map[b];
+    side_a_.node_id_map[prev_a] = prev_b;
+    side_b_.node_id_map[prev_b] = prev_a;
+
+    side_a_.node_id_map[a] = b;
+    side_b_.node_id_map[b] = a;
+    return 0;
+}
+
+}
@@ -105,6 +105,35 @@ void CanTxQueue::registerRejectedFrame()
     }
 }
 
+bool CanTxQueue::isSingleFrameTransfer(const CanFrame& frame)
+{
+    if (frame.isErrorFrame() || frame.isRemoteTransmissionRequest() || (frame.dlc < 1))
+    {
+        return false;
+    }
+    const uint8_t tail = frame.data[frame.dlc - 1U];
+    return ((tail & (1U << 7)) != 0) && ((tail & (1U << 6)) != 0);     // Start and end of transfer
+}
+
+CanTxQueue::Entry* CanTxQueue::findReplaceableEntry(const CanFrame& frame, Qos qos)
+{
+    if (!isSingleFrameTransfer(frame))
+    {
+        return UAVCAN_NULLPTR;
+    }
+    Entry* p = queue_.get();
+    while (p)
+    {
+        if ((p->frame.id == frame.id) && (p->qos == uint8_t(qos)) && ((p->flags & CanIOFlagReplaceQueued) != 0) &&
+            isSingleFrameTransfer(p->frame))
+        {
+            return p;
+        }
+        p = p->getNextListNode();
+    }
+    return UAVCAN_NULLPTR;
+}
+
 void CanTxQueue::push(const CanFrame& frame, MonotonicTime tx_deadline, Qos qos, CanIOFlags flags)
 {
     const MonotonicTime timestamp = sysclock_.getMonotonic();
@@ -116,6 +145,23 @@ void CanTxQueue::push(const CanFrame& frame, MonotonicTime tx_deadline, Qos qos,
         return;
     }
 
+    if ((flags & CanIOFlagReplaceQueued) != 0)
+    {
+        // The replacement has the same CAN ID, so it keeps the position of the old frame in the queue
+        Entry* const replaceable = findReplaceableEntry(frame, qos);
+        if (replaceable != UAVCAN_NULLPTR)
+        {
+            UAVCAN_TRACE("CanTxQueue", "Push: Replacing queued %s", replaceable->toString().c_str());
+            replaceable->frame = frame;
+            replaceable->deadline = tx_deadline;
+            if (replaced_frames_cnt_ < NumericTraits<uint32_t>::max())
+            {
+                replaced_frames_cnt_++;
+            }
+            return;
+        }
+    }
+
     void* praw = allocator_.allocate(sizeof(Entry));
     if (praw == UAVCAN_NULLPTR)
     {
@@ -225,6 +271,62 @@ bool CanTxQueue::topPriorityHigherOrEqual(const CanFrame& rhs_frame) const
     return !rhs_frame.priorityHigherThan(entry->frame);
 }
 
+/*
+ * CanRxQueue
+ */
+void CanRxQueue::Entry::destroy(Entry*& obj, IPoolAllocator& allocator)
+{
+    if (obj != UAVCAN_NULLPTR)
+    {
+        obj->~Entry();
+        allocator.deallocate(obj);
+        obj = UAVCAN_NULLPTR;
+    }
+}
+
+bool CanRxQueue::push(const CanRxFrame& frame)
+{
+    void* const praw = allocator_.allocate(sizeof(Entry));
+    if (praw == UAVCAN_NULLPTR)
+    {
+        UAVCAN_TRACE("CanRxQueue", "Push OOM");
+        return false;
+    }
+    Entry* const entry = new (praw) Entry(frame);
+    UAVCAN_ASSERT(entry);
+    queue_.insertBefore(entry, PriorityInsertionComparator(frame));
+    length_++;
+    return true;
+}
+
+bool CanRxQueue::pop(CanRxFrame& out_frame)
+{
+    Entry* entry = queue_.get();
+    if (entry == UAVCAN_NULLPTR)
+    {
+        return false;
+    }
+    out_frame = entry->frame;
+    queue_.remove(entry);
+    Entry::destroy(entry, allocator_);
+    UAVCAN_ASSERT(length_ > 0);
+    length_--;
+    return true;
+}
+
+void CanRxQueue::clear()
+{
+    Entry* p = queue_.get();
+    while (p)
+    {
+        Entry* const next = p->getNextListNode();
+        queue_.remove(p);
+        Entry::destroy(p, allocator_);
+        p = next;
+    }
+    length_ = 0;
+}
+
 /*
  * CanIOManager
  */
@@ -237,7 +339,7 @@ int CanIOManager::sendToIface(uint8_t iface_index, const CanFrame& frame, Monoto
         UAVCAN_ASSERT(0);   // Nonexistent interface
         return -ErrLogic;
     }
-    const int res = iface->send(frame, tx_deadline, flags);
+    const int res = iface->send(frame, tx_deadline, CanIOFlags(flags & ~CanIOFlagReplaceQueued));
     if (res != 1)
     {
         UAVCAN_TRACE("CanIOManager", "Send failed: code %i, iface %i, frame %s",
@@ -3,6 +3,14 @@
  */
 
 #include <uavcan/transport/crc.hpp>
+#include <uavcan/util/templates.hpp>
+
+#if !UAVCAN_TINY && UAVCAN_CRC_PCLMUL && defined(__PCLMUL__) && defined(__SSSE3__)
+# include <emmintrin.h>
+# include <tmmintrin.h>
+# include <wmmintrin.h>
+# define UAVCAN_CRC_USE_PCLMUL 1
+#endif
 
 namespace uavcan
 {
@@ -46,6 +54,345 @@ const uint16_t TransferCRC::Table[256] =
     0x6E17U, 0x7E36U, 0x4E55U, 0x5E74U, 0x2E93U, 0x3EB2U, 0x0ED1U, 0x1EF0U
 };
 
+namespace
+{
+
+#if UAVCAN_CRC_SLICING_FACTOR > 1
+/*
+ * Table[k - 1][x] is the CRC of the byte x followed by k zero bytes, with zero initial value:
+ * t = [Table]
+ * for k in range(7): t.append([((v << 8) & 0xFFFF) ^ Table[v >> 8] for v in t[-1]])
+ */
+const uint16_t SlicingTable[UAVCAN_CRC_SLICING_FACTOR - 1][256] =
+{
+    {
+        0x0000U, 0x3331U, 0x6662U, 0x5553U, 0xCCC4U, 0xFFF5U, 0xAAA6U, 0x9997U,
+        0x89A9U, 0xBA98U, 0xEFCBU, 0xDCFAU, 0x456DU, 0x765CU, 0x230FU, 0x103EU,
+        0x0373U, 0x3042U, 0x6511U, 0x5620U, 0xCFB7U, 0xFC86U, 0xA9D5U, 0x9AE4U,
+        0x8ADAU, 0xB9EBU, 0xECB8U, 0xDF89U, 0x461EU, 0x752FU, 0x207CU, 0x134DU,
+        0x06E6U, 0x35D7U, 0x6084U, 0x53B5U, 0xCA22U, 0xF913U, 0xAC40U, 0x9F71U,
+        0x8F4FU, 0xBC7EU, 0xE92DU, 0xDA1CU, 0x438BU, 0x70BAU, 0x25E9U, 0x16D8U,
+        0x0595U, 0x36A4U, 0x63F7U, 0x50C6U, 0xC951U, 0xFA60U, 0xAF33U, 0x9C02U,
+        0x8C3CU, 0xBF0DU, 0xEA5EU, 0xD96FU, 0x40F8U, 0x73C9U, 0x269AU, 0x15ABU,
+        0x0DCCU, 0x3EFDU, 0x6BAEU, 0x589FU, 0xC108U, 0xF239U, 0xA76AU, 0x945BU,
+        0x8465U, 0xB754U, 0xE207U, 0xD136U, 0x48A1U, 0x7B90U, 0x2EC3U, 0x1DF2U,
+        0x0EBFU, 0x3D8EU, 0x68DDU, 0x5BECU, 0xC27BU, 0xF14AU, 0xA419U, 0x9728U,
+        0x8716U, 0xB427U, 0xE174U, 0xD245U, 0x4BD2U, 0x78E3U, 0x2DB0U, 0x1E81U,
+        0x0B2AU, 0x381BU, 0x6D48U, 0x5E79U, 0xC7EEU, 0xF4DFU, 0xA18CU, 0x92BDU,
+        0x8283U, 0xB1B2U, 0xE4E1U, 0xD7D0U, 0x4E47U, 0x7D76U, 0x2825U, 0x1B14U,
+        0x0859U, 0x3B68U, 0x6E3BU, 0x5D0AU, 0xC49DU, 0xF7ACU, 0xA2FFU, 0x91CEU,
+        0x81F0U, 0xB2C1U, 0xE792U, 0xD4A3U, 0x4D34U, 0x7E05U, 0x2B56U, 0x1867U,
+        0x1B98U, 0x28A9U, 0x7DFAU, 0x4ECBU, 0xD75CU, 0xE46DU, 0xB13EU, 0x820FU,
+        0x9231U, 0xA100U, 0xF453U, 0xC762U, 0x5EF5U, 0x6DC4U, 0x3897U, 0x0BA6U,
+        0x18EBU, 0x2BDAU, 0x7E89U, 0x4DB8U, 0xD42FU, 0xE71EU, 0xB24DU, 0x817CU,
+        0x9142U, 0xA273U, 0xF720U, 0xC411U, 0x5D86U, 0x6EB7U, 0x3BE4U, 0x08D5U,
+        0x1D7EU, 0x2E4FU, 0x7B1CU, 0x482DU, 0xD1BAU, 0xE28BU, 0xB7D8U, 0x84E9U,
+        0x94D7U, 0xA7E6U, 0xF2B5U, 0xC184U, 0x5813U, 0x6B22U, 0x3E71U, 0x0D40U,
+        0x1E0DU, 0x2D3CU, 0x786FU, 0x4B5EU, 0xD2C9U, 0xE1F8U, 0xB4ABU, 0x879AU,
+        0x97A4U, 0xA495U, 0xF1C6U, 0xC2F7U, 0x5B60U, 0x6851U, 0x3D02U, 0x0E33U,
+        0x1654U, 0x2565U, 0x7036U, 0x4307U, 0xDA90U, 0xE9A1U, 0xBCF2U, 0x8FC3U,
+        0x9FFDU, 0xACCCU, 0xF99FU, 0xCAAEU, 0x5339U, 0x6008U, 0x355BU, 0x066AU,
+        0x1527U, 0x2616U, 0x7345U, 0x4074U, 0xD9E3U, 0xEAD2U, 0xBF81U, 0x8CB0U,
+        0x9C8EU, 0xAFBFU, 0xFAECU, 0xC9DDU, 0x504AU, 0x637BU, 0x3628U, 0x0519U,
+        0x10B2U, 0x2383U, 0x76D0U, 0x45E1U, 0xDC76U, 0xEF47U, 0xBA14U, 0x8925U,
+        0x991BU, 0xAA2AU, 0xFF79U, 0xCC48U, 0x55DFU, 0x66EEU, 0x33BDU, 0x008CU,
+        0x13C1U, 0x20F0U, 0x75A3U, 0x4692U, 0xDF05U, 0xEC34U, 0xB967U, 0x8A56U,
+        0x9A68U, 0xA959U, 0xFC0AU, 0xCF3BU, 0x56ACU, 0x659DU, 0x30CEU, 0x03FFU
+    },
+    {
+        0x0000U, 0x3730U, 0x6E60U, 0x5950U, 0xDCC0U, 0xEBF0U, 0xB2A0U, 0x8590U,
+        0xA9A1U, 0x9E91U, 0xC7C1U, 0xF0F1U, 0x7561U, 0x4251U, 0x1B01U, 0x2C31U,
+        0x4363U, 0x7453U, 0x2D03U, 0x1A33U, 0x9FA3U, 0xA893U, 0xF1C3U, 0xC6F3U,
+        0xEAC2U, 0xDDF2U, 0x84A2U, 0xB392U, 0x3602U, 0x0132U, 0x5862U, 0x6F52U,
+        0x86C6U, 0xB1F6U, 0xE8A6U, 0xDF96U, 0x5A06U, 0x6D36U, 0x3466U, 0x0356U,
+        0x2F67U, 0x1857U, 0x4107U, 0x7637U, 0xF3A7U, 0xC497U, 0x9DC7U, 0xAAF7U,
+        0xC5A5U, 0xF295U, 0xABC5U, 0x9CF5U, 0x1965U, 0x2E55U, 0x7705U, 0x4035U,
+        0x6C04U, 0x5B34U, 0x0264U, 0x3554U, 0xB0C4U, 0x87F4U, 0xDEA4U, 0xE994U,
+        0x1DADU, 0x2A9DU, 0x73CDU, 0x44FDU, 0xC16DU, 0xF65DU, 0xAF0DU, 0x983DU,
+        0xB40CU, 0x833CU, 0xDA6CU, 0xED5CU, 0x68CCU, 0x5FFCU, 0x06ACU, 0x319CU,
+        0x5ECEU, 0x69FEU, 0x30AEU, 0x079EU, 0x820EU, 0xB53EU, 0xEC6EU, 0xDB5EU,
+        0xF76FU, 0xC05FU, 0x990FU, 0xAE3FU, 0x2BAFU, 0x1C9FU, 0x45CFU, 0x72FFU,
+        0x9B6BU, 0xAC5BU, 0xF50BU, 0xC23BU, 0x47ABU, 0x709BU, 0x29CBU, 0x1EFBU,
+        0x32CAU, 0x05FAU, 0x5CAAU, 0x6B9AU, 0xEE0AU, 0xD93AU, 0x806AU, 0xB75AU,
+        0xD808U, 0xEF38U, 0xB668U, 0x8158U, 0x04C8U, 0x33F8U, 0x6AA8U, 0x5D98U,
+        0x71A9U, 0x4699U, 0x1FC9U, 0x28F9U, 0xAD69U, 0x9A59U, 0xC309U, 0xF439U,
+        0x3B5AU, 0x0C6AU, 0x553AU, 0x620AU, 0xE79AU, 0xD0AAU, 0x89FAU, 0xBECAU,
+        0x92FBU, 0xA5CBU, 0xFC9BU, 0xCBABU, 0x4E3BU, 0x790BU, 0x205BU, 0x176BU,
+        0x7839U, 0x4F09U, 0x1659U, 0x2169U, 0xA4F9U, 0x93C9U, 0xCA99U, 0xFDA9U,
+        0xD198U, 0xE6A8U, 0xBFF8U, 0x88C8U, 0x0D58U, 0x3A68U, 0x6338U, 0x5408U,
+        0xBD9CU, 0x8AACU, 0xD3FCU, 0xE4CCU, 0x615CU, 0x566CU, 0x0F3CU, 0x380CU,
+        0x143DU, 0x230DU, 0x7A5DU, 0x4D6DU, 0xC8FDU, 0xFFCDU, 0xA69DU, 0x91ADU,
+        0xFEFFU, 0xC9CFU, 0x909FU, 0xA7AFU, 0x223FU, 0x150FU, 0x4C5FU, 0x7B6FU,
+        0x575EU, 0x606EU, 0x393EU, 0x0E0EU, 0x8B9EU, 0xBCAEU, 0xE5FEU, 0xD2CEU,
+        0x26F7U, 0x11C7U, 0x4897U, 0x7FA7U, 0xFA37U, 0xCD07U, 0x9457U, 0xA367U,
+        0x8F56U, 0xB866U, 0xE136U, 0xD606U, 0x5396U, 0x64A6U, 0x3DF6U, 0x0AC6U,
+        0x6594U, 0x52A4U, 0x0BF4U, 0x3CC4U, 0xB954U, 0x8E64U, 0xD734U, 0xE004U,
+        0xCC35U, 0xFB05U, 0xA255U, 0x9565U, 0x10F5U, 0x27C5U, 0x7E95U, 0x49A5U,
+        0xA031U, 0x9701U, 0xCE51U, 0xF961U, 0x7CF1U, 0x4BC1U, 0x1291U, 0x25A1U,
+        0x0990U, 0x3EA0U, 0x67F0U, 0x50C0U, 0xD550U, 0xE260U, 0xBB30U, 0x8C00U,
+        0xE352U, 0xD462U, 0x8D32U, 0xBA02U, 0x3F92U, 0x08A2U, 0x51F2U, 0x66C2U,
+        0x4AF3U, 0x7DC3U, 0x2493U, 0x13A3U, 0x9633U, 0xA103U, 0xF853U, 0xCF63U
+    },
+    {
+        0x0000U, 0x76B4U, 0xED68U, 0x9BDCU, 0xCAF1U, 0xBC45U, 0x2799U, 0x512DU,
+        0x85C3U, 0xF377U, 0x68ABU, 0x1E1FU, 0x4F32U, 0x3986U, 0xA25AU, 0xD4EEU,
+        0x1BA7U, 0x6D13U, 0xF6CFU, 0x807BU, 0xD156U, 0xA7E2U, 0x3C3EU, 0x4A8AU,
+        0x9E64U, 0xE8D0U, 0x730CU, 0x05B8U, 0x5495U, 0x2221U, 0xB9FDU, 0xCF49U,
+        0x374EU, 0x41FAU, 0xDA26U, 0xAC92U, 0xFDBFU, 0x8B0BU, 0x10D7U, 0x6663U,
+        0xB28DU, 0xC439U, 0x5FE5U, 0x2951U, 0x787CU, 0x0EC8U, 0x9514U, 0xE3A0U,
+        0x2CE9U, 0x5A5DU, 0xC181U, 0xB735U, 0xE618U, 0x90ACU, 0x0B70U, 0x7DC4U,
+        0xA92AU, 0xDF9EU, 0x4442U, 0x32F6U, 0x63DBU, 0x156FU, 0x8EB3U, 0xF807U,
+        0x6E9CU, 0x1828U, 0x83F4U, 0xF540U, 0xA46DU, 0xD2D9U, 0x4905U, 0x3FB1U,
+        0xEB5FU, 0x9DEBU, 0x0637U, 0x7083U, 0x21AEU, 0x571AU, 0xCCC6U, 0xBA72U,
+        0x753BU, 0x038FU, 0x9853U, 0xEEE7U, 0xBFCAU, 0xC97EU, 0x52A2U, 0x2416U,
+        0xF0F8U, 0x864CU, 0x1D90U, 0x6B24U, 0x3A09U, 0x4CBDU, 0xD761U, 0xA1D5U,
+        0x59D2U, 0x2F66U, 0xB4BAU, 0xC20EU, 0x9323U, 0xE597U, 0x7E4BU, 0x08FFU,
+        0xDC11U, 0xAAA5U, 0x3179U, 0x47CDU, 0x16E0U, 0x6054U, 0xFB88U, 0x8D3CU,
+        0x4275U, 0x34C1U, 0xAF1DU, 0xD9A9U, 0x8884U, 0xFE30U, 0x65ECU, 0x1358U,
+        0xC7B6U, 0xB102U, 0x2ADEU, 0x5C6AU, 0x0D47U, 0x7BF3U, 0xE02FU, 0x969BU,
+        0xDD38U, 0xAB8CU, 0x3050U, 0x46E4U, 0x17C9U, 0x617DU, 0xFAA1U, 0x8C15U,
+        0x58FBU, 0x2E4FU, 0xB593U, 0xC327U, 0x920AU, 0xE4BEU, 0x7F62U, 0x09D6U,
+        0xC69FU, 0xB02BU, 0x2BF7U, 0x5D43U, 0x0C6EU, 0x7ADAU, 0xE106U, 0x97B2U,
+        0x435CU, 0x35E8U, 0xAE34U, 0xD880U, 0x89ADU, 0xFF19U, 0x64C5U, 0x1271U,
+        0xEA76U, 0x9CC2U, 0x071EU, 0x71AAU, 0x2087U, 0x5633U, 0xCDEFU, 0xBB5BU,
+        0x6FB5U, 0x1901U, 0x82DDU, 0xF469U, 0xA544U, 0xD3F0U, 0x482CU, 0x3E98U,
+        0xF1D1U, 0x8765U, 0x1CB9U, 0x6A0DU, 0x3B20U, 0x4D94U, 0xD648U, 0xA0FCU,
+        0x7412U, 0x02A6U, 0x997AU, 0xEFCEU, 0xBEE3U, 0xC857U, 0x538BU, 0x253FU,
+        0xB3A4U, 0xC510U, 0x5ECCU, 0x2878U, 0x7955U, 0x0FE1U, 0x943DU, 0xE289U,
+        0x3667U, 0x40D3U, 0xDB0FU, 0xADBBU, 0xFC96U, 0x8A22U, 0x11FEU, 0x674AU,
+        0xA803U, 0xDEB7U, 0x456BU, 0x33DFU, 0x62F2U, 0x1446U, 0x8F9AU, 0xF92EU,
+        0x2DC0U, 0x5B74U, 0xC0A8U, 0xB61CU, 0xE731U, 0x9185U, 0x0A59U, 0x7CEDU,
+        0x84EAU, 0xF25EU, 0x6982U, 0x1F36U, 0x4E1BU, 0x38AFU, 0xA373U, 0xD5C7U,
+        0x0129U, 0x779DU, 0xEC41U, 0x9AF5U, 0xCBD8U, 0xBD6CU, 0x26B0U, 0x5004U,
+        0x9F4DU, 0xE9F9U, 0x7225U, 0x0491U, 0x55BCU, 0x2308U, 0xB8D4U, 0xCE60U,
+        0x1A8EU, 0x6C3AU, 0xF7E6U, 0x8152U, 0xD07FU, 0xA6CBU, 0x3D17U, 0x4BA3U
+    },
+#if UAVCAN_CRC_SLICING_FACTOR >= 8
+    {
+        0x0000U, 0xAA51U, 0x4483U, 0xEED2U, 0x8906U, 0x2357U, 0xCD85U, 0x67D4U,
+        0x022DU, 0xA87CU, 0x46AEU, 0xECFFU, 0x8B2BU, 0x217AU, 0xCFA8U, 0x65F9U,
+        0x045AU, 0xAE0BU, 0x40D9U, 0xEA88U, 0x8D5CU, 0x270DU, 0xC9DFU, 0x638EU,
+        0x0677U, 0xAC26U, 0x42F4U, 0xE8A5U, 0x8F71U, 0x2520U, 0xCBF2U, 0x61A3U,
+        0x08B4U, 0xA2E5U, 0x4C37U, 0xE666U, 0x81B2U, 0x2BE3U, 0xC531U, 0x6F60U,
+        0x0A99U, 0xA0C8U, 0x4E1AU, 0xE44BU, 0x839FU, 0x29CEU, 0xC71CU, 0x6D4DU,
+        0x0CEEU, 0xA6BFU, 0x486DU, 0xE23CU, 0x85E8U, 0x2FB9U, 0xC16BU, 0x6B3AU,
+        0x0EC3U, 0xA492U, 0x4A40U, 0xE011U, 0x87C5U, 0x2D94U, 0xC346U, 0x6917U,
+        0x1168U, 0xBB39U, 0x55EBU, 0xFFBAU, 0x986EU, 0x323FU, 0xDCEDU, 0x76BCU,
+        0x1345U, 0xB914U, 0x57C6U, 0xFD97U, 0x9A43U, 0x3012U, 0xDEC0U, 0x7491U,
+        0x1532U, 0xBF63U, 0x51B1U, 0xFBE0U, 0x9C34U, 0x3665U, 0xD8B7U, 0x72E6U,
+        0x171FU, 0xBD4EU, 0x539CU, 0xF9CDU, 0x9E19U, 0x3448U, 0xDA9AU, 0x70CBU,
+        0x19DCU, 0xB38DU, 0x5D5FU, 0xF70EU, 0x90DAU, 0x3A8BU, 0xD459U, 0x7E08U,
+        0x1BF1U, 0xB1A0U, 0x5F72U, 0xF523U, 0x92F7U, 0x38A6U, 0xD674U, 0x7C25U,
+        0x1D86U, 0xB7D7U, 0x5905U, 0xF354U, 0x9480U, 0x3ED1U, 0xD003U, 0x7A52U,
+        0x1FABU, 0xB5FAU, 0x5B28U, 0xF179U, 0x96ADU, 0x3CFCU, 0xD22EU, 0x787FU,
+        0x22D0U, 0x8881U, 0x6653U, 0xCC02U, 0xABD6U, 0x0187U, 0xEF55U, 0x4504U,
+        0x20FDU, 0x8AACU, 0x647EU, 0xCE2FU, 0xA9FBU, 0x03AAU, 0xED78U, 0x4729U,
+        0x268AU, 0x8CDBU, 0x6209U, 0xC858U, 0xAF8CU, 0x05DDU, 0xEB0FU, 0x415EU,
+        0x24A7U, 0x8EF6U, 0x6024U, 0xCA75U, 0xADA1U, 0x07F0U, 0xE922U, 0x4373U,
+        0x2A64U, 0x8035U, 0x6EE7U, 0xC4B6U, 0xA362U, 0x0933U, 0xE7E1U, 0x4DB0U,
+        0x2849U, 0x8218U, 0x6CCAU, 0xC69BU, 0xA14FU, 0x0B1EU, 0xE5CCU, 0x4F9DU,
+        0x2E3EU, 0x846FU, 0x6ABDU, 0xC0ECU, 0xA738U, 0x0D69U, 0xE3BBU, 0x49EAU,
+        0x2C13U, 0x8642U, 0x6890U, 0xC2C1U, 0xA515U, 0x0F44U, 0xE196U, 0x4BC7U,
+        0x33B8U, 0x99E9U, 0x773BU, 0xDD6AU, 0xBABEU, 0x10EFU, 0xFE3DU, 0x546CU,
+        0x3195U, 0x9BC4U, 0x7516U, 0xDF47U, 0xB893U, 0x12C2U, 0xFC10U, 0x5641U,
+        0x37E2U, 0x9DB3U, 0x7361U, 0xD930U, 0xBEE4U, 0x14B5U, 0xFA67U, 0x5036U,
+        0x35CFU, 0x9F9EU, 0x714CU, 0xDB1DU, 0xBCC9U, 0x1698U, 0xF84AU, 0x521BU,
+        0x3B0CU, 0x915DU, 0x7F8FU, 0xD5DEU, 0xB20AU, 0x185BU, 0xF689U, 0x5CD8U,
+        0x3921U, 0x9370U, 0x7DA2U, 0xD7F3U, 0xB027U, 0x1A76U, 0xF4A4U, 0x5EF5U,
+        0x3F56U, 0x9507U, 0x7BD5U, 0xD184U, 0xB650U, 0x1C01U, 0xF2D3U, 0x5882U,
+        0x3D7BU, 0x972AU, 0x79F8U, 0xD3A9U, 0xB47DU, 0x1E2CU, 0xF0FEU, 0x5AAFU
+    },
+    {
+        0x0000U, 0x45A0U, 0x8B40U, 0xCEE0U, 0x06A1U, 0x4301U, 0x8DE1U, 0xC841U,
+        0x0D42U, 0x48E2U, 0x8602U, 0xC3A2U, 0x0BE3U, 0x4E43U, 0x80A3U, 0xC503U,
+        0x1A84U, 0x5F24U, 0x91C4U, 0xD464U, 0x1C25U, 0x5985U, 0x9765U, 0xD2C5U,
+        0x17C6U, 0x5266U, 0x9C86U, 0xD926U, 0x1167U, 0x54C7U, 0x9A27U, 0xDF87U,
+        0x3508U, 0x70A8U, 0xBE48U, 0xFBE8U, 0x33A9U, 0x7609U, 0xB8E9U, 0xFD49U,
+        0x384AU, 0x7DEAU, 0xB30AU, 0xF6AAU, 0x3EEBU, 0x7B4BU, 0xB5ABU, 0xF00BU,
+        0x2F8CU, 0x6A2CU, 0xA4CCU, 0xE16CU, 0x292DU, 0x6C8DU, 0xA26DU, 0xE7CDU,
+        0x22CEU, 0x676EU, 0xA98EU, 0xEC2EU, 0x246FU, 0x61CFU, 0xAF2FU, 0xEA8FU,
+        0x6A10U, 0x2FB0U, 0xE150U, 0xA4F0U, 0x6CB1U, 0x2911U, 0xE7F1U, 0xA251U,
+        0x6752U, 0x22F2U, 0xEC12U, 0xA9B2U, 0x61F3U, 0x2453U, 0xEAB3U, 0xAF13U,
+        0x7094U, 0x3534U, 0xFBD4U, 0xBE74U, 0x7635U, 0x3395U, 0xFD75U, 0xB8D5U,
+        0x7DD6U, 0x3876U, 0xF696U, 0xB336U, 0x7B77U, 0x3ED7U, 0xF037U, 0xB597U,
+        0x5F18U, 0x1AB8U, 0xD458U, 0x91F8U, 0x59B9U, 0x1C19U, 0xD2F9U, 0x9759U,
+        0x525AU, 0x17FAU, 0xD91AU, 0x9CBAU, 0x54FBU, 0x115BU, 0xDFBBU, 0x9A1BU,
+        0x459CU, 0x003CU, 0xCEDCU, 0x8B7CU, 0x433DU, 0x069DU, 0xC87DU, 0x8DDDU,
+        0x48DEU, 0x0D7EU, 0xC39EU, 0x863EU, 0x4E7FU, 0x0BDFU, 0xC53FU, 0x809FU,
+        0xD420U, 0x9180U, 0x5F60U, 0x1AC0U, 0xD281U, 0x9721U, 0x59C1U, 0x1C61U,
+        0xD962U, 0x9CC2U, 0x5222U, 0x1782U, 0xDFC3U, 0x9A63U, 0x5483U, 0x1123U,
+        0xCEA4U, 0x8B04U, 0x45E4U, 0x0044U, 0xC805U, 0x8DA5U, 0x4345U, 0x06E5U,
+        0xC3E6U, 0x8646U, 0x48A6U, 0x0D06U, 0xC547U, 0x80E7U, 0x4E07U, 0x0BA7U,
+        0xE128U, 0xA488U, 0x6A68U, 0x2FC8U, 0xE789U, 0xA229U, 0x6CC9U, 0x2969U,
+        0xEC6AU, 0xA9CAU, 0x672AU, 0x228AU, 0xEACBU, 0xAF6BU, 0x618BU, 0x242BU,
+        0xFBACU, 0xBE0CU, 0x70ECU, 0x354CU, 0xFD0DU, 0xB8ADU, 0x764DU, 0x33EDU,
+        0xF6EEU, 0xB34EU, 0x7DAEU, 0x380EU, 0xF04FU, 0xB5EFU, 0x7B0FU, 0x3EAFU,
+        0xBE30U, 0xFB90U, 0x3570U, 0x70D0U, 0xB891U, 0xFD31U, 0x33D1U, 0x7671U,
+        0xB372U, 0xF6D2U, 0x3832U, 0x7D92U, 0xB5D3U, 0xF073U, 0x3E93U, 0x7B33U,
+        0xA4B4U, 0xE114U, 0x2FF4U, 0x6A54U, 0xA215U, 0xE7B5U, 0x2955U, 0x6CF5U,
+        0xA9F6U, 0xEC56U, 0x22B6U, 0x6716U, 0xAF57U, 0xEAF7U, 0x2417U, 0x61B7U,
+        0x8B38U, 0xCE98U, 0x0078U, 0x45D8U, 0x8D99U, 0xC839U, 0x06D9U, 0x4379U,
+        0x867AU, 0xC3DAU, 0x0D3AU, 0x489AU, 0x80DBU, 0xC57BU, 0x0B9BU, 0x4E3BU,
+        0x91BCU, 0xD41CU, 0x1AFCU, 0x5F5CU, 0x971DU, 0xD2BDU, 0x1C5DU, 0x59FDU,
+        0x9CFEU, 0xD95EU, 0x17BEU, 0x521EU, 0x9A5FU, 0xDFFFU, 0x111FU, 0x54BFU
+    },
+    {
+        0x0000U, 0xB861U, 0x60E3U, 0xD882U, 0xC1C6U, 0x79A7U, 0xA125U, 0x1944U,
+        0x93ADU, 0x2BCCU, 0xF34EU, 0x4B2FU, 0x526BU, 0xEA0AU, 0x3288U, 0x8AE9U,
+        0x377BU, 0x8F1AU, 0x5798U, 0xEFF9U, 0xF6BDU, 0x4EDCU, 0x965EU, 0x2E3FU,
+        0xA4D6U, 0x1CB7U, 0xC435U, 0x7C54U, 0x6510U, 0xDD71U, 0x05F3U, 0xBD92U,
+        0x6EF6U, 0xD697U, 0x0E15U, 0xB674U, 0xAF30U, 0x1751U, 0xCFD3U, 0x77B2U,
+        0xFD5BU, 0x453AU, 0x9DB8U, 0x25D9U, 0x3C9DU, 0x84FCU, 0x5C7EU, 0xE41FU,
+        0x598DU, 0xE1ECU, 0x396EU, 0x810FU, 0x984BU, 0x202AU, 0xF8A8U, 0x40C9U,
+        0xCA20U, 0x7241U, 0xAAC3U, 0x12A2U, 0x0BE6U, 0xB387U, 0x6B05U, 0xD364U,
+        0xDDECU, 0x658DU, 0xBD0FU, 0x056EU, 0x1C2AU, 0xA44BU, 0x7CC9U, 0xC4A8U,
+        0x4E41U, 0xF620U, 0x2EA2U, 0x96C3U, 0x8F87U, 0x37E6U, 0xEF64U, 0x5705U,
+        0xEA97U, 0x52F6U, 0x8A74U, 0x3215U, 0x2B51U, 0x9330U, 0x4BB2U, 0xF3D3U,
+        0x793AU, 0xC15BU, 0x19D9U, 0xA1B8U, 0xB8FCU, 0x009DU, 0xD81FU, 0x607EU,
+        0xB31AU, 0x0B7BU, 0xD3F9U, 0x6B98U, 0x72DCU, 0xCABDU, 0x123FU, 0xAA5EU,
+        0x20B7U, 0x98D6U, 0x4054U, 0xF835U, 0xE171U, 0x5910U, 0x8192U, 0x39F3U,
+        0x8461U, 0x3C00U, 0xE482U, 0x5CE3U, 0x45A7U, 0xFDC6U, 0x2544U, 0x9D25U,
+        0x17CCU, 0xAFADU, 0x772FU, 0xCF4EU, 0xD60AU, 0x6E6BU, 0xB6E9U, 0x0E88U,
+        0xABF9U, 0x1398U, 0xCB1AU, 0x737BU, 0x6A3FU, 0xD25EU, 0x0ADCU, 0xB2BDU,
+        0x3854U, 0x8035U, 0x58B7U, 0xE0D6U, 0xF992U, 0x41F3U, 0x9971U, 0x2110U,
+        0x9C82U, 0x24E3U, 0xFC61U, 0x4400U, 0x5D44U, 0xE525U, 0x3DA7U, 0x85C6U,
+        0x0F2FU, 0xB74EU, 0x6FCCU, 0xD7ADU, 0xCEE9U, 0x7688U, 0xAE0AU, 0x166BU,
+        0xC50FU, 0x7D6EU, 0xA5ECU, 0x1D8DU, 0x04C9U, 0xBCA8U, 0x642AU, 0xDC4BU,
+        0x56A2U, 0xEEC3U, 0x3641U, 0x8E20U, 0x9764U, 0x2F05U, 0xF787U, 0x4FE6U,
+        0xF274U, 0x4A15U, 0x9297U, 0x2AF6U, 0x33B2U, 0x8BD3U, 0x5351U, 0xEB30U,
+        0x61D9U, 0xD9B8U, 0x013AU, 0xB95BU, 0xA01FU, 0x187EU, 0xC0FCU, 0x789DU,
+        0x7615U, 0xCE74U, 0x16F6U, 0xAE97U, 0xB7D3U, 0x0FB2U, 0xD730U, 0x6F51U,
+        0xE5B8U, 0x5DD9U, 0x855BU, 0x3D3AU, 0x247EU, 0x9C1FU, 0x449DU, 0xFCFCU,
+        0x416EU, 0xF90FU, 0x218DU, 0x99ECU, 0x80A8U, 0x38C9U, 0xE04BU, 0x582AU,
+        0xD2C3U, 0x6AA2U, 0xB220U, 0x0A41U, 0x1305U, 0xAB64U, 0x73E6U, 0xCB87U,
+        0x18E3U, 0xA082U, 0x7800U, 0xC061U, 0xD925U, 0x6144U, 0xB9C6U, 0x01A7U,
+        0x8B4EU, 0x332FU, 0xEBADU, 0x53CCU, 0x4A88U, 0xF2E9U, 0x2A6BU, 0x920AU,
+        0x2F98U, 0x97F9U, 0x4F7BU, 0xF71AU, 0xEE5EU, 0x563FU, 0x8EBDU, 0x36DCU,
+        0xBC35U, 0x0454U, 0xDCD6U, 0x64B7U, 0x7DF3U, 0xC592U, 0x1D10U, 0xA571U
+    },
+    {
+        0x0000U, 0x47D3U, 0x8FA6U, 0xC875U, 0x0F6DU, 0x48BEU, 0x80CBU, 0xC718U,
+        0x1EDAU, 0x5909U, 0x917CU, 0xD6AFU, 0x11B7U, 0x5664U, 0x9E11U, 0xD9C2U,
+        0x3DB4U, 0x7A67U, 0xB212U, 0xF5C1U, 0x32D9U, 0x750AU, 0xBD7FU, 0xFAACU,
+        0x236EU, 0x64BDU, 0xACC8U, 0xEB1BU, 0x2C03U, 0x6BD0U, 0xA3A5U, 0xE476U,
+        0x7B68U, 0x3CBBU, 0xF4CEU, 0xB31DU, 0x7405U, 0x33D6U, 0xFBA3U, 0xBC70U,
+        0x65B2U, 0x2261U, 0xEA14U, 0xADC7U, 0x6ADFU, 0x2D0CU, 0xE579U, 0xA2AAU,
+        0x46DCU, 0x010FU, 0xC97AU, 0x8EA9U, 0x49B1U, 0x0E62U, 0xC617U, 0x81C4U,
+        0x5806U, 0x1FD5U, 0xD7A0U, 0x9073U, 0x576BU, 0x10B8U, 0xD8CDU, 0x9F1EU,
+        0xF6D0U, 0xB103U, 0x7976U, 0x3EA5U, 0xF9BDU, 0xBE6EU, 0x761BU, 0x31C8U,
+        0xE80AU, 0xAFD9U, 0x67ACU, 0x207FU, 0xE767U, 0xA0B4U, 0x68C1U, 0x2F12U,
+        0xCB64U, 0x8CB7U, 0x44C2U, 0x0311U, 0xC409U, 0x83DAU, 0x4BAFU, 0x0C7CU,
+        0xD5BEU, 0x926DU, 0x5A18U, 0x1DCBU, 0xDAD3U, 0x9D00U, 0x5575U, 0x12A6U,
+        0x8DB8U, 0xCA6BU, 0x021EU, 0x45CDU, 0x82D5U, 0xC506U, 0x0D73U, 0x4AA0U,
+        0x9362U, 0xD4B1U, 0x1CC4U, 0x5B17U, 0x9C0FU, 0xDBDCU, 0x13A9U, 0x547AU,
+        0xB00CU, 0xF7DFU, 0x3FAAU, 0x7879U, 0xBF61U, 0xF8B2U, 0x30C7U, 0x7714U,
+        0xAED6U, 0xE905U, 0x2170U, 0x66A3U, 0xA1BBU, 0xE668U, 0x2E1DU, 0x69CEU,
+        0xFD81U, 0xBA52U, 0x7227U, 0x35F4U, 0xF2ECU, 0xB53FU, 0x7D4AU, 0x3A99U,
+        0xE35BU, 0xA488U, 0x6CFDU, 0x2B2EU, 0xEC36U, 0xABE5U, 0x6390U, 0x2443U,
+        0xC035U, 0x87E6U, 0x4F93U, 0x0840U, 0xCF58U, 0x888BU, 0x40FEU, 0x072DU,
+        0xDEEFU, 0x993CU, 0x5149U, 0x169AU, 0xD182U, 0x9651U, 0x5E24U, 0x19F7U,
+        0x86E9U, 0xC13AU, 0x094FU, 0x4E9CU, 0x8984U, 0xCE57U, 0x0622U, 0x41F1U,
+        0x9833U, 0xDFE0U, 0x1795U, 0x5046U, 0x975EU, 0xD08DU, 0x18F8U, 0x5F2BU,
+        0xBB5DU, 0xFC8EU, 0x34FBU, 0x7328U, 0xB430U, 0xF3E3U, 0x3B96U, 0x7C45U,
+        0xA587U, 0xE254U, 0x2A21U, 0x6DF2U, 0xAAEAU, 0xED39U, 0x254CU, 0x629FU,
+        0x0B51U, 0x4C82U, 0x84F7U, 0xC324U, 0x043CU, 0x43EFU, 0x8B9AU, 0xCC49U,
+        0x158BU, 0x5258U, 0x9A2DU, 0xDDFEU, 0x1AE6U, 0x5D35U, 0x9540U, 0xD293U,
+        0x36E5U, 0x7136U, 0xB943U, 0xFE90U, 0x3988U, 0x7E5BU, 0xB62EU, 0xF1FDU,
+        0x283FU, 0x6FECU, 0xA799U, 0xE04AU, 0x2752U, 0x6081U, 0xA8F4U, 0xEF27U,
+        0x7039U, 0x37EAU, 0xFF9FU, 0xB84CU, 0x7F54U, 0x3887U, 0xF0F2U, 0xB721U,
+        0x6EE3U, 0x2930U, 0xE145U, 0xA696U, 0x618EU, 0x265DU, 0xEE28U, 0xA9FBU,
+        0x4D8DU, 0x0A5EU, 0xC22BU, 0x85F8U, 0x42E0U, 0x0533U, 0xCD46U, 0x8A95U,
+        0x5357U, 0x1484U, 0xDCF1U, 0x9B22U, 0x5C3AU, 0x1BE9U, 0xD39CU, 0x944FU
+    },
+#endif
+};
+#endif
+
+#if defined(UAVCAN_CRC_USE_PCLMUL)
+/*
+ * Buffers of at least this many bytes are folded 16 bytes at a time with the carry-less multiplication; the setup
+ * and the final reduction are not worth it for shorter ones.
+ */
+const unsigned PclmulMinLength = 64;
+
+/**
+ * Folds the given number of 16-byte blocks, prepended with the CRC state, into a 16-byte remainder that has
+ * the same CRC (with zero initial value) as the whole input.
+ * The polynomial coefficients are kept in the natural bit order, so the blocks are loaded in big endian.
+ */
+void foldBlocksPclmul(uint16_t crc, const uint8_t* bytes, unsigned num_blocks, uint8_t* out_remainder)
+{
+    const __m128i byte_reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i constants = _mm_set_epi32(0, 0x650B, 0, 0xAEFC);    // x^192 mod P, x^128 mod P
+
+    __m128i acc = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)), byte_reverse);
+    acc = _mm_xor_si128(acc, _mm_insert_epi16(_mm_setzero_si128(), crc, 7));
+
+    for (unsigned i = 1; i < num_blocks; i++)
+    {
+        bytes += 16;
+        const __m128i next = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)),
+                                              byte_reverse);
+        acc = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(acc, constants, 0x11),
+                                          _mm_clmulepi64_si128(acc, constants, 0x00)),
+                            next);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out_remainder), _mm_shuffle_epi8(acc, byte_reverse));
+}
+#endif
+
+}
+
+uint16_t TransferCRC::addSliced(uint16_t crc, const uint8_t* bytes, unsigned len)
+{
+    StaticAssert<(UAVCAN_CRC_SLICING_FACTOR == 1) ||
+                 (UAVCAN_CRC_SLICING_FACTOR == 4) ||
+                 (UAVCAN_CRC_SLICING_FACTOR == 8)>::check();     // Other values are not implemented
+#if UAVCAN_CRC_SLICING_FACTOR >= 8
+    for (; len >= 8; len -= 8)
+    {
+        crc = uint16_t(crc ^ ((unsigned(bytes[0]) << 8) | bytes[1]));
+        crc = uint16_t(SlicingTable[6][crc >> 8] ^ SlicingTable[5][crc & 0xFFU] ^
+                       SlicingTable[4][bytes[2]] ^ SlicingTable[3][bytes[3]] ^
+                       SlicingTable[2][bytes[4]] ^ SlicingTable[1][bytes[5]] ^
+                       SlicingTable[0][bytes[6]] ^ Table[bytes[7]]);
+        bytes += 8;
+    }
+#endif
+#if UAVCAN_CRC_SLICING_FACTOR >= 4
+    for (; len >= 4; len -= 4)
+    {
+        crc = uint16_t(crc ^ ((unsigned(bytes[0]) << 8) | bytes[1]));
+        crc = uint16_t(SlicingTable[2][crc >> 8] ^ SlicingTable[1][crc & 0xFFU] ^
+                       SlicingTable[0][bytes[2]] ^ Table[bytes[3]]);
+        bytes += 4;
+    }
+#endif
+    while (len--)
+    {
+        crc = uint16_t(uint16_t(crc << 8) ^ Table[((crc >> 8) ^ *bytes++) & 0xFFU]);
+    }
+    return crc;
+}
+
+void TransferCRC::add(const uint8_t* bytes, unsigned len)
+{
+    UAVCAN_ASSERT(bytes);
+#if defined(UAVCAN_CRC_USE_PCLMUL)
+    if (len >= PclmulMinLength)
+    {
+        const unsigned num_blocks = len / 16U;
+        uint8_t remainder[16];
+        foldBlocksPclmul(value_, bytes, num_blocks, remainder);
+        value_ = addSliced(0, remainder, sizeof(remainder));
+        bytes += num_blocks * 16U;
+        len -= num_blocks * 16U;
+    }
+#endif
+    value_ = addSliced(value_, bytes, len);
+}
+
 #endif
 
 }
@@ -67,6 +67,59 @@ void LoopbackFrameListenerRegistry::invokeListeners(RxFrame& frame)
         p = next;
     }
 }
+
+/*
+ * RxDropCounterRegistry
+ */
+unsigned RxDropCounterRegistry::getBucket(DataTypeKind kind, DataTypeID data_type_id)
+{
+    StaticAssert<((TableSize & (TableSize - 1)) == 0)>::check();    // Must be a power of two
+    return unsigned((data_type_id.get() + (unsigned(kind) * (TableSize / 2U))) & (TableSize - 1U));
+}
+
+RxDropCounterRegistry::Entry* RxDropCounterRegistry::find(DataTypeKind kind, DataTypeID data_type_id,
+                                                           bool allow_insertion)
+{
+    // Linear probing; entries are never removed, so the first unused entry terminates the search
+    const unsigned bucket = getBucket(kind, data_type_id);
+    for (unsigned i = 0; i < TableSize; i++)
+    {
+        Entry& entry = table_[(bucket + i) & (TableSize - 1U)];
+        if (entry.num_frames == 0)
+        {
+            if (allow_insertion)
+            {
+                entry.data_type_id = data_type_id;
+                entry.kind = uint8_t(kind);
+                num_data_types_++;
+                return &entry;
+            }
+            return UAVCAN_NULLPTR;
+        }
+        if ((entry.kind == kind) && (entry.data_type_id == data_type_id))
+        {
+            return &entry;
+        }
+    }
+    return UAVCAN_NULLPTR;
+}
+
+void RxDropCounterRegistry::registerDrop(DataTypeKind kind, DataTypeID data_type_id)
+{
+    num_frames_++;
+
+    Entry* const entry = find(kind, data_type_id, true);
+    if (entry != UAVCAN_NULLPTR)
+    {
+        entry->num_frames++;
+    }
+}
+
+uint64_t RxDropCounterRegistry::getNumDroppedFrames(DataTypeKind kind, DataTypeID data_type_id) const
+{
+    const Entry* const entry = const_cast<RxDropCounterRegistry*>(this)->find(kind, data_type_id, false);
+    return (entry == UAVCAN_NULLPTR) ? 0 : entry->num_frames;
+}
 #endif
 
 /*
@@ -156,6 +209,13 @@ void Dispatcher::handleFrame(const CanRxFrame& can_frame)
         return;
     }
 
+#if !UAVCAN_TINY
+    if (wildcard_listener_ != UAVCAN_NULLPTR)
+    {
+        wildcard_listener_->handleFrame(frame);     // Accepts frames addressed to other nodes as well
+    }
+#endif
+
     if ((frame.getDstNodeID() != NodeID::Broadcast) &&
         (frame.getDstNodeID() != getNodeID()))
     {
@@ -218,9 +278,189 @@ void Dispatcher::notifyRxFrameListener(const CanRxFrame& can_frame, CanIOFlags f
 }
 #endif
 
+#if !UAVCAN_TINY
+bool Dispatcher::dropRxFrameIfOverloaded(const CanRxFrame& can_frame)
+{
+    if (!rx_overloaded_ || (rx_drop_policies_ == 0))
+    {
+        return false;
+    }
+
+    Frame frame;                                    // Full parsing is left to handleFrame(), the frame may be kept
+    if (!frame.parseCanID(can_frame))
+    {
+        return false;                               // Will be discarded by handleFrame() anyway
+    }
+
+    const TransferType transfer_type = frame.getTransferType();
+    const bool drop =
+        (((rx_drop_policies_ & RxDropLowPriorityMessages) != 0) &&
+         (transfer_type == TransferTypeMessageBroadcast) &&
+         (frame.getPriority().get() > rx_drop_priority_threshold_.get())) ||
+        (((rx_drop_policies_ & RxDropAnonymousTransfers) != 0) && frame.getSrcNodeID().isBroadcast()) ||
+        (((rx_drop_policies_ & RxDropServiceRequests) != 0) && (transfer_type == TransferTypeServiceRequest));
+
+    if (drop)
+    {
+        rx_drop_counters_.registerDrop(getDataTypeKindForTransferType(transfer_type), frame.getDataTypeID());
+    }
+    return drop;
+}
+
+void Dispatcher::updateRxOverloadState(MonotonicDuration processing_time)
+{
+    const bool time_budget_exhausted = rx_time_budget_.isPositive() && (processing_time >= rx_time_budget_);
+
+    if (time_budget_exhausted || !rx_staging_.isEmpty())
+    {
+        if (!rx_overloaded_)
+        {
+            UAVCAN_TRACE("Dispatcher", "RX overload: backlog %u, processing time %s",
+                         rx_staging_.getLength(), processing_time.toString().c_str());
+            rx_overloaded_ = true;
+        }
+        (void)rx_staging_.removeWhere(RxDropPredicate(*this));
+    }
+    else if (rx_overloaded_)
+    {
+        // Half of the budget must remain unused, otherwise the overload state would toggle on every spin
+        if (!rx_time_budget_.isPositive() || ((processing_time * 2) < rx_time_budget_))
+        {
+            UAVCAN_TRACE("Dispatcher", "RX overload is over");
+            rx_overloaded_ = false;
+        }
+    }
+}
+
+int Dispatcher::stageRxFrames(MonotonicTime blocking_deadline, int& inout_num_frames_processed)
+{
+    int num_frames_received = 0;            // Dropped frames don't occupy the staging queue, hence this limit
+    while ((rx_staging_.getLength() < rx_staging_capacity_) && (num_frames_received < int(rx_staging_capacity_)))
+    {
+        CanIOFlags flags = 0;
+        CanRxFrame frame;
+        const int res = canio_.receive(frame, blocking_deadline, flags);
+        if (res < 0)
+        {
+            return res;
+        }
+        if (res == 0)
+        {
+            break;
+        }
+        blocking_deadline = MonotonicTime();        // Only the first frame is waited for
+        num_frames_received++;
+
+        if (flags & CanIOFlagLoopback)
+        {
+            handleLoopbackFrame(frame);
+        }
+        else if (dropRxFrameIfOverloaded(frame))
+        {
+            continue;
+        }
+        else if (rx_staging_.push(frame))
+        {
+            continue;                               // The listener will be notified when the frame is processed
+        }
+        else
+        {
+            // Out of memory - processing it right away is better than losing it
+            inout_num_frames_processed++;
+            handleFrame(frame);
+        }
+        notifyRxFrameListener(frame, flags);
+    }
+    return num_frames_received;
+}
+
+bool Dispatcher::processStagedRxFrames(int& inout_num_frames_processed, MonotonicDuration& inout_processing_time)
+{
+    const bool timed = rx_time_budget_.isPositive();      // The clock is not read unless it is necessary
+    const MonotonicTime started_at = timed ? sysclock_.getMonotonic() : MonotonicTime();
+    bool within_budget = true;
+
+    CanRxFrame frame;
+    while (true)
+    {
+        if ((rx_frame_budget_ > 0) && (inout_num_frames_processed >= int(rx_frame_budget_)))
+        {
+            within_budget = false;
+            break;
+        }
+        if (timed && ((inout_processing_time + (sysclock_.getMonotonic() - started_at)) >= rx_time_budget_))
+        {
+            within_budget = false;
+            break;
+        }
+        if (!rx_staging_.pop(frame))
+        {
+            break;
+        }
+        inout_num_frames_processed++;
+        handleFrame(frame);
+        notifyRxFrameListener(frame, 0);
+    }
+
+    if (timed)
+    {
+        inout_processing_time += sysclock_.getMonotonic() - started_at;
+    }
+    return within_budget;
+}
+
+int Dispatcher::spinStaged(MonotonicTime deadline)
+{
+    int num_frames_processed = 0;
+    MonotonicDuration processing_time;
+    while (true)
+    {
+        // Blocking only makes sense when there is nothing left to process
+        const int num_frames_received =
+            stageRxFrames(rx_staging_.isEmpty() ? deadline : MonotonicTime(), num_frames_processed);
+        if (num_frames_received < 0)
+        {
+            return num_frames_received;
+        }
+
+        if (!processStagedRxFrames(num_frames_processed, processing_time))
+        {
+            break;
+        }
+
+        if ((num_frames_received == 0) && (sysclock_.getMonotonic() >= deadline))
+        {
+            break;
+        }
+    }
+    updateRxOverloadState(processing_time);
+    return num_frames_processed;
+}
+
+int Dispatcher::flushStagedRxFrames()
+{
+    int num_frames_processed = 0;
+    CanRxFrame frame;
+    while (rx_staging_.pop(frame))
+    {
+        num_frames_processed++;
+        handleFrame(frame);
+        notifyRxFrameListener(frame, 0);
+    }
+    return num_frames_processed;
+}
+#endif
+
 int Dispatcher::spin(MonotonicTime deadline)
 {
     int num_frames_processed = 0;
+#if !UAVCAN_TINY
+    if (rx_staging_capacity_ > 0)
+    {
+        return spinStaged(deadline);
+    }
+    num_frames_processed += flushStagedRxFrames();     // Left over from the time when staging was enabled
+#endif
     do
     {
         CanIOFlags flags = 0;
@@ -252,6 +492,13 @@ int Dispatcher::spin(MonotonicTime deadline)
 int Dispatcher::spinOnce()
 {
     int num_frames_processed = 0;
+#if !UAVCAN_TINY
+    if (rx_staging_capacity_ > 0)
+    {
+        return spinStaged(MonotonicTime());
+    }
+    num_frames_processed += flushStagedRxFrames();
+#endif
 
     while (true)
     {
@@ -309,6 +556,12 @@ void Dispatcher::cleanup(MonotonicTime ts)
     lmsg_.cleanup(ts);
     lsrv_req_.cleanup(ts);
     lsrv_resp_.cleanup(ts);
+#if !UAVCAN_TINY
+    if (wildcard_listener_ != UAVCAN_NULLPTR)
+    {
+        wildcard_listener_->cleanup(ts);
+    }
+#endif
 }
 
 bool Dispatcher::registerMessageListener(TransferListener* listener)
@@ -318,6 +571,7 @@ bool Dispatcher::registerMessageListener(TransferListener* listener)
         UAVCAN_ASSERT(0);
         return false;
     }
+    listener_revision_++;
     return lmsg_.add(listener, ListenerRegistry::ManyListeners);       // Multiple subscribers are OK
 }
 
@@ -344,6 +598,7 @@ bool Dispatcher::registerServiceResponseListener(TransferListener* listener)
 void Dispatcher::unregisterMessageListener(TransferListener* listener)
 {
     lmsg_.remove(listener);
+    listener_revision_++;
 }
 
 void Dispatcher::unregisterServiceRequestListener(TransferListener* listener)
@@ -31,7 +31,7 @@ inline static uint32_t bitunpack(uint32_t val)
     return (val >> OFFSET) & ((1UL << WIDTH) - 1);
 }
 
-bool Frame::parse(const CanFrame& can_frame)
+bool Frame::parseCanID(const CanFrame& can_frame)
 {
     if (can_frame.isErrorFrame() || can_frame.isRemoteTransmissionRequest() || !can_frame.isExtended())
     {
@@ -39,21 +39,6 @@ bool Frame::parse(const CanFrame& can_frame)
         return false;
     }
 
-    if (can_frame.dlc > sizeof(can_frame.data))
-    {
-        UAVCAN_ASSERT(0);  // This is not a protocol error, so UAVCAN_ASSERT() is ok
-        return false;
-    }
-
-    if (can_frame.dlc < 1)
-    {
-        UAVCAN_TRACE("Frame", "Parsing failed at line %d", __LINE__);
-        return false;
-    }
-
-    /*
-     * CAN ID parsing
-     */
     const uint32_t id = can_frame.id & CanFrame::MaskExtID;
 
     transfer_priority_ = static_cast<uint8_t>(bitunpack<24, 5>(id));
@@ -81,6 +66,27 @@ bool Frame::parse(const CanFrame& can_frame)
             data_type_id_ = static_cast<uint16_t>(data_type_id_.get() & 3U);
         }
     }
+    return true;
+}
+
+bool Frame::parse(const CanFrame& can_frame)
+{
+    if (!parseCanID(can_frame))
+    {
+        return false;
+    }
+
+    if (can_frame.dlc > sizeof(can_frame.data))
+    {
+        UAVCAN_ASSERT(0);  // This is not a protocol error, so UAVCAN_ASSERT() is ok
+        return false;
+    }
+
+    if (can_frame.dlc < 1)
+    {
+        UAVCAN_TRACE("Frame", "Parsing failed at line %d", __LINE__);
+        return false;
+    }
 
     /*
      * CAN payload parsing
@@ -52,6 +52,17 @@ int StaticTransferBufferImpl::write(unsigned offset, const uint8_t* data, unsign
     return int(len);
 }
 
+int StaticTransferBufferImpl::peek(unsigned offset, const uint8_t*& out_data) const
+{
+    if (offset >= max_write_pos_)
+    {
+        out_data = UAVCAN_NULLPTR;
+        return 0;
+    }
+    out_data = data_ + offset;
+    return int(max_write_pos_ - offset);
+}
+
 void StaticTransferBufferImpl::reset()
 {
     max_write_pos_ = 0;
@@ -184,6 +195,32 @@ int TransferBufferManagerEntry::read(unsigned offset, uint8_t* data, unsigned le
     return int(len);
 }
 
+int TransferBufferManagerEntry::peek(unsigned offset, const uint8_t*& out_data) const
+{
+    out_data = UAVCAN_NULLPTR;
+    if (offset >= max_write_pos_)
+    {
+        return 0;
+    }
+
+    unsigned block_offset = 0;
+    const Block* p = blocks_.get();
+    while ((p != UAVCAN_NULLPTR) && ((block_offset + Block::Size) <= offset))
+    {
+        block_offset += Block::Size;
+        p = p->getNextListNode();
+    }
+    if (p == UAVCAN_NULLPTR)
+    {
+        UAVCAN_ASSERT(0);
+        return -ErrLogic;
+    }
+
+    const unsigned offset_in_block = offset - block_offset;
+    out_data = p->data + offset_in_block;
+    return int(min(unsigned(Block::Size) - offset_in_block, unsigned(max_write_pos_) - offset));
+}
+
 int TransferBufferManagerEntry::write(unsigned offset, const uint8_t* data, unsigned len)
 {
     if (!data)
@@ -359,4 +396,64 @@ unsigned TransferBufferManager::getNumBuffers() const
     return buffers_.getLength();
 }
 
+/*
+ * StreamingTransferBuffer
+ */
+int StreamingTransferBuffer::read(unsigned, uint8_t*, unsigned) const
+{
+    UAVCAN_ASSERT(0);
+    return -ErrLogic;
+}
+
+int StreamingTransferBuffer::write(unsigned offset, const uint8_t* data, unsigned len)
+{
+    if (data == UAVCAN_NULLPTR)
+    {
+        UAVCAN_ASSERT(0);
+        return -ErrInvalidParam;
+    }
+    if (owner_.isEmpty() || (offset != write_pos_))
+    {
+        UAVCAN_TRACE("StreamingTransferBuffer", "Out of order write at %u, expected %u", offset, unsigned(write_pos_));
+        aborted_ = true;
+        return -ErrLogic;
+    }
+    if (offset >= max_size_)
+    {
+        UAVCAN_TRACE("StreamingTransferBuffer", "Write at %u exceeds the max size %u", offset, unsigned(max_size_));
+        aborted_ = true;
+        return 0;
+    }
+    if ((offset + len) > max_size_)
+    {
+        UAVCAN_TRACE("StreamingTransferBuffer", "Write at %u truncated to the max size %u",
+                     offset, unsigned(max_size_));
+        aborted_ = true;    // Same as TransferBufferManagerEntry, the part that fits is written
+        len = max_size_ - offset;
+    }
+    if (!handleStreamData(data, len))
+    {
+        UAVCAN_TRACE("StreamingTransferBuffer", "Stream aborted at %u", offset);
+        aborted_ = true;
+        return -ErrInvalidMarshalData;
+    }
+    crc_.add(data, len);
+    write_pos_ = uint16_t(write_pos_ + len);
+    return int(len);
+}
+
+bool StreamingTransferBuffer::acquire(const TransferBufferManagerKey& key)
+{
+    UAVCAN_ASSERT(!key.isEmpty());
+    if (!owner_.isEmpty() && !(owner_ == key))
+    {
+        return false;
+    }
+    owner_ = key;
+    crc_ = crc_base_;
+    write_pos_ = 0;
+    handleStreamStart();
+    return true;
+}
+
 }
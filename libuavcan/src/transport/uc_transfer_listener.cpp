@@ -50,6 +50,17 @@ int SingleFrameIncomingTransfer::read(unsigned offset, uint8_t* data, unsigned l
     return int(len);
 }
 
+int SingleFrameIncomingTransfer::peek(unsigned offset, const uint8_t*& out_data) const
+{
+    if (offset >= payload_len_)
+    {
+        out_data = UAVCAN_NULLPTR;
+        return 0;
+    }
+    out_data = payload_ + offset;
+    return int(payload_len_ - offset);
+}
+
 bool SingleFrameIncomingTransfer::isAnonymousTransfer() const
 {
     return (getTransferType() == TransferTypeMessageBroadcast) && getSrcNodeID().isBroadcast();
@@ -59,7 +70,7 @@ bool SingleFrameIncomingTransfer::isAnonymousTransfer() const
  * MultiFrameIncomingTransfer
  */
 MultiFrameIncomingTransfer::MultiFrameIncomingTransfer(MonotonicTime ts_mono, UtcTime ts_utc,
-                                                       const RxFrame& last_frame, TransferBufferAccessor& tba)
+                                                       const RxFrame& last_frame, ITransferBufferAccessor& tba)
     : IncomingTransfer(ts_mono, ts_utc, last_frame.getPriority(), last_frame.getTransferType(),
                        last_frame.getTransferID(), last_frame.getSrcNodeID(), last_frame.getIfaceIndex())
     , buf_acc_(tba)
@@ -70,7 +81,7 @@ MultiFrameIncomingTransfer::MultiFrameIncomingTransfer(MonotonicTime ts_mono, Ut
 
 int MultiFrameIncomingTransfer::read(unsigned offset, uint8_t* data, unsigned len) const
 {
-    const ITransferBuffer* const tbb = const_cast<TransferBufferAccessor&>(buf_acc_).access();
+    const ITransferBuffer* const tbb = const_cast<ITransferBufferAccessor&>(buf_acc_).access();
     if (tbb == UAVCAN_NULLPTR)
     {
         UAVCAN_TRACE("MultiFrameIncomingTransfer", "Read failed: no such buffer");
@@ -79,6 +90,18 @@ int MultiFrameIncomingTransfer::read(unsigned offset, uint8_t* data, unsigned le
     return tbb->read(offset, data, len);
 }
 
+int MultiFrameIncomingTransfer::peek(unsigned offset, const uint8_t*& out_data) const
+{
+    const ITransferBuffer* const tbb = const_cast<ITransferBufferAccessor&>(buf_acc_).access();
+    if (tbb == UAVCAN_NULLPTR)
+    {
+        UAVCAN_TRACE("MultiFrameIncomingTransfer", "Peek failed: no such buffer");
+        out_data = UAVCAN_NULLPTR;
+        return -ErrLogic;
+    }
+    return tbb->peek(offset, out_data);
+}
+
 /*
  * TransferListener::TimedOutReceiverPredicate
  */
@@ -95,6 +118,10 @@ bool TransferListener::TimedOutReceiverPredicate::operator()(const TransferBuffe
          * Maybe it is not good that the predicate has side effects, but I ran out of better ideas.
          */
         parent_bufmgr_.remove(key);
+        if ((parent_stream_buf_ != UAVCAN_NULLPTR) && parent_stream_buf_->isAcquiredBy(key))
+        {
+            parent_stream_buf_->release();
+        }
         return true;
     }
     return false;
@@ -103,9 +130,8 @@ bool TransferListener::TimedOutReceiverPredicate::operator()(const TransferBuffe
 /*
  * TransferListener
  */
-bool TransferListener::checkPayloadCrc(const uint16_t compare_with, const ITransferBuffer& tbb) const
+static bool checkPayloadCrc(TransferCRC crc, const uint16_t compare_with, const ITransferBuffer& tbb)
 {
-    TransferCRC crc = crc_base_;
     unsigned offset = 0;
     while (true)
     {
@@ -140,6 +166,11 @@ void TransferListener::handleReception(TransferReceiver& receiver, const RxFrame
     case TransferReceiver::ResultNotComplete:
     {
         perf_.addErrors(receiver.yieldErrorCount());
+        if ((stream_buf_ != UAVCAN_NULLPTR) && stream_buf_->yieldAbort())
+        {
+            UAVCAN_TRACE("TransferListener", "Stream aborted, last frame: %s", frame.toString().c_str());
+            handleStreamedTransferFailure();
+        }
         break;
     }
     case TransferReceiver::ResultSingleFrame:
@@ -152,13 +183,29 @@ void TransferListener::handleReception(TransferReceiver& receiver, const RxFrame
     case TransferReceiver::ResultComplete:
     {
         perf_.addRxTransfer();
+        if (tba.isStreaming())
+        {
+            if (stream_buf_->getCrc() != receiver.getLastTransferCrc())
+            {
+                UAVCAN_TRACE("TransferListener", "CRC error, last frame: %s", frame.toString().c_str());
+                tba.remove();
+                perf_.addError();
+                handleStreamedTransferFailure();
+                break;
+            }
+            MultiFrameIncomingTransfer it(receiver.getLastTransferTimestampMonotonic(),
+                                          receiver.getLastTransferTimestampUtc(), frame, tba);
+            handleStreamedTransfer(it);
+            it.release();
+            break;
+        }
         const ITransferBuffer* tbb = tba.access();
         if (tbb == UAVCAN_NULLPTR)
         {
             UAVCAN_TRACE("TransferListener", "Buffer access failure, last frame: %s", frame.toString().c_str());
             break;
         }
-        if (!checkPayloadCrc(receiver.getLastTransferCrc(), *tbb))
+        if (!checkPayloadCrc(crc_base_, receiver.getLastTransferCrc(), *tbb))
         {
             UAVCAN_TRACE("TransferListener", "CRC error, last frame: %s", frame.toString().c_str());
             break;
@@ -193,9 +240,24 @@ TransferListener::~TransferListener()
     receivers_.clear();
 }
 
+void TransferListener::installStreamingBuffer(StreamingTransferBuffer* stream_buf)
+{
+    if (stream_buf_ != UAVCAN_NULLPTR)
+    {
+        stream_buf_->release();
+    }
+    stream_buf_ = stream_buf;
+    if (stream_buf_ != UAVCAN_NULLPTR)
+    {
+        stream_buf_->release();
+        stream_buf_->setCrcBase(crc_base_);
+        stream_buf_->setMaxSize(bufmgr_.getMaxBufferSize());
+    }
+}
+
 void TransferListener::cleanup(MonotonicTime ts)
 {
-    receivers_.removeAllWhere(TimedOutReceiverPredicate(ts, bufmgr_));
+    receivers_.removeAllWhere(TimedOutReceiverPredicate(ts, bufmgr_, stream_buf_));
     UAVCAN_ASSERT(receivers_.isEmpty() ? bufmgr_.isEmpty() : 1);
 }
 
@@ -221,7 +283,7 @@ void TransferListener::handleFrame(const RxFrame& frame)
                 return;
             }
         }
-        TransferBufferAccessor tba(bufmgr_, key);
+        TransferBufferAccessor tba(bufmgr_, key, stream_buf_);
         handleReception(*recv, frame, tba);
     }
     else if (frame.getSrcNodeID().isBroadcast() &&
@@ -255,4 +317,194 @@ void TransferListenerWithFilter::handleFrame(const RxFrame& frame)
     }
 }
 
+/*
+ * WildcardTransferListener::SessionKey
+ */
+#if UAVCAN_TOSTRING
+std::string WildcardTransferListener::SessionKey::toString() const
+{
+    char buf[48];
+    (void)snprintf(buf, sizeof(buf), "nid=%i tt=%i dtid=%i dnid=%i", int(src_node_id_.get()), int(transfer_type_),
+                   int(data_type_id_), int(dst_node_id_.get()));
+    return std::string(buf);
+}
+#endif
+
+/*
+ * WildcardTransferListener::SessionBufferAccessor
+ */
+ITransferBuffer* WildcardTransferListener::SessionBufferAccessor::create()
+{
+    remove();
+    buffer_ = TransferBufferManagerEntry::instantiate(allocator_, max_buffer_size_);
+    return buffer_;
+}
+
+void WildcardTransferListener::SessionBufferAccessor::remove()
+{
+    if (buffer_ != UAVCAN_NULLPTR)
+    {
+        TransferBufferManagerEntry::destroy(buffer_, allocator_);
+    }
+}
+
+/*
+ * WildcardTransferListener::TimedOutSessionPredicate
+ */
+bool WildcardTransferListener::TimedOutSessionPredicate::operator()(const SessionKey& key,
+                                                                    const Session& value) const
+{
+    (void)key;
+    if (value.receiver.isTimedOut(ts_))
+    {
+        UAVCAN_TRACE("WildcardTransferListener", "Timed out receiver: %s", key.toString().c_str());
+        /*
+         * Same as TransferListener, the sessions do not own their buffers, so that the Map<> container
+         * can copy them around; the buffers are destroyed manually.
+         */
+        TransferBufferManagerEntry* buffer = value.buffer;
+        if (buffer != UAVCAN_NULLPTR)
+        {
+            TransferBufferManagerEntry::destroy(buffer, allocator_);
+        }
+        return true;
+    }
+    return false;
+}
+
+/*
+ * WildcardTransferListener
+ */
+bool WildcardTransferListener::getCrcBase(const RxFrame& frame, TransferCRC& out_crc)
+{
+    const DataTypeKind kind =
+        (frame.getTransferType() == TransferTypeMessageBroadcast) ? DataTypeKindMessage : DataTypeKindService;
+    DataTypeSignature signature;
+    if (!getDataTypeSignature(kind, frame.getDataTypeID(), signature))
+    {
+        return false;
+    }
+    out_crc = signature.toTransferCRC();
+    return true;
+}
+
+void WildcardTransferListener::handleReception(TransferReceiver& receiver, const RxFrame& frame,
+                                               ITransferBufferAccessor& tba)
+{
+    switch (receiver.addFrame(frame, tba))
+    {
+    case TransferReceiver::ResultNotComplete:
+    {
+        perf_.addErrors(receiver.yieldErrorCount());
+        break;
+    }
+    case TransferReceiver::ResultSingleFrame:
+    {
+        perf_.addRxTransfer();
+        SingleFrameIncomingTransfer it(frame);
+        handleIncomingTransfer(frame.getDataTypeID(), frame.getDstNodeID(), it);
+        break;
+    }
+    case TransferReceiver::ResultComplete:
+    {
+        const ITransferBuffer* tbb = tba.access();
+        if (tbb == UAVCAN_NULLPTR)
+        {
+            UAVCAN_TRACE("WildcardTransferListener", "Buffer access failure, last frame: %s",
+                         frame.toString().c_str());
+            break;
+        }
+        TransferCRC crc;
+        if (!getCrcBase(frame, crc) ||
+            !checkPayloadCrc(crc, receiver.getLastTransferCrc(), *tbb))
+        {
+            UAVCAN_TRACE("WildcardTransferListener", "CRC error, last frame: %s", frame.toString().c_str());
+            perf_.addError();
+            tba.remove();
+            break;
+        }
+        perf_.addRxTransfer();
+        MultiFrameIncomingTransfer it(receiver.getLastTransferTimestampMonotonic(),
+                                      receiver.getLastTransferTimestampUtc(), frame, tba);
+        handleIncomingTransfer(frame.getDataTypeID(), frame.getDstNodeID(), it);
+        it.release();
+        break;
+    }
+    default:
+    {
+        UAVCAN_ASSERT(0);
+        break;
+    }
+    }
+}
+
+WildcardTransferListener::~WildcardTransferListener()
+{
+    for (unsigned i = 0; i < sessions_.getSize(); i++)
+    {
+        TransferBufferManagerEntry*& buffer = sessions_.getByIndex(i)->value.buffer;
+        if (buffer != UAVCAN_NULLPTR)
+        {
+            TransferBufferManagerEntry::destroy(buffer, allocator_);
+        }
+    }
+    sessions_.clear();
+}
+
+void WildcardTransferListener::cleanup(MonotonicTime ts)
+{
+    sessions_.removeAllWhere(TimedOutSessionPredicate(ts, allocator_));
+}
+
+void WildcardTransferListener::handleFrame(const RxFrame& frame)
+{
+    if (frame.getSrcNodeID().isUnicast())       // Normal transfer
+    {
+        const SessionKey key(frame);
+
+        Session* session = sessions_.access(key);
+        if (session == UAVCAN_NULLPTR)
+        {
+            if (!frame.isStartOfTransfer())
+            {
+                return;
+            }
+
+            TransferCRC unused;
+            if (!frame.isEndOfTransfer() && !getCrcBase(frame, unused))
+            {
+                UAVCAN_TRACE("WildcardTransferListener", "Unknown signature; frame %s", frame.toString().c_str());
+                return;
+            }
+
+            Session new_session;
+            session = sessions_.insert(key, new_session);
+            if (session == UAVCAN_NULLPTR)
+            {
+                UAVCAN_TRACE("WildcardTransferListener", "Receiver registration failed; frame %s",
+                             frame.toString().c_str());
+                return;
+            }
+        }
+        SessionBufferAccessor tba(allocator_, session->buffer, max_buffer_size_);
+        handleReception(session->receiver, frame, tba);
+    }
+    else if (frame.getSrcNodeID().isBroadcast() &&
+             frame.isStartOfTransfer() &&
+             frame.isEndOfTransfer() &&
+             frame.getDstNodeID().isBroadcast())        // Anonymous transfer
+    {
+        if (allow_anonymous_transfers_)
+        {
+            perf_.addRxTransfer();
+            SingleFrameIncomingTransfer it(frame);
+            handleIncomingTransfer(frame.getDataTypeID(), frame.getDstNodeID(), it);
+        }
+    }
+    else
+    {
+        UAVCAN_TRACE("WildcardTransferListener", "Invalid frame: %s", frame.toString().c_str());
+    }
+}
+
 }
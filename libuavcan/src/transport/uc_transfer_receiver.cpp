@@ -128,7 +128,7 @@ bool TransferReceiver::writePayload(const RxFrame& frame, ITransferBuffer& buf)
     }
 }
 
-TransferReceiver::ResultCode TransferReceiver::receive(const RxFrame& frame, TransferBufferAccessor& tba)
+TransferReceiver::ResultCode TransferReceiver::receive(const RxFrame& frame, ITransferBufferAccessor& tba)
 {
     // Transfer timestamps are derived from the first frame
     if (frame.isStartOfTransfer())
@@ -183,7 +183,7 @@ bool TransferReceiver::isTimedOut(MonotonicTime current_ts) const
     return (current_ts - this_transfer_ts_) > getTidTimeout();
 }
 
-TransferReceiver::ResultCode TransferReceiver::addFrame(const RxFrame& frame, TransferBufferAccessor& tba)
+TransferReceiver::ResultCode TransferReceiver::addFrame(const RxFrame& frame, ITransferBufferAccessor& tba)
 {
     if ((frame.getMonotonicTimestamp().isZero()) ||
         (frame.getMonotonicTimestamp() < prev_transfer_ts_) ||
@@ -9,6 +9,200 @@
 
 namespace uavcan
 {
+namespace
+{
+/**
+ * Splits the payload coming from ITransferPayloadSource into chunks of the frame payload size.
+ * The bytes of a chunk are committed only once the payload extends past the chunk, because until then
+ * the last byte can still be overwritten.
+ */
+class PayloadChunker : public ITransferBuffer
+{
+    uint8_t chunk_[Frame::PayloadCapacity];
+    unsigned chunk_len_;
+    unsigned chunk_capacity_;
+    unsigned committed_len_;
+    bool logic_error_;
+
+    virtual void commit(const uint8_t* data, unsigned len) = 0;
+
+protected:
+    explicit PayloadChunker(unsigned chunk_capacity)
+        : chunk_len_(0)
+        , chunk_capacity_(chunk_capacity)
+        , committed_len_(0)
+        , logic_error_(false)
+    {
+        UAVCAN_ASSERT(chunk_capacity_ <= sizeof(chunk_));
+    }
+
+    void setChunkCapacity(unsigned chunk_capacity)
+    {
+        UAVCAN_ASSERT(chunk_capacity <= sizeof(chunk_));
+        chunk_capacity_ = chunk_capacity;
+    }
+
+public:
+    virtual int read(unsigned, uint8_t*, unsigned) const { return -ErrLogic; }
+
+    virtual int write(unsigned offset, const uint8_t* data, unsigned len)
+    {
+        UAVCAN_ASSERT(data != UAVCAN_NULLPTR);
+        const unsigned total_len = len;
+        while (len > 0)
+        {
+            if ((offset < committed_len_) || (offset > (committed_len_ + chunk_len_)))
+            {
+                UAVCAN_ASSERT(0);       // Committed bytes can't be rewritten, and gaps are not allowed
+                logic_error_ = true;
+                return -ErrLogic;
+            }
+            unsigned pos = offset - committed_len_;
+            if (pos == chunk_capacity_)
+            {
+                commit(chunk_, chunk_len_);
+                committed_len_ += chunk_len_;
+                chunk_len_ = 0;
+                pos = 0;
+            }
+            const unsigned n = min(len, chunk_capacity_ - pos);
+            (void)copy(data, data + n, chunk_ + pos);
+            chunk_len_ = max(chunk_len_, pos + n);
+            offset += n;
+            data += n;
+            len -= n;
+        }
+        return int(total_len);
+    }
+
+    /// Uncommitted trailing bytes of the payload
+    const uint8_t* getChunk() const { return chunk_; }
+    unsigned getChunkLen() const { return chunk_len_; }
+
+    unsigned getTotalLen() const { return committed_len_ + chunk_len_; }
+    unsigned getCommittedLen() const { return committed_len_; }
+
+    bool hadLogicError() const { return logic_error_; }
+};
+
+/**
+ * First pass: computes the transfer CRC and the length of the payload.
+ */
+class PayloadMeter : public PayloadChunker
+{
+    TransferCRC crc_;
+
+    virtual void commit(const uint8_t* data, unsigned len) { crc_.add(data, len); }
+
+public:
+    explicit PayloadMeter(const TransferCRC& crc_base)
+        : PayloadChunker(Frame::PayloadCapacity)
+        , crc_(crc_base)
+    { }
+
+    /**
+     * If the payload fits one frame, it is not committed at all, and the CRC is not needed.
+     */
+    bool isSingleFrame() const { return getCommittedLen() == 0; }
+
+    TransferCRC getCRC() const
+    {
+        TransferCRC crc = crc_;
+        crc.add(getChunk(), getChunkLen());
+        return crc;
+    }
+};
+
+/**
+ * Second pass: fills the frames of a multi frame transfer and sends them as soon as they are complete.
+ */
+class FrameEmitter : public PayloadChunker
+{
+    Dispatcher& dispatcher_;
+    Frame& frame_;
+    const MonotonicTime tx_deadline_;
+    const MonotonicTime blocking_deadline_;
+    const CanTxQueue::Qos qos_;
+    const CanIOFlags flags_;
+    const uint8_t iface_mask_;
+    const uint16_t crc_;
+    int result_;            ///< Number of frames sent or negative error code
+
+    enum { CrcLen = 2 };
+
+    void sendFrame(const uint8_t* data, unsigned len)
+    {
+        if (result_ < 0)
+        {
+            return;             // Discarding the rest of the transfer
+        }
+
+        int write_res = 0;
+        if (frame_.isStartOfTransfer())
+        {
+            uint8_t buf[Frame::PayloadCapacity];
+            UAVCAN_ASSERT(len + CrcLen <= sizeof(buf));
+            buf[0] = uint8_t(crc_ & 0xFFU);             // Transfer CRC, little endian
+            buf[1] = uint8_t((crc_ >> 8) & 0xFFU);
+            (void)copy(data, data + len, buf + CrcLen);
+            write_res = frame_.setPayload(buf, len + CrcLen) - CrcLen;
+        }
+        else
+        {
+            write_res = frame_.setPayload(data, len);
+        }
+        if (write_res != int(len))
+        {
+            UAVCAN_ASSERT(0);
+            result_ = -ErrLogic;
+            return;
+        }
+
+        const int send_res = dispatcher_.send(frame_, tx_deadline_, blocking_deadline_, qos_, flags_, iface_mask_);
+        if (send_res < 0)
+        {
+            result_ = send_res;
+            return;
+        }
+        result_++;
+
+        frame_.setStartOfTransfer(false);
+        frame_.flipToggle();
+        setChunkCapacity(Frame::PayloadCapacity);
+    }
+
+    virtual void commit(const uint8_t* data, unsigned len) { sendFrame(data, len); }
+
+public:
+    FrameEmitter(Dispatcher& dispatcher, Frame& frame, MonotonicTime tx_deadline, MonotonicTime blocking_deadline,
+                 CanTxQueue::Qos qos, CanIOFlags flags, uint8_t iface_mask, uint16_t crc)
+        : PayloadChunker(Frame::PayloadCapacity - CrcLen)
+        , dispatcher_(dispatcher)
+        , frame_(frame)
+        , tx_deadline_(tx_deadline)
+        , blocking_deadline_(blocking_deadline)
+        , qos_(qos)
+        , flags_(flags)
+        , iface_mask_(iface_mask)
+        , crc_(crc)
+        , result_(0)
+    { }
+
+    /**
+     * Sends the last frame. Returns the number of frames sent or negative error code.
+     */
+    int finish()
+    {
+        UAVCAN_ASSERT(getChunkLen() > 0);
+        frame_.setEndOfTransfer(true);
+        sendFrame(getChunk(), getChunkLen());
+        return result_;
+    }
+
+    int getResult() const { return result_; }
+};
+
+}
 
 void TransferSender::registerError() const
 {
@@ -24,9 +218,32 @@ void TransferSender::init(const DataTypeDescriptor& dtid, CanTxQueue::Qos qos)
     crc_base_     = dtid.getSignature().toTransferCRC();
 }
 
+TransferCRC TransferSender::computeTransferCRC(const uint8_t* payload, unsigned payload_len) const
+{
+    TransferCRC crc = crc_base_;
+    crc.add(payload, payload_len);
+    return crc;
+}
+
 int TransferSender::send(const uint8_t* payload, unsigned payload_len, MonotonicTime tx_deadline,
                          MonotonicTime blocking_deadline, TransferType transfer_type, NodeID dst_node_id,
                          TransferID tid) const
+{
+    return sendImpl(payload, payload_len, UAVCAN_NULLPTR, tx_deadline, blocking_deadline, transfer_type,
+                    dst_node_id, tid);
+}
+
+int TransferSender::send(const uint8_t* payload, unsigned payload_len, const TransferCRC& payload_crc,
+                         MonotonicTime tx_deadline, MonotonicTime blocking_deadline, TransferType transfer_type,
+                         NodeID dst_node_id, TransferID tid) const
+{
+    return sendImpl(payload, payload_len, &payload_crc, tx_deadline, blocking_deadline, transfer_type,
+                    dst_node_id, tid);
+}
+
+int TransferSender::sendImpl(const uint8_t* payload, unsigned payload_len, const TransferCRC* payload_crc,
+                             MonotonicTime tx_deadline, MonotonicTime blocking_deadline, TransferType transfer_type,
+                             NodeID dst_node_id, TransferID tid) const
 {
     Frame frame(data_type_id_, transfer_type, dispatcher_.getNodeID(), dst_node_id, tid);
 
@@ -80,8 +297,8 @@ int TransferSender::send(const uint8_t* payload, unsigned payload_len, Monotonic
 
         int offset = 0;
         {
-            TransferCRC crc = crc_base_;
-            crc.add(payload, payload_len);
+            const TransferCRC crc = (payload_crc != UAVCAN_NULLPTR) ? *payload_crc :
+                                    computeTransferCRC(payload, payload_len);
 
             static const int BUFLEN = sizeof(static_cast<CanFrame*>(0)->data);
             uint8_t buf[BUFLEN];
@@ -143,8 +360,8 @@ int TransferSender::send(const uint8_t* payload, unsigned payload_len, Monotonic
     return -ErrLogic; // Return path analysis is apparently broken. There should be no warning, this 'return' is unreachable.
 }
 
-int TransferSender::send(const uint8_t* payload, unsigned payload_len, MonotonicTime tx_deadline,
-                         MonotonicTime blocking_deadline, TransferType transfer_type, NodeID dst_node_id) const
+TransferID* TransferSender::accessTransferID(MonotonicTime tx_deadline, TransferType transfer_type,
+                                             NodeID dst_node_id) const
 {
     /*
      * TODO: TID is not needed for anonymous transfers, this part of the code can be skipped?
@@ -160,6 +377,16 @@ int TransferSender::send(const uint8_t* payload, unsigned payload_len, Monotonic
     {
         UAVCAN_TRACE("TransferSender", "OTR access failure, dtid=%d tt=%i",
                      int(data_type_id_.get()), int(transfer_type));
+    }
+    return tid;
+}
+
+int TransferSender::send(const uint8_t* payload, unsigned payload_len, MonotonicTime tx_deadline,
+                         MonotonicTime blocking_deadline, TransferType transfer_type, NodeID dst_node_id) const
+{
+    TransferID* const tid = accessTransferID(tx_deadline, transfer_type, dst_node_id);
+    if (tid == UAVCAN_NULLPTR)
+    {
         return -ErrMemory;
     }
 
@@ -170,4 +397,102 @@ int TransferSender::send(const uint8_t* payload, unsigned payload_len, Monotonic
                 dst_node_id, this_tid);
 }
 
+int TransferSender::send(const uint8_t* payload, unsigned payload_len, const TransferCRC& payload_crc,
+                         MonotonicTime tx_deadline, MonotonicTime blocking_deadline, TransferType transfer_type,
+                         NodeID dst_node_id) const
+{
+    TransferID* const tid = accessTransferID(tx_deadline, transfer_type, dst_node_id);
+    if (tid == UAVCAN_NULLPTR)
+    {
+        return -ErrMemory;
+    }
+
+    const TransferID this_tid = tid->get();
+    tid->increment();
+
+    return sendImpl(payload, payload_len, &payload_crc, tx_deadline, blocking_deadline, transfer_type,
+                    dst_node_id, this_tid);
+}
+
+int TransferSender::send(const ITransferPayloadSource& payload, MonotonicTime tx_deadline,
+                         MonotonicTime blocking_deadline, TransferType transfer_type, NodeID dst_node_id,
+                         TransferID tid) const
+{
+    /*
+     * First pass - the CRC and the length of the payload.
+     * Short payloads are sent as is, they don't need the second pass.
+     */
+    PayloadMeter meter(crc_base_);
+    int res = payload.writePayload(meter);
+    if (res < 0)
+    {
+        return res;
+    }
+    if (meter.hadLogicError())
+    {
+        registerError();
+        return -ErrLogic;
+    }
+    if (meter.isSingleFrame())
+    {
+        return send(meter.getChunk(), meter.getChunkLen(), tx_deadline, blocking_deadline, transfer_type,
+                    dst_node_id, tid);
+    }
+
+    /*
+     * Second pass - the frames are sent as soon as they are filled
+     */
+    Frame frame(data_type_id_, transfer_type, dispatcher_.getNodeID(), dst_node_id, tid);
+    frame.setPriority(priority_);
+    frame.setStartOfTransfer(true);
+
+    UAVCAN_TRACE("TransferSender", "Streaming %s", frame.toString().c_str());
+
+    if (dispatcher_.isPassiveMode())
+    {
+        return -ErrPassiveMode;         // Multi frame anonymous transfers are not possible
+    }
+    UAVCAN_ASSERT(frame.getSrcNodeID().isUnicast());
+
+    dispatcher_.getTransferPerfCounter().addTxTransfer();
+
+    FrameEmitter emitter(dispatcher_, frame, tx_deadline, blocking_deadline, qos_, flags_, iface_mask_,
+                         meter.getCRC().get());
+    res = payload.writePayload(emitter);
+    if (res >= 0)
+    {
+        // The source must produce exactly the same payload again, otherwise the CRC would be wrong
+        if (emitter.hadLogicError() || (emitter.getTotalLen() != meter.getTotalLen()))
+        {
+            UAVCAN_ASSERT(0);
+            res = -ErrLogic;
+        }
+        else
+        {
+            res = emitter.finish();
+        }
+    }
+    if (res < 0)
+    {
+        UAVCAN_TRACE("TransferSender", "Streaming failure, %i", res);
+        registerError();
+    }
+    return res;
+}
+
+int TransferSender::send(const ITransferPayloadSource& payload, MonotonicTime tx_deadline,
+                         MonotonicTime blocking_deadline, TransferType transfer_type, NodeID dst_node_id) const
+{
+    TransferID* const tid = accessTransferID(tx_deadline, transfer_type, dst_node_id);
+    if (tid == UAVCAN_NULLPTR)
+    {
+        return -ErrMemory;
+    }
+
+    const TransferID this_tid = tid->get();
+    tid->increment();
+
+    return send(payload, tx_deadline, blocking_deadline, transfer_type, dst_node_id, this_tid);
+}
+
 }
@@ -13,8 +13,12 @@ void* LimitedPoolAllocator::allocate(std::size_t size)
 {
     if (used_blocks_ < max_blocks_)
     {
-        used_blocks_++;
-        return allocator_.allocate(size);
+        void* const ptr = allocator_.allocate(size);
+        if (ptr != UAVCAN_NULLPTR)
+        {
+            used_blocks_++;
+        }
+        return ptr;
     }
     else
     {
@@ -14,6 +14,8 @@
 #include <root_ns_a/NestedMessage.hpp>
 #include <root_ns_a/A.hpp>
 #include <root_ns_a/ReportBackSoldier.hpp>
+#include <root_ns_a/FixedLayout.hpp>
+#include <root_ns_a/Deep.hpp>
 #include <root_ns_b/ServiceWithEmptyRequest.hpp>
 #include <root_ns_b/ServiceWithEmptyResponse.hpp>
 #include <root_ns_b/T.hpp>
@@ -97,6 +99,239 @@ TEST(Dsdl, CloseComparison)
     ASSERT_FALSE(first == second);            // Ditto
 }
 
+/**
+ * Encodes the message field by field using the primitive type codecs only, which is how the generated code worked
+ * before the fixed layout serializers were introduced.
+ */
+static void encodeFixedLayoutReference(const root_ns_a::FixedLayout& msg, uavcan::ScalarCodec& sc)
+{
+    typedef root_ns_a::FixedLayout::FieldTypes F;
+    typedef root_ns_a::NestedInUnion::FieldTypes::array::RawValueType H;
+    const uavcan::TailArrayOptimizationMode tao = uavcan::TailArrayOptDisabled;
+
+    ASSERT_EQ(1, F::a::encode(msg.a, sc, tao));
+    ASSERT_EQ(1, F::b::encode(msg.b, sc, tao));
+    ASSERT_EQ(1, F::c::encode(msg.c, sc, tao));
+    ASSERT_EQ(1, F::d::encode(msg.d, sc, tao));
+    ASSERT_EQ(1, sc.encode<5>(uint8_t(0)));
+    ASSERT_EQ(1, F::e::encode(msg.e, sc, tao));
+    for (unsigned i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(1, F::f::RawValueType::encode(msg.f[uint8_t(i)], sc, tao));
+    }
+    ASSERT_EQ(1, F::g::encode(msg.g, sc, tao));
+    ASSERT_EQ(1, sc.encode<2>(uint8_t(0)));
+    for (unsigned i = 0; i < 4; i++)
+    {
+        ASSERT_EQ(1, H::encode(msg.h.array[uint8_t(i)], sc, tao));
+    }
+    ASSERT_EQ(1, sc.encode<3>(uint8_t(0)));
+    ASSERT_EQ(1, F::i::encode(msg.i, sc, tao));
+    for (unsigned i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(1, F::j::RawValueType::encode(msg.j[uint8_t(i)], sc, tao));
+    }
+    ASSERT_EQ(1, F::tail::encode(msg.tail, sc, uavcan::TailArrayOptEnabled));
+}
+
+TEST(Dsdl, FixedLayout)
+{
+    ASSERT_EQ(219, root_ns_a::FixedLayout::FixedPrefixBitLen);
+
+    root_ns_a::FixedLayout msg;
+    msg.a = true;
+    msg.b = -1234;
+    msg.c = 5;
+    msg.d = -3.5F;
+    msg.e = -0x123456789ALL;
+    msg.f[0] = 1;
+    msg.f[1] = 200;             // Saturated
+    msg.f[2] = 100;
+    msg.g = 123.456F;
+    msg.h.array[0] = 3;
+    msg.h.array[1] = 0;
+    msg.h.array[2] = 2;
+    msg.h.array[3] = 1;
+    msg.i = -0x0123456789ABCDEFLL;
+    msg.j[0] = true;
+    msg.j[2] = true;
+    msg.tail.push_back(42);
+    msg.tail.push_back(24);
+
+    // All bit alignments of the message within the stream
+    for (unsigned prefix_bits = 0; prefix_bits < 8; prefix_bits++)
+    {
+        uavcan::StaticTransferBuffer<100> buf;
+        uavcan::StaticTransferBuffer<100> ref_buf;
+        {
+            uavcan::BitStream bs(buf);
+            uavcan::ScalarCodec sc(bs);
+            ASSERT_EQ(1, sc.encode<8>(uint8_t(0xFF >> (8 - prefix_bits))));
+            ASSERT_EQ(1, root_ns_a::FixedLayout::encode(msg, sc));
+
+            uavcan::BitStream ref_bs(ref_buf);
+            uavcan::ScalarCodec ref_sc(ref_bs);
+            ASSERT_EQ(1, ref_sc.encode<8>(uint8_t(0xFF >> (8 - prefix_bits))));
+            encodeFixedLayoutReference(msg, ref_sc);
+
+            ASSERT_EQ(ref_bs.toString(), bs.toString());
+        }
+
+        root_ns_a::FixedLayout decoded;
+        uavcan::BitStream bs(buf);
+        uavcan::ScalarCodec sc(bs);
+        uint8_t prefix = 0;
+        ASSERT_EQ(1, sc.decode<8>(prefix));
+        ASSERT_EQ(1, root_ns_a::FixedLayout::decode(decoded, sc));
+
+        ASSERT_EQ(-0x123456789ALL, decoded.e);
+        ASSERT_EQ(127, decoded.f[1]);
+        msg.f[1] = 127;
+        ASSERT_TRUE(msg == decoded);
+        msg.f[1] = 200;
+    }
+
+    // Out of buffer
+    uavcan::StaticTransferBuffer<27> buf;
+    uavcan::BitStream bs_wr(buf);
+    uavcan::ScalarCodec sc_wr(bs_wr);
+    ASSERT_EQ(0, root_ns_a::FixedLayout::encode(msg, sc_wr));
+
+    root_ns_a::FixedLayout decoded;
+    uavcan::BitStream bs_rd(buf);
+    uavcan::ScalarCodec sc_rd(bs_rd);
+    ASSERT_EQ(0, root_ns_a::FixedLayout::decode(decoded, sc_rd));
+}
+
+TEST(Dsdl, View)
+{
+    root_ns_a::FixedLayout msg;
+    msg.a = true;
+    msg.b = -1234;
+    msg.c = 5;
+    msg.d = -3.5F;
+    msg.e = -0x123456789ALL;
+    msg.f[1] = 100;
+    msg.g = 123.456F;
+    msg.h.array[2] = 2;
+    msg.i = -0x0123456789ABCDEFLL;
+    msg.j[1] = true;
+    msg.tail.push_back(42);
+
+    uavcan::StaticTransferBuffer<100> buf;
+    {
+        uavcan::BitStream bs(buf);
+        uavcan::ScalarCodec sc(bs);
+        ASSERT_EQ(1, root_ns_a::FixedLayout::encode(msg, sc));
+    }
+
+    const root_ns_a::FixedLayout::View view(buf);
+    ASSERT_EQ(msg.a, view.a());
+    ASSERT_EQ(msg.b, view.b());
+    ASSERT_EQ(msg.c, view.c());
+    ASSERT_EQ(msg.d, view.d());
+    ASSERT_EQ(msg.e, view.e());
+    ASSERT_EQ(msg.g, view.g());
+    ASSERT_EQ(msg.i, view.i());
+
+    root_ns_a::FixedLayout materialized;
+    ASSERT_EQ(1, view.materialize(materialized));
+    ASSERT_TRUE(msg == materialized);
+
+    // Truncated payload - the missing fields are zero, full decoding fails
+    buf.setMaxWritePos(19);
+    ASSERT_EQ(msg.g, view.g());
+    ASSERT_EQ(0, view.i());
+    ASSERT_GE(0, view.materialize(materialized));
+}
+
+TEST(Dsdl, SelectiveDecoding)
+{
+    typedef root_ns_a::Deep Deep;
+
+    Deep msg;
+    msg.c = true;
+    msg.str = "Selective";
+    msg.a.resize(1, root_ns_a::A());
+    msg.a[0].scalar = 1.5F;
+    msg.a[0].vector[1].vector[0] = -2.25;
+    msg.a[0].vector[1].bools[7] = true;
+    msg.b[0].vector[1] = 42.0;
+    msg.b[1].bools[15] = true;
+
+    uavcan::StaticTransferBuffer<200> buf;
+    unsigned encoded_bits = 0;
+    {
+        uavcan::BitStream bs(buf);
+        uavcan::ScalarCodec sc(bs);
+        ASSERT_EQ(1, sc.encode<3>(uint8_t(5)));     // Misaligned
+        ASSERT_EQ(1, Deep::encode(msg, sc));
+        encoded_bits = bs.getBitOffset();
+    }
+
+    // Every combination of the fields
+    for (uint32_t mask = 0; mask < 16; mask++)
+    {
+        Deep decoded;
+        uavcan::BitStream bs(buf);
+        uavcan::ScalarCodec sc(bs);
+        uint8_t prefix = 0;
+        ASSERT_EQ(1, sc.decode<3>(prefix));
+        ASSERT_EQ(1, Deep::decodeSelected(decoded, sc, mask));
+
+        const Deep empty;
+        ASSERT_TRUE(((mask & Deep::FieldMask::c) ? msg.c : empty.c) == decoded.c) << mask;
+        ASSERT_TRUE(((mask & Deep::FieldMask::str) ? msg.str : empty.str) == decoded.str) << mask;
+        ASSERT_TRUE(((mask & Deep::FieldMask::a) ? msg.a : empty.a) == decoded.a) << mask;
+        ASSERT_TRUE(((mask & Deep::FieldMask::b) ? msg.b : empty.b) == decoded.b) << mask;
+        if (mask & Deep::FieldMask::b)
+        {
+            ASSERT_EQ(encoded_bits, bs.getBitOffset());
+        }
+    }
+
+    // Skipping consumes exactly the encoded structure
+    {
+        uavcan::BitStream bs(buf);
+        uavcan::ScalarCodec sc(bs);
+        uint8_t prefix = 0;
+        ASSERT_EQ(1, sc.decode<3>(prefix));
+        ASSERT_EQ(1, Deep::skip(sc));
+        ASSERT_EQ(encoded_bits, bs.getBitOffset());
+    }
+
+    // Skipped data must be present
+    buf.setMaxWritePos(uint16_t((encoded_bits + 7) / 8 - 1));
+    {
+        Deep decoded;
+        uavcan::BitStream bs(buf);
+        uavcan::ScalarCodec sc(bs);
+        uint8_t prefix = 0;
+        ASSERT_EQ(1, sc.decode<3>(prefix));
+        ASSERT_EQ(0, Deep::decodeSelected(decoded, sc, Deep::FieldMask::b));
+    }
+
+    // Fixed layout prefix is skipped, the tail array is decoded
+    root_ns_a::FixedLayout fixed;
+    fixed.e = -0x123456789ALL;
+    fixed.tail.push_back(42);
+    fixed.tail.push_back(24);
+    uavcan::StaticTransferBuffer<100> fixed_buf;
+    {
+        uavcan::BitStream bs(fixed_buf);
+        uavcan::ScalarCodec sc(bs);
+        ASSERT_EQ(1, root_ns_a::FixedLayout::encode(fixed, sc));
+    }
+    {
+        root_ns_a::FixedLayout decoded;
+        uavcan::BitStream bs(fixed_buf);
+        uavcan::ScalarCodec sc(bs);
+        ASSERT_EQ(1, root_ns_a::FixedLayout::decodeSelected(decoded, sc, root_ns_a::FixedLayout::FieldMask::tail));
+        ASSERT_EQ(0, decoded.e);
+        ASSERT_TRUE(fixed.tail == decoded.tail);
+    }
+}
+
 /*
  * This test assumes that it will be executed before other GDTR tests; otherwise it fails.
  * TODO: Probably it needs to be called directly from main()
@@ -10,6 +10,8 @@
 #include <gtest/gtest.h>
 #include <uavcan/marshal/types.hpp>
 #include <uavcan/transport/transfer_buffer.hpp>
+#include <algorithm>
+#include <limits>
 
 using uavcan::Array;
 using uavcan::ArrayModeDynamic;
@@ -660,6 +662,255 @@ TEST(Array, StaticEncodeDecodeErrors)
 }
 
 
+/**
+ * Encodes the array after a prefix of PrefixBits ones, then decodes it back.
+ * Depending on the prefix length, the array elements are either byte aligned (bulk codec) or not (per element).
+ * Returns the encoded bits of the array alone, without spaces and without the prefix.
+ */
+template <unsigned PrefixBits, typename A>
+static std::string encodeDecodeWithPrefix(const A& array, A& out_array, const uavcan::TailArrayOptimizationMode tao_mode)
+{
+    uavcan::StaticTransferBuffer<(PrefixBits + A::MaxBitLen + 7) / 8> buf;
+    {
+        uavcan::BitStream bs_wr(buf);
+        uavcan::ScalarCodec sc_wr(bs_wr);
+        EXPECT_EQ(1, sc_wr.encode<PrefixBits>(uint8_t(0xFF)));
+        EXPECT_EQ(1, A::encode(array, sc_wr, tao_mode));
+    }
+    {
+        uavcan::BitStream bs_rd(buf);
+        uavcan::ScalarCodec sc_rd(bs_rd);
+        uint8_t prefix = 0;
+        EXPECT_EQ(1, sc_rd.decode<PrefixBits>(prefix));
+        EXPECT_EQ(1, A::decode(out_array, sc_rd, tao_mode));
+    }
+    uavcan::BitStream bs(buf);
+    std::string bits = bs.toString();
+    bits.erase(std::remove(bits.begin(), bits.end(), ' '), bits.end());
+    return bits.substr(PrefixBits);
+}
+
+template <typename A>
+static void checkBulkCodecEquivalence(const A& array, const uavcan::TailArrayOptimizationMode tao_mode)
+{
+    A aligned;
+    A unaligned;
+    const std::string aligned_bits = encodeDecodeWithPrefix<8>(array, aligned, tao_mode);
+    const std::string unaligned_bits = encodeDecodeWithPrefix<3>(array, unaligned, tao_mode);
+
+    // Encodings may differ only in the zero padding at the end
+    const std::size_t common_length = std::min(aligned_bits.length(), unaligned_bits.length());
+    ASSERT_EQ(aligned_bits.substr(0, common_length), unaligned_bits.substr(0, common_length));
+    ASSERT_EQ(std::string::npos, aligned_bits.find('1', common_length));
+    ASSERT_EQ(std::string::npos, unaligned_bits.find('1', common_length));
+
+    ASSERT_TRUE(aligned == unaligned);
+}
+
+
+TEST(Array, BulkCodec)
+{
+    typedef Array<IntegerSpec<16, SignednessSigned, CastModeSaturate>, ArrayModeStatic, 5> Int16Array;
+    typedef Array<IntegerSpec<24, SignednessSigned, CastModeTruncate>, ArrayModeDynamic, 255> Int24Array;
+    typedef Array<IntegerSpec<48, SignednessUnsigned, CastModeSaturate>, ArrayModeStatic, 3> Uint48Array;
+    typedef Array<IntegerSpec<64, SignednessSigned, CastModeSaturate>, ArrayModeDynamic, 40> Int64Array;
+    typedef Array<FloatSpec<16, CastModeSaturate>, ArrayModeStatic, 7> Float16Array;
+    typedef Array<FloatSpec<32, CastModeTruncate>, ArrayModeDynamic, 100> Float32Array;
+    typedef Array<FloatSpec<64, CastModeSaturate>, ArrayModeStatic, 2> Float64Array;
+
+    ASSERT_EQ(uavcan::ArrayCodecBytes, uavcan::ArrayCodecSelector<Int16Array::RawValueType>::Result);
+    ASSERT_EQ(uavcan::ArrayCodecBytes, uavcan::ArrayCodecSelector<Float16Array::RawValueType>::Result);
+    ASSERT_EQ(uavcan::ArrayCodecPerElement,
+              (uavcan::ArrayCodecSelector<IntegerSpec<12, SignednessSigned, CastModeSaturate> >::Result));
+    ASSERT_EQ(uavcan::ArrayCodecBits,
+              (uavcan::ArrayCodecSelector<IntegerSpec<1, SignednessUnsigned, CastModeSaturate> >::Result));
+
+    /*
+     * Byte order and saturation
+     */
+    Int16Array a16;
+    a16[0] = 1;
+    a16[1] = -2;
+    a16[2] = 0x1234;
+    a16[3] = -32768;
+    a16[4] = 32767;
+    //         1                 -2                0x1234            -32768            32767
+    ASSERT_EQ("0000000100000000" "1111111011111111" "0011010000010010" "0000000010000000" "1111111101111111",
+              encodeDecodeWithPrefix<8>(a16, a16, uavcan::TailArrayOptDisabled));
+    checkBulkCodecEquivalence(a16, uavcan::TailArrayOptDisabled);
+
+    /*
+     * Sign extension, truncation, both tail array optimization modes
+     */
+    Int24Array a24;
+    a24.push_back(-1);
+    a24.push_back(0x7FFFFF);
+    a24.push_back(-0x800000);
+    a24.push_back(0x12345678);     // Truncated
+    a24.push_back(-42);
+    Int24Array a24_decoded;
+    (void)encodeDecodeWithPrefix<8>(a24, a24_decoded, uavcan::TailArrayOptEnabled);
+    ASSERT_EQ(5, a24_decoded.size());
+    ASSERT_EQ(-1, a24_decoded[0]);
+    ASSERT_EQ(0x7FFFFF, a24_decoded[1]);
+    ASSERT_EQ(-0x800000, a24_decoded[2]);
+    ASSERT_EQ(0x345678, a24_decoded[3]);
+    ASSERT_EQ(-42, a24_decoded[4]);
+    checkBulkCodecEquivalence(a24, uavcan::TailArrayOptEnabled);
+    checkBulkCodecEquivalence(a24, uavcan::TailArrayOptDisabled);
+
+    Uint48Array a48;
+    a48[0] = 0xFFFFFFFFFFFFULL;
+    a48[1] = 0x1000000000000ULL;    // Saturated
+    a48[2] = 0x123456789ABCULL;
+    checkBulkCodecEquivalence(a48, uavcan::TailArrayOptDisabled);
+
+    Int64Array a64;
+    for (int i = 0; i < 40; i++)
+    {
+        a64.push_back(int64_t(0x0123456789ABCDEFLL) * (i - 20));
+    }
+    checkBulkCodecEquivalence(a64, uavcan::TailArrayOptEnabled);
+    checkBulkCodecEquivalence(a64, uavcan::TailArrayOptDisabled);
+
+    /*
+     * Floats, including special values
+     */
+    Float16Array f16;
+    f16[0] = 1.0F;
+    f16[1] = -0.0F;
+    f16[2] = 65504.0F;
+    f16[3] = 1e6F;                  // Saturated
+    f16[4] = 5.96e-8F;              // Subnormal
+    f16[5] = std::numeric_limits<float>::infinity();
+    f16[6] = -123.456F;
+    checkBulkCodecEquivalence(f16, uavcan::TailArrayOptDisabled);
+
+    Float32Array f32;
+    for (int i = 0; i < 100; i++)
+    {
+        f32.push_back(float(i) * 1.2345e-3F - 7.0F);
+    }
+    checkBulkCodecEquivalence(f32, uavcan::TailArrayOptEnabled);
+    checkBulkCodecEquivalence(f32, uavcan::TailArrayOptDisabled);
+
+    Float64Array f64;
+    f64[0] = 3.14159265358979;
+    f64[1] = -1e300;
+    checkBulkCodecEquivalence(f64, uavcan::TailArrayOptDisabled);
+}
+
+
+TEST(Array, BulkCodecTailArray)
+{
+    typedef Array<IntegerSpec<8, SignednessUnsigned, CastModeSaturate>, ArrayModeDynamic, 256> A;
+
+    // Full size, spanning multiple chunks
+    A a;
+    for (unsigned i = 0; i < 256; i++)
+    {
+        a.push_back(uint8_t(i * 7));
+    }
+    A a2;
+    (void)encodeDecodeWithPrefix<8>(a, a2, uavcan::TailArrayOptEnabled);
+    ASSERT_TRUE(a == a2);
+    checkBulkCodecEquivalence(a, uavcan::TailArrayOptEnabled);
+
+    // Too long
+    uavcan::StaticTransferBuffer<257> buf;
+    {
+        uavcan::BitStream bs_wr(buf);
+        uavcan::ScalarCodec sc_wr(bs_wr);
+        ASSERT_EQ(1, A::encode(a, sc_wr, uavcan::TailArrayOptEnabled));
+        ASSERT_EQ(1, sc_wr.encode<8>(uint8_t(42)));
+    }
+    {
+        uavcan::BitStream bs_rd(buf);
+        uavcan::ScalarCodec sc_rd(bs_rd);
+        ASSERT_GT(0, A::decode(a2, sc_rd, uavcan::TailArrayOptEnabled));
+        ASSERT_EQ(256, a2.size());
+    }
+
+    // Trailing incomplete element is ignored
+    typedef Array<IntegerSpec<16, SignednessUnsigned, CastModeSaturate>, ArrayModeDynamic, 10> B;
+    uavcan::StaticTransferBuffer<5> buf2;
+    {
+        uavcan::BitStream bs_wr(buf2);
+        uavcan::ScalarCodec sc_wr(bs_wr);
+        ASSERT_EQ(1, sc_wr.encode<8>(uint8_t(0x34)));
+        ASSERT_EQ(1, sc_wr.encode<8>(uint8_t(0x12)));
+        ASSERT_EQ(1, sc_wr.encode<8>(uint8_t(0x78)));
+        ASSERT_EQ(1, sc_wr.encode<8>(uint8_t(0x56)));
+        ASSERT_EQ(1, sc_wr.encode<8>(uint8_t(0x9A)));
+    }
+    {
+        uavcan::BitStream bs_rd(buf2);
+        uavcan::ScalarCodec sc_rd(bs_rd);
+        B b;
+        ASSERT_EQ(1, B::decode(b, sc_rd, uavcan::TailArrayOptEnabled));
+        ASSERT_EQ(2, b.size());
+        ASSERT_EQ(0x1234, b[0]);
+        ASSERT_EQ(0x5678, b[1]);
+        ASSERT_EQ(32, bs_rd.getBitOffset());    // The incomplete element is not consumed
+    }
+
+    // Same with the incomplete element in a chunk that follows the full ones
+    typedef Array<IntegerSpec<24, SignednessUnsigned, CastModeSaturate>, ArrayModeDynamic, 100> C;
+    C c;
+    for (unsigned i = 0; i < 50; i++)
+    {
+        c.push_back(i * 0x10101U);
+    }
+    uavcan::StaticTransferBuffer<152> buf3;
+    {
+        uavcan::BitStream bs_wr(buf3);
+        uavcan::ScalarCodec sc_wr(bs_wr);
+        ASSERT_EQ(1, C::encode(c, sc_wr, uavcan::TailArrayOptEnabled));
+        ASSERT_EQ(1, sc_wr.encode<16>(uint16_t(0xFFFF)));
+    }
+    {
+        uavcan::BitStream bs_rd(buf3);
+        uavcan::ScalarCodec sc_rd(bs_rd);
+        C c2;
+        ASSERT_EQ(1, C::decode(c2, sc_rd, uavcan::TailArrayOptEnabled));
+        ASSERT_TRUE(c == c2);
+        ASSERT_EQ(150 * 8, bs_rd.getBitOffset());
+    }
+}
+
+
+TEST(Array, BulkCodecBits)
+{
+    typedef Array<IntegerSpec<1, SignednessUnsigned, CastModeSaturate>, ArrayModeStatic, 300> A;
+    typedef Array<IntegerSpec<1, SignednessUnsigned, CastModeSaturate>, ArrayModeDynamic, 200> B;
+
+    A a;
+    std::string expected;
+    for (unsigned i = 0; i < 300; i++)
+    {
+        const bool x = ((i * 13) % 7) < 3;
+        a[uint16_t(i)] = x;
+        expected += x ? '1' : '0';
+    }
+
+    A a2;
+    ASSERT_EQ(expected + "0000", encodeDecodeWithPrefix<8>(a, a2, uavcan::TailArrayOptDisabled));
+    ASSERT_TRUE(a == a2);
+    checkBulkCodecEquivalence(a, uavcan::TailArrayOptDisabled);
+
+    B b;
+    for (unsigned i = 0; i < 150; i++)
+    {
+        b.push_back((i % 3) == 0);
+    }
+    B b2;
+    //                                                                            length 150
+    ASSERT_EQ("10010110", encodeDecodeWithPrefix<8>(b, b2, uavcan::TailArrayOptEnabled).substr(0, 8));
+    ASSERT_TRUE(b == b2);
+    checkBulkCodecEquivalence(b, uavcan::TailArrayOptDisabled);
+}
+
+
 TEST(Array, Copyability)
 {
     typedef Array<IntegerSpec<1, SignednessUnsigned, CastModeSaturate>, ArrayModeDynamic, 5>   OneBitArray;
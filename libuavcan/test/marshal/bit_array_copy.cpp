@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2015 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+#include <uavcan/marshal/bit_stream.hpp>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * Straightforward bit-by-bit copy that serves as a reference implementation.
+ */
+static void referenceBitarrayCopy(const unsigned char* src, std::size_t src_offset, std::size_t src_len,
+                                  unsigned char* dst, std::size_t dst_offset)
+{
+    for (std::size_t i = 0; i < src_len; i++)
+    {
+        const std::size_t s = src_offset + i;
+        const std::size_t d = dst_offset + i;
+        const bool bit = ((src[s / 8U] >> (7U - (s % 8U))) & 1U) != 0;
+        const unsigned char mask = static_cast<unsigned char>(1U << (7U - (d % 8U)));
+        if (bit)
+        {
+            dst[d / 8U] = static_cast<unsigned char>(dst[d / 8U] | mask);
+        }
+        else
+        {
+            dst[d / 8U] = static_cast<unsigned char>(dst[d / 8U] & ~mask);
+        }
+    }
+}
+
+TEST(BitArrayCopy, BitOrder)
+{
+    const unsigned char src[] = { 0xad, 0xbe };     // 10101101 10111110
+    unsigned char dst[] = { 0x00, 0x00, 0x00 };
+
+    uavcan::bitarrayCopy(src, 3, 10, dst, 5);       // 01101101 11
+    ASSERT_EQ(0x03, dst[0]);                        // 00000011
+    ASSERT_EQ(0x6E, dst[1]);                        // 01101110
+    ASSERT_EQ(0x00, dst[2]);
+}
+
+TEST(BitArrayCopy, Exhaustive)
+{
+    /*
+     * All offset combinations and all lengths up to several machine words, so that the head, word loop and
+     * tail of any implementation are exercised in every alignment. The destination is filled with garbage
+     * in order to make sure that the bits outside of the destination range are not modified.
+     */
+    static const std::size_t MaxBits = 300;
+    static const std::size_t BufSize = (MaxBits + 7) / 8 + 2;
+
+    std::srand(42);
+
+    std::vector<unsigned char> src(BufSize);
+    std::vector<unsigned char> dst_garbage(BufSize);
+    for (std::size_t i = 0; i < BufSize; i++)
+    {
+        src[i] = static_cast<unsigned char>(std::rand());
+        dst_garbage[i] = static_cast<unsigned char>(std::rand());
+    }
+
+    for (std::size_t src_offset = 0; src_offset < 8; src_offset++)
+    {
+        for (std::size_t dst_offset = 0; dst_offset < 8; dst_offset++)
+        {
+            for (std::size_t len = 1; len <= MaxBits; len++)
+            {
+                std::vector<unsigned char> expected(dst_garbage);
+                std::vector<unsigned char> actual(dst_garbage);
+
+                referenceBitarrayCopy(&src[0], src_offset, len, &expected[0], dst_offset);
+                uavcan::bitarrayCopy(&src[0], src_offset, len, &actual[0], dst_offset);
+
+                ASSERT_TRUE(expected == actual)
+                    << "src_offset=" << src_offset << " dst_offset=" << dst_offset << " len=" << len;
+            }
+        }
+    }
+}
@@ -192,3 +192,26 @@ TEST(BitStream, BitByBit)
     ASSERT_EQ(0, bs_wr.read(dummy_data_rd, 1));
     ASSERT_EQ(0xFF, dummy_data_rd[0]);
 }
+
+TEST(BitStream, Skip)
+{
+    uavcan::StaticTransferBuffer<4> buf;
+    const uint8_t data[] = { 0x12, 0x34, 0x56, 0x78 };
+    ASSERT_EQ(4, buf.write(0, data, 4));
+
+    uavcan::BitStream bs(buf);
+    ASSERT_EQ(1, bs.skip(0));
+    ASSERT_EQ(1, bs.skip(4));
+    ASSERT_EQ(4, bs.getBitOffset());
+
+    uint8_t byte = 0;
+    ASSERT_EQ(1, bs.read(&byte, 8));
+    ASSERT_EQ(0x23, byte);
+
+    ASSERT_EQ(1, bs.skip(12));
+    ASSERT_EQ(1, bs.read(&byte, 8));
+    ASSERT_EQ(0x78, byte);
+
+    ASSERT_EQ(0, bs.skip(1));           // Out of buffer, the position is retained
+    ASSERT_EQ(32, bs.getBitOffset());
+}
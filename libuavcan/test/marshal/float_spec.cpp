@@ -4,6 +4,11 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
 #include <uavcan/marshal/types.hpp>
 #include <uavcan/transport/transfer_buffer.hpp>
 
@@ -182,3 +187,190 @@ TEST(FloatSpec, Float16Representation)
 
     ASSERT_EQ(Reference, bs_wr.toString());
 }
+
+static uint32_t floatBits(float value)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float floatFromBits(uint32_t bits)
+{
+    float value = 0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+TEST(FloatSpec, Float16BatchConversionExhaustive)
+{
+    using uavcan::IEEE754Converter;
+
+    // Half to float: every possible half value, including NaNs with all payloads
+    std::vector<uint16_t> halves(65536);
+    for (unsigned i = 0; i < halves.size(); i++)
+    {
+        halves[i] = uint16_t(i);
+    }
+    std::vector<float> floats(halves.size());
+    IEEE754Converter::halfToNativeIeeeArray(&halves[0], &floats[0], unsigned(halves.size()));
+    for (unsigned i = 0; i < halves.size(); i++)
+    {
+        ASSERT_EQ(floatBits(IEEE754Converter::toNative<16>(halves[i])), floatBits(floats[i])) << i;
+    }
+
+    // Float to half: every float whose low mantissa bits are a few interesting patterns, which covers all
+    // exponents (denormals, overflow, Inf, NaN) and all rounding cases
+    static const uint32_t LowBits[] = { 0x0000, 0x0001, 0x0FFF, 0x1000, 0x1001, 0x1FFF };
+    static const unsigned NumLowBits = unsigned(sizeof(LowBits) / sizeof(LowBits[0]));
+    floats.resize(0x80000U * NumLowBits);
+    for (uint32_t high = 0; high < 0x80000U; high++)
+    {
+        for (unsigned k = 0; k < NumLowBits; k++)
+        {
+            floats[high * NumLowBits + k] = floatFromBits((high << 13) | LowBits[k]);
+        }
+    }
+    halves.resize(floats.size());
+    IEEE754Converter::nativeIeeeToHalfArray(&floats[0], &halves[0], unsigned(floats.size()));
+    for (unsigned i = 0; i < floats.size(); i++)
+    {
+        ASSERT_EQ(IEEE754Converter::toIeee<16>(floats[i]), halves[i]) << std::hex << floatBits(floats[i]);
+    }
+
+    // All lengths, to exercise the vector body as well as the tail
+    for (unsigned len = 0; len < 40; len++)
+    {
+        std::vector<uint16_t> out(len + 1, 0xABCD);
+        IEEE754Converter::nativeIeeeToHalfArray(&floats[1000], &out[0], len);
+        for (unsigned i = 0; i < len; i++)
+        {
+            ASSERT_EQ(IEEE754Converter::toIeee<16>(floats[1000 + i]), out[i]);
+        }
+        ASSERT_EQ(0xABCD, out[len]);
+    }
+}
+
+TEST(FloatSpec, Float16ArrayCodec)
+{
+    using uavcan::Array;
+    using uavcan::ArrayModeStatic;
+    using uavcan::FloatSpec;
+    using uavcan::CastModeSaturate;
+    using uavcan::CastModeTruncate;
+
+    typedef FloatSpec<16, CastModeSaturate> F16S;
+    typedef FloatSpec<16, CastModeTruncate> F16T;
+
+    static const float Values[] =
+    {
+        0.0F, -0.0F, 1.0F, -2.0F, 65504.0F, 65519.0F, 65520.0F, 999999.0F, -999999.0F, 6.0e-8F, 1.0e-9F,
+        std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::quiet_NaN(), 3.14159F, -123.456F, 0.1F
+    };
+    static const unsigned NumValues = unsigned(sizeof(Values) / sizeof(Values[0]));
+
+    typedef Array<F16S, ArrayModeStatic, NumValues> ArrayS;
+    typedef Array<F16T, ArrayModeStatic, NumValues> ArrayT;
+    ArrayS sat;
+    ArrayT trunc;
+    for (uint8_t i = 0; i < NumValues; i++)
+    {
+        sat[i] = Values[i];
+        trunc[i] = Values[i];
+    }
+
+    uavcan::StaticTransferBuffer<NumValues * 2 * 2> buf;
+    uavcan::BitStream bs_wr(buf);
+    uavcan::ScalarCodec sc_wr(bs_wr);
+    ASSERT_EQ(1, ArrayS::encode(sat, sc_wr, uavcan::TailArrayOptDisabled));
+    ASSERT_EQ(1, ArrayT::encode(trunc, sc_wr, uavcan::TailArrayOptDisabled));
+
+    // Element-by-element reference
+    uavcan::StaticTransferBuffer<NumValues * 2 * 2> ref_buf;
+    uavcan::BitStream ref_bs(ref_buf);
+    uavcan::ScalarCodec ref_sc(ref_bs);
+    for (unsigned i = 0; i < NumValues; i++)
+    {
+        ASSERT_EQ(1, F16S::encode(Values[i], ref_sc, uavcan::TailArrayOptDisabled));
+    }
+    for (unsigned i = 0; i < NumValues; i++)
+    {
+        ASSERT_EQ(1, F16T::encode(Values[i], ref_sc, uavcan::TailArrayOptDisabled));
+    }
+    ASSERT_EQ(ref_bs.toString(), bs_wr.toString());
+
+    uavcan::BitStream bs_rd(buf);
+    uavcan::ScalarCodec sc_rd(bs_rd);
+    ArrayS sat_decoded;
+    ASSERT_EQ(1, ArrayS::decode(sat_decoded, sc_rd, uavcan::TailArrayOptDisabled));
+
+    uavcan::BitStream ref_bs_rd(ref_buf);
+    uavcan::ScalarCodec ref_sc_rd(ref_bs_rd);
+    for (uint8_t i = 0; i < NumValues; i++)
+    {
+        float value = 0;
+        ASSERT_EQ(1, F16S::decode(value, ref_sc_rd, uavcan::TailArrayOptDisabled));
+        ASSERT_EQ(floatBits(value), floatBits(sat_decoded[i])) << i;
+    }
+}
+
+TEST(FloatSpec, Float16BatchConversionBenchmark)
+{
+    using uavcan::IEEE754Converter;
+
+    static const unsigned Size = 1024;
+    static const unsigned Iterations = 2000;
+
+    std::srand(42);
+    std::vector<float> floats(Size);
+    for (unsigned i = 0; i < Size; i++)
+    {
+        floats[i] = float(std::rand() - RAND_MAX / 2) / 1000.0F;
+    }
+    std::vector<uint16_t> halves(Size);
+    uint32_t checksum = 0;
+
+    std::clock_t started = std::clock();
+    for (unsigned it = 0; it < Iterations; it++)
+    {
+        for (unsigned i = 0; i < Size; i++)
+        {
+            halves[i] = IEEE754Converter::toIeee<16>(floats[i]);
+        }
+        checksum += halves[it % Size];
+    }
+    const double scalar_encode = double(std::clock() - started) / CLOCKS_PER_SEC;
+
+    started = std::clock();
+    for (unsigned it = 0; it < Iterations; it++)
+    {
+        IEEE754Converter::nativeIeeeToHalfArray(&floats[0], &halves[0], Size);
+        checksum += halves[it % Size];
+    }
+    const double batch_encode = double(std::clock() - started) / CLOCKS_PER_SEC;
+
+    started = std::clock();
+    for (unsigned it = 0; it < Iterations; it++)
+    {
+        for (unsigned i = 0; i < Size; i++)
+        {
+            floats[i] = IEEE754Converter::toNative<16>(halves[i]);
+        }
+        checksum += floatBits(floats[it % Size]);
+    }
+    const double scalar_decode = double(std::clock() - started) / CLOCKS_PER_SEC;
+
+    started = std::clock();
+    for (unsigned it = 0; it < Iterations; it++)
+    {
+        IEEE754Converter::halfToNativeIeeeArray(&halves[0], &floats[0], Size);
+        checksum += floatBits(floats[it % Size]);
+    }
+    const double batch_decode = double(std::clock() - started) / CLOCKS_PER_SEC;
+
+    std::cout << "float16 conversion of " << (Size * Iterations) << " values, seconds:\n"
+              << "  encode: scalar " << scalar_encode << ", batch " << batch_encode << "\n"
+              << "  decode: scalar " << scalar_decode << ", batch " << batch_decode << "\n"
+              << "  (checksum " << checksum << ")" << std::endl;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+#include <uavcan/node/caching_publisher.hpp>
+#include <uavcan/node/publisher.hpp>
+#include <root_ns_a/MavlinkMessage.hpp>
+#include <root_ns_a/FixedLayout.hpp>
+#include "../clock.hpp"
+#include "../transport/can/can.hpp"
+#include "test_node.hpp"
+
+
+TEST(CachingPublisher, Basic)
+{
+    SystemClockMock clock_mock(100);
+
+    // The reference is produced by the regular publisher on the other node that has the same Node ID
+    CanDriverMock can_driver(1, clock_mock);
+    CanDriverMock ref_can_driver(1, clock_mock);
+    TestNode node(can_driver, clock_mock, 1);
+    TestNode ref_node(ref_can_driver, clock_mock, 1);
+
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _registrator;
+
+    uavcan::CachingPublisher<root_ns_a::MavlinkMessage> publisher(node);
+    uavcan::Publisher<root_ns_a::MavlinkMessage> ref_publisher(ref_node);
+
+    std::cout <<
+        "sizeof(uavcan::CachingPublisher<root_ns_a::MavlinkMessage>): " <<
+        sizeof(uavcan::CachingPublisher<root_ns_a::MavlinkMessage>) << std::endl;
+
+    root_ns_a::MavlinkMessage short_msg;
+    short_msg.seq = 0x42;
+    short_msg.payload = "Msg";
+
+    root_ns_a::MavlinkMessage long_msg;
+    long_msg.seq = 0x43;
+    for (unsigned i = 0; i < 100; i++)
+    {
+        long_msg.payload.push_back(uint8_t(i));
+    }
+
+    const root_ns_a::MavlinkMessage sequence[] = { long_msg, long_msg, short_msg, short_msg, long_msg, long_msg };
+
+    for (unsigned i = 0; i < sizeof(sequence) / sizeof(sequence[0]); i++)
+    {
+        ASSERT_LT(0, publisher.broadcast(sequence[i]));
+        ASSERT_LT(0, ref_publisher.broadcast(sequence[i]));
+    }
+    ASSERT_EQ(3, publisher.getCacheHitCount());
+
+    // Explicit Transfer ID
+    ASSERT_LT(0, publisher.broadcast(long_msg, 7));
+    ASSERT_LT(0, ref_publisher.broadcast(long_msg, 7));
+    ASSERT_EQ(4, publisher.getCacheHitCount());
+
+    publisher.invalidateCache();
+    ASSERT_LT(0, publisher.broadcast(long_msg));
+    ASSERT_LT(0, ref_publisher.broadcast(long_msg));
+    ASSERT_EQ(4, publisher.getCacheHitCount());
+
+    /*
+     * The frames must be exactly the same
+     */
+    std::queue<CanIfaceMock::FrameWithTime>& tx = can_driver.ifaces[0].tx;
+    std::queue<CanIfaceMock::FrameWithTime>& ref_tx = ref_can_driver.ifaces[0].tx;
+    ASSERT_LT(20, ref_tx.size());
+    ASSERT_EQ(ref_tx.size(), tx.size());
+    while (!ref_tx.empty())
+    {
+        ASSERT_TRUE(ref_tx.front().frame == tx.front().frame);
+        ASSERT_EQ(ref_tx.front().time, tx.front().time);
+        ref_tx.pop();
+        tx.pop();
+    }
+}
+
+
+TEST(CachingPublisher, SignOfZero)
+{
+    SystemClockMock clock_mock(100);
+
+    CanDriverMock can_driver(1, clock_mock);
+    CanDriverMock ref_can_driver(1, clock_mock);
+    TestNode node(can_driver, clock_mock, 1);
+    TestNode ref_node(ref_can_driver, clock_mock, 1);
+
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    ASSERT_EQ(uavcan::GlobalDataTypeRegistry::RegistrationResultOk,
+              uavcan::GlobalDataTypeRegistry::instance().registerDataType<root_ns_a::FixedLayout>(1234));
+
+    uavcan::CachingPublisher<root_ns_a::FixedLayout> publisher(node);
+    uavcan::Publisher<root_ns_a::FixedLayout> ref_publisher(ref_node);
+
+    /*
+     * The messages compare equal, but are encoded differently, so neither of them may be published from the cache
+     */
+    root_ns_a::FixedLayout positive_zero;
+    positive_zero.g = 0.0F;
+    root_ns_a::FixedLayout negative_zero;
+    negative_zero.g = -0.0F;
+
+    const root_ns_a::FixedLayout sequence[] = { positive_zero, negative_zero, negative_zero, positive_zero };
+
+    for (unsigned i = 0; i < sizeof(sequence) / sizeof(sequence[0]); i++)
+    {
+        ASSERT_LT(0, publisher.broadcast(sequence[i]));
+        ASSERT_LT(0, ref_publisher.broadcast(sequence[i]));
+    }
+    ASSERT_EQ(1, publisher.getCacheHitCount());
+
+    std::queue<CanIfaceMock::FrameWithTime>& tx = can_driver.ifaces[0].tx;
+    std::queue<CanIfaceMock::FrameWithTime>& ref_tx = ref_can_driver.ifaces[0].tx;
+    ASSERT_LT(4, ref_tx.size());
+    ASSERT_EQ(ref_tx.size(), tx.size());
+    while (!ref_tx.empty())
+    {
+        ASSERT_TRUE(ref_tx.front().frame == tx.front().frame);
+        ref_tx.pop();
+        tx.pop();
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+#include <uavcan/node/conflating_publisher.hpp>
+#include <root_ns_a/MavlinkMessage.hpp>
+#include "../clock.hpp"
+#include "../transport/can/can.hpp"
+#include "test_node.hpp"
+
+
+static uint8_t getSeqFromFrame(const uavcan::CanFrame& can_frame)
+{
+    uavcan::Frame frame;
+    EXPECT_TRUE(frame.parse(can_frame));
+    EXPECT_TRUE(frame.isStartOfTransfer() && frame.isEndOfTransfer());
+    return frame.getPayloadPtr()[0];
+}
+
+
+TEST(ConflatingPublisher, Pacing)
+{
+    SystemClockMock clock_mock(100);
+    CanDriverMock can_driver(1, clock_mock);
+    TestNode node(can_driver, clock_mock, 1);
+
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _registrator;
+
+    uavcan::ConflatingPublisher<root_ns_a::MavlinkMessage> publisher(node, uavcan::MonotonicDuration::fromMSec(10));
+
+    std::cout <<
+        "sizeof(uavcan::ConflatingPublisher<root_ns_a::MavlinkMessage>): " <<
+        sizeof(uavcan::ConflatingPublisher<root_ns_a::MavlinkMessage>) << std::endl;
+
+    std::queue<CanIfaceMock::FrameWithTime>& tx = can_driver.ifaces[0].tx;
+
+    // The first message is published immediately
+    ASSERT_LT(0, publisher.broadcast(makeMavlinkTestMessage(1, 3)));
+    ASSERT_EQ(1, tx.size());
+    ASSERT_EQ(1, getSeqFromFrame(tx.front().frame));
+    ASSERT_EQ(0, tx.front().flags);                         // The library-level flag never reaches the driver
+    tx.pop();
+
+    // The next ones are held back, only the latest is kept
+    ASSERT_EQ(0, publisher.broadcast(makeMavlinkTestMessage(2, 3)));
+    ASSERT_EQ(0, publisher.broadcast(makeMavlinkTestMessage(3, 3)));
+    ASSERT_EQ(0, publisher.broadcast(makeMavlinkTestMessage(4, 3)));
+    ASSERT_TRUE(tx.empty());
+    ASSERT_TRUE(publisher.hasPendingMessage());
+    ASSERT_EQ(2, publisher.getConflatedSampleCount());
+
+    clock_mock.advance(5000);
+    ASSERT_LE(0, node.spinOnce());
+    ASSERT_TRUE(tx.empty());
+
+    clock_mock.advance(5000);
+    ASSERT_LE(0, node.spinOnce());
+    ASSERT_EQ(1, tx.size());
+    ASSERT_EQ(4, getSeqFromFrame(tx.front().frame));
+    ASSERT_FALSE(publisher.hasPendingMessage());
+    tx.pop();
+
+    // The interval has elapsed, so the message is published immediately
+    clock_mock.advance(10000);
+    ASSERT_LT(0, publisher.broadcast(makeMavlinkTestMessage(5, 3)));
+    ASSERT_EQ(1, tx.size());
+    tx.pop();
+
+    // A failed publication doesn't hold back the next one
+    clock_mock.advance(10000);
+    can_driver.select_failure = true;
+    ASSERT_GT(0, publisher.broadcast(makeMavlinkTestMessage(6, 3)));
+    can_driver.select_failure = false;
+    ASSERT_LT(0, publisher.broadcast(makeMavlinkTestMessage(7, 3)));
+    ASSERT_EQ(1, tx.size());
+    ASSERT_EQ(7, getSeqFromFrame(tx.front().frame));
+    tx.pop();
+
+    ASSERT_EQ(2, publisher.getConflatedSampleCount());
+    ASSERT_EQ(0, publisher.getFailureCount());
+
+    /*
+     * Bus load share
+     */
+    ASSERT_EQ(-uavcan::ErrInvalidParam, publisher.setMaxBusLoadShare(0, 0.5F));
+    ASSERT_EQ(-uavcan::ErrInvalidParam, publisher.setMaxBusLoadShare(1000000, 0.0F));
+    ASSERT_EQ(-uavcan::ErrInvalidParam, publisher.setMaxBusLoadShare(1000000, 1.5F));
+
+    ASSERT_EQ(0, publisher.setMaxBusLoadShare(1000000, 1.0F));
+    const int64_t full_bus_interval = publisher.getMinInterval().toUSec();
+    ASSERT_LT(0, full_bus_interval);
+    ASSERT_EQ(0, full_bus_interval % uavcan::ConflatingPublisher<root_ns_a::MavlinkMessage>::WorstCaseFrameBitLen);
+
+    ASSERT_EQ(0, publisher.setMaxBusLoadShare(1000000, 0.25F));
+    ASSERT_NEAR(double(full_bus_interval * 4), double(publisher.getMinInterval().toUSec()), 1.0);
+}
+
+
+TEST(ConflatingPublisher, TxQueueReplacement)
+{
+    SystemClockMock clock_mock(100);
+    CanDriverMock can_driver(1, clock_mock);
+    TestNode node(can_driver, clock_mock, 1);
+
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _registrator;
+
+    // No pacing, only the TX queue replacement
+    uavcan::ConflatingPublisher<root_ns_a::MavlinkMessage> publisher(node);
+
+    can_driver.ifaces[0].writeable = false;
+
+    for (uint8_t i = 1; i <= 10; i++)
+    {
+        ASSERT_LE(0, publisher.broadcast(makeMavlinkTestMessage(i, 3)));
+    }
+    ASSERT_EQ(0, publisher.getConflatedSampleCount());
+
+    std::queue<CanIfaceMock::FrameWithTime>& tx = can_driver.ifaces[0].tx;
+    ASSERT_TRUE(tx.empty());
+
+    // Only the latest message is left in the TX queue
+    can_driver.ifaces[0].writeable = true;
+    ASSERT_LE(0, node.spinOnce());
+    ASSERT_EQ(1, tx.size());
+    ASSERT_EQ(10, getSeqFromFrame(tx.front().frame));
+    ASSERT_EQ(0, tx.front().flags);
+}
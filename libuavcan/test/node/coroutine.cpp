@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+#include <uavcan/node/coroutine.hpp>
+
+#if UAVCAN_COROUTINES
+
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ < 13)
+# pragma GCC diagnostic ignored "-Wmismatched-new-delete"    // False positive on coroutine frames
+#endif
+
+#include <uavcan/node/service_server.hpp>
+#include <uavcan/node/publisher.hpp>
+#include <root_ns_a/StringService.hpp>
+#include <root_ns_a/EmptyService.hpp>
+#include <root_ns_a/MavlinkMessage.hpp>
+#include <string>
+#include <vector>
+#include "test_node.hpp"
+
+
+static uavcan::CoroutineTask sleepingCoroutine(uavcan::IPoolAllocator&, uavcan::INode& node, unsigned& counter)
+{
+    for (unsigned i = 0; i < 3; i++)
+    {
+        co_await uavcan::sleep(node, uavcan::MonotonicDuration::fromMSec(10));
+        counter++;
+    }
+}
+
+TEST(Coroutine, Sleep)
+{
+    InterlinkedTestNodesWithSysClock nodes;
+    uavcan::HeapBasedPoolAllocator<256> frame_allocator(2000);
+
+    static const unsigned NumCoroutines = 1000;
+    unsigned counter = 0;
+    for (unsigned i = 0; i < NumCoroutines; i++)
+    {
+        ASSERT_TRUE(sleepingCoroutine(frame_allocator, nodes.a, counter).isValid());
+    }
+    ASSERT_EQ(0, counter);
+    ASSERT_EQ(NumCoroutines, frame_allocator.getNumAllocatedBlocks());
+
+    ASSERT_LE(0, nodes.a.spin(uavcan::MonotonicDuration::fromMSec(100)));
+    ASSERT_EQ(NumCoroutines * 3, counter);
+    ASSERT_EQ(0, frame_allocator.getNumAllocatedBlocks());
+
+    /*
+     * The frame doesn't fit the block
+     */
+    uavcan::HeapBasedPoolAllocator<16> small_frame_allocator(10);
+    ASSERT_FALSE(sleepingCoroutine(small_frame_allocator, nodes.a, counter).isValid());
+    ASSERT_EQ(0, small_frame_allocator.getNumAllocatedBlocks());
+}
+
+
+static void coroutineStringServerCallback(const uavcan::ReceivedDataStructure<root_ns_a::StringService::Request>& req,
+                                          uavcan::ServiceResponseDataStructure<root_ns_a::StringService::Response>& rsp)
+{
+    rsp.string_response = req.string_request;
+    rsp.string_response += "!";
+}
+
+static uavcan::CoroutineTask chainingCoroutine(uavcan::IPoolAllocator&,
+                                               uavcan::CoroutineServiceClient<root_ns_a::StringService>& client,
+                                               uavcan::NodeID server_node_id,
+                                               std::vector<std::string>& out_log)
+{
+    root_ns_a::StringService::Request request;
+    request.string_request = "a";
+
+    // Each next request is made of the previous response
+    for (unsigned i = 0; i < 3; i++)
+    {
+        const auto result = co_await client.call(server_node_id, request);
+        if (!result.isSuccessful())
+        {
+            out_log.push_back("failure");
+            co_return;
+        }
+        out_log.push_back(result.response.string_response.c_str());
+        request.string_request = result.response.string_response;
+    }
+
+    const auto result = co_await client.call(123, request);     // No such node
+    out_log.push_back(result.isSuccessful() ? "unexpected" : "timeout");
+
+    const auto invalid = co_await client.call(uavcan::NodeID::Broadcast, request);
+    out_log.push_back((invalid.error < 0) ? "invalid" : "unexpected");
+}
+
+TEST(Coroutine, ServiceCalls)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::StringService> _registrator;
+
+    InterlinkedTestNodesWithSysClock nodes;
+    uavcan::HeapBasedPoolAllocator<1024> frame_allocator(100);
+
+    uavcan::ServiceServer<root_ns_a::StringService> server(nodes.a);
+    ASSERT_LE(0, server.start(coroutineStringServerCallback));
+
+    uavcan::CoroutineServiceClient<root_ns_a::StringService> client(nodes.b);
+    client.setRequestTimeout(uavcan::MonotonicDuration::fromMSec(50));
+
+    std::vector<std::string> logs[2];
+    ASSERT_TRUE(chainingCoroutine(frame_allocator, client, nodes.a.getNodeID(), logs[0]).isValid());
+    ASSERT_TRUE(chainingCoroutine(frame_allocator, client, nodes.a.getNodeID(), logs[1]).isValid());
+    ASSERT_EQ(2, client.getNumPendingCalls());
+
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(200)));
+
+    for (unsigned i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(5, logs[i].size());
+        ASSERT_EQ("a!", logs[i][0]);
+        ASSERT_EQ("a!!", logs[i][1]);
+        ASSERT_EQ("a!!!", logs[i][2]);
+        ASSERT_EQ("timeout", logs[i][3]);
+        ASSERT_EQ("invalid", logs[i][4]);
+    }
+    ASSERT_EQ(0, client.getNumPendingCalls());
+    ASSERT_EQ(0, frame_allocator.getNumAllocatedBlocks());
+}
+
+
+static uavcan::CoroutineTask receivingCoroutine(uavcan::IPoolAllocator&,
+                                                uavcan::CoroutineSubscriber<root_ns_a::MavlinkMessage>& subscriber,
+                                                unsigned num_messages,
+                                                std::vector<uint8_t>& out_seqs)
+{
+    while (num_messages --> 0)
+    {
+        const root_ns_a::MavlinkMessage msg = co_await subscriber.next();
+        out_seqs.push_back(msg.seq);
+    }
+}
+
+TEST(Coroutine, Subscriber)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _registrator;
+
+    InterlinkedTestNodesWithSysClock nodes;
+    uavcan::HeapBasedPoolAllocator<512> frame_allocator(100);
+
+    uavcan::Publisher<root_ns_a::MavlinkMessage> publisher(nodes.a);
+    uavcan::CoroutineSubscriber<root_ns_a::MavlinkMessage> subscriber(nodes.b);
+    ASSERT_LE(0, subscriber.start());
+
+    root_ns_a::MavlinkMessage msg;
+    msg.seq = 1;
+    ASSERT_LE(0, publisher.broadcast(msg));
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_EQ(1, subscriber.getNumUnawaitedMessages());
+
+    // Both coroutines get the same messages
+    std::vector<uint8_t> seqs_a;
+    std::vector<uint8_t> seqs_b;
+    ASSERT_TRUE(receivingCoroutine(frame_allocator, subscriber, 2, seqs_a).isValid());
+    ASSERT_TRUE(receivingCoroutine(frame_allocator, subscriber, 3, seqs_b).isValid());
+
+    for (uint8_t seq = 2; seq < 5; seq++)
+    {
+        msg.seq = seq;
+        ASSERT_LE(0, publisher.broadcast(msg));
+        ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(10)));
+    }
+
+    ASSERT_EQ(2, seqs_a.size());
+    ASSERT_EQ(2, seqs_a[0]);
+    ASSERT_EQ(3, seqs_a[1]);
+    ASSERT_EQ(3, seqs_b.size());
+    ASSERT_EQ(4, seqs_b[2]);
+    ASSERT_EQ(1, subscriber.getNumUnawaitedMessages());
+    ASSERT_EQ(0, frame_allocator.getNumAllocatedBlocks());
+}
+
+#endif
@@ -4,6 +4,13 @@
 
 #include <gtest/gtest.h>
 #include <uavcan/node/global_data_type_registry.hpp>
+#include <uavcan/protocol/GetNodeInfo.hpp>
+#include <uavcan/protocol/NodeStatus.hpp>
+#include <root_ns_a/StringService.hpp>
+#include <uavcan_data_type_table.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
 
 namespace
 {
@@ -48,6 +55,37 @@ struct DataTypeD
     static const char* getDataTypeFullName() { return "foo.DataTypeD"; }
 };
 
+template <unsigned Index>
+struct NumberedDataType
+{
+    enum { DataTypeKind = (Index % 4 == 0) ? uavcan::DataTypeKindService : uavcan::DataTypeKindMessage };
+    static uavcan::DataTypeSignature getDataTypeSignature() { return uavcan::DataTypeSignature(Index); }
+    static const char* getDataTypeFullName()
+    {
+        static char name[32];
+        (void)std::snprintf(name, sizeof(name), "numbered.namespace.Type%u", Index);
+        return name;
+    }
+    static uint16_t getID() { return uint16_t((Index % 4 == 0) ? Index : (Index * 7U)); }
+};
+
+template <unsigned Index>
+struct NumberedDataTypeRegistrator
+{
+    static bool registerAll()
+    {
+        return NumberedDataTypeRegistrator<Index - 1>::registerAll() &&
+               (uavcan::GlobalDataTypeRegistry::instance().registerDataType<NumberedDataType<Index> >(
+                    NumberedDataType<Index>::getID()) == uavcan::GlobalDataTypeRegistry::RegistrationResultOk);
+    }
+};
+
+template <>
+struct NumberedDataTypeRegistrator<0>
+{
+    static bool registerAll() { return true; }
+};
+
 template <typename Type>
 uavcan::DataTypeDescriptor extractDescriptor(uint16_t dtid = Type::DefaultDataTypeID)
 {
@@ -166,3 +204,200 @@ TEST(GlobalDataTypeRegistry, Reset)
     GlobalDataTypeRegistry::instance().reset();
     ASSERT_FALSE(GlobalDataTypeRegistry::instance().isFrozen());
 }
+
+
+TEST(GlobalDataTypeRegistry, ManyTypes)
+{
+    using uavcan::GlobalDataTypeRegistry;
+
+    static const unsigned NumTypes = 200;
+
+    GlobalDataTypeRegistry::instance().reset();
+    ASSERT_TRUE(NumberedDataTypeRegistrator<NumTypes>::registerAll());
+    ASSERT_EQ(NumTypes / 4, GlobalDataTypeRegistry::instance().getNumServiceTypes());
+    ASSERT_EQ(NumTypes - NumTypes / 4, GlobalDataTypeRegistry::instance().getNumMessageTypes());
+
+    // Linear search before freezing, indexed lookup afterwards; both must give the same results
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass > 0)
+        {
+            GlobalDataTypeRegistry::instance().freeze();
+        }
+
+        const std::chrono::steady_clock::time_point started_at = std::chrono::steady_clock::now();
+
+        for (unsigned i = 1; i <= NumTypes; i++)
+        {
+            char name[32];
+            (void)std::snprintf(name, sizeof(name), "numbered.namespace.Type%u", i);
+            const uavcan::DataTypeKind kind = (i % 4 == 0) ? uavcan::DataTypeKindService : uavcan::DataTypeKindMessage;
+            const uavcan::DataTypeKind other_kind =
+                (kind == uavcan::DataTypeKindService) ? uavcan::DataTypeKindMessage : uavcan::DataTypeKindService;
+
+            const uint16_t id = uint16_t((kind == uavcan::DataTypeKindService) ? i : (i * 7));
+
+            const uavcan::DataTypeDescriptor* const by_name = GlobalDataTypeRegistry::instance().find(kind, name);
+            ASSERT_TRUE(by_name);
+            ASSERT_EQ(id, by_name->getID().get());
+            ASSERT_EQ(uavcan::DataTypeSignature(i), by_name->getSignature());
+            ASSERT_EQ(by_name, GlobalDataTypeRegistry::instance().find(name));
+            ASSERT_EQ(by_name, GlobalDataTypeRegistry::instance().find(kind, uavcan::DataTypeID(id)));
+            ASSERT_FALSE(GlobalDataTypeRegistry::instance().find(other_kind, name));
+        }
+        ASSERT_FALSE(GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage, uavcan::DataTypeID(1)));
+        ASSERT_FALSE(GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage, uavcan::DataTypeID(4 * 7)));
+        ASSERT_FALSE(GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindService, uavcan::DataTypeID(7)));
+        ASSERT_FALSE(GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindService, uavcan::DataTypeID(201)));
+        ASSERT_FALSE(GlobalDataTypeRegistry::instance().find("numbered.namespace.Type0"));
+        ASSERT_FALSE(GlobalDataTypeRegistry::instance().find("numbered.namespace.Type"));
+
+        std::cout << "Lookups of " << NumTypes << " types, " << (pass ? "frozen" : "not frozen") << ": "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - started_at).count()
+                  << " usec" << std::endl;
+    }
+
+    GlobalDataTypeRegistry::instance().reset();
+    ASSERT_FALSE(GlobalDataTypeRegistry::instance().find("numbered.namespace.Type1"));
+}
+
+
+TEST(GlobalDataTypeRegistry, AdoptTable)
+{
+    using uavcan::GlobalDataTypeRegistry;
+    using uavcan::DataTypeDescriptor;
+
+    GlobalDataTypeRegistry::instance().reset();
+
+    /*
+     * Individually registered types must not collide with the table
+     */
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultOk,
+              GlobalDataTypeRegistry::instance().registerDataType<root_ns_a::StringService>(
+                  root_ns_a::StringService::DefaultDataTypeID));
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultCollision, uavcan_data_type_table::adoptTable());
+    ASSERT_EQ(0, GlobalDataTypeRegistry::instance().getNumMessageTypes());
+    ASSERT_EQ(1, GlobalDataTypeRegistry::instance().getNumServiceTypes());
+
+    GlobalDataTypeRegistry::instance().reset();
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultOk, uavcan_data_type_table::adoptTable());
+    ASSERT_EQ(uavcan_data_type_table::TableSize,
+              GlobalDataTypeRegistry::instance().getNumMessageTypes() +
+              GlobalDataTypeRegistry::instance().getNumServiceTypes());
+
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultCollision,
+              GlobalDataTypeRegistry::instance().registerDataType<root_ns_a::StringService>(
+                  root_ns_a::StringService::DefaultDataTypeID));
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultOk,
+              GlobalDataTypeRegistry::instance().registerDataType<DataTypeC>(DataTypeC::DefaultDataTypeID));
+
+    /*
+     * The signatures computed by the DSDL compiler must match the ones computed at run time
+     */
+    const DataTypeDescriptor* pdtd = GlobalDataTypeRegistry::instance().find("root_ns_a.StringService");
+    ASSERT_TRUE(pdtd);
+    ASSERT_EQ(root_ns_a::StringService::getDataTypeSignature(), pdtd->getSignature());
+    ASSERT_EQ(root_ns_a::StringService::DefaultDataTypeID, pdtd->getID().get());
+
+    pdtd = GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindService, "uavcan.protocol.GetNodeInfo");
+    ASSERT_TRUE(pdtd);
+    ASSERT_EQ(uavcan::protocol::GetNodeInfo::getDataTypeSignature(), pdtd->getSignature());     // Nested types
+
+    pdtd = GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage, "uavcan.protocol.NodeStatus");
+    ASSERT_TRUE(pdtd);
+    ASSERT_EQ(uavcan::protocol::NodeStatus::getDataTypeSignature(), pdtd->getSignature());
+
+    /*
+     * Every entry can be found by name and by ID, both before and after freezing
+     */
+    const DataTypeDescriptor* const table = uavcan_data_type_table::getTable();
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass > 0)
+        {
+            GlobalDataTypeRegistry::instance().freeze();
+        }
+        for (unsigned i = 0; i < uavcan_data_type_table::TableSize; i++)
+        {
+            ASSERT_EQ(&table[i], GlobalDataTypeRegistry::instance().find(table[i].getKind(), table[i].getFullName()));
+            ASSERT_EQ(&table[i], GlobalDataTypeRegistry::instance().find(table[i].getKind(), table[i].getID()));
+        }
+        ASSERT_TRUE(GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage, "foo.DataTypeC"));
+        ASSERT_FALSE(GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage, "root_ns_a.StringService"));
+        ASSERT_FALSE(GlobalDataTypeRegistry::instance().find("uavcan.protocol.NodeStatu"));
+        ASSERT_FALSE(GlobalDataTypeRegistry::instance().find("zzz"));
+    }
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultFrozen, uavcan_data_type_table::adoptTable());
+
+    /*
+     * Malformed tables are rejected
+     */
+    GlobalDataTypeRegistry::instance().reset();
+
+    static const uavcan::uint16_t identity[] = { 0, 1 };
+
+    static UAVCAN_CONSTEXPR const DataTypeDescriptor unordered[] =
+    {
+        DataTypeDescriptor(uavcan::DataTypeKindMessage, 10U, 1ULL, "b.Type"),
+        DataTypeDescriptor(uavcan::DataTypeKindMessage, 11U, 2ULL, "a.Type")
+    };
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultInvalidParams,
+              GlobalDataTypeRegistry::instance().adoptTable(unordered, identity, 2));
+
+    static UAVCAN_CONSTEXPR const DataTypeDescriptor services_first[] =
+    {
+        DataTypeDescriptor(uavcan::DataTypeKindService, 10U, 1ULL, "a.Type"),
+        DataTypeDescriptor(uavcan::DataTypeKindMessage, 10U, 2ULL, "b.Type")
+    };
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultInvalidParams,
+              GlobalDataTypeRegistry::instance().adoptTable(services_first, identity, 2));
+
+    static UAVCAN_CONSTEXPR const DataTypeDescriptor bad_service_id[] =
+    {
+        DataTypeDescriptor(uavcan::DataTypeKindService, 1000U, 1ULL, "a.Type")
+    };
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultInvalidParams,
+              GlobalDataTypeRegistry::instance().adoptTable(bad_service_id, identity, 1));
+
+    static UAVCAN_CONSTEXPR const DataTypeDescriptor id_collision[] =
+    {
+        DataTypeDescriptor(uavcan::DataTypeKindMessage, 10U, 1ULL, "a.Type"),
+        DataTypeDescriptor(uavcan::DataTypeKindMessage, 10U, 2ULL, "b.Type")
+    };
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultCollision,
+              GlobalDataTypeRegistry::instance().adoptTable(id_collision, identity, 2));
+
+    /*
+     * Malformed ID order arrays are rejected as well
+     */
+    static UAVCAN_CONSTEXPR const DataTypeDescriptor descending_ids[] =
+    {
+        DataTypeDescriptor(uavcan::DataTypeKindMessage, 11U, 1ULL, "a.Type"),
+        DataTypeDescriptor(uavcan::DataTypeKindMessage, 10U, 2ULL, "b.Type")
+    };
+    static const uavcan::uint16_t reversed[] = { 1, 0 };
+    static const uavcan::uint16_t repeated[] = { 1, 1 };
+    static const uavcan::uint16_t out_of_range[] = { 1, 2 };
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultInvalidParams,
+              GlobalDataTypeRegistry::instance().adoptTable(descending_ids, identity, 2));
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultInvalidParams,
+              GlobalDataTypeRegistry::instance().adoptTable(descending_ids, repeated, 2));
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultInvalidParams,
+              GlobalDataTypeRegistry::instance().adoptTable(descending_ids, out_of_range, 2));
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultInvalidParams,
+              GlobalDataTypeRegistry::instance().adoptTable(descending_ids, UAVCAN_NULLPTR, 2));
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultOk,
+              GlobalDataTypeRegistry::instance().adoptTable(descending_ids, reversed, 2));
+    ASSERT_EQ(&descending_ids[1], GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage, 10U));
+    ASSERT_EQ(&descending_ids[0], GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage, 11U));
+    ASSERT_FALSE(GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage, 12U));
+
+    ASSERT_EQ(GlobalDataTypeRegistry::RegistrationResultOk,
+              GlobalDataTypeRegistry::instance().adoptTable(unordered + 1, identity, 1));
+    ASSERT_EQ(1, GlobalDataTypeRegistry::instance().getNumMessageTypes());
+    ASSERT_EQ(0, GlobalDataTypeRegistry::instance().getNumServiceTypes());
+
+    GlobalDataTypeRegistry::instance().reset();
+    ASSERT_EQ(0, GlobalDataTypeRegistry::instance().getNumMessageTypes());
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+#include <uavcan/node/multi_node_host.hpp>
+#include <uavcan/node/publisher.hpp>
+#include <uavcan/node/service_server.hpp>
+#include <uavcan/node/service_client.hpp>
+#include <root_ns_a/StringService.hpp>
+#include <root_ns_a/MavlinkMessage.hpp>
+#include "test_node.hpp"
+#include "../clock.hpp"
+#include "../protocol/helpers.hpp"
+
+
+static void hostedStringServerCallback(const uavcan::ReceivedDataStructure<root_ns_a::StringService::Request>& req,
+                                       uavcan::ServiceResponseDataStructure<root_ns_a::StringService::Response>& rsp)
+{
+    rsp.string_response = req.string_request;
+    rsp.string_response += "!";
+}
+
+static void forwardTxToRx(CanDriverMock& from, CanDriverMock& to)
+{
+    for (uint8_t i = 0; i < from.getNumIfaces(); i++)
+    {
+        while (!from.ifaces.at(i).tx.empty())
+        {
+            to.ifaces.at(i).pushRx(from.ifaces.at(i).popTxFrame());
+        }
+    }
+}
+
+TEST(MultiNodeHost, Routing)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::StringService> _reg1;
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _reg2;
+
+    SystemClockMock clock(100);
+    CanDriverMock driver(2, clock);
+    uavcan::HeapBasedPoolAllocator<uavcan::MemPoolBlockSize> pool(1024);
+    uavcan::MultiNodeHost host(driver, clock, pool);
+
+    uavcan::MultiNodeHostPort port1(host);
+    uavcan::MultiNodeHostPort port2(host);
+    uavcan::MultiNodeHostPort port3(host);
+    TestNode node1(port1, clock, 1);
+    TestNode node2(port2, clock, 2);
+    TestNode node3(port3, clock, 3);
+    ASSERT_EQ(3, host.getNumPorts());
+    ASSERT_TRUE(port1.receivesAllFrames());     // Not bound yet
+    port1.setNode(node1);
+    port2.setNode(node2);
+    port3.setNode(node3);
+    ASSERT_FALSE(port1.receivesAllFrames());
+    ASSERT_EQ(2, port1.getNumIfaces());
+
+    uavcan::Publisher<root_ns_a::MavlinkMessage> publisher(node1);
+    SubscriberWithCollector<root_ns_a::MavlinkMessage> subscriber(node2);
+    ASSERT_LE(0, subscriber.start());
+
+    uavcan::ServiceServer<root_ns_a::StringService> server(node3);
+    ASSERT_LE(0, server.start(hostedStringServerCallback));
+    ServiceClientWithCollector<root_ns_a::StringService> client(node1);
+
+    ASSERT_LE(0, host.spinOnce());              // Subscription index is refreshed here
+    ASSERT_EQ(0, host.getNumFramesRouted());
+
+    /*
+     * Local broadcast: goes to the bus, and to the subscriber only, once per interface
+     */
+    root_ns_a::MavlinkMessage msg;
+    msg.seq = 42;
+    ASSERT_LE(0, publisher.broadcast(msg));
+    ASSERT_EQ(1, driver.ifaces.at(0).tx.size());
+    ASSERT_EQ(1, driver.ifaces.at(1).tx.size());
+    ASSERT_EQ(2, host.getNumFramesRouted());
+    ASSERT_EQ(2, host.getNumFramesDelivered());
+    ASSERT_EQ(2, port2.getRxQueueLength());
+    ASSERT_EQ(0, port3.getRxQueueLength());
+
+    ASSERT_LE(0, host.spin(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_TRUE(subscriber.collector.msg.get());
+    ASSERT_EQ(42, subscriber.collector.msg->seq);
+    ASSERT_EQ(0, port2.getRxQueueLength());
+
+    /*
+     * Broadcast from the bus, received once by the host
+     */
+    CanDriverMock ext_driver(2, clock);
+    TestNode ext_node(ext_driver, clock, 100);
+    uavcan::Publisher<root_ns_a::MavlinkMessage> ext_publisher(ext_node);
+    msg.seq = 43;
+    ASSERT_LE(0, ext_publisher.broadcast(msg));
+    forwardTxToRx(ext_driver, driver);
+
+    ASSERT_LE(0, host.spin(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_EQ(43, subscriber.collector.msg->seq);
+    ASSERT_EQ(4, host.getNumFramesRouted());
+    ASSERT_EQ(4, host.getNumFramesDelivered());
+
+    /*
+     * Local service call: the request reaches the server only, the response reaches the caller only
+     */
+    root_ns_a::StringService::Request request;
+    request.string_request = "Hi";
+    ASSERT_LE(0, client.call(3, request));
+    ASSERT_LE(0, host.spin(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_TRUE(client.collector.result.get());
+    ASSERT_TRUE(client.collector.result->isSuccessful());
+    ASSERT_STREQ("Hi!", client.collector.result->getResponse().string_response.c_str());
+    ASSERT_EQ(8, host.getNumFramesRouted());
+    ASSERT_EQ(8, host.getNumFramesDelivered());
+
+    /*
+     * Remote service call addressed to a hosted node
+     */
+    ServiceClientWithCollector<root_ns_a::StringService> ext_client(ext_node);
+    ASSERT_LE(0, ext_client.call(3, request));
+    forwardTxToRx(ext_driver, driver);
+    ASSERT_LE(0, host.spin(uavcan::MonotonicDuration::fromMSec(10)));
+    forwardTxToRx(driver, ext_driver);
+    ASSERT_LE(0, ext_node.spin(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_TRUE(ext_client.collector.result.get());
+    ASSERT_TRUE(ext_client.collector.result->isSuccessful());
+    ASSERT_EQ(12, host.getNumFramesRouted());
+    ASSERT_EQ(10, host.getNumFramesDelivered());   // The response went to the bus only
+
+    /*
+     * An unbound port receives everything, within its RX queue capacity
+     */
+    {
+        uavcan::MultiNodeHostPort sniffer(host);
+        host.setRxQueueCapacity(3);
+        ASSERT_LE(0, publisher.broadcast(msg));
+        ASSERT_LE(0, host.spin(uavcan::MonotonicDuration::fromMSec(10)));
+        ASSERT_EQ(2, sniffer.getRxQueueLength());
+        ASSERT_LE(0, publisher.broadcast(msg));
+        ASSERT_LE(0, host.spin(uavcan::MonotonicDuration::fromMSec(10)));
+        ASSERT_EQ(3, sniffer.getRxQueueLength());
+        ASSERT_EQ(1, sniffer.getRxFramesDropped());
+        host.setRxQueueCapacity(uavcan::MultiNodeHost::DefaultRxQueueCapacity);
+    }
+    ASSERT_EQ(3, host.getNumPorts());
+}
+
+
+TEST(MultiNodeHost, TxFairness)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _reg1;
+
+    SystemClockMock clock(100);
+    CanDriverMock driver(1, clock);
+    uavcan::HeapBasedPoolAllocator<uavcan::MemPoolBlockSize> pool(1024);
+    uavcan::MultiNodeHost host(driver, clock, pool);
+    host.setTxFramesPerRound(1);
+
+    uavcan::MultiNodeHostPort port1(host);
+    uavcan::MultiNodeHostPort port2(host);
+    TestNode node1(port1, clock, 1);
+    TestNode node2(port2, clock, 2);
+    port1.setNode(node1);
+    port2.setNode(node2);
+
+    uavcan::Publisher<root_ns_a::MavlinkMessage> publisher1(node1);
+    uavcan::Publisher<root_ns_a::MavlinkMessage> publisher2(node2);
+
+    /*
+     * The first node floods the bus; its excess stays in its own queue
+     */
+    root_ns_a::MavlinkMessage msg;
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        msg.seq = i;
+        ASSERT_LE(0, publisher1.broadcast(msg));
+    }
+    ASSERT_EQ(1, driver.ifaces.at(0).tx.size());
+    ASSERT_TRUE(node1.getDispatcher().getCanIOManager().makePendingTxMask());
+
+    /*
+     * The second node still gets its turn within the same round
+     */
+    ASSERT_LE(0, publisher2.broadcast(msg));
+    ASSERT_EQ(2, driver.ifaces.at(0).tx.size());
+
+    /*
+     * One more frame of the first node per round
+     */
+    ASSERT_LE(0, host.spinOnce());
+    ASSERT_EQ(3, driver.ifaces.at(0).tx.size());
+    ASSERT_LE(0, host.spinOnce());
+    ASSERT_EQ(4, driver.ifaces.at(0).tx.size());
+    ASSERT_FALSE(node1.getDispatcher().getCanIOManager().makePendingTxMask());
+}
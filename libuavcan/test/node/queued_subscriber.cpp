@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+#include <uavcan/node/queued_subscriber.hpp>
+#include <uavcan/node/publisher.hpp>
+#include <uavcan/util/method_binder.hpp>
+#include <root_ns_a/MavlinkMessage.hpp>
+#include "test_node.hpp"
+
+
+struct QueuedMessageCollector
+{
+    std::vector<root_ns_a::MavlinkMessage> messages;
+    std::vector<uavcan::NodeID> src_node_ids;
+
+    void receive(const uavcan::ReceivedDataStructure<root_ns_a::MavlinkMessage>& msg)
+    {
+        messages.push_back(msg);
+        src_node_ids.push_back(msg.getSrcNodeID());
+    }
+
+    typedef uavcan::MethodBinder<QueuedMessageCollector*,
+        void (QueuedMessageCollector::*)(const uavcan::ReceivedDataStructure<root_ns_a::MavlinkMessage>&)> Binder;
+
+    Binder bind() { return Binder(this, &QueuedMessageCollector::receive); }
+};
+
+
+TEST(QueuedSubscriber, KeepAll)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _registrator;
+
+    InterlinkedTestNodesWithSysClock nodes;
+
+    uavcan::Publisher<root_ns_a::MavlinkMessage> pub(nodes.a);
+    uavcan::QueuedSubscriber<root_ns_a::MavlinkMessage> sub(nodes.b, uavcan::QueuedSubscriberBase::PolicyKeepAll, 3);
+
+    ASSERT_EQ(0, sub.start());
+
+    /*
+     * Single frame and multi frame messages; the last one doesn't fit the queue
+     */
+    const root_ns_a::MavlinkMessage sequence[] = {
+        makeMavlinkTestMessage(1, 2),
+        makeMavlinkTestMessage(2, 100),
+        makeMavlinkTestMessage(3, 0),
+        makeMavlinkTestMessage(4, 5)
+    };
+    for (unsigned i = 0; i < 4; i++)
+    {
+        ASSERT_LT(0, pub.broadcast(sequence[i]));
+        ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(10)));
+    }
+
+    ASSERT_EQ(3, sub.getQueueLength());
+    ASSERT_EQ(1, sub.getDroppedCount());
+    ASSERT_EQ(0, sub.getConflatedCount());
+
+    /*
+     * Draining in batches
+     */
+    QueuedMessageCollector collector;
+    ASSERT_EQ(2, sub.drain(collector.bind(), 2));
+    ASSERT_TRUE(sequence[0] == collector.messages.at(0));
+    ASSERT_TRUE(sequence[1] == collector.messages.at(1));
+
+    std::vector<root_ns_a::MavlinkMessage> received;
+    std::vector<uavcan::NodeID> src_node_ids;
+    auto callback = [&](const uavcan::ReceivedDataStructure<root_ns_a::MavlinkMessage>& msg)
+    {
+        received.push_back(msg);
+        src_node_ids.push_back(msg.getSrcNodeID());
+    };
+
+    ASSERT_EQ(1, sub.drain(callback));
+    ASSERT_EQ(0, sub.drain(callback));
+    ASSERT_EQ(1, received.size());
+    ASSERT_TRUE(sequence[2] == received[0]);
+    ASSERT_EQ(nodes.a.getNodeID(), src_node_ids[0]);
+    ASSERT_TRUE(sub.isQueueEmpty());
+
+    for (unsigned i = 0; i < 3; i++)
+    {
+        ASSERT_LT(0, pub.broadcast(sequence[i]));
+    }
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_EQ(3, sub.drain(callback));
+    ASSERT_EQ(4, received.size());
+    for (unsigned i = 0; i < 3; i++)
+    {
+        ASSERT_TRUE(sequence[i] == received[i + 1]);
+    }
+    ASSERT_EQ(0, sub.getFailureCount());
+
+    /*
+     * Stopping keeps the queue, clearing releases the memory
+     */
+    ASSERT_LT(0, pub.broadcast(sequence[1]));
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(10)));
+    sub.stop();
+    ASSERT_EQ(1, sub.getQueueLength());
+    const unsigned num_used_blocks = unsigned(nodes.b.pool.getNumAllocatedBlocks());
+    sub.clear();
+    ASSERT_EQ(0, sub.getQueueLength());
+    ASSERT_GT(num_used_blocks, nodes.b.pool.getNumAllocatedBlocks());
+}
+
+
+TEST(QueuedSubscriber, KeepLatest)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _registrator;
+
+    TestNetwork<3> network;
+
+    uavcan::Publisher<root_ns_a::MavlinkMessage> pub_a(network[0]);
+    uavcan::Publisher<root_ns_a::MavlinkMessage> pub_b(network[1]);
+
+    uavcan::QueuedSubscriber<root_ns_a::MavlinkMessage>
+        sub_latest(network[2], uavcan::QueuedSubscriberBase::PolicyKeepLatest);
+    uavcan::QueuedSubscriber<root_ns_a::MavlinkMessage>
+        sub_per_source(network[2], uavcan::QueuedSubscriberBase::PolicyKeepLatestPerSource);
+
+    ASSERT_EQ(0, sub_latest.start());
+    ASSERT_EQ(0, sub_per_source.start());
+
+    ASSERT_LT(0, pub_a.broadcast(makeMavlinkTestMessage(1, 10)));
+    ASSERT_LE(0, network.spinAll(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_LT(0, pub_b.broadcast(makeMavlinkTestMessage(2, 20)));
+    ASSERT_LE(0, network.spinAll(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_LT(0, pub_a.broadcast(makeMavlinkTestMessage(3, 30)));
+    ASSERT_LE(0, network.spinAll(uavcan::MonotonicDuration::fromMSec(10)));
+
+    QueuedMessageCollector latest;
+    ASSERT_EQ(1, sub_latest.getQueueLength());
+    ASSERT_EQ(2, sub_latest.getConflatedCount());
+    ASSERT_EQ(1, sub_latest.drain(latest.bind()));
+    ASSERT_EQ(3, latest.messages.at(0).seq);
+
+    // The queue is ordered by arrival of the latest message from each source
+    QueuedMessageCollector per_source;
+    ASSERT_EQ(2, sub_per_source.getQueueLength());
+    ASSERT_EQ(1, sub_per_source.getConflatedCount());
+    ASSERT_EQ(2, sub_per_source.drain(per_source.bind()));
+    ASSERT_EQ(2, per_source.messages.at(0).seq);
+    ASSERT_EQ(network[1].getNodeID(), per_source.src_node_ids.at(0));
+    ASSERT_EQ(3, per_source.messages.at(1).seq);
+    ASSERT_EQ(network[0].getNodeID(), per_source.src_node_ids.at(1));
+    ASSERT_TRUE(makeMavlinkTestMessage(3, 30) == per_source.messages.at(1));
+}
+
+
+TEST(QueuedSubscriber, PoolQuota)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _registrator;
+
+    InterlinkedTestNodesWithSysClock nodes;
+
+    uavcan::Publisher<root_ns_a::MavlinkMessage> pub(nodes.a);
+
+    // Three blocks per single frame message
+    uavcan::QueuedSubscriber<root_ns_a::MavlinkMessage>
+        sub(nodes.b, uavcan::QueuedSubscriberBase::PolicyKeepAll, 100, 7);
+    ASSERT_EQ(0, sub.start());
+
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        ASSERT_LT(0, pub.broadcast(makeMavlinkTestMessage(i, 1)));
+        ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(5)));
+    }
+    ASSERT_EQ(2, sub.getQueueLength());
+    ASSERT_EQ(3, sub.getDroppedCount());
+
+    QueuedMessageCollector collector;
+    ASSERT_EQ(2, sub.drain(collector.bind()));
+    ASSERT_EQ(0, collector.messages.at(0).seq);
+    ASSERT_EQ(1, collector.messages.at(1).seq);
+}
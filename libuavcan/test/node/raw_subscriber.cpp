@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+#include <uavcan/node/raw_subscriber.hpp>
+#include <uavcan/node/raw_publisher.hpp>
+#include <uavcan/node/publisher.hpp>
+#include <uavcan/node/subscriber.hpp>
+#include <uavcan/util/method_binder.hpp>
+#include <root_ns_a/MavlinkMessage.hpp>
+#include "test_node.hpp"
+
+
+struct RawTransferListener
+{
+    std::vector<std::string> payloads;
+    std::vector<uavcan::NodeID> src_node_ids;
+    unsigned num_pieces;
+
+    RawTransferListener() : num_pieces(0) { }
+
+    void receive(const uavcan::IncomingTransfer& transfer)
+    {
+        std::string payload;
+        const uint8_t* data = UAVCAN_NULLPTR;
+        int len = 0;
+        while ((len = transfer.peek(unsigned(payload.length()), data)) > 0)
+        {
+            payload.append(reinterpret_cast<const char*>(data), unsigned(len));
+            num_pieces++;
+        }
+        EXPECT_EQ(0, len);
+        payloads.push_back(payload);
+        src_node_ids.push_back(transfer.getSrcNodeID());
+    }
+
+    typedef uavcan::MethodBinder<RawTransferListener*,
+                                 void (RawTransferListener::*)(const uavcan::IncomingTransfer&)> Binder;
+
+    Binder bind() { return Binder(this, &RawTransferListener::receive); }
+};
+
+struct MavlinkMessageCollector
+{
+    std::vector<root_ns_a::MavlinkMessage> messages;
+
+    void receive(const uavcan::ReceivedDataStructure<root_ns_a::MavlinkMessage>& msg) { messages.push_back(msg); }
+
+    typedef uavcan::MethodBinder<MavlinkMessageCollector*,
+        void (MavlinkMessageCollector::*)(const uavcan::ReceivedDataStructure<root_ns_a::MavlinkMessage>&)> Binder;
+
+    Binder bind() { return Binder(this, &MavlinkMessageCollector::receive); }
+};
+
+TEST(RawSubscriber, Basic)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::MavlinkMessage> _registrator;
+
+    InterlinkedTestNodesWithSysClock nodes;
+
+    const uavcan::DataTypeID dtid = root_ns_a::MavlinkMessage::DefaultDataTypeID;
+    const uavcan::DataTypeSignature signature = root_ns_a::MavlinkMessage::getDataTypeSignature();
+
+    uavcan::RawPublisher raw_pub(nodes.a);
+    uavcan::Publisher<root_ns_a::MavlinkMessage> typed_pub(nodes.a);
+
+    RawTransferListener listener;
+    uavcan::RawSubscriber<RawTransferListener::Binder> raw_sub(nodes.b);
+    uavcan::RawSubscriber<RawTransferListener::Binder> raw_sub_wrong_signature(nodes.b);
+    RawTransferListener listener_wrong_signature;
+
+    ASSERT_EQ(-uavcan::ErrNotInited, raw_pub.broadcast(reinterpret_cast<const uint8_t*>("123"), 3));
+    ASSERT_EQ(-uavcan::ErrInvalidParam, raw_pub.init(uavcan::DataTypeID(), signature));
+    ASSERT_EQ(0, raw_pub.init(dtid, signature));
+
+    ASSERT_EQ(-uavcan::ErrInvalidParam,
+              raw_sub.start(dtid, signature, RawTransferListener::Binder(UAVCAN_NULLPTR, UAVCAN_NULLPTR)));
+    ASSERT_EQ(0, raw_sub.start(dtid, signature, listener.bind()));
+    ASSERT_EQ(0, raw_sub_wrong_signature.start(dtid, uavcan::DataTypeSignature(123), listener_wrong_signature.bind()));
+    ASSERT_EQ(dtid, raw_sub.getDataTypeDescriptor().getID());
+
+    /*
+     * Raw to raw, single frame and multi frame
+     */
+    const std::string short_payload("\x42\x72\x08\xa5Msg", 7);
+    const std::string long_payload = std::string("\x01\x02\x03\x04", 4) + std::string(200, 'x');
+
+    ASSERT_LT(0, raw_pub.broadcast(reinterpret_cast<const uint8_t*>(short_payload.c_str()),
+                                   unsigned(short_payload.length())));
+    ASSERT_LT(0, raw_pub.broadcast(reinterpret_cast<const uint8_t*>(long_payload.c_str()),
+                                   unsigned(long_payload.length())));
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(20)));
+
+    ASSERT_EQ(2, listener.payloads.size());
+    ASSERT_EQ(short_payload, listener.payloads[0]);
+    ASSERT_EQ(long_payload, listener.payloads[1]);
+    ASSERT_EQ(nodes.a.getNodeID(), listener.src_node_ids[1]);
+    ASSERT_LT(2, listener.num_pieces);                  // The long payload spans several pool blocks
+
+    ASSERT_EQ(1, listener_wrong_signature.payloads.size());    // Multi frame transfer is rejected by the CRC check
+    ASSERT_EQ(short_payload, listener_wrong_signature.payloads[0]);
+    raw_sub_wrong_signature.stop();
+
+    /*
+     * Typed to raw
+     */
+    root_ns_a::MavlinkMessage msg;
+    msg.seq = 0x42;
+    msg.sysid = 0x72;
+    msg.compid = 0x08;
+    msg.msgid = 0xa5;
+    msg.payload = "Msg";
+    ASSERT_LT(0, typed_pub.broadcast(msg));
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(20)));
+    ASSERT_EQ(3, listener.payloads.size());
+    ASSERT_EQ(short_payload, listener.payloads[2]);
+
+    /*
+     * Raw to typed
+     */
+    MavlinkMessageCollector collector;
+    uavcan::Subscriber<root_ns_a::MavlinkMessage, MavlinkMessageCollector::Binder> typed_sub(nodes.b);
+    ASSERT_EQ(0, typed_sub.start(collector.bind()));
+    ASSERT_LT(0, raw_pub.broadcast(reinterpret_cast<const uint8_t*>(long_payload.c_str()),
+                                   unsigned(long_payload.length())));
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(20)));
+    ASSERT_EQ(4, listener.payloads.size());
+    ASSERT_EQ(long_payload, listener.payloads[3]);
+    ASSERT_EQ(0, typed_sub.getFailureCount());
+
+    ASSERT_EQ(1, collector.messages.size());
+    ASSERT_EQ(0x01, collector.messages[0].seq);
+    ASSERT_EQ(0x02, collector.messages[0].sysid);
+    ASSERT_EQ(0x03, collector.messages[0].compid);
+    ASSERT_EQ(0x04, collector.messages[0].msgid);
+    ASSERT_EQ(200, collector.messages[0].payload.size());
+    ASSERT_TRUE(collector.messages[0].payload == std::string(200, 'x').c_str());
+
+    /*
+     * Stopped
+     */
+    raw_sub.stop();
+    ASSERT_LT(0, raw_pub.broadcast(reinterpret_cast<const uint8_t*>(short_payload.c_str()),
+                                   unsigned(short_payload.length())));
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(20)));
+    ASSERT_EQ(4, listener.payloads.size());
+}
@@ -90,6 +90,107 @@ TEST(Scheduler, Timers)
     ASSERT_EQ(0, node.spin(durMono(1000)));                                    // Spin some more without timers
 }
 
+TEST(Scheduler, TimerSlack)
+{
+    SystemClockMock clock_mock(100);
+    CanDriverMock can_driver(2, clock_mock);
+    TestNode node(can_driver, clock_mock, 1);
+    uavcan::DeadlineScheduler& ds = node.getScheduler().getDeadlineScheduler();
+
+    TimerCallCounter tcc;
+    uavcan::TimerEventForwarder<TimerCallCounter::Binder> a(node, tcc.bindA());
+    uavcan::TimerEventForwarder<TimerCallCounter::Binder> b(node, tcc.bindB());
+    uavcan::TimerEventForwarder<TimerCallCounter::Binder> c(node, tcc.bindB());
+
+    ASSERT_TRUE(a.getSlack().isZero());
+    a.setSlack(durMono(-1));
+    ASSERT_TRUE(a.getSlack().isZero());
+
+    const uavcan::MonotonicTime start_ts = clock_mock.getMonotonic();
+
+    a.setSlack(durMono(5000));
+    a.startPeriodic(durMono(10000));
+    b.startOneShotWithDeadline(start_ts + durMono(13000));
+    c.startOneShotWithDeadline(start_ts + durMono(30000));
+
+    ASSERT_EQ(start_ts + durMono(10000), ds.getEarliestDeadline());
+    ASSERT_EQ(start_ts + durMono(13000), ds.getNextWakeupTime());   // A can wait for B
+
+    /*
+     * A is due, but it waits for B
+     */
+    clock_mock.advance(11000);
+    ASSERT_LE(0, node.spinOnce());
+    ASSERT_TRUE(tcc.events_a.empty());
+    ASSERT_TRUE(tcc.events_b.empty());
+
+    /*
+     * Both are served in one wakeup; A was delayed within its slack, without accumulating the delay
+     */
+    clock_mock.advance(2000);
+    ASSERT_LE(0, node.spinOnce());
+    ASSERT_EQ(1, tcc.events_a.size());
+    ASSERT_EQ(1, tcc.events_b.size());
+    ASSERT_EQ(start_ts + durMono(10000), tcc.events_a[0].scheduled_time);
+    ASSERT_EQ(start_ts + durMono(13000), tcc.events_a[0].real_time);
+    ASSERT_EQ(start_ts + durMono(20000), a.getDeadline());
+    ASSERT_EQ(1, ds.getNumCoalescedDeadlines());
+
+    /*
+     * Nothing else to coalesce with - A fires when its slack runs out
+     */
+    ASSERT_EQ(start_ts + durMono(25000), ds.getNextWakeupTime());
+    clock_mock.advance(12000);
+    ASSERT_LE(0, node.spinOnce());
+    ASSERT_EQ(2, tcc.events_a.size());
+    ASSERT_EQ(start_ts + durMono(25000), tcc.events_a[1].real_time);
+    ASSERT_EQ(1, ds.getNumCoalescedDeadlines());
+
+    /*
+     * Without slack, the deadlines are served exactly
+     */
+    a.setSlack(uavcan::MonotonicDuration());
+    ASSERT_EQ(start_ts + durMono(30000), ds.getNextWakeupTime());
+}
+
+TEST(Scheduler, TimerSlackZero)
+{
+    SystemClockMock clock_mock(100);
+    CanDriverMock can_driver(2, clock_mock);
+    TestNode node(can_driver, clock_mock, 1);
+    uavcan::DeadlineScheduler& ds = node.getScheduler().getDeadlineScheduler();
+
+    TimerCallCounter tcc;
+    uavcan::TimerEventForwarder<TimerCallCounter::Binder> a(node, tcc.bindA());
+    uavcan::TimerEventForwarder<TimerCallCounter::Binder> b(node, tcc.bindB());
+
+    const uavcan::MonotonicTime start_ts = clock_mock.getMonotonic();
+
+    /*
+     * Same deadline, no slack - nothing was coalesced
+     */
+    a.startOneShotWithDeadline(start_ts + durMono(10000));
+    b.startOneShotWithDeadline(start_ts + durMono(10000));
+    ASSERT_EQ(start_ts + durMono(10000), ds.getNextWakeupTime());
+
+    clock_mock.advance(10000);
+    ASSERT_LE(0, node.spinOnce());
+    ASSERT_EQ(1, tcc.events_a.size());
+    ASSERT_EQ(1, tcc.events_b.size());
+    ASSERT_EQ(0, ds.getNumCoalescedDeadlines());
+
+    /*
+     * Late handlers and a periodic timer served several times in one poll are not coalesced either
+     */
+    a.startPeriodic(durMono(1000));
+    b.startOneShotWithDelay(durMono(2500));
+    clock_mock.advance(5000);
+    ASSERT_LE(0, node.spinOnce());
+    ASSERT_EQ(6, tcc.events_a.size());
+    ASSERT_EQ(2, tcc.events_b.size());
+    ASSERT_EQ(0, ds.getNumCoalescedDeadlines());
+}
+
 #if UAVCAN_CPP_VERSION >= UAVCAN_CPP11
 
 TEST(Scheduler, TimerCpp11)
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+#include <uavcan/node/service_call_pipeline.hpp>
+#include <uavcan/node/service_server.hpp>
+#include <root_ns_a/StringService.hpp>
+#include <root_ns_a/EmptyService.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include "test_node.hpp"
+
+
+static std::string last_pipeline_request;
+
+static void pipelineStringServerCallback(const uavcan::ReceivedDataStructure<root_ns_a::StringService::Request>& req,
+                                         uavcan::ServiceResponseDataStructure<root_ns_a::StringService::Response>& rsp)
+{
+    last_pipeline_request = req.string_request.c_str();
+    if (req.string_request.size() <= (rsp.string_response.capacity() - 16))
+    {
+        rsp.string_response = "Request string: ";
+        rsp.string_response += req.string_request;
+    }
+}
+
+static root_ns_a::StringService::Request makePipelineRequest(const char* str)
+{
+    root_ns_a::StringService::Request req;
+    req.string_request = str;
+    return req;
+}
+
+template <unsigned NumNodes>
+static bool spinUntilDone(TestNetwork<NumNodes>& network, const uavcan::ServiceCallPipelineBase& pipeline,
+                          unsigned max_spins = 100)
+{
+    while (pipeline.hasPendingCalls() && (max_spins --> 0))
+    {
+        if (network.spinAll(uavcan::MonotonicDuration::fromMSec(10)) < 0)
+        {
+            return false;
+        }
+    }
+    return !pipeline.hasPendingCalls();
+}
+
+
+TEST(ServiceCallPipeline, Window)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::StringService> _registrator;
+
+    TestNetwork<5> network;                 // Node IDs 1..5, the client is 1
+
+    std::vector<std::unique_ptr<uavcan::ServiceServer<root_ns_a::StringService> > > servers;
+    for (unsigned i = 1; i < 5; i++)
+    {
+        servers.emplace_back(new uavcan::ServiceServer<root_ns_a::StringService>(network[i]));
+        ASSERT_EQ(0, servers.back()->start(pipelineStringServerCallback));
+    }
+
+    std::vector<std::pair<uint8_t, bool> > results;
+    typedef uavcan::ServiceCallPipeline<root_ns_a::StringService> Pipeline;
+    Pipeline pipeline(network[0], [&](const uavcan::ServiceCallResult<root_ns_a::StringService>& result)
+    {
+        results.push_back(std::make_pair(result.getCallID().server_node_id.get(), result.isSuccessful()));
+    });
+    pipeline.setWindowSize(2);
+    pipeline.setMaxAttempts(2);
+    pipeline.setAttemptTimeout(uavcan::MonotonicDuration::fromMSec(50));
+
+    ASSERT_EQ(-uavcan::ErrInvalidParam, pipeline.enqueue(1, makePipelineRequest("self")));
+    ASSERT_EQ(-uavcan::ErrInvalidParam, pipeline.enqueue(uavcan::NodeID::Broadcast, makePipelineRequest("all")));
+
+    /*
+     * The first call goes to a node that doesn't exist, it will be retried once
+     */
+    Pipeline::FutureType futures[5];
+    ASSERT_EQ(0, pipeline.enqueue(100, makePipelineRequest("void"), &futures[0]));
+    ASSERT_EQ(-uavcan::ErrInvalidParam, pipeline.enqueue(2, makePipelineRequest("busy"), &futures[0]));
+    for (uint8_t i = 1; i < 5; i++)
+    {
+        char str[] = { char('0' + i), '\0' };
+        ASSERT_EQ(0, pipeline.enqueue(uint8_t(i + 1), makePipelineRequest(str), &futures[i]));
+    }
+
+    ASSERT_EQ(2, pipeline.getNumCallsInFlight());
+    ASSERT_EQ(3, pipeline.getNumQueuedCalls());
+    for (unsigned i = 0; i < 5; i++)
+    {
+        ASSERT_EQ(uavcan::ServiceCallFutureBase::StatePending, futures[i].getState());
+        ASSERT_FALSE(futures[i].isReady());
+    }
+
+    ASSERT_TRUE(spinUntilDone(network, pipeline));
+
+    for (uint8_t i = 1; i < 5; i++)
+    {
+        ASSERT_TRUE(futures[i].isSuccessful());
+        ASSERT_EQ(1, futures[i].getNumAttempts());
+        ASSERT_EQ(i + 1, futures[i].getServerNodeID().get());
+        char str[] = { 'R', 'e', 'q', 'u', 'e', 's', 't', ' ', 's', 't', 'r', 'i', 'n', 'g', ':', ' ',
+                       char('0' + i), '\0' };
+        ASSERT_STREQ(str, futures[i].getResponse().string_response.c_str());
+    }
+    ASSERT_TRUE(futures[0].isReady());
+    ASSERT_FALSE(futures[0].isSuccessful());
+    ASSERT_EQ(2, futures[0].getNumAttempts());
+
+    ASSERT_EQ(5, results.size());
+    ASSERT_EQ(std::make_pair(uint8_t(100), false), results.back());
+    ASSERT_EQ(4, pipeline.getNumSucceededCalls());
+    ASSERT_EQ(1, pipeline.getNumFailedCalls());
+    ASSERT_EQ(1, pipeline.getNumRetries());
+
+    /*
+     * With a wide window, the whole fleet is queried in one round trip
+     */
+    pipeline.setWindowSize(8);
+    for (uint8_t i = 1; i < 5; i++)
+    {
+        ASSERT_EQ(0, pipeline.enqueue(uint8_t(i + 1), makePipelineRequest("again"), &futures[i]));
+    }
+    ASSERT_EQ(4, pipeline.getNumCallsInFlight());
+    ASSERT_EQ(0, pipeline.getNumQueuedCalls());
+    ASSERT_LE(0, network.spinAll(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_FALSE(pipeline.hasPendingCalls());
+    for (unsigned i = 1; i < 5; i++)
+    {
+        ASSERT_TRUE(futures[i].isSuccessful());
+    }
+    ASSERT_EQ(9, results.size());
+
+    /*
+     * The stored request spans several pool blocks, it is sent intact
+     */
+    const std::string long_str(60, 'x');
+    ASSERT_EQ(0, pipeline.enqueue(2, makePipelineRequest(long_str.c_str()), &futures[1]));
+    ASSERT_TRUE(spinUntilDone(network, pipeline));
+    ASSERT_TRUE(futures[1].isSuccessful());
+    ASSERT_EQ(long_str, last_pipeline_request);
+}
+
+
+TEST(ServiceCallPipeline, DeadlineAndCancellation)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::EmptyService> _registrator;
+
+    TestNetwork<2> network;
+
+    typedef uavcan::ServiceCallPipeline<root_ns_a::EmptyService> Pipeline;
+    Pipeline pipeline(network[0]);          // No callback, futures only
+    pipeline.setWindowSize(1);
+    pipeline.setMaxAttempts(10);
+    pipeline.setCallDeadline(uavcan::MonotonicDuration::fromMSec(30));
+
+    /*
+     * The first call times out once the deadline expires; the queued ones expire without being issued
+     */
+    Pipeline::FutureType futures[3];
+    for (unsigned i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(0, pipeline.enqueue(uint8_t(100 + i), root_ns_a::EmptyService::Request(), &futures[i]));
+    }
+    {
+        Pipeline::FutureType abandoned_future;
+        ASSERT_EQ(0, pipeline.enqueue(110, root_ns_a::EmptyService::Request(), &abandoned_future));
+    }
+    ASSERT_EQ(1, pipeline.getNumCallsInFlight());
+    ASSERT_EQ(3, pipeline.getNumQueuedCalls());
+
+    ASSERT_TRUE(spinUntilDone(network, pipeline));
+
+    ASSERT_EQ(uavcan::ServiceCallFutureBase::StateFailed, futures[0].getState());
+    ASSERT_LE(1, futures[0].getNumAttempts());
+    ASSERT_GT(10, futures[0].getNumAttempts());
+    for (unsigned i = 1; i < 3; i++)
+    {
+        ASSERT_EQ(uavcan::ServiceCallFutureBase::StateFailed, futures[i].getState());
+        ASSERT_EQ(0, futures[i].getNumAttempts());
+    }
+    ASSERT_EQ(4, pipeline.getNumFailedCalls());
+
+    /*
+     * Cancellation
+     */
+    pipeline.setCallDeadline(uavcan::MonotonicDuration());
+    ASSERT_EQ(0, pipeline.enqueue(100, root_ns_a::EmptyService::Request(), &futures[0]));
+    ASSERT_EQ(0, pipeline.enqueue(101, root_ns_a::EmptyService::Request(), &futures[1]));
+    ASSERT_TRUE(pipeline.hasPendingCalls());
+
+    const uint64_t num_used_blocks = network[0].pool.getNumAllocatedBlocks();
+    pipeline.cancelAllCalls();
+    ASSERT_GT(num_used_blocks, network[0].pool.getNumAllocatedBlocks());
+    ASSERT_FALSE(pipeline.hasPendingCalls());
+    ASSERT_EQ(uavcan::ServiceCallFutureBase::StateFailed, futures[0].getState());
+    ASSERT_EQ(uavcan::ServiceCallFutureBase::StateFailed, futures[1].getState());
+    ASSERT_EQ(0, network[0].getDispatcher().getNumServiceResponseListeners());
+}
@@ -12,6 +12,8 @@
 #include <root_ns_a/EmptyService.hpp>
 #include <queue>
 #include <sstream>
+#include "../clock.hpp"
+#include "../transport/can/can.hpp"
 #include "test_node.hpp"
 
 
@@ -439,6 +441,118 @@ TEST(ServiceClient, Priority)
 }
 
 
+/**
+ * Exposes the hash function of the call registry, so that the number of calls a lookup has to walk can be checked.
+ */
+struct CallRegistryInspector : public uavcan::ServiceClient<root_ns_a::EmptyService>
+{
+    enum { NumBuckets = CallRegistry::NumBuckets };
+
+    static unsigned getBucketIndex(uavcan::ServiceCallID call_id) { return CallRegistry::getBucketIndex(call_id); }
+};
+
+TEST(ServiceClient, ManyConcurrentCalls)
+{
+    static const unsigned NumCalls = 120;
+    static const unsigned NumRounds = 100;
+    static const uint8_t FirstServerNodeID = 2;
+
+    SystemClockMock clock_mock(100);
+    CanDriverMock can_driver(1, clock_mock);
+    TestNode node(can_driver, clock_mock, 1);
+
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::EmptyService> _registrator;
+
+    unsigned num_successful_calls = 0;
+    unsigned num_failed_calls = 0;
+    uavcan::ServiceClient<root_ns_a::EmptyService> client(node);
+    client.setCallback([&](const uavcan::ServiceCallResult<root_ns_a::EmptyService>& result)
+    {
+        (result.isSuccessful() ? num_successful_calls : num_failed_calls)++;
+    });
+
+    std::queue<CanIfaceMock::FrameWithTime>& tx = can_driver.ifaces[0].tx;
+
+    for (unsigned round = 0; round < NumRounds; round++)
+    {
+        uavcan::ServiceCallID call_ids[NumCalls];
+        for (unsigned i = 0; i < NumCalls; i++)
+        {
+            ASSERT_LE(0, client.call(uint8_t(FirstServerNodeID + i), root_ns_a::EmptyService::Request(),
+                                     call_ids[i]));
+        }
+        ASSERT_EQ(NumCalls, client.getNumPendingCalls());
+        ASSERT_TRUE(client.hasPendingCallToServer(FirstServerNodeID + NumCalls - 1));
+        ASSERT_FALSE(client.hasPendingCallToServer(FirstServerNodeID + NumCalls));
+
+        // No lookup walks more calls than an even spread over the buckets would give
+        {
+            unsigned bucket_lengths[CallRegistryInspector::NumBuckets] = {};
+            unsigned max_bucket_length = 0;
+            for (unsigned i = 0; i < NumCalls; i++)
+            {
+                unsigned& len = bucket_lengths[CallRegistryInspector::getBucketIndex(call_ids[i])];
+                max_bucket_length = std::max(max_bucket_length, ++len);
+            }
+            ASSERT_GE((NumCalls + CallRegistryInspector::NumBuckets - 1) / CallRegistryInspector::NumBuckets,
+                      max_bucket_length);
+        }
+
+        while (!tx.empty())
+        {
+            tx.pop();
+        }
+
+        // Responses arrive in reverse order; the first one is cancelled, one response has unknown transfer ID
+        client.cancelCall(call_ids[0]);
+        for (int i = NumCalls - 1; i >= 0; i--)
+        {
+            uavcan::Frame frame(root_ns_a::EmptyService::DefaultDataTypeID, uavcan::TransferTypeServiceResponse,
+                                call_ids[i].server_node_id, node.getNodeID(), call_ids[i].transfer_id);
+            frame.setStartOfTransfer(true);
+            frame.setEndOfTransfer(true);
+            uavcan::CanFrame can_frame;
+            ASSERT_TRUE(frame.compile(can_frame));
+            can_driver.ifaces[0].pushRx(can_frame);
+        }
+        {
+            uavcan::TransferID unknown_tid = call_ids[1].transfer_id;
+            unknown_tid.increment();
+            uavcan::Frame frame(root_ns_a::EmptyService::DefaultDataTypeID, uavcan::TransferTypeServiceResponse,
+                                call_ids[1].server_node_id, node.getNodeID(), unknown_tid);
+            frame.setStartOfTransfer(true);
+            frame.setEndOfTransfer(true);
+            uavcan::CanFrame can_frame;
+            ASSERT_TRUE(frame.compile(can_frame));
+            can_driver.ifaces[0].pushRx(can_frame);
+        }
+
+        ASSERT_LE(0, node.spinOnce());
+
+        ASSERT_EQ(0, client.getNumPendingCalls());
+        ASSERT_EQ((round + 1) * (NumCalls - 1), num_successful_calls);
+
+        clock_mock.advance(1000);
+    }
+
+    /*
+     * Timeouts are delivered for every call
+     */
+    for (unsigned i = 0; i < NumCalls; i++)
+    {
+        ASSERT_LE(0, client.call(uint8_t(FirstServerNodeID + (i % 3)), root_ns_a::EmptyService::Request()));
+    }
+    ASSERT_EQ(NumCalls, client.getNumPendingCalls());
+    ASSERT_TRUE(client.hasPendingCallToServer(FirstServerNodeID + 2));
+
+    clock_mock.advance(uint64_t(client.getRequestTimeout().toUSec()) + 1000);
+    ASSERT_LE(0, node.spinOnce());
+    ASSERT_EQ(0, client.getNumPendingCalls());
+    ASSERT_EQ(NumCalls, num_failed_calls);
+    ASSERT_FALSE(client.hasPendingCallToServer(FirstServerNodeID + 2));
+}
+
 TEST(ServiceClient, Sizes)
 {
     using namespace uavcan;
@@ -4,11 +4,14 @@
 
 #include <gtest/gtest.h>
 #include <uavcan/node/service_server.hpp>
+#include <uavcan/node/service_client.hpp>
 #include <uavcan/util/method_binder.hpp>
 #include <root_ns_a/StringService.hpp>
 #include <root_ns_a/EmptyService.hpp>
 #include "../clock.hpp"
 #include "../transport/can/can.hpp"
+#include <vector>
+#include <string>
 #include "test_node.hpp"
 
 
@@ -154,3 +157,111 @@ TEST(ServiceServer, Empty)
     ASSERT_GE(0, server.start(impl.bind()));
     ASSERT_EQ(1, node.getDispatcher().getNumServiceRequestListeners());
 }
+
+
+TEST(ServiceServer, Deferred)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    uavcan::DefaultDataTypeRegistrator<root_ns_a::StringService> _registrator;
+
+    InterlinkedTestNodesWithSysClock nodes;
+
+    typedef uavcan::ServiceServer<root_ns_a::StringService> Server;
+    Server server(nodes.a);
+    server.setMaxDeferredResponses(2);
+    server.setDeferredResponseTimeout(uavcan::MonotonicDuration::fromMSec(100));
+
+    std::vector<uavcan::ServiceResponseToken> tokens;
+    std::vector<std::string> requests;
+    ASSERT_LE(0, server.start(
+        [&](const uavcan::ReceivedDataStructure<root_ns_a::StringService::Request>& req,
+            uavcan::ServiceResponseDataStructure<root_ns_a::StringService::Response>& rsp)
+        {
+            uavcan::ServiceResponseToken token;
+            if (server.deferResponse(req, rsp, token) >= 0)
+            {
+                tokens.push_back(token);
+                requests.push_back(req.string_request.c_str());
+            }
+            else
+            {
+                rsp.string_response = "immediate";      // Storage is full, responding right away
+            }
+        }));
+
+    std::vector<std::string> responses;
+    uavcan::ServiceClient<root_ns_a::StringService> client(nodes.b);
+    client.setCallback([&](const uavcan::ServiceCallResult<root_ns_a::StringService>& result)
+    {
+        responses.push_back(result.isSuccessful() ? result.getResponse().string_response.c_str() : "timeout");
+    });
+    client.setRequestTimeout(uavcan::MonotonicDuration::fromMSec(100));
+
+    /*
+     * Two requests are deferred, the third one doesn't fit
+     */
+    const char* const strings[] = { "a", "b", "c" };
+    for (unsigned i = 0; i < 3; i++)
+    {
+        root_ns_a::StringService::Request req;
+        req.string_request = strings[i];
+        ASSERT_LE(0, client.call(nodes.a.getNodeID(), req));
+    }
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(10)));
+
+    ASSERT_EQ(2, tokens.size());
+    ASSERT_EQ(2, server.getNumDeferredResponses());
+    ASSERT_EQ(1, responses.size());
+    ASSERT_EQ("immediate", responses[0]);
+    ASSERT_EQ(nodes.b.getNodeID(), tokens[0].getClientNodeID());
+    ASSERT_TRUE(tokens[0].isValid());
+    ASSERT_FALSE(uavcan::ServiceResponseToken().isValid());
+
+    /*
+     * Responding out of order, outside of the callback
+     */
+    for (int i = 1; i >= 0; i--)
+    {
+        root_ns_a::StringService::Response rsp;
+        rsp.string_response = requests[unsigned(i)].c_str();
+        rsp.string_response += " deferred";
+        ASSERT_LE(0, server.respond(tokens[unsigned(i)], rsp));
+    }
+    ASSERT_EQ(0, server.getNumDeferredResponses());
+    ASSERT_EQ(-uavcan::ErrInvalidParam, server.respond(tokens[0], root_ns_a::StringService::Response()));
+
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_EQ(3, responses.size());
+    ASSERT_EQ("b deferred", responses[1]);
+    ASSERT_EQ("a deferred", responses[2]);
+    ASSERT_FALSE(client.hasPendingCalls());
+
+    /*
+     * Expired tokens can't be used and don't occupy the storage
+     */
+    tokens.clear();
+    for (unsigned i = 0; i < 2; i++)
+    {
+        ASSERT_LE(0, client.call(nodes.a.getNodeID(), root_ns_a::StringService::Request()));
+    }
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_EQ(2, tokens.size());
+    server.cancelDeferredResponse(tokens[1]);
+    ASSERT_EQ(1, server.getNumDeferredResponses());
+
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(150)));
+    ASSERT_EQ(5, responses.size());
+    ASSERT_EQ("timeout", responses[4]);
+    ASSERT_EQ(-uavcan::ErrInvalidParam, server.respond(tokens[0], root_ns_a::StringService::Response()));
+    ASSERT_EQ(0, server.getNumDeferredResponses());
+
+    const uint64_t num_used_blocks = nodes.a.pool.getNumAllocatedBlocks();
+    tokens.clear();
+    ASSERT_LE(0, client.call(nodes.a.getNodeID(), root_ns_a::StringService::Request()));
+    ASSERT_LE(0, nodes.spinBoth(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_EQ(1, tokens.size());
+    ASSERT_EQ(1, server.getNumDeferredResponses());
+    ASSERT_LT(num_used_blocks, nodes.a.pool.getNumAllocatedBlocks());
+
+    ASSERT_EQ(0, server.getResponseFailureCount());
+}
@@ -7,8 +7,11 @@
 #include <uavcan/util/method_binder.hpp>
 #include <root_ns_a/EmptyMessage.hpp>
 #include <root_ns_a/MavlinkMessage.hpp>
+#include <root_ns_a/FixedLayout.hpp>
+#include <root_ns_a/Deep.hpp>
 #include "../clock.hpp"
 #include "../transport/can/can.hpp"
+#include "../transport/transfer_test_helpers.hpp"
 #include "test_node.hpp"
 
 
@@ -280,3 +283,203 @@ TEST(Subscriber, SingleFrameTransfer)
         ASSERT_TRUE(listener.simple.at(i) == root_ns_a::EmptyMessage());
     }
 }
+
+
+template <typename SubscriberType>
+static uint16_t receiveStreamingTestTransfer(const std::vector<uavcan::RxFrame>& frames)
+{
+    SystemClockDriver clock_driver;
+    CanDriverMock can_driver(1, clock_driver);
+    TestNode node(can_driver, clock_driver, 1);
+
+    typedef SubscriptionListener<root_ns_a::FixedLayout> Listener;
+    Listener listener;
+    SubscriberType sub(node);
+    EXPECT_EQ(0, sub.start(listener.bindSimple()));
+
+    for (unsigned i = 0; i < (frames.size() - 1); i++)
+    {
+        can_driver.ifaces[0].pushRx(frames[i]);
+    }
+    EXPECT_LE(0, node.spin(uavcan::MonotonicDuration::fromMSec(1)));
+    const uint16_t num_blocks = node.pool.getNumAllocatedBlocks();
+    EXPECT_EQ(0, listener.simple.size());
+
+    can_driver.ifaces[0].pushRx(frames.back());
+    EXPECT_LE(0, node.spin(uavcan::MonotonicDuration::fromMSec(1)));
+    EXPECT_EQ(1, listener.simple.size());
+    return num_blocks;
+}
+
+TEST(Subscriber, Streaming)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    ASSERT_EQ(uavcan::GlobalDataTypeRegistry::RegistrationResultOk,
+              uavcan::GlobalDataTypeRegistry::instance().registerDataType<root_ns_a::FixedLayout>(1234));
+
+    SystemClockDriver clock_driver;
+    CanDriverMock can_driver(2, clock_driver);
+    TestNode node(can_driver, clock_driver, 1);
+
+    typedef SubscriptionListener<root_ns_a::FixedLayout> Listener;
+    Listener listener;
+
+    uavcan::StreamingSubscriber<root_ns_a::FixedLayout, Listener::ExtendedBinder> sub(node);
+    ASSERT_EQ(0, sub.start(listener.bindExtended()));
+
+    root_ns_a::FixedLayout msgs[2];
+    msgs[0].b = -1234;
+    msgs[0].d = 3.5F;
+    msgs[0].e = -0x123456789ALL;
+    msgs[0].h.array[1] = 2;
+    msgs[0].i = 0x0123456789ABCDEFLL;
+    msgs[0].tail.push_back(42);
+    msgs[0].tail.push_back(24);
+    msgs[1].a = true;
+    msgs[1].g = -1.0F;
+    msgs[1].j[1] = true;
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        msgs[1].tail.push_back(i);
+    }
+
+    const uavcan::NodeID NodeA(100);
+    const uavcan::NodeID NodeB(101);
+
+    /*
+     * Two interleaved transfers - the first one is streamed, the other one is buffered as usual
+     */
+    {
+        const std::vector<uavcan::RxFrame> a = serializeMessage(msgs[0], NodeA, 0, clock_driver.getMonotonic());
+        const std::vector<uavcan::RxFrame> b = serializeMessage(msgs[1], NodeB, 0, clock_driver.getMonotonic());
+        ASSERT_LT(4, a.size());
+        ASSERT_LT(4, b.size());
+        for (unsigned i = 0; i < std::max(a.size(), b.size()); i++)
+        {
+            if (i < a.size())
+            {
+                can_driver.ifaces[0].pushRx(a[i]);
+                can_driver.ifaces[1].pushRx(a[i]);      // Redundant interface
+            }
+            if (i < b.size())
+            {
+                can_driver.ifaces[0].pushRx(b[i]);
+            }
+        }
+        ASSERT_LE(0, node.spin(uavcan::MonotonicDuration::fromMSec(10)));
+
+        ASSERT_EQ(2, listener.extended.size());
+        ASSERT_TRUE(listener.extended[0].msg == msgs[0]);
+        ASSERT_EQ(NodeA, listener.extended[0].src_node_id);
+        ASSERT_TRUE(listener.extended[1].msg == msgs[1]);
+        ASSERT_EQ(NodeB, listener.extended[1].src_node_id);
+    }
+
+    /*
+     * Corrupted transfer is discarded, the next one is accepted
+     */
+    {
+        std::vector<uavcan::RxFrame> a = serializeMessage(msgs[1], NodeA, 1, clock_driver.getMonotonic());
+        uint8_t payload[uavcan::Frame::PayloadCapacity];
+        std::copy(a[2].getPayloadPtr(), a[2].getPayloadPtr() + a[2].getPayloadLen(), payload);
+        payload[0] ^= 1;
+        ASSERT_EQ(int(a[2].getPayloadLen()), a[2].setPayload(payload, a[2].getPayloadLen()));
+
+        const std::vector<uavcan::RxFrame> b = serializeMessage(msgs[1], NodeA, 2, clock_driver.getMonotonic());
+
+        for (unsigned i = 0; i < a.size(); i++)
+        {
+            can_driver.ifaces[0].pushRx(a[i]);
+        }
+        ASSERT_LE(0, node.spin(uavcan::MonotonicDuration::fromMSec(10)));
+        ASSERT_EQ(2, listener.extended.size());
+        ASSERT_EQ(1, sub.getFailureCount());
+
+        for (unsigned i = 0; i < b.size(); i++)
+        {
+            can_driver.ifaces[0].pushRx(b[i]);
+        }
+        ASSERT_LE(0, node.spin(uavcan::MonotonicDuration::fromMSec(10)));
+        ASSERT_EQ(3, listener.extended.size());
+        ASSERT_TRUE(listener.extended[2].msg == msgs[1]);
+        ASSERT_EQ(2, listener.extended[2].transfer_id.get());
+    }
+
+    /*
+     * Transfer that is longer than the structure is aborted while it is being streamed
+     */
+    {
+        const uavcan::DataTypeDescriptor* const descr =
+            uavcan::GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage,
+                                                            root_ns_a::FixedLayout::getDataTypeFullName());
+        ASSERT_TRUE(descr != UAVCAN_NULLPTR);
+        const unsigned max_len = uavcan::BitLenToByteLen<root_ns_a::FixedLayout::MaxBitLen>::Result;
+        const Transfer transfer(clock_driver.getMonotonic(), uavcan::UtcTime(), uavcan::TransferPriority::Default,
+                                uavcan::TransferTypeMessageBroadcast, 3, NodeA, uavcan::NodeID::Broadcast,
+                                std::string(max_len + 8U, '\0'), *descr);
+        const std::vector<uavcan::RxFrame> a = serializeTransfer(transfer);
+        for (unsigned i = 0; i < a.size(); i++)
+        {
+            can_driver.ifaces[0].pushRx(a[i]);
+        }
+        ASSERT_LE(0, node.spin(uavcan::MonotonicDuration::fromMSec(10)));
+        ASSERT_EQ(3, listener.extended.size());
+        ASSERT_EQ(2, sub.getFailureCount());
+    }
+
+    ASSERT_EQ(2, sub.getFailureCount());
+
+    /*
+     * The streamed transfer does not occupy the pool while it is being received
+     */
+    const std::vector<uavcan::RxFrame> frames = serializeMessage(msgs[1], NodeA, 0, SystemClockDriver().getMonotonic());
+    const uint16_t streaming_blocks =
+        receiveStreamingTestTransfer<uavcan::StreamingSubscriber<root_ns_a::FixedLayout,
+                                                                 Listener::SimpleBinder> >(frames);
+    const uint16_t buffered_blocks =
+        receiveStreamingTestTransfer<uavcan::Subscriber<root_ns_a::FixedLayout, Listener::SimpleBinder> >(frames);
+    std::cout << "Pool blocks used by streaming/buffered subscriber: "
+              << streaming_blocks << "/" << buffered_blocks << std::endl;
+    ASSERT_LT(streaming_blocks, buffered_blocks);
+}
+
+TEST(Subscriber, FieldMask)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    ASSERT_EQ(uavcan::GlobalDataTypeRegistry::RegistrationResultOk,
+              uavcan::GlobalDataTypeRegistry::instance().registerDataType<root_ns_a::Deep>(1235));
+
+    SystemClockDriver clock_driver;
+    CanDriverMock can_driver(1, clock_driver);
+    TestNode node(can_driver, clock_driver, 1);
+
+    typedef SubscriptionListener<root_ns_a::Deep> Listener;
+    Listener listener;
+
+    uavcan::Subscriber<root_ns_a::Deep, Listener::SimpleBinder> sub(node);
+    ASSERT_EQ(0xFFFFFFFFU, sub.getFieldMask());
+    sub.setFieldMask(root_ns_a::Deep::FieldMask::c | root_ns_a::Deep::FieldMask::b);
+    ASSERT_EQ(0, sub.start(listener.bindSimple()));
+
+    root_ns_a::Deep msg;
+    msg.c = true;
+    msg.str = "Not decoded";
+    msg.a.resize(1, root_ns_a::A());
+    msg.a[0].scalar = 1.5F;
+    msg.b[1].vector[0] = 42.0;
+
+    const std::vector<uavcan::RxFrame> frames =
+        serializeMessage(msg, uavcan::NodeID(100), 0, clock_driver.getMonotonic());
+    for (unsigned i = 0; i < frames.size(); i++)
+    {
+        can_driver.ifaces[0].pushRx(frames[i]);
+    }
+    ASSERT_LE(0, node.spin(uavcan::MonotonicDuration::fromMSec(10)));
+
+    ASSERT_EQ(1, listener.simple.size());
+    ASSERT_TRUE(listener.simple[0].c);
+    ASSERT_TRUE(listener.simple[0].str.empty());
+    ASSERT_TRUE(listener.simple[0].a.empty());
+    ASSERT_TRUE(msg.b == listener.simple[0].b);
+    ASSERT_EQ(0, sub.getFailureCount());
+}
@@ -16,6 +16,7 @@
 #include "../transport/can/can.hpp"
 #include <uavcan/util/method_binder.hpp>
 #include <uavcan/node/subscriber.hpp>
+#include <root_ns_a/MavlinkMessage.hpp>
 
 struct TestNode : public uavcan::INode
 {
@@ -266,3 +267,18 @@ struct TestNetwork
         return nodes[index]->node;
     }
 };
+
+/**
+ * Test message with the specified sequence number and payload 0, 1, 2...
+ * Up to three bytes of payload fit one CAN frame.
+ */
+inline root_ns_a::MavlinkMessage makeMavlinkTestMessage(uint8_t seq, unsigned payload_len)
+{
+    root_ns_a::MavlinkMessage msg;
+    msg.seq = seq;
+    for (unsigned i = 0; i < payload_len; i++)
+    {
+        msg.payload.push_back(uint8_t(i));
+    }
+    return msg;
+}
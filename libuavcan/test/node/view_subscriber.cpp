@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+#include <uavcan/node/view_subscriber.hpp>
+#include <uavcan/util/method_binder.hpp>
+#include <root_ns_a/FixedLayout.hpp>
+#include "../clock.hpp"
+#include "../transport/can/can.hpp"
+#include "../transport/transfer_test_helpers.hpp"
+#include "test_node.hpp"
+
+
+struct ViewListener
+{
+    typedef uavcan::ReceivedDataView<root_ns_a::FixedLayout> View;
+
+    std::vector<int64_t> e_values;
+    std::vector<uavcan::NodeID> src_node_ids;
+    std::vector<root_ns_a::FixedLayout> materialized;
+
+    void receive(const View& view)
+    {
+        e_values.push_back(view.e());
+        src_node_ids.push_back(view.getSrcNodeID());
+        if (view.a())
+        {
+            root_ns_a::FixedLayout msg;
+            EXPECT_EQ(1, view.materialize(msg));
+            materialized.push_back(msg);
+        }
+    }
+
+    typedef uavcan::MethodBinder<ViewListener*, void (ViewListener::*)(const View&)> Binder;
+
+    Binder bind() { return Binder(this, &ViewListener::receive); }
+};
+
+
+TEST(ViewSubscriber, Basic)
+{
+    uavcan::GlobalDataTypeRegistry::instance().reset();
+    ASSERT_EQ(uavcan::GlobalDataTypeRegistry::RegistrationResultOk,
+              uavcan::GlobalDataTypeRegistry::instance().registerDataType<root_ns_a::FixedLayout>(1234));
+
+    SystemClockDriver clock_driver;
+    CanDriverMock can_driver(1, clock_driver);
+    TestNode node(can_driver, clock_driver, 1);
+
+    ViewListener listener;
+    uavcan::ViewSubscriber<root_ns_a::FixedLayout, ViewListener::Binder> sub(node);
+
+    // Null binder - will fail
+    ASSERT_EQ(-uavcan::ErrInvalidParam, sub.start(ViewListener::Binder(UAVCAN_NULLPTR, UAVCAN_NULLPTR)));
+    ASSERT_EQ(0, sub.start(listener.bind()));
+
+    root_ns_a::FixedLayout msgs[2];
+    msgs[0].e = -0x123456789ALL;
+    msgs[1].a = true;                           // Will be materialized
+    msgs[1].e = 42;
+    msgs[1].g = -1.0F;
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        msgs[1].tail.push_back(i);
+    }
+
+    const uavcan::NodeID NodeA(100);
+    const uavcan::NodeID NodeB(101);
+
+    const std::vector<uavcan::RxFrame> a = serializeMessage(msgs[0], NodeA, 0, clock_driver.getMonotonic());
+    const std::vector<uavcan::RxFrame> b = serializeMessage(msgs[1], NodeB, 0, clock_driver.getMonotonic());
+    ASSERT_LT(1, a.size());
+    for (unsigned i = 0; i < a.size(); i++)
+    {
+        can_driver.ifaces[0].pushRx(a[i]);
+    }
+    for (unsigned i = 0; i < b.size(); i++)
+    {
+        can_driver.ifaces[0].pushRx(b[i]);
+    }
+    ASSERT_LE(0, node.spin(uavcan::MonotonicDuration::fromMSec(10)));
+
+    ASSERT_EQ(2, listener.e_values.size());
+    ASSERT_EQ(msgs[0].e, listener.e_values[0]);
+    ASSERT_EQ(NodeA, listener.src_node_ids[0]);
+    ASSERT_EQ(msgs[1].e, listener.e_values[1]);
+    ASSERT_EQ(NodeB, listener.src_node_ids[1]);
+
+    ASSERT_EQ(1, listener.materialized.size());
+    ASSERT_TRUE(msgs[1] == listener.materialized[0]);
+
+    sub.stop();
+    for (unsigned i = 0; i < a.size(); i++)
+    {
+        can_driver.ifaces[0].pushRx(serializeMessage(msgs[0], NodeA, 1, clock_driver.getMonotonic())[i]);
+    }
+    ASSERT_LE(0, node.spin(uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_EQ(2, listener.e_values.size());
+}
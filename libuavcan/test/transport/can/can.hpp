@@ -274,6 +274,23 @@ public:
     virtual uavcan::uint8_t getNumIfaces() const { return uavcan::uint8_t(ifaces.size()); }
 };
 
+/**
+ * Single-frame transfer with a short payload, compiled into a CAN frame.
+ */
+inline uavcan::CanFrame makeTransferCanFrame(uavcan::DataTypeID dtid, uavcan::TransferType tt, uavcan::NodeID src,
+                                             uavcan::NodeID dst, uavcan::TransferID tid = 0,
+                                             uavcan::TransferPriority priority = uavcan::TransferPriority::Default)
+{
+    uavcan::Frame frame(dtid, tt, src, dst, tid);
+    frame.setPriority(priority);
+    frame.setStartOfTransfer(true);
+    frame.setEndOfTransfer(true);
+    frame.setPayload(reinterpret_cast<const uint8_t*>("123"), 3);
+    uavcan::CanFrame can_frame;
+    EXPECT_TRUE(frame.compile(can_frame));
+    return can_frame;
+}
+
 enum FrameType { STD, EXT };
 inline uavcan::CanFrame makeCanFrame(uint32_t id, const std::string& str_data, FrameType type)
 {
@@ -214,3 +214,50 @@ TEST(CanTxQueue, TxQueue)
     EXPECT_FALSE(queue.peek());
     EXPECT_FALSE(queue.topPriorityHigherOrEqual(f0));
 }
+
+TEST(CanTxQueue, ReplaceQueued)
+{
+    using uavcan::CanTxQueue;
+    using uavcan::CanFrame;
+
+    uavcan::PoolAllocator<40 * 8, 40> pool;
+    SystemClockMock clockmock;
+    CanTxQueue queue(pool, clockmock, 99999);
+
+    const uavcan::CanIOFlags replace = uavcan::CanIOFlagReplaceQueued;
+
+    // The last byte is the tail byte; single-frame transfers have both the start and the end bits set
+    const CanFrame single1 = makeCanFrame(100, "a\xC1", EXT);
+    const CanFrame single2 = makeCanFrame(100, "b\xC2", EXT);
+    const CanFrame single3 = makeCanFrame(100, "c\xC3", EXT);
+    const CanFrame multi   = makeCanFrame(100, "d\x84", EXT);
+    const CanFrame other   = makeCanFrame(200, "e\xC5", EXT);
+
+    queue.push(single1, tsMono(1000), CanTxQueue::Volatile, replace);
+    queue.push(other, tsMono(1000), CanTxQueue::Volatile, replace);
+    EXPECT_EQ(2, getQueueLength(queue));
+
+    // Replaced in place, with the new deadline
+    queue.push(single2, tsMono(2000), CanTxQueue::Volatile, replace);
+    EXPECT_EQ(2, getQueueLength(queue));
+    EXPECT_EQ(single2, queue.peek()->frame);
+    EXPECT_EQ(tsMono(2000), queue.peek()->deadline);
+    EXPECT_EQ(1, queue.getReplacedFrameCount());
+
+    // Not replaced: no flag, different QoS, multi-frame transfer
+    queue.push(single3, tsMono(1000), CanTxQueue::Volatile, 0);
+    queue.push(single3, tsMono(1000), CanTxQueue::Persistent, replace);
+    queue.push(multi, tsMono(1000), CanTxQueue::Volatile, replace);
+    EXPECT_EQ(5, getQueueLength(queue));
+    EXPECT_EQ(5, pool.getNumUsedBlocks());
+    EXPECT_TRUE(isInQueue(queue, single2));
+    EXPECT_EQ(1, queue.getReplacedFrameCount());
+
+    // Only the entry that was pushed with the flag is replaced
+    queue.push(single1, tsMono(1000), CanTxQueue::Volatile, replace);
+    EXPECT_EQ(5, getQueueLength(queue));
+    EXPECT_TRUE(isInQueue(queue, single1));
+    EXPECT_FALSE(isInQueue(queue, single2));
+    EXPECT_EQ(2, queue.getReplacedFrameCount());
+    EXPECT_EQ(0, queue.getRejectedFrameCount());
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2014 Pavel Kirienko <pavel.kirienko@gmail.com>
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <uavcan/transport/can_bridge.hpp>
+#include "can/can.hpp"
+
+
+static uavcan::Frame parseBridgeTestFrame(const uavcan::CanFrame& can_frame)
+{
+    uavcan::Frame frame;
+    EXPECT_TRUE(frame.parse(can_frame));
+    return frame;
+}
+
+
+TEST(CanBridge, Forwarding)
+{
+    uavcan::PoolAllocator<uavcan::MemPoolBlockSize * 100, uavcan::MemPoolBlockSize> pool;
+
+    SystemClockMock clockmock(100);
+    CanDriverMock bus_a(2, clockmock);
+    CanDriverMock bus_b(1, clockmock);
+
+    uavcan::CanBridge bridge(bus_a, bus_b, pool, clockmock, uavcan::MonotonicDuration::fromMSec(5));
+    ASSERT_EQ(5000, bridge.getLatencyBudget().toUSec());
+
+    /*
+     * Node 10 on the bus A is seen as 50 on the bus B; node 20 on the bus B is seen as 30 on the bus A
+     */
+    ASSERT_EQ(-uavcan::ErrInvalidParam, bridge.setNodeIDMapping(uavcan::NodeID::Broadcast, 50));
+    ASSERT_EQ(0, bridge.setNodeIDMapping(10, 50));
+    ASSERT_EQ(0, bridge.setNodeIDMapping(30, 20));
+
+    ASSERT_EQ(0, bridge.addFilterRule(uavcan::CanBridge::DirectionAToB, uavcan::DataTypeKindMessage, 200, false));
+    ASSERT_EQ(-uavcan::ErrInvalidParam,
+              bridge.addFilterRule(uavcan::CanBridge::DirectionAToB, uavcan::DataTypeKindService, 300, true));
+    bridge.setDefaultFilterPolicy(uavcan::CanBridge::DirectionBToA, false);
+    ASSERT_EQ(0, bridge.addFilterRule(uavcan::CanBridge::DirectionBToA, uavcan::DataTypeKindService, 5, true));
+
+    /*
+     * A to B
+     */
+    bus_a.ifaces.at(0).pushRx(makeTransferCanFrame(100, uavcan::TransferTypeMessageBroadcast, 10,
+                                                   uavcan::NodeID::Broadcast));
+    bus_a.ifaces.at(1).pushRx(makeTransferCanFrame(5, uavcan::TransferTypeServiceRequest, 10, 30));
+    bus_a.ifaces.at(0).pushRx(makeTransferCanFrame(200, uavcan::TransferTypeMessageBroadcast, 10,
+                                                   uavcan::NodeID::Broadcast));                   // Denied
+    bus_a.ifaces.at(0).pushRx(makeTransferCanFrame(1, uavcan::TransferTypeMessageBroadcast, 0,
+                                                   uavcan::NodeID::Broadcast));                   // Anonymous
+
+    uavcan::CanFrame std_frame;
+    std_frame.id = 123;
+    std_frame.dlc = 1;
+    bus_a.ifaces.at(0).pushRx(std_frame);                                                       // Not UAVCAN
+
+    const uavcan::MonotonicTime rx_ts = clockmock.getMonotonic();
+    ASSERT_EQ(3, bridge.spinOnce());
+
+    CanIfaceMock& b0 = bus_b.ifaces.at(0);
+    ASSERT_EQ(3, b0.tx.size());             // The second iface of the bus A is read last
+
+    uavcan::Frame frm = parseBridgeTestFrame(b0.tx.front().frame);
+    ASSERT_EQ(50, frm.getSrcNodeID().get());
+    ASSERT_EQ(100, frm.getDataTypeID().get());
+    ASSERT_EQ(rx_ts + bridge.getLatencyBudget(), b0.tx.front().time);  // TX deadline
+    b0.tx.pop();
+
+    const uavcan::CanFrame anonymous = makeTransferCanFrame(1, uavcan::TransferTypeMessageBroadcast, 0,
+                                                            uavcan::NodeID::Broadcast);
+    ASSERT_TRUE(anonymous == b0.tx.front().frame);
+    b0.tx.pop();
+
+    frm = parseBridgeTestFrame(b0.tx.front().frame);
+    ASSERT_EQ(uavcan::TransferTypeServiceRequest, frm.getTransferType());
+    ASSERT_EQ(50, frm.getSrcNodeID().get());
+    ASSERT_EQ(20, frm.getDstNodeID().get());
+    const uavcan::CanFrame forwarded_request = b0.tx.front().frame;
+    b0.tx.pop();
+
+    ASSERT_EQ(3, bridge.getCounters(uavcan::CanBridge::DirectionAToB).frames_forwarded);
+    ASSERT_EQ(1, bridge.getCounters(uavcan::CanBridge::DirectionAToB).frames_filtered);
+
+    /*
+     * B to A
+     */
+    bus_b.ifaces.at(0).pushRx(makeTransferCanFrame(5, uavcan::TransferTypeServiceResponse, 20, 50));
+    bus_b.ifaces.at(0).pushRx(makeTransferCanFrame(100, uavcan::TransferTypeMessageBroadcast, 20,
+                                                   uavcan::NodeID::Broadcast));                   // Denied by default
+    bus_b.ifaces.at(0).pushRx(forwarded_request);                                               // Echo
+
+    ASSERT_EQ(1, bridge.spinOnce());
+
+    CanIfaceMock& a0 = bus_a.ifaces.at(0);
+    ASSERT_EQ(1, a0.tx.size());
+    ASSERT_TRUE(bus_a.ifaces.at(1).tx.empty());
+    frm = parseBridgeTestFrame(a0.tx.front().frame);
+    ASSERT_EQ(uavcan::TransferTypeServiceResponse, frm.getTransferType());
+    ASSERT_EQ(30, frm.getSrcNodeID().get());
+    ASSERT_EQ(10, frm.getDstNodeID().get());
+    a0.tx.pop();
+
+    ASSERT_EQ(1, bridge.getCounters(uavcan::CanBridge::DirectionBToA).frames_forwarded);
+    ASSERT_EQ(1, bridge.getCounters(uavcan::CanBridge::DirectionBToA).frames_filtered);
+    ASSERT_EQ(1, bridge.getCounters(uavcan::CanBridge::DirectionBToA).echoes_ignored);
+
+    // The echo is ignored only once
+    bus_b.ifaces.at(0).pushRx(forwarded_request);
+    ASSERT_EQ(1, bridge.spinOnce());
+    ASSERT_EQ(1, a0.tx.size());
+    a0.tx.pop();
+
+    /*
+     * Expired frames are not forwarded
+     */
+    clockmock.advance(20000);
+    bus_a.ifaces.at(0).rx.push(CanIfaceMock::FrameWithTime(
+        makeTransferCanFrame(100, uavcan::TransferTypeMessageBroadcast, 11, uavcan::NodeID::Broadcast),
+        clockmock.getMonotonic() - uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_EQ(0, bridge.spinOnce());
+    ASSERT_TRUE(b0.tx.empty());
+    ASSERT_EQ(1, bridge.getCounters(uavcan::CanBridge::DirectionAToB).frames_dropped);
+
+    /*
+     * Blocking spin
+     */
+    bus_a.ifaces.at(1).pushRx(makeTransferCanFrame(100, uavcan::TransferTypeMessageBroadcast, 12,
+                                                   uavcan::NodeID::Broadcast));
+    ASSERT_EQ(0, bridge.spin(clockmock.getMonotonic() + uavcan::MonotonicDuration::fromMSec(10)));
+    ASSERT_EQ(1, b0.tx.size());
+    ASSERT_EQ(12, parseBridgeTestFrame(b0.tx.front().frame).getSrcNodeID().get());
+}
+
+
+TEST(CanBridge, NodeIDRemapping)
+{
+    uavcan::PoolAllocator<uavcan::MemPoolBlockSize * 100, uavcan::MemPoolBlockSize> pool;
+
+    SystemClockMock clockmock(100);
+    CanDriverMock bus_a(1, clockmock);
+    CanDriverMock bus_b(1, clockmock);
+
+    uavcan::CanBridge bridge(bus_a, bus_b, pool, clockmock);
+
+    /*
+     * Node 10 on the bus A was seen as 50 on the bus B, now it is seen as 60
+     */
+    ASSERT_EQ(0, bridge.setNodeIDMapping(10, 50));
+    ASSERT_EQ(0, bridge.setNodeIDMapping(10, 60));
+
+    bus_a.ifaces.at(0).pushRx(makeTransferCanFrame(100, uavcan::TransferTypeMessageBroadcast, 10,
+                                                   uavcan::NodeID::Broadcast));
+    ASSERT_EQ(1, bridge.spinOnce());
+    CanIfaceMock& b0 = bus_b.ifaces.at(0);
+    ASSERT_EQ(1, b0.tx.size());
+    ASSERT_EQ(60, parseBridgeTestFrame(b0.tx.front().frame).getSrcNodeID().get());
+    b0.tx.pop();
+
+    // Requests addressed to the old ID must not reach node 10 anymore
+    bus_b.ifaces.at(0).pushRx(makeTransferCanFrame(5, uavcan::TransferTypeServiceRequest, 20, 50));
+    bus_b.ifaces.at(0).pushRx(makeTransferCanFrame(5, uavcan::TransferTypeServiceRequest, 20, 60));
+    ASSERT_EQ(2, bridge.spinOnce());
+    CanIfaceMock& a0 = bus_a.ifaces.at(0);
+    ASSERT_EQ(2, a0.tx.size());
+    ASSERT_EQ(60, parseBridgeTestFrame(a0.tx.front().frame).getDstNodeID().get());
+    a0.tx.pop();
+    ASSERT_EQ(10, parseBridgeTestFrame(a0.tx.front().frame).getDstNodeID().get());
+    a0.tx.pop();
+
+    // The node that holds ID 60 on the bus A takes over the released ID 50
+    bus_a.ifaces.at(0).pushRx(makeTransferCanFrame(100, uavcan::TransferTypeMessageBroadcast, 60,
+                                                   uavcan::NodeID::Broadcast));
+    ASSERT_EQ(1, bridge.spinOnce());
+    ASSERT_EQ(50, parseBridgeTestFrame(b0.tx.front().frame).getSrcNodeID().get());
+    b0.tx.pop();
+
+    /*
+     * A zero latency budget must not make the blocking spin loop without ever blocking
+     */
+    bridge.setLatencyBudget(uavcan::MonotonicDuration());
+    const uavcan::MonotonicTime deadline = clockmock.getMonotonic() + uavcan::MonotonicDuration::fromMSec(10);
+    ASSERT_EQ(0, bridge.spin(deadline));
+    ASSERT_LE(deadline, clockmock.getMonotonic());
+}
+
+
+TEST(CanBridge, Throughput)
+{
+    static const unsigned NumFrames = 20000;
+
+    uavcan::PoolAllocator<uavcan::MemPoolBlockSize * 100, uavcan::MemPoolBlockSize> pool;
+
+    SystemClockDriver clock;
+    CanDriverMock bus_a(1, clock);
+    CanDriverMock bus_b(1, clock);
+
+    uavcan::CanBridge bridge(bus_a, bus_b, pool, clock, uavcan::MonotonicDuration::fromMSec(10000));
+    ASSERT_EQ(0, bridge.setNodeIDMapping(10, 50));
+
+    for (unsigned i = 0; i < NumFrames; i++)
+    {
+        bus_a.ifaces.at(0).pushRx(makeTransferCanFrame(uint16_t(i % 1000), uavcan::TransferTypeMessageBroadcast,
+                                                       10, uavcan::NodeID::Broadcast, uint8_t(i & 31U)));
+    }
+
+    const std::chrono::steady_clock::time_point started_at = std::chrono::steady_clock::now();
+    ASSERT_EQ(int(NumFrames), bridge.spinOnce());
+    const double elapsed_sec =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+
+    std::cout << "Bridge throughput: " << (NumFrames / elapsed_sec) << " frames per second" << std::endl;
+
+    ASSERT_EQ(NumFrames, bus_b.ifaces.at(0).tx.size());
+    ASSERT_EQ(NumFrames, bridge.getCounters(uavcan::CanBridge::DirectionAToB).frames_forwarded);
+    ASSERT_EQ(50, parseBridgeTestFrame(bus_b.ifaces.at(0).tx.back().frame).getSrcNodeID().get());
+    ASSERT_EQ(999, parseBridgeTestFrame(bus_b.ifaces.at(0).tx.back().frame).getDataTypeID().get());
+}
@@ -4,6 +4,10 @@
 
 #include <gtest/gtest.h>
 #include <uavcan/transport/crc.hpp>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
 
 /*
    import crcmod
@@ -30,3 +34,78 @@ TEST(TransferCRC, Correctness)
     crc.add(reinterpret_cast<const uint8_t*>("456789"), 6);
     ASSERT_EQ(0x29B1, crc.get());
 }
+
+TEST(TransferCRC, MultiByteMatchesBytewise)
+{
+    /*
+     * All lengths up to several blocks of any multi-byte implementation, at all buffer alignments,
+     * continuing from a non-trivial CRC state.
+     */
+    std::srand(42);
+    std::vector<uint8_t> data(600);
+    for (unsigned i = 0; i < data.size(); i++)
+    {
+        data[i] = uint8_t(std::rand());
+    }
+
+    for (unsigned offset = 0; offset < 16; offset++)
+    {
+        for (unsigned len = 0; len <= data.size() - offset; len++)
+        {
+            uavcan::TransferCRC reference;
+            uavcan::TransferCRC crc;
+            reference.add(data[offset]);
+            crc.add(data[offset]);
+
+            for (unsigned i = 0; i < len; i++)
+            {
+                reference.add(data[offset + i]);
+            }
+            if (len > 0)
+            {
+                crc.add(&data[offset], len);
+            }
+            ASSERT_EQ(reference.get(), crc.get()) << "offset=" << offset << " len=" << len;
+        }
+    }
+}
+
+TEST(TransferCRC, Benchmark)
+{
+    static const unsigned Sizes[] = { 7, 64, 256, 4096 };
+    static const unsigned TotalBytes = 4 * 1024 * 1024;
+
+    std::vector<uint8_t> data(4096);
+    for (unsigned i = 0; i < data.size(); i++)
+    {
+        data[i] = uint8_t(i * 31U);
+    }
+
+    for (unsigned s = 0; s < sizeof(Sizes) / sizeof(Sizes[0]); s++)
+    {
+        const unsigned size = Sizes[s];
+        uavcan::TransferCRC bytewise;
+        uavcan::TransferCRC multibyte;
+
+        std::clock_t started = std::clock();
+        for (unsigned n = 0; n < TotalBytes / size; n++)
+        {
+            for (unsigned i = 0; i < size; i++)
+            {
+                bytewise.add(data[i]);
+            }
+        }
+        const double bytewise_time = double(std::clock() - started) / CLOCKS_PER_SEC;
+
+        started = std::clock();
+        for (unsigned n = 0; n < TotalBytes / size; n++)
+        {
+            multibyte.add(&data[0], size);
+        }
+        const double multibyte_time = double(std::clock() - started) / CLOCKS_PER_SEC;
+
+        ASSERT_EQ(bytewise.get(), multibyte.get());
+        std::cout << "CRC of " << (TotalBytes >> 20) << " MiB in " << size << " byte chunks, seconds: "
+                  << "bytewise " << bytewise_time << ", multi-byte " << multibyte_time << std::endl;
+    }
+}
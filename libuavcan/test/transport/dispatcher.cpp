@@ -332,6 +332,257 @@ TEST(Dispatcher, Spin)
 }
 
 
+static uavcan::CanFrame makeStagingTestFrame(uint32_t id, uint8_t tag)
+{
+    return uavcan::CanFrame(id | uavcan::CanFrame::FlagEFF, &tag, 1);
+}
+
+static bool checkStagingTestFrame(const uavcan::CanRxFrame& frame, uint32_t id, uint8_t tag)
+{
+    return ((frame.id & uavcan::CanFrame::MaskExtID) == id) && (frame.dlc == 1) && (frame.data[0] == tag);
+}
+
+TEST(Dispatcher, PriorityStaging)
+{
+    uavcan::PoolAllocator<uavcan::MemPoolBlockSize * 100, uavcan::MemPoolBlockSize> pool;
+
+    SystemClockMock clockmock(100);
+    CanDriverMock driver(1, clockmock);
+
+    uavcan::Dispatcher dispatcher(driver, pool, clockmock);
+    ASSERT_TRUE(dispatcher.setNodeID(SELF_NODE_ID));
+
+    RxFrameListener rx_listener;
+    dispatcher.installRxFrameListener(&rx_listener);
+
+    ASSERT_EQ(0, dispatcher.getRxStagingCapacity());   // Disabled by default
+    ASSERT_EQ(0, dispatcher.getRxFrameBudget());
+    dispatcher.setRxStagingCapacity(10);
+    dispatcher.setRxFrameBudget(3);
+
+    /*
+     * Higher priority first, equal priority in the order of arrival
+     */
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(3000, 1));
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(1000, 2));
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(2000, 3));
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(1000, 4));
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(500, 5));
+
+    ASSERT_EQ(3, dispatcher.spinOnce());
+    ASSERT_EQ(2, dispatcher.getNumStagedRxFrames());
+    ASSERT_EQ(3, rx_listener.rx_frames.size());
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(0), 500, 5));
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(1), 1000, 2));
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(2), 1000, 4));
+
+    /*
+     * A new high priority frame overtakes the low priority leftovers
+     */
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(100, 6));
+    ASSERT_EQ(3, dispatcher.spin(tsMono(10000)));      // Returns early because of the budget
+    ASSERT_GT(10000, clockmock.monotonic);
+    ASSERT_EQ(0, dispatcher.getNumStagedRxFrames());
+    ASSERT_EQ(6, rx_listener.rx_frames.size());
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(3), 100, 6));
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(4), 2000, 3));
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(5), 3000, 1));
+    rx_listener.rx_frames.clear();
+
+    /*
+     * The staging capacity limits how far ahead the dispatcher looks
+     */
+    dispatcher.setRxStagingCapacity(2);
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(3000, 7));
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(2000, 8));
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(1000, 9));
+    ASSERT_EQ(3, dispatcher.spinOnce());
+    ASSERT_EQ(3, rx_listener.rx_frames.size());
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(0), 2000, 8));
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(1), 3000, 7));
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(2), 1000, 9));
+    rx_listener.rx_frames.clear();
+
+    /*
+     * Disabling the staging releases the leftovers first
+     */
+    dispatcher.setRxStagingCapacity(10);
+    dispatcher.setRxFrameBudget(1);
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(3000, 10));
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(2000, 11));
+    ASSERT_EQ(1, dispatcher.spinOnce());
+    ASSERT_EQ(1, dispatcher.getNumStagedRxFrames());
+
+    dispatcher.setRxStagingCapacity(0);
+    driver.ifaces.at(0).pushRx(makeStagingTestFrame(1000, 12));
+    ASSERT_EQ(2, dispatcher.spinOnce());               // No budget without staging
+    ASSERT_EQ(0, dispatcher.getNumStagedRxFrames());
+    ASSERT_EQ(3, rx_listener.rx_frames.size());
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(0), 2000, 11));
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(1), 3000, 10));
+    ASSERT_TRUE(checkStagingTestFrame(rx_listener.rx_frames.at(2), 1000, 12));
+
+    ASSERT_EQ(0, pool.getNumUsedBlocks());
+}
+
+TEST(Dispatcher, OverloadProtection)
+{
+    uavcan::PoolAllocator<uavcan::MemPoolBlockSize * 100, uavcan::MemPoolBlockSize> pool;
+
+    SystemClockMock clockmock(100);
+    CanDriverMock driver(1, clockmock);
+
+    uavcan::Dispatcher dispatcher(driver, pool, clockmock);
+    ASSERT_TRUE(dispatcher.setNodeID(SELF_NODE_ID));
+
+    RxFrameListener rx_listener;
+    dispatcher.installRxFrameListener(&rx_listener);
+
+    dispatcher.setRxStagingCapacity(20);
+    dispatcher.setRxFrameBudget(2);
+    ASSERT_EQ(0, dispatcher.getRxDropPolicies());
+    ASSERT_TRUE(uavcan::TransferPriority::Default == dispatcher.getRxDropPriorityThreshold());
+    dispatcher.setRxDropPolicies(uavcan::Dispatcher::RxDropLowPriorityMessages |
+                                 uavcan::Dispatcher::RxDropAnonymousTransfers |
+                                 uavcan::Dispatcher::RxDropServiceRequests);
+
+    const uavcan::TransferType Msg = uavcan::TransferTypeMessageBroadcast;
+    const uavcan::TransferType Req = uavcan::TransferTypeServiceRequest;
+    const uavcan::NodeID Bcast = uavcan::NodeID::Broadcast;
+
+    const uavcan::CanFrame high_msg      = makeTransferCanFrame(100, Msg, 10, Bcast, 0, 0);
+    const uavcan::CanFrame low_msg       = makeTransferCanFrame(200, Msg, 10, Bcast, 0, 30);
+    const uavcan::CanFrame request       = makeTransferCanFrame(50, Req, 10, SELF_NODE_ID, 0, 8);
+    const uavcan::CanFrame anonymous_msg = makeTransferCanFrame(1, Msg, Bcast, Bcast, 0, 4);
+    const uavcan::CanFrame lower_msg     = makeTransferCanFrame(300, Msg, 11, Bcast, 0, 20);
+    const uavcan::CanFrame middle_msg    = makeTransferCanFrame(400, Msg, 11, Bcast, 0, 10);
+
+    /*
+     * The backlog exceeds the frame budget - overload; the leftovers are purged according to the policies
+     */
+    driver.ifaces.at(0).pushRx(high_msg);
+    driver.ifaces.at(0).pushRx(low_msg);
+    driver.ifaces.at(0).pushRx(request);
+    driver.ifaces.at(0).pushRx(anonymous_msg);
+    driver.ifaces.at(0).pushRx(lower_msg);
+    driver.ifaces.at(0).pushRx(middle_msg);
+
+    ASSERT_FALSE(dispatcher.isRxOverloaded());
+    ASSERT_EQ(2, dispatcher.spinOnce());
+    ASSERT_TRUE(dispatcher.isRxOverloaded());
+    ASSERT_EQ(1, dispatcher.getNumStagedRxFrames());               // The middle priority message is kept
+
+    ASSERT_EQ(2, rx_listener.rx_frames.size());
+    ASSERT_TRUE(rx_listener.rx_frames.at(0) == high_msg);
+    ASSERT_TRUE(rx_listener.rx_frames.at(1) == anonymous_msg);     // Was processed before the overload
+
+    const uavcan::RxDropCounterRegistry& drops = dispatcher.getRxDropCounters();
+    ASSERT_EQ(3, drops.getNumDroppedFrames());
+    ASSERT_EQ(3, drops.getNumDataTypes());
+    ASSERT_EQ(1, drops.getNumDroppedFrames(uavcan::DataTypeKindMessage, 200));
+    ASSERT_EQ(1, drops.getNumDroppedFrames(uavcan::DataTypeKindMessage, 300));
+    ASSERT_EQ(1, drops.getNumDroppedFrames(uavcan::DataTypeKindService, 50));
+    ASSERT_EQ(0, drops.getNumDroppedFrames(uavcan::DataTypeKindMessage, 100));
+    rx_listener.rx_frames.clear();
+
+    /*
+     * While overloaded, the frames matching the policies are dropped upon reception
+     */
+    driver.ifaces.at(0).pushRx(anonymous_msg);
+    driver.ifaces.at(0).pushRx(low_msg);
+    driver.ifaces.at(0).pushRx(high_msg);
+
+    ASSERT_EQ(2, dispatcher.spinOnce());
+    ASSERT_FALSE(dispatcher.isRxOverloaded());                      // The backlog is gone
+    ASSERT_EQ(0, dispatcher.getNumStagedRxFrames());
+
+    ASSERT_EQ(2, rx_listener.rx_frames.size());
+    ASSERT_TRUE(rx_listener.rx_frames.at(0) == high_msg);
+    ASSERT_TRUE(rx_listener.rx_frames.at(1) == middle_msg);
+
+    ASSERT_EQ(5, drops.getNumDroppedFrames());
+    ASSERT_EQ(4, drops.getNumDataTypes());
+    ASSERT_EQ(1, drops.getNumDroppedFrames(uavcan::DataTypeKindMessage, 1));
+    ASSERT_EQ(2, drops.getNumDroppedFrames(uavcan::DataTypeKindMessage, 200));
+    rx_listener.rx_frames.clear();
+
+    /*
+     * Nothing is dropped without overload
+     */
+    driver.ifaces.at(0).pushRx(low_msg);
+    ASSERT_EQ(1, dispatcher.spinOnce());
+    ASSERT_EQ(1, rx_listener.rx_frames.size());
+    ASSERT_EQ(5, drops.getNumDroppedFrames());
+    rx_listener.rx_frames.clear();
+
+    /*
+     * Time budget; every clock reading takes 600 usec
+     */
+    dispatcher.setRxFrameBudget(0);
+    dispatcher.setRxTimeBudget(uavcan::MonotonicDuration::fromUSec(1000));
+    clockmock.monotonic_auto_advance = 600;
+
+    driver.ifaces.at(0).pushRx(low_msg);
+    driver.ifaces.at(0).pushRx(high_msg);
+    driver.ifaces.at(0).pushRx(request);
+
+    ASSERT_EQ(1, dispatcher.spinOnce());
+    ASSERT_TRUE(dispatcher.isRxOverloaded());
+    ASSERT_EQ(0, dispatcher.getNumStagedRxFrames());
+    ASSERT_EQ(1, rx_listener.rx_frames.size());
+    ASSERT_TRUE(rx_listener.rx_frames.at(0) == high_msg);
+    ASSERT_EQ(7, drops.getNumDroppedFrames());
+    ASSERT_EQ(2, drops.getNumDroppedFrames(uavcan::DataTypeKindService, 50));
+
+    /*
+     * The overload state ends only when less than half of the time budget is used
+     */
+    clockmock.monotonic_auto_advance = 300;
+    ASSERT_EQ(0, dispatcher.spinOnce());
+    ASSERT_TRUE(dispatcher.isRxOverloaded());
+
+    clockmock.monotonic_auto_advance = 100;
+    ASSERT_EQ(0, dispatcher.spinOnce());
+    ASSERT_FALSE(dispatcher.isRxOverloaded());
+    clockmock.monotonic_auto_advance = 0;
+
+    dispatcher.setRxStagingCapacity(0);
+    ASSERT_EQ(0, pool.getNumUsedBlocks());                          // Drop counters don't use the pool
+}
+
+TEST(Dispatcher, RxDropCounters)
+{
+    uavcan::RxDropCounterRegistry drops;
+    ASSERT_EQ(0, drops.getNumDroppedFrames());
+    ASSERT_EQ(0, drops.getNumDataTypes());
+
+    drops.registerDrop(uavcan::DataTypeKindMessage, 5);
+    drops.registerDrop(uavcan::DataTypeKindService, 5);
+    drops.registerDrop(uavcan::DataTypeKindMessage, 5);
+    ASSERT_EQ(3, drops.getNumDroppedFrames());
+    ASSERT_EQ(2, drops.getNumDataTypes());
+    ASSERT_EQ(2, drops.getNumDroppedFrames(uavcan::DataTypeKindMessage, 5));
+    ASSERT_EQ(1, drops.getNumDroppedFrames(uavcan::DataTypeKindService, 5));
+    ASSERT_EQ(0, drops.getNumDroppedFrames(uavcan::DataTypeKindService, 6));
+
+    /*
+     * Once the table is full, the new data types are accounted in the total counter only
+     */
+    for (unsigned i = 0; i < UAVCAN_RX_DROP_COUNTER_TABLE_SIZE; i++)
+    {
+        drops.registerDrop(uavcan::DataTypeKindMessage, uavcan::DataTypeID(uint16_t(100 + i * 16)));
+    }
+    ASSERT_EQ(3 + UAVCAN_RX_DROP_COUNTER_TABLE_SIZE, drops.getNumDroppedFrames());
+    ASSERT_EQ(UAVCAN_RX_DROP_COUNTER_TABLE_SIZE, drops.getNumDataTypes());
+    ASSERT_EQ(2, drops.getNumDroppedFrames(uavcan::DataTypeKindMessage, 5));
+    ASSERT_EQ(1, drops.getNumDroppedFrames(uavcan::DataTypeKindMessage, 100));
+    const uavcan::DataTypeID last_dtid(uint16_t(100 + (UAVCAN_RX_DROP_COUNTER_TABLE_SIZE - 1) * 16));
+    ASSERT_EQ(0, drops.getNumDroppedFrames(uavcan::DataTypeKindMessage, last_dtid));
+
+    drops.registerDrop(uavcan::DataTypeKindService, 5);
+    ASSERT_EQ(2, drops.getNumDroppedFrames(uavcan::DataTypeKindService, 5));  // Existing counters keep counting
+}
+
 struct DispatcherTestLoopbackFrameListener : public uavcan::LoopbackFrameListenerBase
 {
     uavcan::RxFrame last_frame;
@@ -390,3 +641,188 @@ TEST(Dispatcher, Loopback)
     }
     ASSERT_EQ(0, dispatcher.getLoopbackFrameListenerRegistry().getNumListeners());
 }
+
+
+class WildcardTestListener : public uavcan::WildcardTransferListener
+{
+    const std::vector<uavcan::DataTypeDescriptor> known_types_;
+
+    const uavcan::DataTypeDescriptor* findType(uavcan::DataTypeKind kind, uavcan::DataTypeID dtid) const
+    {
+        for (unsigned i = 0; i < known_types_.size(); i++)
+        {
+            if (known_types_[i].getKind() == kind && known_types_[i].getID() == dtid)
+            {
+                return &known_types_[i];
+            }
+        }
+        return UAVCAN_NULLPTR;
+    }
+
+    virtual void handleIncomingTransfer(uavcan::DataTypeID data_type_id, uavcan::NodeID dst_node_id,
+                                        uavcan::IncomingTransfer& transfer)
+    {
+        const uavcan::DataTypeKind kind = (transfer.getTransferType() == uavcan::TransferTypeMessageBroadcast) ?
+                                          uavcan::DataTypeKindMessage : uavcan::DataTypeKindService;
+        const uavcan::DataTypeDescriptor* const type = findType(kind, data_type_id);
+        Transfer rx(transfer, (type == UAVCAN_NULLPTR) ? makeDataType(kind, data_type_id.get()) : *type);
+        rx.dst_node_id = dst_node_id;
+        std::cout << "Wildcard listener received transfer: " << rx.toString() << std::endl;
+        transfers.push_back(rx);
+    }
+
+    virtual bool getDataTypeSignature(uavcan::DataTypeKind kind, uavcan::DataTypeID data_type_id,
+                                      uavcan::DataTypeSignature& out_signature)
+    {
+        const uavcan::DataTypeDescriptor* const type = findType(kind, data_type_id);
+        if (type != UAVCAN_NULLPTR)
+        {
+            out_signature = type->getSignature();
+            return true;
+        }
+        return false;
+    }
+
+public:
+    std::vector<Transfer> transfers;
+
+    WildcardTestListener(const std::vector<uavcan::DataTypeDescriptor>& known_types,
+                         uavcan::IPoolAllocator& allocator, std::size_t max_blocks)
+        : uavcan::WildcardTransferListener(allocator, max_blocks, 512)
+        , known_types_(known_types)
+    { }
+
+    bool matchAndRemove(const Transfer& reference)
+    {
+        for (std::vector<Transfer>::iterator it = transfers.begin(); it != transfers.end(); ++it)
+        {
+            if (*it == reference)
+            {
+                transfers.erase(it);
+                return true;
+            }
+        }
+        std::cout << "Wildcard listener: no match for " << reference.toString() << std::endl;
+        return false;
+    }
+};
+
+
+TEST(Dispatcher, WildcardListener)
+{
+    uavcan::PoolAllocator<uavcan::MemPoolBlockSize * 100, uavcan::MemPoolBlockSize> pool;
+
+    SystemClockMock clockmock(100);
+    CanDriverMock driver(2, clockmock);
+
+    uavcan::Dispatcher dispatcher(driver, pool, clockmock);
+    ASSERT_TRUE(dispatcher.setNodeID(SELF_NODE_ID));
+
+    DispatcherTransferEmulator emulator(driver, SELF_NODE_ID);
+
+    const uavcan::DataTypeDescriptor msg1 = makeDataType(uavcan::DataTypeKindMessage, 1);
+    const uavcan::DataTypeDescriptor msg2 = makeDataType(uavcan::DataTypeKindMessage, 2);
+    const uavcan::DataTypeDescriptor msg3 = makeDataType(uavcan::DataTypeKindMessage, 3);   // Unknown signature
+    const uavcan::DataTypeDescriptor srv1 = makeDataType(uavcan::DataTypeKindService, 1);
+    const uavcan::DataTypeDescriptor msg2_wrong(uavcan::DataTypeKindMessage, 2, uavcan::DataTypeSignature(123), "");
+
+    std::vector<uavcan::DataTypeDescriptor> known_types;
+    known_types.push_back(msg1);
+    known_types.push_back(msg2);
+    known_types.push_back(srv1);
+
+    const std::string long_payload(100, 'a');
+    const std::string short_payload("123");
+
+    // Regular listener for comparison
+    TestListener regular(dispatcher.getTransferPerfCounter(), msg1, 512, pool);
+    ASSERT_TRUE(dispatcher.registerMessageListener(&regular));
+
+    WildcardTestListener wildcard(known_types, pool, 40);
+    ASSERT_FALSE(dispatcher.getWildcardTransferListener());
+    dispatcher.installWildcardTransferListener(&wildcard);
+    ASSERT_EQ(&wildcard, dispatcher.getWildcardTransferListener());
+
+    /*
+     * Same source node, different data types, interleaved
+     */
+    const Transfer transfers[7] =
+    {
+        emulator.makeTransfer(0,  uavcan::TransferTypeMessageBroadcast, 10, long_payload, msg1),
+        emulator.makeTransfer(0,  uavcan::TransferTypeMessageBroadcast, 10, long_payload + "b", msg2),
+        emulator.makeTransfer(0,  uavcan::TransferTypeMessageBroadcast, 10, short_payload, msg3),
+        emulator.makeTransfer(0,  uavcan::TransferTypeMessageBroadcast, 11, long_payload, msg3),       // Ignored
+        emulator.makeTransfer(0,  uavcan::TransferTypeMessageBroadcast, 12, long_payload, msg2_wrong), // Bad CRC
+        emulator.makeTransfer(0,  uavcan::TransferTypeServiceRequest,   13, long_payload + "c", srv1),
+        emulator.makeTransfer(0,  uavcan::TransferTypeServiceRequest,   13, long_payload + "d", srv1, 100)
+    };
+
+    emulator.send(transfers);
+    while (dispatcher.spinOnce() > 0)
+    {
+        clockmock.advance(100);
+    }
+
+    ASSERT_TRUE(regular.matchAndPop(transfers[0]));
+    ASSERT_TRUE(regular.isEmpty());
+
+    ASSERT_EQ(5, wildcard.transfers.size());
+    ASSERT_TRUE(wildcard.matchAndRemove(transfers[0]));
+    ASSERT_TRUE(wildcard.matchAndRemove(transfers[1]));
+    ASSERT_TRUE(wildcard.matchAndRemove(transfers[2]));
+    ASSERT_TRUE(wildcard.matchAndRemove(transfers[5]));
+    ASSERT_TRUE(wildcard.matchAndRemove(transfers[6]));        // Addressed to another node
+
+    EXPECT_EQ(5, wildcard.getPerfCounter().getRxTransferCount());
+    EXPECT_EQ(1, wildcard.getPerfCounter().getErrorCount());
+    EXPECT_EQ(1, dispatcher.getTransferPerfCounter().getRxTransferCount());
+
+    // Duplicates are rejected by the transfer ID check
+    emulator.send(transfers);
+    while (dispatcher.spinOnce() > 0)
+    {
+        clockmock.advance(100);
+    }
+    ASSERT_TRUE(wildcard.transfers.empty());
+
+    // A transfer that is cut short keeps its buffer until it times out
+    {
+        const Transfer cut = emulator.makeTransfer(0, uavcan::TransferTypeMessageBroadcast, 14, long_payload, msg2);
+        const std::vector<uavcan::RxFrame> frames = serializeTransfer(cut);
+        const unsigned used_blocks = pool.getNumUsedBlocks();
+        emulator.sendOneFrame(frames[0]);
+        emulator.sendOneFrame(frames[1]);
+        while (dispatcher.spinOnce() > 0)
+        {
+            clockmock.advance(100);
+        }
+        EXPECT_LT(used_blocks, pool.getNumUsedBlocks());
+    }
+
+    EXPECT_LT(0, wildcard.getNumReceivers());
+    dispatcher.cleanup(tsMono(100000000));
+    EXPECT_EQ(0, wildcard.getNumReceivers());
+    EXPECT_EQ(0, pool.getNumUsedBlocks());
+
+    /*
+     * The memory quota is exhausted by the wildcard listener, the regular listener is not affected
+     */
+    dispatcher.removeWildcardTransferListener();
+    ASSERT_FALSE(dispatcher.getWildcardTransferListener());
+
+    WildcardTestListener starving(known_types, pool, 3);
+    dispatcher.installWildcardTransferListener(&starving);
+
+    const Transfer transfer = emulator.makeTransfer(0, uavcan::TransferTypeMessageBroadcast, 10,
+                                                    std::string(300, 'x'), msg1);
+    emulator.send(&transfer, 1);
+    while (dispatcher.spinOnce() > 0)
+    {
+        clockmock.advance(100);
+    }
+    ASSERT_TRUE(regular.matchAndPop(transfer));
+    ASSERT_TRUE(starving.transfers.empty());
+
+    dispatcher.removeWildcardTransferListener();
+    dispatcher.unregisterMessageListener(&regular);
+}
@@ -195,6 +195,61 @@ TEST(TransferBufferManagerEntry, Basic)
 }
 
 
+/**
+ * Gathers the whole content of the buffer with peek().
+ */
+static std::string peekAll(const uavcan::ITransferBuffer& tbb, unsigned& out_num_pieces)
+{
+    std::string out;
+    out_num_pieces = 0;
+    const uint8_t* data = UAVCAN_NULLPTR;
+    int len = 0;
+    while ((len = tbb.peek(unsigned(out.length()), data)) > 0)
+    {
+        EXPECT_TRUE(data != UAVCAN_NULLPTR);
+        out.append(reinterpret_cast<const char*>(data), unsigned(len));
+        out_num_pieces++;
+    }
+    EXPECT_EQ(0, len);
+    return out;
+}
+
+TEST(TransferBuffer, Peek)
+{
+    const uint8_t* const test_data_ptr = reinterpret_cast<const uint8_t*>(TEST_DATA.c_str());
+    unsigned num_pieces = 0;
+
+    // Static buffer - one piece
+    uavcan::StaticTransferBuffer<TEST_BUFFER_SIZE> static_buf;
+    ASSERT_EQ("", peekAll(static_buf, num_pieces));
+    ASSERT_EQ(TEST_BUFFER_SIZE, static_buf.write(0, test_data_ptr, TEST_BUFFER_SIZE));
+    ASSERT_EQ(TEST_DATA.substr(0, TEST_BUFFER_SIZE), peekAll(static_buf, num_pieces));
+    ASSERT_EQ(1, num_pieces);
+
+    const uint8_t* data = UAVCAN_NULLPTR;
+    ASSERT_EQ(TEST_BUFFER_SIZE - 10, static_buf.peek(10, data));
+    ASSERT_TRUE(data == static_buf.getRawPtr() + 10);
+
+    // Dynamic buffer - one piece per block, pointing into the block
+    static const int POOL_BLOCKS = 8;
+    uavcan::PoolAllocator<uavcan::MemPoolBlockSize * POOL_BLOCKS, uavcan::MemPoolBlockSize> pool;
+    uavcan::TransferBufferManagerEntry dyn_buf(pool, TEST_BUFFER_SIZE);
+    ASSERT_EQ("", peekAll(dyn_buf, num_pieces));
+    ASSERT_EQ(TEST_BUFFER_SIZE, dyn_buf.write(0, test_data_ptr, TEST_BUFFER_SIZE));
+    ASSERT_EQ(TEST_DATA.substr(0, TEST_BUFFER_SIZE), peekAll(dyn_buf, num_pieces));
+    ASSERT_LT(1, num_pieces);
+    ASSERT_EQ(pool.getNumUsedBlocks(), num_pieces);
+
+    for (unsigned offset = 0; offset < TEST_BUFFER_SIZE; offset += 7)
+    {
+        const int len = dyn_buf.peek(offset, data);
+        ASSERT_LT(0, len);
+        ASSERT_TRUE(std::equal(data, data + len, test_data_ptr + offset));
+    }
+    ASSERT_EQ(0, dyn_buf.peek(TEST_BUFFER_SIZE, data));
+}
+
+
 static const std::string MGR_TEST_DATA[4] =
 {
     "I thought you would cry out again \'don\'t speak of it, leave off.\'\" Raskolnikov gave a laugh, but rather a "
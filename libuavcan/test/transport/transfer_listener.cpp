@@ -260,6 +260,95 @@ TEST(TransferListener, AnonymousTransfers)
     ASSERT_TRUE(subscriber.isEmpty());
 }
 
+/**
+ * Collects the streamed payload; can be made to reject it.
+ */
+class StreamCollector : public uavcan::StreamingTransferBuffer
+{
+    virtual void handleStreamStart() { data.clear(); }
+
+    virtual bool handleStreamData(const uint8_t* ptr, unsigned len)
+    {
+        data.append(reinterpret_cast<const char*>(ptr), len);
+        return !reject;
+    }
+
+public:
+    std::string data;
+    bool reject;
+
+    StreamCollector() : reject(false) { }
+};
+
+class StreamingTestListener : public TestListener
+{
+    virtual void handleStreamedTransfer(uavcan::IncomingTransfer&) { num_streamed++; }
+    virtual void handleStreamedTransferFailure() { num_failures++; }
+
+public:
+    unsigned num_streamed;
+    unsigned num_failures;
+
+    StreamingTestListener(uavcan::TransferPerfCounter& perf, const uavcan::DataTypeDescriptor& data_type,
+                          uavcan::uint16_t max_buffer_size, uavcan::IPoolAllocator& allocator)
+        : TestListener(perf, data_type, max_buffer_size, allocator)
+        , num_streamed(0)
+        , num_failures(0)
+    { }
+};
+
+TEST(TransferListener, StreamAborts)
+{
+    const uavcan::DataTypeDescriptor type(uavcan::DataTypeKindMessage, 123, uavcan::DataTypeSignature(123456789), "A");
+
+    static const int NUM_POOL_BLOCKS = 100;
+    uavcan::PoolAllocator<uavcan::MemPoolBlockSize * NUM_POOL_BLOCKS, uavcan::MemPoolBlockSize> poolmgr;
+    uavcan::TransferPerfCounter perf;
+    StreamingTestListener subscriber(perf, type, 16, poolmgr);
+    StreamCollector collector;
+    subscriber.installStreamingBuffer(&collector);
+
+    TransferListenerEmulator emulator(subscriber, type);
+    const Transfer transfers[] =
+    {
+        emulator.makeTransfer(16, uavcan::TransferTypeMessageBroadcast, 1, "0123456789abcdef"),   // Max size
+        emulator.makeTransfer(16, uavcan::TransferTypeMessageBroadcast, 2, "0123456789abcdefg"),  // Too long
+        emulator.makeTransfer(16, uavcan::TransferTypeMessageBroadcast, 3, "0123456789abc"),      // Rejected
+        emulator.makeTransfer(16, uavcan::TransferTypeMessageBroadcast, 4, "0123456789abc")
+    };
+
+    std::vector<std::vector<uavcan::RxFrame> > sers(1, serializeTransfer(transfers[0]));
+    emulator.send(sers);
+    ASSERT_EQ(1, subscriber.num_streamed);
+    ASSERT_EQ(0, subscriber.num_failures);
+    ASSERT_EQ("0123456789abcdef", collector.data);
+
+    // Payload beyond the max buffer size is not streamed through
+    sers[0] = serializeTransfer(transfers[1]);
+    emulator.send(sers);
+    ASSERT_EQ(1, subscriber.num_streamed);
+    ASSERT_EQ(1, subscriber.num_failures);
+    ASSERT_EQ("0123456789abcdef", collector.data);
+    ASSERT_EQ(1, perf.getErrorCount());
+
+    collector.reject = true;
+    sers[0] = serializeTransfer(transfers[2]);
+    emulator.send(sers);
+    ASSERT_EQ(1, subscriber.num_streamed);
+    ASSERT_EQ(2, subscriber.num_failures);
+    ASSERT_LT(1, perf.getErrorCount());     // The frames that follow the rejected one are counted as well
+
+    // The streaming buffer has been released by the aborted transfers
+    collector.reject = false;
+    sers[0] = serializeTransfer(transfers[3]);
+    emulator.send(sers);
+    ASSERT_EQ(2, subscriber.num_streamed);
+    ASSERT_EQ(2, subscriber.num_failures);
+    ASSERT_EQ("0123456789abc", collector.data);
+
+    ASSERT_TRUE(subscriber.isEmpty());
+}
+
 TEST(TransferListener, Sizes)
 {
     using namespace uavcan;
@@ -7,6 +7,8 @@
 #include "transfer_test_helpers.hpp"
 #include "can/can.hpp"
 #include <uavcan/transport/transfer_sender.hpp>
+#include <uavcan/marshal/bit_stream.hpp>
+#include <vector>
 
 static int sendOne(uavcan::TransferSender& sender, const std::string& data,
                    uint64_t monotonic_tx_deadline, uint64_t monotonic_blocking_deadline,
@@ -264,3 +266,115 @@ TEST(TransferSender, PassiveMode)
     EXPECT_EQ(1, dispatcher.getTransferPerfCounter().getTxTransferCount());
     EXPECT_EQ(0, dispatcher.getTransferPerfCounter().getRxTransferCount());
 }
+
+/**
+ * Writes the string through BitStream in odd-sized pieces, so that the last byte of the sink gets overwritten
+ * by the next write most of the time.
+ */
+class StringPayloadSource : public uavcan::ITransferPayloadSource
+{
+    const std::string data_;
+
+public:
+    explicit StringPayloadSource(const std::string& data) : data_(data) { }
+
+    virtual int writePayload(uavcan::ITransferBuffer& sink) const
+    {
+        uavcan::BitStream bs(sink);
+        const unsigned total_bits = unsigned(data_.length()) * 8U;
+        unsigned piece_bits = 3;
+        unsigned pos = 0;
+        while (pos < total_bits)
+        {
+            const unsigned len = std::min(piece_bits, total_bits - pos);
+            uint8_t piece[4] = { 0, 0, 0, 0 };
+            uavcan::bitarrayCopy(reinterpret_cast<const unsigned char*>(data_.c_str()) + pos / 8U, pos % 8U, len,
+                                 piece, 0);
+            if (bs.write(piece, len) != uavcan::BitStream::ResultOk)
+            {
+                return -uavcan::ErrLogic;
+            }
+            pos += len;
+            piece_bits = (piece_bits % 23U) + 5U;
+        }
+        return 0;
+    }
+};
+
+static std::vector<uavcan::CanFrame> popTxFrames(CanDriverMock& driver)
+{
+    std::vector<uavcan::CanFrame> frames;
+    for (uint8_t i = 0; i < driver.getNumIfaces(); i++)
+    {
+        CanIfaceMock& iface = driver.ifaces.at(i);
+        while (!iface.tx.empty())
+        {
+            frames.push_back(iface.tx.front().frame);
+            iface.tx.pop();
+        }
+    }
+    return frames;
+}
+
+TEST(TransferSender, Streaming)
+{
+    uavcan::PoolAllocator<uavcan::MemPoolBlockSize * 100, uavcan::MemPoolBlockSize> poolmgr;
+
+    SystemClockMock clockmock(100);
+    CanDriverMock driver(2, clockmock);
+
+    uavcan::Dispatcher dispatcher(driver, poolmgr, clockmock);
+
+    uavcan::TransferSender sender(dispatcher, makeDataType(uavcan::DataTypeKindMessage, 123),
+                                  uavcan::CanTxQueue::Volatile);
+
+    static const std::string Data = "Time is an illusion. Lunchtime doubly so.";
+
+    /*
+     * Passive mode - only single frame anonymous transfers are possible
+     */
+    sender.allowAnonymousTransfers();
+    ASSERT_EQ(2, sender.send(StringPayloadSource("1234567"), tsMono(1000), uavcan::MonotonicTime(),
+                             uavcan::TransferTypeMessageBroadcast, uavcan::NodeID::Broadcast));
+    ASSERT_EQ(-uavcan::ErrPassiveMode,
+              sender.send(StringPayloadSource("12345678"), tsMono(1000), uavcan::MonotonicTime(),
+                          uavcan::TransferTypeMessageBroadcast, uavcan::NodeID::Broadcast));
+    ASSERT_EQ(2, popTxFrames(driver).size());                   // Two interfaces
+
+    /*
+     * The streamed transfers must be exactly the same as the buffered ones
+     */
+    ASSERT_TRUE(dispatcher.setNodeID(64));
+
+    for (unsigned len = 0; len <= Data.length(); len++)
+    {
+        const std::string payload = Data.substr(0, len);
+
+        const int buffered_res = sender.send(reinterpret_cast<const uint8_t*>(payload.c_str()), len,
+                                             tsMono(1000), uavcan::MonotonicTime(),
+                                             uavcan::TransferTypeMessageBroadcast, uavcan::NodeID::Broadcast,
+                                             uavcan::TransferID(uint8_t(len % 32U)));
+        const std::vector<uavcan::CanFrame> buffered = popTxFrames(driver);
+
+        const int streamed_res = sender.send(StringPayloadSource(payload), tsMono(1000), uavcan::MonotonicTime(),
+                                             uavcan::TransferTypeMessageBroadcast, uavcan::NodeID::Broadcast,
+                                             uavcan::TransferID(uint8_t(len % 32U)));
+        const std::vector<uavcan::CanFrame> streamed = popTxFrames(driver);
+
+        ASSERT_LT(0, buffered_res);
+        ASSERT_EQ(buffered_res, streamed_res) << "len=" << len;
+        // Single frame transfers report the number of interfaces, multi frame transfers the number of frames
+        ASSERT_EQ((len <= 7) ? 2U : 2U * unsigned(buffered_res), buffered.size());
+        ASSERT_TRUE(buffered == streamed) << "len=" << len;
+    }
+
+    /*
+     * Automatic Transfer ID
+     */
+    ASSERT_EQ(7, sender.send(StringPayloadSource(Data), tsMono(1000), uavcan::MonotonicTime(),
+                             uavcan::TransferTypeMessageBroadcast, uavcan::NodeID::Broadcast));
+    ASSERT_EQ(14, popTxFrames(driver).size());
+
+    EXPECT_EQ(0, dispatcher.getTransferPerfCounter().getErrorCount());
+    EXPECT_EQ(2 * (Data.length() + 1) + 2, dispatcher.getTransferPerfCounter().getTxTransferCount());
+}
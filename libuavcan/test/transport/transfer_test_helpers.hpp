@@ -9,6 +9,8 @@
 #include <vector>
 #include <gtest/gtest.h>
 #include <uavcan/transport/transfer_listener.hpp>
+#include <uavcan/node/global_data_type_registry.hpp>
+#include <uavcan/marshal/scalar_codec.hpp>
 
 /**
  * UAVCAN transfer representation used in various tests.
@@ -232,6 +234,34 @@ std::vector<uavcan::RxFrame> serializeTransfer(const Transfer& transfer)
     return output;
 }
 
+/**
+ * Encodes the message and serializes it into the frames of a broadcast transfer.
+ * The data type must be registered.
+ */
+template <typename DataType>
+std::vector<uavcan::RxFrame> serializeMessage(const DataType& msg, uavcan::NodeID src, uavcan::TransferID tid,
+                                              uavcan::MonotonicTime ts)
+{
+    uavcan::StaticTransferBuffer<(DataType::MaxBitLen + 7) / 8> buf;
+    uavcan::BitStream bitstream(buf);
+    uavcan::ScalarCodec codec(bitstream);
+    EXPECT_EQ(1, DataType::encode(msg, codec));
+
+    const uavcan::DataTypeDescriptor* const descr =
+        uavcan::GlobalDataTypeRegistry::instance().find(uavcan::DataTypeKindMessage, DataType::getDataTypeFullName());
+    if (descr == UAVCAN_NULLPTR)
+    {
+        ADD_FAILURE() << "Data type is not registered: " << DataType::getDataTypeFullName();
+        return std::vector<uavcan::RxFrame>();
+    }
+
+    const Transfer transfer(ts, uavcan::UtcTime(), uavcan::TransferPriority::Default,
+                            uavcan::TransferTypeMessageBroadcast, tid, src, uavcan::NodeID::Broadcast,
+                            std::string(reinterpret_cast<const char*>(buf.getRawPtr()), buf.getMaxWritePos()),
+                            *descr);
+    return serializeTransfer(transfer);
+}
+
 inline uavcan::DataTypeDescriptor makeDataType(uavcan::DataTypeKind kind, uint16_t id, const char* name = "")
 {
     const uavcan::DataTypeSignature signature((uint64_t(kind) << 16) | uint16_t(id << 8) | uint16_t(id & 0xFF));